@@ -202,6 +202,12 @@ template <class T> class HalfClockReceiver: public T {
 			T::run_for(half_cycles_.flush_cycles());
 		}
 
+		/// Extends T::serialise with the half cycle that may be outstanding.
+		template <typename Archive> void serialise(Archive &archive) {
+			T::serialise(archive);
+			archive(half_cycles_);
+		}
+
 	private:
 		HalfCycles half_cycles_;
 };
@@ -0,0 +1,265 @@
+//
+//  JustInTime.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 28/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#ifndef JustInTime_hpp
+#define JustInTime_hpp
+
+#include <limits>
+#include <memory>
+#include <utility>
+
+#include "ClockReceiver.hpp"
+#include "ForceInline.hpp"
+#include "../Concurrency/AsyncTaskQueue.hpp"
+
+/*
+	Informal pattern for components that are clocked only when somebody needs them to be up to date:
+
+		The owner accumulates the time that has passed since the component was last run, and runs
+		it for that period immediately before any interaction with it, and upon each flush. A
+		component that may change its outputs of its own accord, e.g. by signalling an interrupt,
+		additionally says when next it might do so; its owner then also runs it at that time.
+
+	JustInTimeActor captures the first of those; SequencedJustInTimeActor adds the second.
+*/
+
+namespace JustInTime {
+
+/// @returns A pointer to @c object, which is held directly.
+template <typename T> T *target(T &object)								{	return &object;			}
+
+/// @returns The object that @c object owns.
+template <typename T> T *target(std::shared_ptr<T> &object)				{	return object.get();	}
+
+/// @returns The object that @c object owns.
+template <typename T> T *target(std::unique_ptr<T> &object)				{	return object.get();	}
+
+/// Converts an accumulation of local time into the number of target time units it fully covers, keeping the remainder.
+inline Cycles divide(Cycles &time, int divider, Cycles)					{	return time.divide(Cycles(divider));			}
+inline HalfCycles divide(HalfCycles &time, int divider, HalfCycles)		{	return time.divide(HalfCycles(divider));		}
+inline Cycles divide(HalfCycles &time, int divider, Cycles)				{	return time.divide_cycles(Cycles(divider));		}
+
+}
+
+/*!
+	Holds a component that is clocked via run_for, plus the amount of time that has passed since that
+	component was last run. @c T may be the component itself or a std::shared_ptr or std::unique_ptr to it.
+
+	Time is added with +=, and is expressed in @c LocalTimeScale. The component is run for
+	1 / @c divider of that time, expressed in @c TargetTimeScale; any remainder is kept for next time.
+
+	The -> operator runs the component for all time that has accumulated and then provides access to it;
+	owners should therefore use -> for any interaction that depends on the current time, and @c last_valid
+	for any that doesn't.
+*/
+template <class T, class LocalTimeScale = Cycles, int divider = 1, class TargetTimeScale = LocalTimeScale> class JustInTimeActor {
+	private:
+		typedef decltype(JustInTime::target(std::declval<T &>())) TargetPointer;
+
+	public:
+		/// Constructs the held object, forwarding @c args to its constructor.
+		template <typename... Args> JustInTimeActor(Args &&... args) : object_(std::forward<Args>(args)...) {}
+
+		/// Adds @c duration to the time that has passed since the component was last run.
+		forceinline void operator += (const LocalTimeScale &duration) {
+			time_since_update_ += duration;
+			is_flushed_ = false;
+		}
+
+		/// Runs the component for all time that has accumulated, then provides access to it.
+		forceinline TargetPointer operator->() {
+			flush();
+			return JustInTime::target(object_);
+		}
+
+		/// Provides access to the component without running it; it may therefore not be up to date.
+		forceinline TargetPointer last_valid() {
+			return JustInTime::target(object_);
+		}
+
+		/// Provides the object that this actor holds — for owners that need to create, replace or share the component.
+		T &object() {
+			return object_;
+		}
+
+		/// @returns The amount of time that has accumulated since the component was last run.
+		const LocalTimeScale &time_since_update() const {
+			return time_since_update_;
+		}
+
+		/// Runs the component for all time that has accumulated.
+		forceinline void flush() {
+			if(!is_flushed_) {
+				is_flushed_ = true;
+				JustInTime::target(object_)->run_for(JustInTime::divide(time_since_update_, divider, TargetTimeScale()));
+			}
+		}
+
+		/// Captures or restores the amount of time that has accumulated; the component itself is not included.
+		template <typename Archive> void serialise_backlog(Archive &archive) {
+			archive(time_since_update_);
+			if(archive.is_reading()) is_flushed_ = false;
+		}
+
+	private:
+		T object_;
+		LocalTimeScale time_since_update_;
+		bool is_flushed_ = true;
+};
+
+/*!
+	A JustInTimeActor for components that provide get_next_sequence_point(), returning the amount of
+	time until next their outputs might change of their own accord, or a negative number if they
+	won't without further interaction. Such components are run at those sequence points as well as
+	whenever accessed, so that e.g. interrupts are signalled on time.
+
+	The sequence point is reassessed at the first += following any access, since any interaction may
+	have moved it.
+*/
+template <class T, class TimeScale = Cycles> class SequencedJustInTimeActor {
+	private:
+		typedef JustInTimeActor<T, TimeScale> Actor;
+		typedef decltype(JustInTime::target(std::declval<T &>())) TargetPointer;
+
+	public:
+		/// Constructs the held object, forwarding @c args to its constructor.
+		template <typename... Args> SequencedJustInTimeActor(Args &&... args) : actor_(std::forward<Args>(args)...) {}
+
+		/// Adds @c duration to the time that has passed since the component was last run, running it if a sequence point has been reached.
+		forceinline void operator += (const TimeScale &duration) {
+			actor_ += duration;
+			if(actor_.time_since_update() >= time_until_sequence_point_) update_sequence_point();
+		}
+
+		/// Runs the component for all time that has accumulated, then provides access to it.
+		forceinline TargetPointer operator->() {
+			flush();
+			return actor_.last_valid();
+		}
+
+		/// Provides access to the component without running it; it may therefore not be up to date.
+		forceinline TargetPointer last_valid() {
+			return actor_.last_valid();
+		}
+
+		/// Provides the object that this actor holds — for owners that need to create, replace or share the component.
+		T &object() {
+			return actor_.object();
+		}
+
+		/// @returns The amount of time that has accumulated since the component was last run.
+		const TimeScale &time_since_update() const {
+			return actor_.time_since_update();
+		}
+
+		/// Runs the component for all time that has accumulated.
+		forceinline void flush() {
+			actor_.flush();
+			time_until_sequence_point_ = TimeScale(0);
+		}
+
+		/// Captures or restores the amount of time that has accumulated; the component itself is not included.
+		template <typename Archive> void serialise_backlog(Archive &archive) {
+			actor_.serialise_backlog(archive);
+			if(archive.is_reading()) time_until_sequence_point_ = TimeScale(0);
+		}
+
+	private:
+		Actor actor_;
+		TimeScale time_until_sequence_point_;
+
+		void update_sequence_point() {
+			actor_.flush();
+			time_until_sequence_point_ = actor_.last_valid()->get_next_sequence_point();
+			if(time_until_sequence_point_ < TimeScale(0)) time_until_sequence_point_ = TimeScale(std::numeric_limits<int>::max());
+		}
+};
+
+/*!
+	A JustInTimeActor that can optionally run its component on another thread.
+
+	If asynchronous, whenever at least @c threshold time has accumulated it is passed to a task queue,
+	which runs the component for that period while its owner continues. The -> operator and flush wait
+	for any such work to complete before running the component for whatever remains, so the component
+	always performs exactly the same sequence of run_fors as it otherwise would, merely in different
+	places.
+
+	That is safe only if the component interacts with the rest of the machine exclusively through state
+	that its owner inspects or alters after -> or flush.
+*/
+template <class T, class TimeScale = Cycles> class AsyncJustInTimeActor {
+	private:
+		typedef decltype(JustInTime::target(std::declval<T &>())) TargetPointer;
+
+	public:
+		/// Constructs the held object, forwarding @c args to its constructor; work will be handed off in periods of at least @c threshold.
+		template <typename... Args> AsyncJustInTimeActor(TimeScale threshold, Args &&... args) :
+			object_(std::forward<Args>(args)...), threshold_(threshold) {}
+
+		/// Adds @c duration to the time that has passed since the component was last run, passing it to the task queue if appropriate.
+		forceinline void operator += (const TimeScale &duration) {
+			time_since_update_ += duration;
+			if(is_asynchronous_ && time_since_update_ >= threshold_) {
+				const TimeScale period = time_since_update_.flush();
+				task_queue_.enqueue([this, period] {
+					JustInTime::target(object_)->run_for(period);
+				});
+				has_pending_work_ = true;
+				is_flushed_ = true;
+			} else {
+				is_flushed_ = false;
+			}
+		}
+
+		/// Runs the component for all time that has accumulated, then provides access to it.
+		forceinline TargetPointer operator->() {
+			flush();
+			return JustInTime::target(object_);
+		}
+
+		/// Provides access to the component without running it; it may therefore not be up to date, and may currently be running elsewhere.
+		forceinline TargetPointer last_valid() {
+			return JustInTime::target(object_);
+		}
+
+		/// Provides the object that this actor holds — for owners that need to create, replace or share the component.
+		T &object() {
+			return object_;
+		}
+
+		/// Runs the component for all time that has accumulated.
+		forceinline void flush() {
+			if(has_pending_work_) {
+				has_pending_work_ = false;
+				task_queue_.flush();
+			}
+			if(!is_flushed_) {
+				is_flushed_ = true;
+				JustInTime::target(object_)->run_for(time_since_update_.flush());
+			}
+		}
+
+		/// Sets whether the component may be run on another thread.
+		void set_is_asynchronous(bool is_asynchronous) {
+			flush();
+			is_asynchronous_ = is_asynchronous;
+		}
+
+	private:
+		T object_;
+		TimeScale time_since_update_;
+		const TimeScale threshold_;
+		bool is_flushed_ = true;
+		bool is_asynchronous_ = false;
+		bool has_pending_work_ = false;
+
+		// Declared last, so as to be destroyed first; destruction waits for any outstanding work.
+		Concurrency::AsyncTaskQueue task_queue_;
+};
+
+#endif /* JustInTime_hpp */
@@ -768,3 +768,16 @@ void WD1770::set_head_loaded(bool head_loaded) {
 	head_is_loaded_ = head_loaded;
 	if(head_loaded) posit_event(static_cast<int>(Event1770::HeadLoad));
 }
+
+void WD1770::serialise(Snapshot::Archive &archive) {
+	archive.tag(0x31373730);
+
+	Personality personality = personality_;
+	archive(personality);
+	if(personality != personality_) archive.set_invalid();
+
+	MFMController::serialise(archive);
+	archive(status_, track_, sector_, data_, command_);
+	archive(index_hole_count_, index_hole_count_target_, distance_into_section_, step_direction_);
+	archive(interesting_event_mask_, resume_point_, delay_time_, header_, head_is_loaded_);
+}
@@ -74,6 +74,12 @@ class WD1770: public Storage::Disk::MFMController {
 		};
 		inline void set_delegate(Delegate *delegate)	{	delegate_ = delegate;			}
 
+		/*!
+			Captures or restores the controller's registers, status and the point reached in executing the
+			current command. Drives are not included; see MFMController.
+		*/
+		void serialise(Snapshot::Archive &archive);
+
 	protected:
 		virtual void set_head_load_request(bool head_load);
 		virtual void set_motor_on(bool motor_on);
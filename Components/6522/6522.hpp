@@ -16,6 +16,7 @@
 #include "Implementation/6522Storage.hpp"
 
 #include "../../ClockReceiver/ClockReceiver.hpp"
+#include "../../Snapshot/Snapshot.hpp"
 
 namespace MOS {
 namespace MOS6522 {
@@ -79,15 +80,28 @@ class MOS6522Base: public MOS6522Storage {
 		/// Runs for a specified number of half cycles.
 		void run_for(const HalfCycles half_cycles);
 
-		/// Runs for a specified number of cycles.
+		/// Runs for a specified number of cycles. Time is advanced arithmetically between timer events, so
+		/// the cost is independent of the number of cycles.
 		void run_for(const Cycles cycles);
 
+		/*!
+			@returns The number of cycles that would need to be run for the VIA to reach its next sequence point,
+			i.e. the next moment at which its interrupt flags might change of their own accord, or Cycles(-1) if
+			there is no such moment pending. Owners may defer calls to @c run_for until that point, or until the
+			next register access or control line input, without affecting results.
+		*/
+		Cycles get_next_sequence_point();
+
 		/// @returns @c true if the IRQ line is currently active; @c false otherwise.
 		bool get_interrupt_line();
 
+		/// Captures or restores all of the VIA's internal state via @c archive.
+		void serialise(Snapshot::Archive &archive);
+
 	private:
 		inline void do_phase1();
 		inline void do_phase2();
+		void advance_timers(int number_of_cycles);
 		virtual void reevaluate_interrupts() = 0;
 };
 
@@ -8,6 +8,8 @@
 
 #include "../6522.hpp"
 
+#include <algorithm>
+
 using namespace MOS::MOS6522;
 
 void MOS6522Base::set_control_line_input(Port port, Line line, bool value) {
@@ -77,6 +79,15 @@ void MOS6522Base::do_phase1() {
 	}
 }
 
+void MOS6522Base::advance_timers(int number_of_cycles) {
+	// Equivalent to number_of_cycles consecutive calls to do_phase2 in which neither a reload nor
+	// a write is pending.
+	for(int c = 0; c < 2; ++c) {
+		registers_.last_timer[c] = static_cast<uint16_t>(registers_.timer[c] - number_of_cycles + 1);
+		registers_.timer[c] = static_cast<uint16_t>(registers_.timer[c] - number_of_cycles);
+	}
+}
+
 /*! Runs for a specified number of half cycles. */
 void MOS6522Base::run_for(const HalfCycles half_cycles) {
 	int number_of_half_cycles = half_cycles.as_int();
@@ -86,13 +97,9 @@ void MOS6522Base::run_for(const HalfCycles half_cycles) {
 		number_of_half_cycles--;
 	}
 
-	while(number_of_half_cycles >= 2) {
-		do_phase1();
-		do_phase2();
-		number_of_half_cycles -= 2;
-	}
+	run_for(Cycles(number_of_half_cycles >> 1));
 
-	if(number_of_half_cycles) {
+	if(number_of_half_cycles & 1) {
 		do_phase1();
 		is_phase2_ = true;
 	} else {
@@ -103,14 +110,56 @@ void MOS6522Base::run_for(const HalfCycles half_cycles) {
 /*! Runs for a specified number of cycles. */
 void MOS6522Base::run_for(const Cycles cycles) {
 	int number_of_cycles = cycles.as_int();
-	while(number_of_cycles--) {
+	while(number_of_cycles > 0) {
+		// Skip directly over those cycles in which nothing other than counting down can happen ...
+		if(number_of_cycles > 1) {
+			const int next_sequence_point = get_next_sequence_point().as_int();
+			const int quiet_cycles = (next_sequence_point < 0) ? number_of_cycles : std::min(number_of_cycles, next_sequence_point - 1);
+			if(quiet_cycles) {
+				advance_timers(quiet_cycles);
+				number_of_cycles -= quiet_cycles;
+				if(!number_of_cycles) break;
+			}
+		}
+
+		// ... and perform the one after discretely.
 		do_phase1();
 		do_phase2();
+		number_of_cycles--;
 	}
 }
 
+Cycles MOS6522Base::get_next_sequence_point() {
+	// A pending reload or timer write takes effect in the next cycle.
+	if(registers_.timer_needs_reload || registers_.next_timer[0] >= 0 || registers_.next_timer[1] >= 0) return Cycles(1);
+
+	int next_sequence_point = -1;
+	for(int c = 0; c < 2; ++c) {
+		if(!timer_is_running_[c]) continue;
+
+		// A running timer signals its interrupt in the first half of the cycle after it has counted from 0 to 0xffff;
+		// that's either this coming cycle or the one after the next such transition.
+		int cycles_until_interrupt;
+		if(registers_.timer[c] == 0xffff && !registers_.last_timer[c]) {
+			cycles_until_interrupt = 1;
+		} else {
+			cycles_until_interrupt = ((registers_.timer[c] + 1) & 0xffff) + 1;
+			if(cycles_until_interrupt == 1) cycles_until_interrupt += 0x10000;
+		}
+
+		if(next_sequence_point < 0 || cycles_until_interrupt < next_sequence_point) next_sequence_point = cycles_until_interrupt;
+	}
+
+	return Cycles(next_sequence_point);
+}
+
 /*! @returns @c true if the IRQ line is currently active; @c false otherwise. */
 bool MOS6522Base::get_interrupt_line() {
 	uint8_t interrupt_status = registers_.interrupt_flags & registers_.interrupt_enable & 0x7f;
 	return !!interrupt_status;
 }
+
+void MOS6522Base::serialise(Snapshot::Archive &archive) {
+	archive.tag(0x36353232);
+	archive(is_phase2_, registers_, control_inputs_, timer_is_running_, last_posted_interrupt_status_);
+}
@@ -13,6 +13,7 @@
 #include <cstdio>
 
 #include "../../ClockReceiver/ClockReceiver.hpp"
+#include "../../Snapshot/Snapshot.hpp"
 
 namespace MOS {
 
@@ -146,6 +147,12 @@ template <class T> class MOS6532 {
 			return interrupt_line_;
 		}
 
+		/// Captures or restores the RIOT's RAM and all of its internal state via @c archive.
+		void serialise(Snapshot::Archive &archive) {
+			archive.tag(0x36353332);
+			archive(ram_, timer_, a7_interrupt_, port_, interrupt_status_, interrupt_line_);
+		}
+
 	private:
 		uint8_t ram_[128];
 
@@ -13,15 +13,26 @@
 using namespace MOS;
 
 void Speaker::set_volume(uint8_t volume) {
-	enqueue([=]() {
-		volume_ = volume;
-	});
+	enqueue_register_write(4, volume);
 }
 
 void Speaker::set_control(int channel, uint8_t value) {
-	enqueue([=]() {
-		control_registers_[channel] = value;
-	});
+	enqueue_register_write(channel, value);
+}
+
+void Speaker::apply_register_write(int address, uint8_t value) {
+	// Addresses 0–3 are the four control registers; 4 is the volume.
+	if(address < 4) {
+		control_registers_[address] = value;
+	} else {
+		volume_ = value;
+	}
+}
+
+void Speaker::serialise(Snapshot::Archive &archive) {
+	synchronise();
+	archive.tag(0x76696373);
+	archive(counters_, shift_registers_, control_registers_, volume_);
 }
 
 // Source: VICE. Not original.
@@ -9,9 +9,12 @@
 #ifndef _560_hpp
 #define _560_hpp
 
+#include <cmath>
+
 #include "../../Outputs/CRT/CRT.hpp"
 #include "../../Outputs/Speaker.hpp"
 #include "../../ClockReceiver/ClockReceiver.hpp"
+#include "../../Snapshot/Snapshot.hpp"
 
 namespace MOS {
 
@@ -23,6 +26,9 @@ class Speaker: public ::Outputs::Filter<Speaker> {
 
 		void get_samples(unsigned int number_of_samples, int16_t *target);
 		void skip_samples(unsigned int number_of_samples);
+		void apply_register_write(int address, uint8_t value);
+
+		void serialise(Snapshot::Archive &archive);
 
 	private:
 		unsigned int counters_[4] = {2, 1, 0, 0}; 	// create a slight phase offset for the three channels
@@ -53,6 +59,12 @@ template <class T> class MOS6560 {
 					"float chroma = cos(phase + phaseOffset);"
 					"return mix(yc.x, step(yc.y, 0.75) * chroma, amplitude);"
 				"}");
+			crt_->set_software_composite_sampling_function([] (const uint8_t *sample, float x, float phase, float amplitude) {
+				const float luminance = static_cast<float>(sample[0]) / 255.0f;
+				const float chrominance = static_cast<float>(sample[1]) / 255.0f;
+				const float chroma = (chrominance <= 0.75f) ? cosf(phase + 6.283185308f * 2.0f * chrominance) : 0.0f;
+				return luminance * (1.0f - amplitude) + chroma * amplitude;
+			});
 
 			// default to NTSC
 			set_output_mode(OutputMode::NTSC);
@@ -397,6 +409,30 @@ template <class T> class MOS6560 {
 			}
 		}
 
+		/*!
+			Captures or restores all state, including the output mode, other than that of the CRT; pixels
+			in progress at the moment of restoration are not drawn.
+		*/
+		void serialise(Snapshot::Archive &archive) {
+			archive.tag(0x36353630);
+
+			OutputMode output_mode = output_mode_;
+			archive(output_mode);
+			if(archive.is_reading() && output_mode != output_mode_) set_output_mode(output_mode);
+
+			speaker_->serialise(archive);
+			archive(cycles_since_speaker_update_, registers_);
+			archive(this_state_, output_state_, cycles_in_state_);
+			archive(horizontal_counter_, vertical_counter_, full_frame_counter_);
+			archive(vertical_drawing_latch_, horizontal_drawing_latch_, rows_this_field_, columns_this_line_);
+			archive(pixel_line_cycle_, column_counter_, current_row_, current_character_row_);
+			archive(video_matrix_address_counter_, base_video_matrix_address_counter_);
+			archive(character_code_, character_colour_, character_value_);
+			archive(is_odd_frame_, is_odd_line_);
+
+			if(archive.is_reading()) pixel_pointer = nullptr;
+		}
+
 	private:
 		std::shared_ptr<Outputs::CRT::CRT> crt_;
 
@@ -9,6 +9,8 @@
 #ifndef i8255_hpp
 #define i8255_hpp
 
+#include "../../Snapshot/Snapshot.hpp"
+
 namespace Intel {
 namespace i8255 {
 
@@ -74,6 +76,15 @@ template <class T> class i8255 {
 			return 0xff;
 		}
 
+		/*!
+			Captures or restores the control register and output latches. The PortHandler is
+			not informed of restored output.
+		*/
+		void serialise(Snapshot::Archive &archive) {
+			archive.tag(0x38323535);
+			archive(control_, outputs_);
+		}
+
 	private:
 		void update_outputs() {
 			port_handler_.set_value(0, outputs_[0]);
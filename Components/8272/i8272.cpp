@@ -83,6 +83,21 @@ i8272::i8272(BusHandler &bus_handler, Cycles clock_rate) :
 	posit_event(static_cast<int>(Event8272::CommandByte));
 }
 
+void i8272::serialise(Snapshot::Archive &archive) {
+	archive.tag(0x38323732);
+	MFMController::serialise(archive);
+
+	archive(main_status_, status_, command_, result_stack_, input_, has_input_, expects_input_);
+	archive(interesting_event_mask_, resume_point_, is_access_command_, delay_time_);
+	archive(drives_, drives_seeking_);
+	archive(step_rate_time_, head_unload_time_, head_load_time_, dma_mode_, is_executing_, head_timers_running_);
+	archive(header_, distance_into_section_, index_hole_count_, index_hole_limit_);
+	archive(active_drive_, active_head_, cylinder_, head_, sector_, size_);
+	archive(is_sleeping_);
+
+	if(archive.is_reading()) update_sleep_observer();
+}
+
 bool i8272::is_sleeping() {
 	return is_sleeping_ && Storage::Disk::MFMController::is_sleeping();
 }
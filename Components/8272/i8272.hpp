@@ -41,6 +41,12 @@ class i8272: public Storage::Disk::MFMController {
 
 		bool is_sleeping();
 
+		/*!
+			Captures or restores the controller's registers, command and result buffers and the point
+			reached in executing the current command. Drives are not included; see MFMController.
+		*/
+		void serialise(Snapshot::Archive &archive);
+
 	protected:
 		virtual void select_drive(int number) = 0;
 
@@ -168,44 +168,45 @@ void AY38910::set_register_value(uint8_t value) {
 	if(selected_register_ > 15) return;
 	registers_[selected_register_] = value;
 	if(selected_register_ < 14) {
-		int selected_register = selected_register_;
-		enqueue([=] () {
-			uint8_t masked_value = value;
-			switch(selected_register) {
-				case 0: case 2: case 4:
-				case 1: case 3: case 5: {
-					int channel = selected_register >> 1;
-
-					if(selected_register & 1)
-						tone_periods_[channel] = (tone_periods_[channel] & 0xff) | static_cast<uint16_t>((value&0xf) << 8);
-					else
-						tone_periods_[channel] = (tone_periods_[channel] & ~0xff) | value;
-				}
-				break;
+		enqueue_register_write(selected_register_, value);
+	} else {
+		if(port_handler_) port_handler_->set_port_output(selected_register_ == 15, value);
+	}
+}
 
-				case 6:
-					noise_period_ = value & 0x1f;
-				break;
+void AY38910::apply_register_write(int address, uint8_t value) {
+	uint8_t masked_value = value;
+	switch(address) {
+		case 0: case 2: case 4:
+		case 1: case 3: case 5: {
+			int channel = address >> 1;
+
+			if(address & 1)
+				tone_periods_[channel] = (tone_periods_[channel] & 0xff) | static_cast<uint16_t>((value&0xf) << 8);
+			else
+				tone_periods_[channel] = (tone_periods_[channel] & ~0xff) | value;
+		}
+		break;
 
-				case 11:
-					envelope_period_ = (envelope_period_ & ~0xff) | value;
-				break;
+		case 6:
+			noise_period_ = value & 0x1f;
+		break;
 
-				case 12:
-					envelope_period_ = (envelope_period_ & 0xff) | static_cast<int>(value << 8);
-				break;
+		case 11:
+			envelope_period_ = (envelope_period_ & ~0xff) | value;
+		break;
 
-				case 13:
-					masked_value &= 0xf;
-					envelope_position_ = 0;
-				break;
-			}
-			output_registers_[selected_register] = masked_value;
-			evaluate_output_volume();
-		});
-	} else {
-		if(port_handler_) port_handler_->set_port_output(selected_register_ == 15, value);
+		case 12:
+			envelope_period_ = (envelope_period_ & 0xff) | static_cast<int>(value << 8);
+		break;
+
+		case 13:
+			masked_value &= 0xf;
+			envelope_position_ = 0;
+		break;
 	}
+	output_registers_[address] = masked_value;
+	evaluate_output_volume();
 }
 
 uint8_t AY38910::get_register_value() {
@@ -267,6 +268,19 @@ void AY38910::set_control_lines(ControlLines control_lines) {
 	update_bus();
 }
 
+// MARK: - Snapshots
+
+void AY38910::serialise(Snapshot::Archive &archive) {
+	synchronise();
+	archive.tag(0x41592d33);
+
+	archive(selected_register_, registers_, output_registers_, port_inputs_);
+	archive(master_divider_, tone_periods_, tone_counters_, tone_outputs_);
+	archive(noise_period_, noise_counter_, noise_shift_register_, noise_output_);
+	archive(envelope_period_, envelope_divider_, envelope_position_);
+	archive(control_state_, data_input_, data_output_, output_volume_);
+}
+
 void AY38910::update_bus() {
 	switch(control_state_) {
 		default: break;
@@ -10,6 +10,7 @@
 #define AY_3_8910_hpp
 
 #include "../../Outputs/Speaker.hpp"
+#include "../../Snapshot/Snapshot.hpp"
 
 namespace GI {
 namespace AY38910 {
@@ -85,8 +86,15 @@ class AY38910: public ::Outputs::Filter<AY38910> {
 		*/
 		void set_port_handler(PortHandler *);
 
+		/*!
+			Captures or restores the AY's registers, bus state and generator state. The port handler
+			is not informed of restored port output.
+		*/
+		void serialise(Snapshot::Archive &archive);
+
 		// to satisfy ::Outputs::Speaker (included via ::Outputs::Filter; not for public consumption
 		void get_samples(unsigned int number_of_samples, int16_t *target);
+		void apply_register_write(int address, uint8_t value);
 
 	private:
 		int selected_register_ = 0;
@@ -10,36 +10,9 @@
 
 using namespace Concurrency;
 
-AsyncTaskQueue::AsyncTaskQueue()
-#ifndef __APPLE__
-	: should_destruct_(false)
-#endif
-{
+AsyncTaskQueue::AsyncTaskQueue() {
 #ifdef __APPLE__
 	serial_dispatch_queue_ = dispatch_queue_create("com.thomasharte.clocksignal.asyntaskqueue", DISPATCH_QUEUE_SERIAL);
-#else
-	thread_.reset(new std::thread([this]() {
-		while(!should_destruct_) {
-			std::function<void(void)> next_function;
-
-			// Take lock, check for a new task
-			std::unique_lock<std::mutex> lock(queue_mutex_);
-			if(!pending_tasks_.empty()) {
-				next_function = pending_tasks_.front();
-				pending_tasks_.pop_front();
-			}
-
-			if(next_function) {
-				// If there is a task, release lock and perform it
-				lock.unlock();
-				next_function();
-			} else {
-				// If there isn't a task, atomically block on the processing condition and release the lock
-				// until there's something pending (and then release it again via scope)
-				processing_condition_.wait(lock);
-			}
-		}
-	}));
 #endif
 }
 
@@ -48,34 +21,70 @@ AsyncTaskQueue::~AsyncTaskQueue() {
 	dispatch_release(serial_dispatch_queue_);
 	serial_dispatch_queue_ = nullptr;
 #else
-	should_destruct_ = true;
-	enqueue([](){});
-	thread_->join();
-	thread_.reset();
+	// Allow all pending tasks to complete, and the thread pool to be finished with this queue. As in flush(),
+	// a worker performs this queue itself while it is waiting for a thread; anything it resubmits in the
+	// meantime lands in this worker's own queue, so keep going until that stops happening.
+	ThreadPool &pool = ThreadPool::shared();
+	if(pool.is_worker_thread()) {
+		while(pool.perform_if_queued(this));
+	}
+
+	std::unique_lock<std::mutex> lock(queue_mutex_);
+	idle_condition_.wait(lock, [this] { return !is_scheduled_; });
 #endif
 }
 
-void AsyncTaskQueue::enqueue(std::function<void(void)> function) {
-#ifdef __APPLE__
-	dispatch_async(serial_dispatch_queue_, ^{function();});
-#else
-	std::lock_guard<std::mutex> lock(queue_mutex_);
-	pending_tasks_.push_back(function);
-	processing_condition_.notify_all();
-#endif
+#ifndef __APPLE__
+void AsyncTaskQueue::perform() {
+	// Take everything that is pending, and perform it.
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex_);
+		performing_tasks_.swap(pending_tasks_);
+	}
+	for(auto &task: performing_tasks_) {
+		task();
+	}
+	performing_tasks_.clear();
+
+	// If more tasks have arrived in the meantime then go to the back of the line so that other
+	// queues get a turn; otherwise this queue is now idle.
+	std::unique_lock<std::mutex> lock(queue_mutex_);
+	if(pending_tasks_.empty()) {
+		is_scheduled_ = false;
+		idle_condition_.notify_all();
+	} else {
+		lock.unlock();
+		ThreadPool::shared().submit(this);
+	}
 }
+#endif
 
 void AsyncTaskQueue::flush() {
 #ifdef __APPLE__
 	dispatch_sync(serial_dispatch_queue_, ^{});
 #else
-	std::shared_ptr<std::mutex> flush_mutex(new std::mutex);
-	std::shared_ptr<std::condition_variable> flush_condition(new std::condition_variable);
-	std::unique_lock<std::mutex> lock(*flush_mutex);
-	enqueue([=] () {
-		std::unique_lock<std::mutex> inner_lock(*flush_mutex);
-		flush_condition->notify_all();
+	// This thread will wait until the flush task has run, so it can safely refer to local state.
+	std::mutex flush_mutex;
+	std::condition_variable flush_condition;
+	std::atomic<bool> has_flushed(false);
+
+	enqueue([&] {
+		std::lock_guard<std::mutex> inner_lock(flush_mutex);
+		has_flushed = true;
+		flush_condition.notify_all();
 	});
-	flush_condition->wait(lock);
+
+	// A worker mustn't just block, as the flush task might then never get a thread to run on; so if this queue
+	// is waiting for a thread, the worker performs it, which runs the flush task too. Otherwise another worker
+	// is already performing this queue, and will resubmit it to itself if need be, so blocking is safe. Nothing
+	// else is performed, as that could be any amount of unrelated work, run part way through whatever this
+	// worker is already doing.
+	ThreadPool &pool = ThreadPool::shared();
+	if(pool.is_worker_thread()) {
+		pool.perform_if_queued(this);
+	}
+
+	std::unique_lock<std::mutex> lock(flush_mutex);
+	flush_condition.wait(lock, [&] { return has_flushed.load(); });
 #endif
 }
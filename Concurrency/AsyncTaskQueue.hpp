@@ -12,12 +12,17 @@
 #include <atomic>
 #include <condition_variable>
 #include <functional>
-#include <list>
 #include <memory>
+#include <mutex>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #ifdef __APPLE__
 #include <dispatch/dispatch.h>
+#else
+#include "Task.hpp"
+#include "ThreadPool.hpp"
 #endif
 
 namespace Concurrency {
@@ -26,8 +31,16 @@ namespace Concurrency {
 	An async task queue allows a caller to enqueue void(void) functions. Those functions are guaranteed
 	to be performed serially and asynchronously from the caller. A caller may also request to flush,
 	causing it to block until all previously-enqueued functions are complete.
+
+	Queues don't have threads of their own: on Apple platforms each is a serial dispatch queue; elsewhere
+	each acts as a strand of the shared @c ThreadPool, being submitted to it whenever it has work pending.
+	So the number of threads in use depends on the number of cores, not the number of queues.
 */
-class AsyncTaskQueue {
+class AsyncTaskQueue
+#ifndef __APPLE__
+	: private ThreadPool::Job
+#endif
+{
 	public:
 		AsyncTaskQueue();
 		~AsyncTaskQueue();
@@ -39,7 +52,21 @@ class AsyncTaskQueue {
 			call from multiple threads.
 			@parameter function The function to enqueue.
 		*/
-		void enqueue(std::function<void(void)> function);
+		template <typename F> void enqueue(F &&function) {
+#ifdef __APPLE__
+			std::function<void(void)> stored_function(std::forward<F>(function));
+			dispatch_async(serial_dispatch_queue_, ^{stored_function();});
+#else
+			Task task(std::forward<F>(function));
+			std::unique_lock<std::mutex> lock(queue_mutex_);
+			pending_tasks_.push_back(std::move(task));
+			if(!is_scheduled_) {
+				is_scheduled_ = true;
+				lock.unlock();
+				ThreadPool::shared().submit(this);
+			}
+#endif
+		}
 
 		/*!
 			Blocks the caller until all previously-enqueud functions have completed.
@@ -50,12 +77,17 @@ class AsyncTaskQueue {
 #ifdef __APPLE__
 		dispatch_queue_t serial_dispatch_queue_;
 #else
-		std::unique_ptr<std::thread> thread_;
-
+		// Tasks are appended to pending_tasks_; when performed, the whole list is swapped into
+		// performing_tasks_. Both therefore retain their capacity, so that steady-state use doesn't allocate.
 		std::mutex queue_mutex_;
-		std::list<std::function<void(void)>> pending_tasks_;
-		std::condition_variable processing_condition_;
-		std::atomic_bool should_destruct_;
+		std::vector<Task> pending_tasks_;
+		std::vector<Task> performing_tasks_;
+
+		// Indicates whether this queue has been submitted to the thread pool, or is being performed by it.
+		bool is_scheduled_ = false;
+		std::condition_variable idle_condition_;
+
+		void perform() override;
 #endif
 };
 
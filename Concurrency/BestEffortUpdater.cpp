@@ -8,6 +8,7 @@
 
 #include "BestEffortUpdater.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 using namespace Concurrency;
@@ -15,6 +16,7 @@ using namespace Concurrency;
 BestEffortUpdater::BestEffortUpdater() {
 	// ATOMIC_FLAG_INIT isn't necessarily safe to use, so establish default state by other means.
 	update_is_ongoing_.clear();
+	run_as_unlimited_ = false;
 }
 
 void BestEffortUpdater::update() {
@@ -27,7 +29,22 @@ void BestEffortUpdater::update() {
 			const auto elapsed = now - previous_time_point_;
 			previous_time_point_ = now;
 
-			if(has_previous_time_point_) {
+			if(run_as_unlimited_) {
+				// Run in slices of a hundredth of a second's worth of cycles until either this update has used
+				// its share of host time or the delegate no longer wants to be unlimited.
+				if(delegate_) {
+					const int slice = std::max(static_cast<int>(clock_rate_ / 100.0), 1);
+					const auto deadline = now + std::chrono::milliseconds(10);
+					do {
+						delegate_->update(this, slice, has_skipped_);
+						has_skipped_ = false;
+					} while(run_as_unlimited_ && std::chrono::high_resolution_clock::now() < deadline);
+				}
+
+				// Time spent running unlimited shouldn't be made up for subsequently.
+				previous_time_point_ = std::chrono::high_resolution_clock::now();
+				has_previous_time_point_ = true;
+			} else if(has_previous_time_point_) {
 				// If the duration is valid, convert it to integer cycles, maintaining a rolling error and call the delegate
 				// if there is one. Proceed only if the number of cycles is positive, and cap it to the per-second maximum —
 				// it's possible this is an adjustable clock so be ready to swallow unexpected adjustments.
@@ -65,6 +82,10 @@ void BestEffortUpdater::set_delegate(Delegate *const delegate) {
 	});
 }
 
+void BestEffortUpdater::set_run_as_unlimited(const bool run_as_unlimited) {
+	run_as_unlimited_ = run_as_unlimited;
+}
+
 void BestEffortUpdater::set_clock_rate(const double clock_rate) {
 	async_task_queue_.enqueue([this, clock_rate]() {
 		this->clock_rate_ = clock_rate;
@@ -21,6 +21,8 @@ namespace Concurrency {
 	a certain number of cycles per second, that those calls are strictly serialised, and that no
 	backlog of calls accrues.
 
+	Alternatively the delegate can be run as quickly as possible, for as long as it would like to be.
+
 	No guarantees about the thread that the delegate will be called on are made.
 */
 class BestEffortUpdater {
@@ -38,6 +40,12 @@ class BestEffortUpdater {
 		/// Sets the clock rate of the delegate.
 		void set_clock_rate(double clock_rate);
 
+		/*!
+			Sets whether the delegate should be run as quickly as possible rather than at its clock rate. This
+			takes effect immediately, even if an update is ongoing, so may be called by the delegate.
+		*/
+		void set_run_as_unlimited(bool run_as_unlimited);
+
 		/*!
 			If the delegate is not currently in the process of an `update` call, calls it now to catch up to the current time.
 			The call is asynchronous; this method will return immediately.
@@ -58,6 +66,7 @@ class BestEffortUpdater {
 
 		Delegate *delegate_ = nullptr;
 		double clock_rate_ = 1.0;
+		std::atomic<bool> run_as_unlimited_;
 };
 
 }
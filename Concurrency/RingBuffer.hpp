@@ -0,0 +1,105 @@
+//
+//  RingBuffer.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 23/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#ifndef RingBuffer_hpp
+#define RingBuffer_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace Concurrency {
+
+/*!
+	A fixed-capacity queue of values that may be written by exactly one thread and read by exactly one
+	other, without either ever blocking the other: neither reads nor writes take a lock or allocate.
+
+	Writes that would exceed the capacity are truncated, and reads of more than is available return only
+	what is available; in both cases the caller is told how many values were actually transferred.
+*/
+template <typename T> class RingBuffer {
+	public:
+		/*!
+			Creates a ring buffer that can hold at least @c capacity values; the actual capacity is
+			rounded up to the next power of two.
+		*/
+		RingBuffer(std::size_t capacity) : read_pointer_(0), write_pointer_(0) {
+			std::size_t size = 1;
+			while(size < capacity) size <<= 1;
+			buffer_.resize(size);
+			mask_ = size - 1;
+		}
+
+		/*!
+			Appends up to @c count values from @c source. For use by the producer only.
+
+			@returns The number of values appended.
+		*/
+		std::size_t write(const T *source, std::size_t count) {
+			const std::size_t write_pointer = write_pointer_.load(std::memory_order_relaxed);
+			const std::size_t read_pointer = read_pointer_.load(std::memory_order_acquire);
+			count = std::min(count, buffer_.size() - (write_pointer - read_pointer));
+
+			// Copy in up to two parts: to the end of the buffer, then from its start.
+			const std::size_t start = write_pointer & mask_;
+			const std::size_t first_part = std::min(count, buffer_.size() - start);
+			std::copy(source, source + first_part, &buffer_[start]);
+			std::copy(source + first_part, source + count, buffer_.data());
+
+			write_pointer_.store(write_pointer + count, std::memory_order_release);
+			return count;
+		}
+
+		/*!
+			Removes up to @c count values, storing them to @c target. For use by the consumer only.
+
+			@returns The number of values removed.
+		*/
+		std::size_t read(T *target, std::size_t count) {
+			const std::size_t read_pointer = read_pointer_.load(std::memory_order_relaxed);
+			const std::size_t write_pointer = write_pointer_.load(std::memory_order_acquire);
+			count = std::min(count, write_pointer - read_pointer);
+
+			const std::size_t start = read_pointer & mask_;
+			const std::size_t first_part = std::min(count, buffer_.size() - start);
+			std::copy(&buffer_[start], &buffer_[start] + first_part, target);
+			std::copy(buffer_.data(), buffer_.data() + (count - first_part), target + first_part);
+
+			read_pointer_.store(read_pointer + count, std::memory_order_release);
+			return count;
+		}
+
+		/*!
+			@returns The number of values currently held. If called by either the producer or the consumer then the
+			true number may be larger or smaller, respectively, by the time this returns.
+		*/
+		std::size_t size() const {
+			return write_pointer_.load(std::memory_order_acquire) - read_pointer_.load(std::memory_order_acquire);
+		}
+
+		/*!
+			@returns The maximum number of values that may be held.
+		*/
+		std::size_t capacity() const {
+			return buffer_.size();
+		}
+
+	private:
+		std::vector<T> buffer_;
+		std::size_t mask_;
+
+		// Pointers increase without bound, being masked only upon use, so that a full buffer can be distinguished
+		// from an empty one. Each is kept on its own cache line so that the two threads don't contend.
+		alignas(64) std::atomic<std::size_t> read_pointer_;
+		alignas(64) std::atomic<std::size_t> write_pointer_;
+};
+
+}
+
+#endif /* RingBuffer_hpp */
@@ -0,0 +1,147 @@
+//
+//  Task.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 24/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#ifndef Task_hpp
+#define Task_hpp
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Concurrency {
+
+/*!
+	A Task holds a void(void) callable, much like std::function, but with enough inline storage for
+	the sort of lambdas that are typically enqueued, so that constructing one rarely allocates.
+
+	Tasks can be moved but not copied.
+*/
+class Task {
+	public:
+		/// The number of bytes of callable that will be stored without allocation.
+		static const std::size_t InlineStorageSize = 48;
+
+		Task() {}
+
+		template <typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, Task>::value>::type>
+		Task(F &&function) {
+			typedef typename std::decay<F>::type Callable;
+			construct<Callable>(std::forward<F>(function), std::integral_constant<bool,
+				sizeof(Callable) <= InlineStorageSize &&
+				std::alignment_of<Callable>::value <= std::alignment_of<Storage>::value &&
+				std::is_nothrow_move_constructible<Callable>::value>());
+		}
+
+		Task(Task &&rhs) {
+			*this = std::move(rhs);
+		}
+
+		Task &operator =(Task &&rhs) {
+			if(this != &rhs) {
+				reset();
+				if(rhs.operations_) {
+					rhs.operations_->move(&rhs.storage_, &storage_);
+					operations_ = rhs.operations_;
+					rhs.operations_ = nullptr;
+				}
+			}
+			return *this;
+		}
+
+		Task(const Task &) = delete;
+		Task &operator =(const Task &) = delete;
+
+		~Task() {
+			reset();
+		}
+
+		/// Performs the task; it is undefined behaviour to call this on an empty task.
+		void operator()() {
+			operations_->invoke(&storage_);
+		}
+
+		/// @returns @c true if this task holds a callable; @c false otherwise.
+		explicit operator bool() const {
+			return !!operations_;
+		}
+
+		/// Destroys the callable held by this task, if any.
+		void reset() {
+			if(operations_) {
+				operations_->destroy(&storage_);
+				operations_ = nullptr;
+			}
+		}
+
+	private:
+		typedef typename std::aligned_storage<InlineStorageSize>::type Storage;
+		Storage storage_;
+
+		struct Operations {
+			void (*invoke)(void *storage);
+			void (*move)(void *source, void *destination);
+			void (*destroy)(void *storage);
+		};
+		const Operations *operations_ = nullptr;
+
+		// Callables that fit are placement constructed within storage_.
+		template <typename Callable> struct InlineOperations {
+			static void invoke(void *storage) {
+				(*static_cast<Callable *>(storage))();
+			}
+			static void move(void *source, void *destination) {
+				new (destination) Callable(std::move(*static_cast<Callable *>(source)));
+				static_cast<Callable *>(source)->~Callable();
+			}
+			static void destroy(void *storage) {
+				static_cast<Callable *>(storage)->~Callable();
+			}
+			static const Operations operations;
+		};
+
+		// Those that don't are allocated, and storage_ holds a pointer to them.
+		template <typename Callable> struct AllocatedOperations {
+			static void invoke(void *storage) {
+				(**static_cast<Callable **>(storage))();
+			}
+			static void move(void *source, void *destination) {
+				*static_cast<Callable **>(destination) = *static_cast<Callable **>(source);
+			}
+			static void destroy(void *storage) {
+				delete *static_cast<Callable **>(storage);
+			}
+			static const Operations operations;
+		};
+
+		template <typename Callable, typename F> void construct(F &&function, std::true_type) {
+			new (&storage_) Callable(std::forward<F>(function));
+			operations_ = &InlineOperations<Callable>::operations;
+		}
+
+		template <typename Callable, typename F> void construct(F &&function, std::false_type) {
+			*reinterpret_cast<Callable **>(&storage_) = new Callable(std::forward<F>(function));
+			operations_ = &AllocatedOperations<Callable>::operations;
+		}
+};
+
+template <typename Callable> const Task::Operations Task::InlineOperations<Callable>::operations = {
+	&Task::InlineOperations<Callable>::invoke,
+	&Task::InlineOperations<Callable>::move,
+	&Task::InlineOperations<Callable>::destroy
+};
+
+template <typename Callable> const Task::Operations Task::AllocatedOperations<Callable>::operations = {
+	&Task::AllocatedOperations<Callable>::invoke,
+	&Task::AllocatedOperations<Callable>::move,
+	&Task::AllocatedOperations<Callable>::destroy
+};
+
+}
+
+#endif /* Task_hpp */
@@ -0,0 +1,127 @@
+//
+//  ThreadPool.cpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 24/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+using namespace Concurrency;
+
+namespace {
+
+// Records the index of the worker that the current thread is, if any.
+thread_local ThreadPool *current_pool = nullptr;
+thread_local std::size_t current_worker = 0;
+
+}
+
+ThreadPool::ThreadPool(std::size_t number_of_threads) : queued_jobs_(0), next_worker_(0) {
+	if(!number_of_threads) number_of_threads = std::thread::hardware_concurrency();
+	if(!number_of_threads) number_of_threads = 1;
+
+	// Create all workers before starting any, as they'll look at each other's queues.
+	for(std::size_t index = 0; index < number_of_threads; ++index) {
+		workers_.emplace_back(new Worker);
+	}
+	for(std::size_t index = 0; index < number_of_threads; ++index) {
+		workers_[index]->thread = std::thread([this, index] {
+			run_worker(index);
+		});
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex_);
+		should_stop_ = true;
+		sleep_condition_.notify_all();
+	}
+	for(auto &worker: workers_) {
+		worker->thread.join();
+	}
+}
+
+ThreadPool &ThreadPool::shared() {
+	static ThreadPool pool;
+	return pool;
+}
+
+std::size_t ThreadPool::get_number_of_threads() const {
+	return workers_.size();
+}
+
+bool ThreadPool::is_worker_thread() const {
+	return current_pool == this;
+}
+
+bool ThreadPool::perform_if_queued(Job *job) {
+	for(auto &worker: workers_) {
+		std::unique_lock<std::mutex> lock(worker->mutex);
+		const auto position = std::find(worker->jobs.begin(), worker->jobs.end(), job);
+		if(position == worker->jobs.end()) continue;
+
+		worker->jobs.erase(position);
+		--queued_jobs_;
+		lock.unlock();
+
+		job->perform();
+		return true;
+	}
+	return false;
+}
+
+void ThreadPool::submit(Job *job) {
+	const std::size_t index = (current_pool == this) ? current_worker : (next_worker_++ % workers_.size());
+	++queued_jobs_;
+	{
+		std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+		workers_[index]->jobs.push_back(job);
+	}
+
+	// Taking the sleep lock guarantees that any worker that saw no queued jobs is now waiting, and will be woken.
+	std::lock_guard<std::mutex> lock(sleep_mutex_);
+	sleep_condition_.notify_one();
+}
+
+ThreadPool::Job *ThreadPool::take_job(std::size_t index) {
+	// Take from the front of this worker's own queue if possible; otherwise from the back of anybody else's.
+	for(std::size_t offset = 0; offset < workers_.size(); ++offset) {
+		Worker &worker = *workers_[(index + offset) % workers_.size()];
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		if(worker.jobs.empty()) continue;
+
+		Job *job;
+		if(!offset) {
+			job = worker.jobs.front();
+			worker.jobs.pop_front();
+		} else {
+			job = worker.jobs.back();
+			worker.jobs.pop_back();
+		}
+		--queued_jobs_;
+		return job;
+	}
+	return nullptr;
+}
+
+void ThreadPool::run_worker(std::size_t index) {
+	current_pool = this;
+	current_worker = index;
+
+	while(true) {
+		Job *const job = take_job(index);
+		if(job) {
+			job->perform();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleep_mutex_);
+		if(should_stop_) break;
+		if(!queued_jobs_) sleep_condition_.wait(lock);
+	}
+}
@@ -0,0 +1,88 @@
+//
+//  ThreadPool.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 24/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#ifndef ThreadPool_hpp
+#define ThreadPool_hpp
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Concurrency {
+
+/*!
+	A thread pool owns a fixed number of worker threads, by default one per core, and performs jobs
+	submitted to it on those threads.
+
+	Each worker has its own queue of jobs; a worker that submits a job adds it to its own queue, other
+	threads distribute jobs between the queues in turn. A worker with nothing left in its own queue
+	steals from the others before going to sleep.
+
+	Jobs are not owned by the pool; the submitter must ensure that a job outlives its performance.
+*/
+class ThreadPool {
+	public:
+		/// A job is anything that can be performed by a worker.
+		struct Job {
+			virtual void perform() = 0;
+		};
+
+		/*!
+			Creates a thread pool with @c number_of_threads workers, or one per core if that is zero.
+		*/
+		ThreadPool(std::size_t number_of_threads = 0);
+		~ThreadPool();
+
+		/// @returns A pool shared by the whole process, which is created upon first request.
+		static ThreadPool &shared();
+
+		/// Queues @c job to be performed by one of the workers.
+		void submit(Job *job);
+
+		/// @returns The number of worker threads.
+		std::size_t get_number_of_threads() const;
+
+		/// @returns @c true if the caller is one of this pool's workers; @c false otherwise.
+		bool is_worker_thread() const;
+
+		/*!
+			Performs @c job on the calling thread if it is queued but not yet taken by a worker. A worker that would
+			otherwise block waiting for @c job to finish should use this to ensure that it makes progress; no other
+			job is performed in the meantime.
+
+			@returns @c true if @c job was performed; @c false otherwise.
+		*/
+		bool perform_if_queued(Job *job);
+
+	private:
+		struct Worker {
+			std::mutex mutex;
+			std::deque<Job *> jobs;
+			std::thread thread;
+		};
+		std::vector<std::unique_ptr<Worker>> workers_;
+
+		// Counts jobs queued but not yet taken, so that workers can go to sleep when there are none.
+		std::atomic<std::size_t> queued_jobs_;
+		std::atomic<std::size_t> next_worker_;
+
+		std::mutex sleep_mutex_;
+		std::condition_variable sleep_condition_;
+		bool should_stop_ = false;
+
+		void run_worker(std::size_t index);
+		Job *take_job(std::size_t index);
+};
+
+}
+
+#endif /* ThreadPool_hpp */
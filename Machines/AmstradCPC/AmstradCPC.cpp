@@ -18,11 +18,13 @@
 #include "../../Components/AY38910/AY38910.hpp"
 
 #include "../Utility/MemoryFuzzer.hpp"
+#include "../Utility/MemoryMap.hpp"
 #include "../Utility/Typer.hpp"
 
 #include "../../Storage/Tape/Tape.hpp"
 
 #include "../../ClockReceiver/ForceInline.hpp"
+#include "../../ClockReceiver/JustInTime.hpp"
 
 #include <cstdint>
 #include <vector>
@@ -100,6 +102,11 @@ class InterruptTimer {
 			interrupt_request_ = false;
 		}
 
+		/// Captures or restores the timer's count and request state.
+		void serialise(Snapshot::Archive &archive) {
+			archive(reset_counter_, interrupt_request_, last_interrupt_request_, timer_);
+		}
+
 	private:
 		int reset_counter_ = 0;
 		bool interrupt_request_ = false;
@@ -108,52 +115,10 @@ class InterruptTimer {
 };
 
 /*!
-	Provides a holder for an AY-3-8910 and its current cycles-since-updated count.
-	Therefore acts both to store an AY and to bookkeep this emulator's idiomatic
-	deferred clocking for this component.
+	Holds an AY-3-8910 and the time since it was last updated. The CPC's AY is clocked at 1Mhz, i.e. once for
+	every eight half-cycles that pass on the bus.
 */
-class AYDeferrer {
-	public:
-		/// Constructs a new AY instance and sets its clock rate.
-		inline void setup_output() {
-			ay_.reset(new GI::AY38910::AY38910);
-			ay_->set_input_rate(1000000);
-		}
-
-		/// Destructs the AY.
-		inline void close_output() {
-			ay_.reset();
-		}
-
-		/// Adds @c half_cycles half cycles to the amount of time that has passed.
-		inline void run_for(HalfCycles half_cycles) {
-			cycles_since_update_ += half_cycles;
-		}
-
-		/// Enqueues an update-to-now into the AY's deferred queue.
-		inline void update() {
-			ay_->run_for(cycles_since_update_.divide_cycles(Cycles(4)));
-		}
-
-		/// Issues a request to the AY to perform all processing up to the current time.
-		inline void flush() {
-			ay_->flush();
-		}
-
-		/// @returns the speaker the AY is using for output.
-		std::shared_ptr<Outputs::Speaker> get_speaker() {
-			return ay_;
-		}
-
-		/// @returns the AY itself.
-		GI::AY38910::AY38910 *ay() {
-			return ay_.get();
-		}
-
-	private:
-		std::shared_ptr<GI::AY38910::AY38910> ay_;
-		HalfCycles cycles_since_update_;
-};
+typedef JustInTimeActor<std::shared_ptr<GI::AY38910::AY38910>, HalfCycles, 4, Cycles> AYDeferrer;
 
 /*!
 	Provides the mechanism of receipt for the CRTC outputs. In practice has the gate array's
@@ -309,6 +274,11 @@ class CRTCBusHandler {
 					"uint sample = texture(texID, coordinate).r;"
 					"return vec3(float((sample >> 4) & 3u), float((sample >> 2) & 3u), float(sample & 3u)) / 2.0;"
 				"}");
+			crt_->set_software_rgb_sampling_function([] (const uint8_t *sample, float x, float *rgb) {
+				rgb[0] = static_cast<float>((sample[0] >> 4) & 3) / 2.0f;
+				rgb[1] = static_cast<float>((sample[0] >> 2) & 3) / 2.0f;
+				rgb[2] = static_cast<float>(sample[0] & 3) / 2.0f;
+			});
 			crt_->set_visible_area(Outputs::CRT::Rect(0.075f, 0.05f, 0.9f, 0.9f));
 			crt_->set_output_device(Outputs::CRT::OutputDevice::Monitor);
 		}
@@ -352,6 +322,20 @@ class CRTCBusHandler {
 			}
 		}
 
+		/*!
+			Captures or restores the gate array's video state: mode, palette and sync tracking. Pixels
+			not yet passed to the CRT are discarded upon restore.
+		*/
+		void serialise(Snapshot::Archive &archive) {
+			archive.tag(0x67617465);
+			archive(cycles_, was_enabled_, was_sync_, was_hsync_, was_vsync_, cycles_into_hsync_);
+			archive(next_mode_, mode_, pixel_divider_, pen_, palette_, border_);
+			if(archive.is_reading()) {
+				pixel_pointer_ = pixel_data_ = nullptr;
+				build_mode_table();
+			}
+		}
+
 	private:
 		void output_border(unsigned int length) {
 			uint8_t *colour_pointer = static_cast<uint8_t *>(crt_->allocate_write_area(1));
@@ -568,6 +552,11 @@ class KeyboardState: public GI::AY38910::PortHandler {
 			memset(rows_, 0xff, 10);
 		}
 
+		/// Captures or restores the state of all keys and the selected row.
+		void serialise(Snapshot::Archive &archive) {
+			archive(rows_, row_);
+		}
+
 	private:
 		uint8_t rows_[10];
 		int row_;
@@ -600,6 +589,12 @@ class FDC: public Intel::i8272::i8272 {
 		void set_disk(std::shared_ptr<Storage::Disk::Disk> disk, int drive) {
 			drive_->set_disk(disk);
 		}
+
+		/// Extends i8272::serialise with the state of the single drive.
+		void serialise(Snapshot::Archive &archive) {
+			i8272::serialise(archive);
+			drive_->serialise(archive);
+		}
 };
 
 /*!
@@ -622,8 +617,7 @@ class i8255PortHandler : public Intel::i8255::PortHandler {
 			switch(port) {
 				case 0:
 					// Port A is connected to the AY's data bus.
-					ay_.update();
-					ay_.ay()->set_data_input(value);
+					ay_->set_data_input(value);
 				break;
 				case 1:
 					// Port B is an input only. So output goes nowehere.
@@ -639,7 +633,7 @@ class i8255PortHandler : public Intel::i8255::PortHandler {
 					tape_player_.set_tape_output((value & 0x20) ? true : false);
 
 					// Bits 6 and 7 set BDIR and BC1 for the AY.
-					ay_.ay()->set_control_lines(
+					ay_.last_valid()->set_control_lines(
 						(GI::AY38910::ControlLines)(
 							((value & 0x80) ? GI::AY38910::BDIR : 0) |
 							((value & 0x40) ? GI::AY38910::BC1 : 0) |
@@ -652,7 +646,7 @@ class i8255PortHandler : public Intel::i8255::PortHandler {
 		/// The i8255 will call this to obtain a new input for @c port.
 		uint8_t get_value(int port) {
 			switch(port) {
-				case 0: return ay_.ay()->get_data_output();	// Port A is wired to the AY
+				case 0: return ay_.last_valid()->get_data_output();	// Port A is wired to the AY
 				case 1:	return
 					(crtc_.get_bus_state().vsync ? 0x01 : 0x00) |	// Bit 0 returns CRTC vsync.
 					(tape_player_.get_input() ? 0x80 : 0x00) |		// Bit 7 returns cassette input.
@@ -728,7 +722,7 @@ class ConcreteMachine:
 			if(!tape_player_is_sleeping_) tape_player_.run_for(cycle.length.as_int());
 
 			// Pump the AY
-			ay_.run_for(cycle.length);
+			ay_ += cycle.length;
 
 			// Clock the FDC, if connected, using a lazy scale by two
 			if(has_fdc_ && !fdc_is_sleeping_) fdc_.run_for(Cycles(cycle.length.as_int()));
@@ -743,11 +737,11 @@ class ConcreteMachine:
 			switch(cycle.operation) {
 				case CPU::Z80::PartialMachineCycle::ReadOpcode:
 				case CPU::Z80::PartialMachineCycle::Read:
-					*cycle.value = read_pointers_[address >> 14][address & 16383];
+					*cycle.value = memory_map_.read(address);
 				break;
 
 				case CPU::Z80::PartialMachineCycle::Write:
-					write_pointers_[address >> 14][address & 16383] = *cycle.value;
+					memory_map_.write(address, *cycle.value);
 				break;
 
 				case CPU::Z80::PartialMachineCycle::Output:
@@ -759,7 +753,7 @@ class ConcreteMachine:
 					// Check for an upper ROM selection
 					if(has_fdc_ && !(address&0x2000)) {
 						upper_rom_ = (*cycle.value == 7) ? ROMType::AMSDOS : rom_model_ + 1;
-						if(upper_rom_is_paged_) read_pointers_[3] = roms_[upper_rom_].data();
+						if(upper_rom_is_paged_) update_memory_map();
 					}
 
 					// Check for a CRTC access
@@ -838,21 +832,21 @@ class ConcreteMachine:
 		/// Another Z80 entry point; indicates that a partcular run request has concluded.
 		void flush() {
 			// Just flush the AY.
-			ay_.update();
-			ay_.flush();
+			ay_->flush();
 		}
 
 		/// A CRTMachine function; indicates that outputs should be created now.
 		void setup_output(float aspect_ratio) override final {
 			crtc_bus_handler_.setup_output(aspect_ratio);
-			ay_.setup_output();
-			ay_.ay()->set_port_handler(&key_state_);
+			ay_.object().reset(new GI::AY38910::AY38910);
+			ay_->set_input_rate(1000000);
+			ay_->set_port_handler(&key_state_);
 		}
 
 		/// A CRTMachine function; indicates that outputs should be destroyed now.
 		void close_output() override final {
 			crtc_bus_handler_.close_output();
-			ay_.close_output();
+			ay_.object().reset();
 		}
 
 		/// @returns the CRT in use.
@@ -862,7 +856,7 @@ class ConcreteMachine:
 
 		/// @returns the speaker in use.
 		std::shared_ptr<Outputs::Speaker> get_speaker() override final {
-			return ay_.get_speaker();
+			return ay_.object();
 		}
 
 		/// Wires virtual-dispatched CRTMachine run_for requests to the static Z80 method.
@@ -891,18 +885,10 @@ class ConcreteMachine:
 			}
 
 			// Establish default memory map
-			upper_rom_is_paged_ = true;
+			lower_rom_is_paged_ = upper_rom_is_paged_ = true;
 			upper_rom_ = rom_model_ + 1;
-
-			write_pointers_[0] = &ram_[0];
-			write_pointers_[1] = &ram_[16384];
-			write_pointers_[2] = &ram_[32768];
-			write_pointers_[3] = &ram_[49152];
-
-			read_pointers_[0] = roms_[rom_model_].data();
-			read_pointers_[1] = write_pointers_[1];
-			read_pointers_[2] = write_pointers_[2];
-			read_pointers_[3] = roms_[upper_rom_].data();
+			for(int c = 0; c < 4; ++c) ram_banks_[c] = static_cast<uint8_t>(c);
+			update_memory_map();
 
 			// Type whatever is required.
 			if(target.loadingCommand.length()) {
@@ -953,6 +939,7 @@ class ConcreteMachine:
 		void set_component_is_sleeping(void *component, bool is_sleeping) override final {
 			fdc_is_sleeping_ = fdc_.is_sleeping();
 			tape_player_is_sleeping_ = tape_player_.is_sleeping();
+			update_clock_is_unlimited();
 		}
 
 // MARK: - Keyboard
@@ -984,17 +971,75 @@ class ConcreteMachine:
 			return keyboard_mapper_;
 		}
 
+	protected:
+		// to satisfy SnapshotMachine::Machine
+		void serialise(Snapshot::Archive &archive) override {
+			archive.tag(0x43504320);
+
+			// The model is set by configuration, so it is checked rather than restored.
+			int rom_model = rom_model_;
+			archive(rom_model);
+			if(rom_model != rom_model_) {
+				archive.set_invalid();
+				return;
+			}
+
+			z80_.serialise(archive);
+			archive(ram_, clock_offset_, crtc_counter_);
+			crtc_bus_handler_.serialise(archive);
+			crtc_.serialise(archive);
+			ay_.last_valid()->serialise(archive);
+			ay_.serialise_backlog(archive);
+			i8255_.serialise(archive);
+			fdc_.serialise(archive);
+			interrupt_timer_.serialise(archive);
+			tape_player_.serialise(archive);
+			key_state_.serialise(archive);
+
+			// Paging is recorded as the RAM bank visible in each slot, plus whether each ROM is paged in.
+			archive(ram_banks_, lower_rom_is_paged_, upper_rom_is_paged_, upper_rom_);
+			if(archive.is_reading()) {
+				if(upper_rom_ < 0 || upper_rom_ >= 7) {
+					archive.set_invalid();
+					upper_rom_ = rom_model_ + 1;
+				}
+				for(auto &bank: ram_banks_) bank &= 7;
+				update_memory_map();
+
+				fdc_is_sleeping_ = fdc_.is_sleeping();
+				tape_player_is_sleeping_ = tape_player_.is_sleeping();
+				update_clock_is_unlimited();
+			}
+		}
+
 	private:
+		// The machine may be run as quickly as possible while the tape is playing or a disk drive is in use.
+		void update_clock_is_unlimited() {
+			set_clock_is_unlimited(!tape_player_is_sleeping_ || (has_fdc_ && !fdc_is_sleeping_));
+		}
+
+		/*!
+			Maps the RAM bank selected for each 16kb slot for writing, and for reading unless a ROM is paged over it.
+		*/
+		void update_memory_map() {
+			for(int c = 0; c < 4; ++c) {
+				uint8_t *const bank = &ram_[ram_banks_[c] * 16384];
+				memory_map_.map_write(bank, static_cast<uint16_t>(c * 16384), 16384);
+				memory_map_.map_read(bank, static_cast<uint16_t>(c * 16384), 16384);
+			}
+			if(lower_rom_is_paged_) memory_map_.map_read(roms_[rom_model_].data(), 0x0000, 16384);
+			if(upper_rom_is_paged_) memory_map_.map_read(roms_[upper_rom_].data(), 0xc000, 16384);
+		}
+
 		inline void write_to_gate_array(uint8_t value) {
 			switch(value >> 6) {
 				case 0: crtc_bus_handler_.select_pen(value & 0x1f);		break;
 				case 1: crtc_bus_handler_.set_colour(value & 0x1f);		break;
 				case 2:
 					// Perform ROM paging.
-					read_pointers_[0] = (value & 4) ? write_pointers_[0] : roms_[rom_model_].data();
-
+					lower_rom_is_paged_ = !(value & 4);
 					upper_rom_is_paged_ = !(value & 8);
-					read_pointers_[3] = upper_rom_is_paged_ ? roms_[upper_rom_].data() : write_pointers_[3];
+					update_memory_map();
 
 					// Reset the interrupt timer if requested.
 					if(value & 0x10) interrupt_timer_.reset_count();
@@ -1005,10 +1050,7 @@ class ConcreteMachine:
 				case 3:
 					// Perform RAM paging, if 128kb is permitted.
 					if(has_128k_) {
-						bool adjust_low_read_pointer = read_pointers_[0] == write_pointers_[0];
-						bool adjust_high_read_pointer = read_pointers_[3] == write_pointers_[3];
-#define RAM_BANK(x) &ram_[x * 16384]
-#define RAM_CONFIG(a, b, c, d) write_pointers_[0] = RAM_BANK(a); write_pointers_[1] = RAM_BANK(b); write_pointers_[2] = RAM_BANK(c); write_pointers_[3] = RAM_BANK(d);
+#define RAM_CONFIG(a, b, c, d) ram_banks_[0] = a; ram_banks_[1] = b; ram_banks_[2] = c; ram_banks_[3] = d;
 						switch(value & 7) {
 							case 0:	RAM_CONFIG(0, 1, 2, 3);	break;
 							case 1:	RAM_CONFIG(0, 1, 2, 7);	break;
@@ -1020,11 +1062,7 @@ class ConcreteMachine:
 							case 7:	RAM_CONFIG(0, 7, 2, 3);	break;
 						}
 #undef RAM_CONFIG
-#undef RAM_BANK
-						if(adjust_low_read_pointer) read_pointers_[0] = write_pointers_[0];
-						read_pointers_[1] = write_pointers_[1];
-						read_pointers_[2] = write_pointers_[2];
-						if(adjust_high_read_pointer) read_pointers_[3] = write_pointers_[3];
+						update_memory_map();
 					}
 				break;
 			}
@@ -1055,12 +1093,12 @@ class ConcreteMachine:
 		bool has_fdc_, fdc_is_sleeping_;
 		bool tape_player_is_sleeping_;
 		bool has_128k_;
+		bool lower_rom_is_paged_;
 		bool upper_rom_is_paged_;
 		int upper_rom_;
 
-		uint8_t *ram_pages_[4];
-		uint8_t *read_pointers_[4];
-		uint8_t *write_pointers_[4];
+		uint8_t ram_banks_[4];		// The RAM bank visible in each 16kb slot.
+		Memory::MemoryMap<14> memory_map_;
 
 		KeyboardState key_state_;
 		AmstradCPC::KeyboardMapper keyboard_mapper_;
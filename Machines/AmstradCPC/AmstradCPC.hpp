@@ -12,6 +12,7 @@
 #include "../ConfigurationTarget.hpp"
 #include "../CRTMachine.hpp"
 #include "../KeyboardMachine.hpp"
+#include "../SnapshotMachine.hpp"
 
 namespace AmstradCPC {
 
@@ -21,7 +22,8 @@ namespace AmstradCPC {
 class Machine:
 	public CRTMachine::Machine,
 	public ConfigurationTarget::Machine,
-	public KeyboardMachine::Machine {
+	public KeyboardMachine::Machine,
+	public SnapshotMachine::Machine {
 	public:
 		virtual ~Machine();
 
@@ -38,10 +38,10 @@ class Joystick: public Inputs::Joystick {
 
 		void set_digital_input(DigitalInput digital_input, bool is_active) {
 			switch(digital_input) {
-				case DigitalInput::Up:		bus_->mos6532_.update_port_input(0, 0x10 >> shift_, is_active);		break;
-				case DigitalInput::Down:	bus_->mos6532_.update_port_input(0, 0x20 >> shift_, is_active);		break;
-				case DigitalInput::Left:	bus_->mos6532_.update_port_input(0, 0x40 >> shift_, is_active);		break;
-				case DigitalInput::Right:	bus_->mos6532_.update_port_input(0, 0x80 >> shift_, is_active);		break;
+				case DigitalInput::Up:		bus_->mos6532_.last_valid()->update_port_input(0, 0x10 >> shift_, is_active);		break;
+				case DigitalInput::Down:	bus_->mos6532_.last_valid()->update_port_input(0, 0x20 >> shift_, is_active);		break;
+				case DigitalInput::Left:	bus_->mos6532_.last_valid()->update_port_input(0, 0x40 >> shift_, is_active);		break;
+				case DigitalInput::Right:	bus_->mos6532_.last_valid()->update_port_input(0, 0x80 >> shift_, is_active);		break;
 
 				// TODO: latching
 				case DigitalInput::Fire:
@@ -122,11 +122,11 @@ class ConcreteMachine:
 
 		void set_switch_is_enabled(Atari2600Switch input, bool state) override {
 			switch(input) {
-				case Atari2600SwitchReset:					bus_->mos6532_.update_port_input(1, 0x01, state);	break;
-				case Atari2600SwitchSelect:					bus_->mos6532_.update_port_input(1, 0x02, state);	break;
-				case Atari2600SwitchColour:					bus_->mos6532_.update_port_input(1, 0x08, state);	break;
-				case Atari2600SwitchLeftPlayerDifficulty:	bus_->mos6532_.update_port_input(1, 0x40, state);	break;
-				case Atari2600SwitchRightPlayerDifficulty:	bus_->mos6532_.update_port_input(1, 0x80, state);	break;
+				case Atari2600SwitchReset:					bus_->mos6532_.last_valid()->update_port_input(1, 0x01, state);	break;
+				case Atari2600SwitchSelect:					bus_->mos6532_.last_valid()->update_port_input(1, 0x02, state);	break;
+				case Atari2600SwitchColour:					bus_->mos6532_.last_valid()->update_port_input(1, 0x08, state);	break;
+				case Atari2600SwitchLeftPlayerDifficulty:	bus_->mos6532_.last_valid()->update_port_input(1, 0x40, state);	break;
+				case Atari2600SwitchRightPlayerDifficulty:	bus_->mos6532_.last_valid()->update_port_input(1, 0x80, state);	break;
 			}
 		}
 
@@ -136,10 +136,10 @@ class ConcreteMachine:
 
 		// to satisfy CRTMachine::Machine
 		void setup_output(float aspect_ratio) override {
-			bus_->tia_.reset(new TIA);
-			bus_->speaker_.reset(new Speaker);
+			bus_->tia_.object().reset(new TIA);
+			bus_->speaker_.object().reset(new Speaker);
 			bus_->speaker_->set_input_rate(static_cast<float>(get_clock_rate() / static_cast<double>(CPUTicksPerAudioTick)));
-			bus_->tia_->get_crt()->set_delegate(this);
+			bus_->tia_.last_valid()->get_crt()->set_delegate(this);
 		}
 
 		void close_output() override {
@@ -147,11 +147,11 @@ class ConcreteMachine:
 		}
 
 		std::shared_ptr<Outputs::CRT::CRT> get_crt() override {
-			return bus_->tia_->get_crt();
+			return bus_->tia_.last_valid()->get_crt();
 		}
 
 		std::shared_ptr<Outputs::Speaker> get_speaker() override {
-			return bus_->speaker_;
+			return bus_->speaker_.object();
 		}
 
 		void run_for(const Cycles cycles) override {
@@ -178,25 +178,48 @@ class ConcreteMachine:
 						frame_records_[c].number_of_frames = 0;
 						frame_records_[c].number_of_unexpected_vertical_syncs = 0;
 					}
-					is_ntsc_ ^= true;
+					set_is_ntsc(!is_ntsc_);
+				}
+			}
+		}
 
-					double clock_rate;
-					if(is_ntsc_) {
-						clock_rate = NTSC_clock_rate;
-						bus_->tia_->set_output_mode(TIA::OutputMode::NTSC);
-					} else {
-						clock_rate = PAL_clock_rate;
-						bus_->tia_->set_output_mode(TIA::OutputMode::PAL);
-					}
+	protected:
+		// to satisfy SnapshotMachine::Machine
+		void serialise(Snapshot::Archive &archive) override {
+			archive.tag(0x32363030);
 
-					bus_->speaker_->set_input_rate(static_cast<float>(clock_rate / static_cast<double>(CPUTicksPerAudioTick)));
-					bus_->speaker_->set_high_frequency_cut_off(static_cast<float>(clock_rate / (static_cast<double>(CPUTicksPerAudioTick) * 2.0)));
-					set_clock_rate(clock_rate);
-				}
+			bool is_ntsc = is_ntsc_;
+			archive(is_ntsc);
+			if(archive.is_reading() && is_ntsc != is_ntsc_) set_is_ntsc(is_ntsc);
+
+			// Frame records are kept in step with the CRT, which isn't captured; so when restoring, detection
+			// of the video standard begins again, as it does for the CRT.
+			if(archive.is_reading()) {
+				for(auto &record: frame_records_) record = FrameRecord();
+				frame_record_pointer_ = 0;
 			}
+
+			bus_->serialise(archive);
 		}
 
 	private:
+		void set_is_ntsc(bool is_ntsc) {
+			is_ntsc_ = is_ntsc;
+
+			double clock_rate;
+			if(is_ntsc_) {
+				clock_rate = NTSC_clock_rate;
+				bus_->tia_->set_output_mode(TIA::OutputMode::NTSC);
+			} else {
+				clock_rate = PAL_clock_rate;
+				bus_->tia_->set_output_mode(TIA::OutputMode::PAL);
+			}
+
+			bus_->speaker_->set_input_rate(static_cast<float>(clock_rate / static_cast<double>(CPUTicksPerAudioTick)));
+			bus_->speaker_->set_high_frequency_cut_off(static_cast<float>(clock_rate / (static_cast<double>(CPUTicksPerAudioTick) * 2.0)));
+			set_clock_rate(clock_rate);
+		}
+
 		// the bus
 		std::unique_ptr<Bus> bus_;
 
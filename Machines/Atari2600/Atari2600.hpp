@@ -12,6 +12,7 @@
 #include "../ConfigurationTarget.hpp"
 #include "../CRTMachine.hpp"
 #include "../JoystickMachine.hpp"
+#include "../SnapshotMachine.hpp"
 
 #include "Atari2600Inputs.h"
 
@@ -23,7 +24,8 @@ namespace Atari2600 {
 class Machine:
 	public CRTMachine::Machine,
 	public ConfigurationTarget::Machine,
-	public JoystickMachine::Machine {
+	public JoystickMachine::Machine,
+	public SnapshotMachine::Machine {
 	public:
 		virtual ~Machine();
 
@@ -15,43 +15,38 @@
 #include "TIA.hpp"
 
 #include "../../ClockReceiver/ClockReceiver.hpp"
+#include "../../ClockReceiver/JustInTime.hpp"
 
 namespace Atari2600 {
 
 class Bus {
 	public:
 		Bus() :
-			tia_input_value_{0xff, 0xff},
-			cycles_since_speaker_update_(0) {}
+			tia_input_value_{0xff, 0xff} {}
 
 		virtual void run_for(const Cycles cycles) = 0;
 		virtual void set_reset_line(bool state) = 0;
 
-		// the RIOT, TIA and speaker
-		PIA mos6532_;
-		std::shared_ptr<TIA> tia_;
-		std::shared_ptr<Speaker> speaker_;
+		// the RIOT, TIA and speaker, each run only upon access
+		JustInTimeActor<PIA> mos6532_;
+		JustInTimeActor<std::shared_ptr<TIA>> tia_;
+		JustInTimeActor<std::shared_ptr<Speaker>, Cycles, CPUTicksPerAudioTick * 3> speaker_;
 
 		// joystick state
 		uint8_t tia_input_value_[2];
 
-	protected:
-		// speaker backlog accumlation counter
-		Cycles cycles_since_speaker_update_;
-		inline void update_audio() {
-			speaker_->run_for(cycles_since_speaker_update_.divide(Cycles(CPUTicksPerAudioTick * 3)));
-		}
-
-		// video backlog accumulation counter
-		Cycles cycles_since_video_update_;
-		inline void update_video() {
-			tia_->run_for(cycles_since_video_update_.flush());
-		}
-
-		// RIOT backlog accumulation counter
-		Cycles cycles_since_6532_update_;
-		inline void update_6532() {
-			mos6532_.run_for(cycles_since_6532_update_.flush());
+		/*!
+			Captures or restores the RIOT, TIA and speaker, and the backlogs of each. Subclasses should
+			extend this with the processor and any cartridge state.
+		*/
+		virtual void serialise(Snapshot::Archive &archive) {
+			mos6532_.last_valid()->serialise(archive);
+			tia_.last_valid()->serialise(archive);
+			speaker_.last_valid()->serialise(archive);
+			archive(tia_input_value_);
+			speaker_.serialise_backlog(archive);
+			tia_.serialise_backlog(archive);
+			mos6532_.serialise_backlog(archive);
 		}
 };
 
@@ -40,6 +40,11 @@ class ActivisionStack: public BusExtender {
 			if(operation == CPU::MOS6502::BusOperation::ReadOpcode) last_opcode_ = *value;
 		}
 
+		void serialise(Snapshot::Archive &archive) {
+			serialise_pointer(archive, rom_ptr_, rom_base_, rom_size_);
+			archive(last_opcode_);
+		}
+
 	private:
 		uint8_t *rom_ptr_;
 		uint8_t last_opcode_;
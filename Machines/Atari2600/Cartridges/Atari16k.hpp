@@ -31,6 +31,10 @@ class Atari16k: public BusExtender {
 			}
 		}
 
+		void serialise(Snapshot::Archive &archive) {
+			serialise_pointer(archive, rom_ptr_, rom_base_, rom_size_);
+		}
+
 	private:
 		uint8_t *rom_ptr_;
 };
@@ -55,6 +59,11 @@ class Atari16kSuperChip: public BusExtender {
 			else if(address < 0x1100 && isReadOperation(operation)) *value = ram_[address & 0x7f];
 		}
 
+		void serialise(Snapshot::Archive &archive) {
+			serialise_pointer(archive, rom_ptr_, rom_base_, rom_size_);
+			archive(ram_);
+		}
+
 	private:
 		uint8_t *rom_ptr_;
 		uint8_t ram_[128];
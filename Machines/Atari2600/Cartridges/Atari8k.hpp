@@ -30,6 +30,10 @@ class Atari8k: public BusExtender {
 			}
 		}
 
+		void serialise(Snapshot::Archive &archive) {
+			serialise_pointer(archive, rom_ptr_, rom_base_, rom_size_);
+		}
+
 	private:
 		uint8_t *rom_ptr_;
 };
@@ -53,6 +57,11 @@ class Atari8kSuperChip: public BusExtender {
 			else if(address < 0x1100 && isReadOperation(operation)) *value = ram_[address & 0x7f];
 		}
 
+		void serialise(Snapshot::Archive &archive) {
+			serialise_pointer(archive, rom_ptr_, rom_base_, rom_size_);
+			archive(ram_);
+		}
+
 	private:
 		uint8_t *rom_ptr_;
 		uint8_t ram_[128];
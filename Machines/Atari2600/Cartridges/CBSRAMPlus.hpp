@@ -32,6 +32,11 @@ class CBSRAMPlus: public BusExtender {
 			else if(address < 0x1200 && isReadOperation(operation)) *value = ram_[address & 0xff];
 		}
 
+		void serialise(Snapshot::Archive &archive) {
+			serialise_pointer(archive, rom_ptr_, rom_base_, rom_size_);
+			archive(ram_);
+		}
+
 	private:
 		uint8_t *rom_ptr_;
 		uint8_t ram_[256];
@@ -21,9 +21,30 @@ class BusExtender: public CPU::MOS6502::BusHandler {
 
 		void advance_cycles(int cycles) {}
 
+		/// Captures or restores any paging state and cartridge RAM. Extenders with either should supply their own.
+		void serialise(Snapshot::Archive &archive) {}
+
 	protected:
 		uint8_t *rom_base_;
 		std::size_t rom_size_;
+
+		/*!
+			Captures or restores @c pointer, which should be either @c nullptr or a pointer into the @c size
+			bytes at @c base, as an offset.
+		*/
+		static void serialise_pointer(Snapshot::Archive &archive, uint8_t *&pointer, uint8_t *base, std::size_t size) {
+			uint32_t offset = pointer ? static_cast<uint32_t>(pointer - base) : 0xffffffff;
+			archive(offset);
+			if(!archive.is_reading()) return;
+
+			if(offset == 0xffffffff) {
+				pointer = nullptr;
+			} else if(offset < size) {
+				pointer = base + offset;
+			} else {
+				archive.set_invalid();
+			}
+		}
 };
 
 template<class T> class Cartridge:
@@ -52,11 +73,11 @@ template<class T> class Cartridge:
 			// effect until the next read; therefore it isn't safe to assume that signalling ready immediately
 			// skips to the end of the line.
 			if(operation == CPU::MOS6502::BusOperation::Ready)
-				cycles_run_for = tia_->get_cycles_until_horizontal_blank(cycles_since_video_update_);
+				cycles_run_for = tia_.last_valid()->get_cycles_until_horizontal_blank(tia_.time_since_update());
 
-			cycles_since_speaker_update_ += Cycles(cycles_run_for);
-			cycles_since_video_update_ += Cycles(cycles_run_for);
-			cycles_since_6532_update_ += Cycles(cycles_run_for / 3);
+			speaker_ += Cycles(cycles_run_for);
+			tia_ += Cycles(cycles_run_for);
+			mos6532_ += Cycles(cycles_run_for / 3);
 			bus_extender_.advance_cycles(cycles_run_for / 3);
 
 			if(operation != CPU::MOS6502::BusOperation::Ready) {
@@ -66,9 +87,9 @@ template<class T> class Cartridge:
 				// check for a RIOT RAM access
 				if((address&0x1280) == 0x80) {
 					if(isReadOperation(operation)) {
-						returnValue &= mos6532_.get_ram(address);
+						returnValue &= mos6532_.last_valid()->get_ram(address);
 					} else {
-						mos6532_.set_ram(address, *value);
+						mos6532_.last_valid()->set_ram(address, *value);
 					}
 				}
 
@@ -85,7 +106,7 @@ template<class T> class Cartridge:
 							case 0x05:		// missile 1 / playfield / ball collisions
 							case 0x06:		// ball / playfield collisions
 							case 0x07:		// player / player, missile / missile collisions
-								returnValue &= tia_->get_collision_flags(decodedAddress);
+								returnValue &= tia_.last_valid()->get_collision_flags(decodedAddress);
 							break;
 
 							case 0x08:
@@ -104,66 +125,65 @@ template<class T> class Cartridge:
 					} else {
 						const uint16_t decodedAddress = address & 0x3f;
 						switch(decodedAddress) {
-							case 0x00:	update_video(); tia_->set_sync(*value & 0x02);		break;
-							case 0x01:	update_video();	tia_->set_blank(*value & 0x02);		break;
+							case 0x00:	tia_->set_sync(*value & 0x02);		break;
+							case 0x01:	tia_->set_blank(*value & 0x02);		break;
 
 							case 0x02:	m6502_.set_ready_line(true);						break;
-							case 0x03:	update_video();	tia_->reset_horizontal_counter();	break;
+							case 0x03:	tia_->reset_horizontal_counter();	break;
 								// TODO: audio will now be out of synchronisation — fix
 
 							case 0x04:
-							case 0x05:	update_video();	tia_->set_player_number_and_size(decodedAddress - 0x04, *value);	break;
+							case 0x05:	tia_->set_player_number_and_size(decodedAddress - 0x04, *value);	break;
 							case 0x06:
-							case 0x07:	update_video();	tia_->set_player_missile_colour(decodedAddress - 0x06, *value);		break;
-							case 0x08:	update_video();	tia_->set_playfield_ball_colour(*value);							break;
-							case 0x09:	update_video();	tia_->set_background_colour(*value);								break;
-							case 0x0a:	update_video();	tia_->set_playfield_control_and_ball_size(*value);					break;
+							case 0x07:	tia_->set_player_missile_colour(decodedAddress - 0x06, *value);		break;
+							case 0x08:	tia_->set_playfield_ball_colour(*value);							break;
+							case 0x09:	tia_->set_background_colour(*value);								break;
+							case 0x0a:	tia_->set_playfield_control_and_ball_size(*value);					break;
 							case 0x0b:
-							case 0x0c:	update_video();	tia_->set_player_reflected(decodedAddress - 0x0b, !((*value)&8));	break;
+							case 0x0c:	tia_->set_player_reflected(decodedAddress - 0x0b, !((*value)&8));	break;
 							case 0x0d:
 							case 0x0e:
-							case 0x0f:	update_video();	tia_->set_playfield(decodedAddress - 0x0d, *value);					break;
+							case 0x0f:	tia_->set_playfield(decodedAddress - 0x0d, *value);					break;
 							case 0x10:
-							case 0x11:	update_video(); tia_->set_player_position(decodedAddress - 0x10);					break;
+							case 0x11:	tia_->set_player_position(decodedAddress - 0x10);					break;
 							case 0x12:
-							case 0x13:	update_video(); tia_->set_missile_position(decodedAddress - 0x12);					break;
-							case 0x14:	update_video();	tia_->set_ball_position();											break;
+							case 0x13:	tia_->set_missile_position(decodedAddress - 0x12);					break;
+							case 0x14:	tia_->set_ball_position();											break;
 							case 0x1b:
-							case 0x1c:	update_video(); tia_->set_player_graphic(decodedAddress - 0x1b, *value);			break;
+							case 0x1c:	tia_->set_player_graphic(decodedAddress - 0x1b, *value);			break;
 							case 0x1d:
-							case 0x1e:	update_video(); tia_->set_missile_enable(decodedAddress - 0x1d, (*value)&2);		break;
-							case 0x1f:	update_video(); tia_->set_ball_enable((*value)&2);									break;
+							case 0x1e:	tia_->set_missile_enable(decodedAddress - 0x1d, (*value)&2);		break;
+							case 0x1f:	tia_->set_ball_enable((*value)&2);									break;
 							case 0x20:
-							case 0x21:	update_video(); tia_->set_player_motion(decodedAddress - 0x20, *value);				break;
+							case 0x21:	tia_->set_player_motion(decodedAddress - 0x20, *value);				break;
 							case 0x22:
-							case 0x23:	update_video(); tia_->set_missile_motion(decodedAddress - 0x22, *value);			break;
-							case 0x24:	update_video(); tia_->set_ball_motion(*value);										break;
+							case 0x23:	tia_->set_missile_motion(decodedAddress - 0x22, *value);			break;
+							case 0x24:	tia_->set_ball_motion(*value);										break;
 							case 0x25:
-							case 0x26:	tia_->set_player_delay(decodedAddress - 0x25, (*value)&1);							break;
-							case 0x27:	tia_->set_ball_delay((*value)&1);													break;
+							case 0x26:	tia_.last_valid()->set_player_delay(decodedAddress - 0x25, (*value)&1);							break;
+							case 0x27:	tia_.last_valid()->set_ball_delay((*value)&1);													break;
 							case 0x28:
-							case 0x29:	update_video(); tia_->set_missile_position_to_player(decodedAddress - 0x28, (*value)&2);		break;
-							case 0x2a:	update_video(); tia_->move();														break;
-							case 0x2b:	update_video(); tia_->clear_motion();												break;
-							case 0x2c:	update_video(); tia_->clear_collision_flags();										break;
+							case 0x29:	tia_->set_missile_position_to_player(decodedAddress - 0x28, (*value)&2);		break;
+							case 0x2a:	tia_->move();														break;
+							case 0x2b:	tia_->clear_motion();												break;
+							case 0x2c:	tia_->clear_collision_flags();										break;
 
 							case 0x15:
-							case 0x16:	update_audio(); speaker_->set_control(decodedAddress - 0x15, *value);				break;
+							case 0x16:	speaker_->set_control(decodedAddress - 0x15, *value);				break;
 							case 0x17:
-							case 0x18:	update_audio(); speaker_->set_divider(decodedAddress - 0x17, *value);				break;
+							case 0x18:	speaker_->set_divider(decodedAddress - 0x17, *value);				break;
 							case 0x19:
-							case 0x1a:	update_audio(); speaker_->set_volume(decodedAddress - 0x19, *value);				break;
+							case 0x1a:	speaker_->set_volume(decodedAddress - 0x19, *value);				break;
 						}
 					}
 				}
 
 				// check for a PIA access
 				if((address&0x1280) == 0x280) {
-					update_6532();
 					if(isReadOperation(operation)) {
-						returnValue &= mos6532_.get_register(address);
+						returnValue &= mos6532_->get_register(address);
 					} else {
-						mos6532_.set_register(address, *value);
+						mos6532_->set_register(address, *value);
 					}
 				}
 
@@ -172,17 +192,27 @@ template<class T> class Cartridge:
 				}
 			}
 
-			if(!tia_->get_cycles_until_horizontal_blank(cycles_since_video_update_)) m6502_.set_ready_line(false);
+			if(!tia_.last_valid()->get_cycles_until_horizontal_blank(tia_.time_since_update())) m6502_.set_ready_line(false);
 
 			return Cycles(cycles_run_for / 3);
 		}
 
 		void flush() {
-			update_audio();
-			update_video();
+			tia_.flush();
 			speaker_->flush();
 		}
 
+		void serialise(Snapshot::Archive &archive) {
+			// The cartridge itself isn't captured, but a snapshot of a different one should be rejected.
+			uint32_t rom_size = static_cast<uint32_t>(rom_.size());
+			archive(rom_size);
+			if(rom_size != rom_.size()) archive.set_invalid();
+
+			Bus::serialise(archive);
+			m6502_.serialise(archive);
+			bus_extender_.serialise(archive);
+		}
+
 	protected:
 		CPU::MOS6502::Processor<Cartridge<T>, true> m6502_;
 		std::vector<uint8_t> rom_;
@@ -35,6 +35,10 @@ class CommaVid: public BusExtender {
 			if(isReadOperation(operation)) *value = rom_base_[address & 2047];
 		}
 
+		void serialise(Snapshot::Archive &archive) {
+			archive(ram_);
+		}
+
 	private:
 		uint8_t ram_[1024];
 };
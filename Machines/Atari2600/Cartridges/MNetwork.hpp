@@ -57,6 +57,13 @@ class MNetwork: public BusExtender {
 			}
 		}
 
+		void serialise(Snapshot::Archive &archive) {
+			serialise_pointer(archive, rom_ptr_[0], rom_base_, rom_size_);
+			serialise_pointer(archive, rom_ptr_[1], rom_base_, rom_size_);
+			serialise_pointer(archive, high_ram_ptr_, high_ram_, sizeof(high_ram_));
+			archive(low_ram_, high_ram_);
+		}
+
 	private:
 		uint8_t *rom_ptr_[2];
 		uint8_t *high_ram_ptr_;
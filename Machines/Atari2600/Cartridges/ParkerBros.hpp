@@ -38,6 +38,10 @@ class ParkerBros: public BusExtender {
 			}
 		}
 
+		void serialise(Snapshot::Archive &archive) {
+			for(int c = 0; c < 4; ++c) serialise_pointer(archive, rom_ptr_[c], rom_base_, rom_size_);
+		}
+
 	private:
 		uint8_t *rom_ptr_[4];
 };
@@ -90,6 +90,12 @@ class Pitfall2: public BusExtender {
 			}
 		}
 
+		void serialise(Snapshot::Archive &archive) {
+			serialise_pointer(archive, rom_ptr_, rom_base_, rom_size_);
+			archive(featcher_address_, top_, bottom_, mask_, music_mode_, random_number_generator_);
+			archive(audio_channel_, cycles_since_audio_update_);
+		}
+
 	private:
 		inline uint16_t address_for_counter(int counter) {
 			uint16_t fetch_address = (featcher_address_[counter] & 2047) ^ 2047;
@@ -32,6 +32,11 @@ class Tigervision: public BusExtender {
 			}
 		}
 
+		void serialise(Snapshot::Archive &archive) {
+			serialise_pointer(archive, rom_ptr_[0], rom_base_, rom_size_);
+			serialise_pointer(archive, rom_ptr_[1], rom_base_, rom_size_);
+		}
+
 	private:
 		uint8_t *rom_ptr_[2];
 };
@@ -30,6 +30,11 @@ class PIA: public MOS::MOS6532<PIA> {
 			port_values_{0xff, 0xff}
 		{}
 
+		void serialise(Snapshot::Archive &archive) {
+			MOS::MOS6532<PIA>::serialise(archive);
+			archive(port_values_);
+		}
+
 	private:
 		uint8_t port_values_[2];
 
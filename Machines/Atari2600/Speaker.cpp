@@ -17,22 +17,33 @@ Atari2600::Speaker::Speaker() :
 {}
 
 void Atari2600::Speaker::set_volume(int channel, uint8_t volume) {
-	enqueue([=]() {
-		volume_[channel] = volume & 0xf;
-	});
+	enqueue_register_write(Volume | channel, volume);
 }
 
 void Atari2600::Speaker::set_divider(int channel, uint8_t divider) {
-	enqueue([=]() {
-		divider_[channel] = divider & 0x1f;
-		divider_counter_[channel] = 0;
-	});
+	enqueue_register_write(Divider | channel, divider);
 }
 
 void Atari2600::Speaker::set_control(int channel, uint8_t control) {
-	enqueue([=]() {
-		control_[channel] = control & 0xf;
-	});
+	enqueue_register_write(Control | channel, control);
+}
+
+void Atari2600::Speaker::apply_register_write(int address, uint8_t value) {
+	const int channel = address & 1;
+	switch(address & ~1) {
+		case Volume:
+			volume_[channel] = value & 0xf;
+		break;
+
+		case Divider:
+			divider_[channel] = value & 0x1f;
+			divider_counter_[channel] = 0;
+		break;
+
+		case Control:
+			control_[channel] = value & 0xf;
+		break;
+	}
 }
 
 #define advance_poly4(c) poly4_counter_[channel] = (poly4_counter_[channel] >> 1) | (((poly4_counter_[channel] << 3) ^ (poly4_counter_[channel] << 2))&0x008)
@@ -122,3 +133,9 @@ void Atari2600::Speaker::get_samples(unsigned int number_of_samples, int16_t *ta
 		}
 	}
 }
+
+void Atari2600::Speaker::serialise(Snapshot::Archive &archive) {
+	synchronise();
+	archive.tag(0x41534e44);
+	archive(volume_, divider_, control_, poly4_counter_, poly5_counter_, poly9_counter_, output_state_, divider_counter_);
+}
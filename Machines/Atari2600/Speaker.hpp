@@ -10,6 +10,7 @@
 #define Atari2600_Speaker_hpp
 
 #include "../../Outputs/Speaker.hpp"
+#include "../../Snapshot/Snapshot.hpp"
 
 namespace Atari2600 {
 
@@ -26,8 +27,16 @@ class Speaker: public ::Outputs::Filter<Speaker> {
 		void set_control(int channel, uint8_t control);
 
 		void get_samples(unsigned int number_of_samples, int16_t *target);
+		void apply_register_write(int address, uint8_t value);
+
+		void serialise(Snapshot::Archive &archive);
 
 	private:
+		// Register addresses are one of these plus the channel number.
+		enum Register {
+			Volume = 0, Divider = 2, Control = 4
+		};
+
 		uint8_t volume_[2];
 		uint8_t divider_[2];
 		uint8_t control_[2];
@@ -8,6 +8,7 @@
 
 #include "TIA.hpp"
 #include <cassert>
+#include <cmath>
 
 using namespace Atari2600;
 namespace {
@@ -117,6 +118,20 @@ TIA::TIA(std::function<void(uint8_t *output_buffer)> line_end_function) : TIA(fa
 	line_end_function_ = line_end_function;
 }
 
+void TIA::serialise(Snapshot::Archive &archive) {
+	archive.tag(0x54494120);
+	archive(horizontal_counter_, output_mode_, collision_buffer_, collision_flags_, colour_palette_);
+	archive(background_half_mask_, playfield_priority_, background_);
+
+	// The objects include constants, which are the same in every instance, so are transferred wholesale.
+	archive.bytes(player_, sizeof(player_));
+	archive.bytes(missile_, sizeof(missile_));
+	archive.bytes(&ball_, sizeof(ball_));
+
+	archive(horizontal_blank_extend_, pixels_start_location_);
+	if(archive.is_reading()) pixel_target_ = nullptr;
+}
+
 void TIA::set_output_mode(Atari2600::TIA::OutputMode output_mode) {
 	Outputs::CRT::DisplayType display_type;
 
@@ -131,6 +146,14 @@ void TIA::set_output_mode(Atari2600::TIA::OutputMode output_mode) {
 				"float phaseOffset = 6.283185308 * float(iPhase) / 13.0 + 5.074880441076923;"
 				"return mix(float(y) / 14.0, step(1, iPhase) * cos(phase + phaseOffset), amplitude);"
 			"}");
+		crt_->set_software_composite_sampling_function([] (const uint8_t *sample, float x, float phase, float amplitude) {
+			const unsigned int y = sample[0] & 14;
+			const unsigned int phase_index = sample[0] >> 4;
+
+			const float phase_offset = 6.283185308f * static_cast<float>(phase_index) / 13.0f + 5.074880441076923f;
+			const float chroma = phase_index ? cosf(phase + phase_offset) : 0.0f;
+			return (static_cast<float>(y) / 14.0f) * (1.0f - amplitude) + chroma * amplitude;
+		});
 		display_type = Outputs::CRT::DisplayType::NTSC60;
 	} else {
 		crt_->set_composite_sampling_function(
@@ -145,6 +168,16 @@ void TIA::set_output_mode(Atari2600::TIA::OutputMode output_mode) {
 				"phaseOffset *= 6.283185308 / 12.0;"
 				"return mix(float(y) / 14.0, step(4, (iPhase + 2u) & 15u) * cos(phase + phaseOffset), amplitude);"
 			"}");
+		crt_->set_software_composite_sampling_function([] (const uint8_t *sample, float x, float phase, float amplitude) {
+			const unsigned int y = sample[0] & 14;
+			const unsigned int phase_index = sample[0] >> 4;
+
+			const unsigned int direction = phase_index & 1;
+			float phase_offset = static_cast<float>(7 - direction) + (static_cast<float>(direction) - 0.5f) * 2.0f * static_cast<float>(phase_index >> 1);
+			phase_offset *= 6.283185308f / 12.0f;
+			const float chroma = (((phase_index + 2) & 15) >= 4) ? cosf(phase + phase_offset) : 0.0f;
+			return (static_cast<float>(y) / 14.0f) * (1.0f - amplitude) + chroma * amplitude;
+		});
 		display_type = Outputs::CRT::DisplayType::PAL50;
 	}
 	// line number of cycles in a line of video is one less than twice the number of clock cycles per line; the Atari
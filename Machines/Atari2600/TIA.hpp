@@ -12,6 +12,7 @@
 #include <cstdint>
 
 #include "../CRTMachine.hpp"
+#include "../../Snapshot/Snapshot.hpp"
 
 namespace Atari2600 {
 
@@ -73,6 +74,12 @@ class TIA {
 		uint8_t get_collision_flags(int offset);
 		void clear_collision_flags();
 
+		/*!
+			Captures or restores all state other than the output mode, which is the owner's responsibility,
+			and that of the CRT; any line in progress at restoration is not drawn.
+		*/
+		void serialise(Snapshot::Archive &archive);
+
 		virtual std::shared_ptr<Outputs::CRT::CRT> get_crt() { return crt_; }
 
 	private:
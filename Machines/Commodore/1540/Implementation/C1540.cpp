@@ -66,18 +66,23 @@ Cycles MachineBase::perform_bus_operation(CPU::MOS6502::BusOperation operation,
 		}
 	} else if(address >= 0x1800 && address <= 0x180f) {
 		if(isReadOperation(operation))
-			*value = serial_port_VIA_.get_register(address);
+			*value = serial_port_VIA_->get_register(address);
 		else
-			serial_port_VIA_.set_register(address, *value);
+			serial_port_VIA_->set_register(address, *value);
 	} else if(address >= 0x1c00 && address <= 0x1c0f) {
 		if(isReadOperation(operation))
-			*value = drive_VIA_.get_register(address);
+			*value = drive_VIA_->get_register(address);
 		else
-			drive_VIA_.set_register(address, *value);
+			drive_VIA_->set_register(address, *value);
 	}
 
-	serial_port_VIA_.run_for(Cycles(1));
-	drive_VIA_.run_for(Cycles(1));
+	// The VIAs are run only when next they might change of their own accord, or upon an access.
+	serial_port_VIA_ += Cycles(1);
+	drive_VIA_ += Cycles(1);
+
+	// The disk is observed by the processor on every cycle, via the overflow line, so is kept in lockstep
+	// with it; it needs no time at all while the motor is off.
+	if(drive_VIA_port_handler_.get_motor_enabled()) Storage::Disk::Controller::run_for(Cycles(1));
 
 	return Cycles(1);
 }
@@ -101,18 +106,29 @@ void Machine::set_disk(std::shared_ptr<Storage::Disk::Disk> disk) {
 
 void Machine::run_for(const Cycles cycles) {
 	m6502_.run_for(cycles);
+}
+
+void MachineBase::serialise(Snapshot::Archive &archive) {
+	archive.tag(0x31353430);
+	m6502_.serialise(archive);
+	archive(ram_);
 
-	bool drive_motor = drive_VIA_port_handler_.get_motor_enabled();
-	drive_->set_motor_on(drive_motor);
-	if(drive_motor)
-		Storage::Disk::Controller::run_for(cycles);
+	drive_VIA_->serialise(archive);
+	drive_VIA_port_handler_.serialise(archive);
+	serial_port_VIA_->serialise(archive);
+	serial_port_VIA_port_handler_->serialise(archive);
+	serial_port_->serialise(archive);
+
+	Storage::Disk::Controller::serialise(archive);
+	drive_->serialise(archive);
+	archive(shift_register_, bit_window_offset_);
 }
 
 // MARK: - 6522 delegate
 
 void MachineBase::mos6522_did_change_interrupt_status(void *mos6522) {
 	// both VIAs are connected to the IRQ line
-	m6502_.set_irq_line(serial_port_VIA_.get_interrupt_line() || drive_VIA_.get_interrupt_line());
+	m6502_.set_irq_line(serial_port_VIA_.last_valid()->get_interrupt_line() || drive_VIA_.last_valid()->get_interrupt_line());
 }
 
 // MARK: - Disk drive
@@ -149,9 +165,13 @@ void MachineBase::drive_via_did_set_data_density(void *driveVIA, int density) {
 	set_expected_bit_length(Storage::Encodings::CommodoreGCR::length_of_a_bit_in_time_zone(static_cast<unsigned int>(density)));
 }
 
+void MachineBase::drive_via_did_set_drive_motor(void *driveVIA, bool enabled) {
+	drive_->set_motor_on(enabled);
+}
+
 // MARK: - SerialPortVIA
 
-SerialPortVIA::SerialPortVIA(MOS::MOS6522::MOS6522<SerialPortVIA> &via) : via_(via) {}
+SerialPortVIA::SerialPortVIA(SequencedJustInTimeActor<MOS::MOS6522::MOS6522<SerialPortVIA>> &via) : via_(via) {}
 
 uint8_t SerialPortVIA::get_port_input(MOS::MOS6522::Port port) {
 	if(port) return port_b_;
@@ -181,7 +201,7 @@ void SerialPortVIA::set_serial_line_state(::Commodore::Serial::Line line, bool v
 		case ::Commodore::Serial::Line::Attention:
 			attention_level_input_ = !value;
 			port_b_ = (port_b_ & ~0x80) | (value ? 0x00 : 0x80);
-			via_.set_control_line_input(MOS::MOS6522::Port::A, MOS::MOS6522::Line::One, !value);
+			via_->set_control_line_input(MOS::MOS6522::Port::A, MOS::MOS6522::Line::One, !value);
 			update_data_line();
 		break;
 	}
@@ -191,6 +211,10 @@ void SerialPortVIA::set_serial_port(const std::shared_ptr<::Commodore::Serial::P
 	serial_port_ = serialPort;
 }
 
+void SerialPortVIA::serialise(Snapshot::Archive &archive) {
+	archive(port_b_, attention_acknowledge_level_, attention_level_input_, data_level_output_);
+}
+
 void SerialPortVIA::update_data_line() {
 	std::shared_ptr<::Commodore::Serial::Port> serialPort = serial_port_.lock();
 	if(serialPort) {
@@ -239,7 +263,11 @@ void DriveVIA::set_port_output(MOS::MOS6522::Port port, uint8_t value, uint8_t d
 	if(port) {
 		if(previous_port_b_output_ != value) {
 			// record drive motor state
-			drive_motor_ = !!(value&4);
+			const bool drive_motor = !!(value&4);
+			if(drive_motor != drive_motor_) {
+				drive_motor_ = drive_motor;
+				if(delegate_) delegate_->drive_via_did_set_drive_motor(this, drive_motor_);
+			}
 
 			// check for a head step
 			int step_difference = ((value&3) - (previous_port_b_output_&3))&3;
@@ -261,6 +289,10 @@ void DriveVIA::set_port_output(MOS::MOS6522::Port port, uint8_t value, uint8_t d
 	}
 }
 
+void DriveVIA::serialise(Snapshot::Archive &archive) {
+	archive(port_b_, port_a_, should_set_overflow_, drive_motor_, previous_port_b_output_);
+}
+
 // MARK: - SerialPort
 
 void SerialPort::set_input(::Commodore::Serial::Line line, ::Commodore::Serial::LineLevel level) {
@@ -18,6 +18,9 @@
 
 #include "../../../../Storage/Disk/Controller/DiskController.hpp"
 
+#include "../../../../ClockReceiver/JustInTime.hpp"
+#include "../../../../Snapshot/Snapshot.hpp"
+
 namespace Commodore {
 namespace C1540 {
 
@@ -38,7 +41,7 @@ namespace C1540 {
 */
 class SerialPortVIA: public MOS::MOS6522::IRQDelegatePortHandler {
 	public:
-		SerialPortVIA(MOS::MOS6522::MOS6522<SerialPortVIA> &via);
+		SerialPortVIA(SequencedJustInTimeActor<MOS::MOS6522::MOS6522<SerialPortVIA>> &via);
 
 		uint8_t get_port_input(MOS::MOS6522::Port);
 
@@ -47,8 +50,10 @@ class SerialPortVIA: public MOS::MOS6522::IRQDelegatePortHandler {
 
 		void set_serial_port(const std::shared_ptr<::Commodore::Serial::Port> &);
 
+		void serialise(Snapshot::Archive &archive);
+
 	private:
-		MOS::MOS6522::MOS6522<SerialPortVIA> &via_;
+		SequencedJustInTimeActor<MOS::MOS6522::MOS6522<SerialPortVIA>> &via_;
 		uint8_t port_b_ = 0x0;
 		std::weak_ptr<::Commodore::Serial::Port> serial_port_;
 		bool attention_acknowledge_level_ = false;
@@ -80,6 +85,7 @@ class DriveVIA: public MOS::MOS6522::IRQDelegatePortHandler {
 			public:
 				virtual void drive_via_did_step_head(void *driveVIA, int direction) = 0;
 				virtual void drive_via_did_set_data_density(void *driveVIA, int density) = 0;
+				virtual void drive_via_did_set_drive_motor(void *driveVIA, bool enabled) = 0;
 		};
 		void set_delegate(Delegate *);
 
@@ -96,10 +102,12 @@ class DriveVIA: public MOS::MOS6522::IRQDelegatePortHandler {
 
 		void set_port_output(MOS::MOS6522::Port, uint8_t value, uint8_t direction_mask);
 
+		void serialise(Snapshot::Archive &archive);
+
 	private:
 		uint8_t port_b_, port_a_;
 		bool should_set_overflow_;
-		bool drive_motor_;
+		bool drive_motor_ = false;
 		uint8_t previous_port_b_output_;
 		Delegate *delegate_;
 };
@@ -134,6 +142,13 @@ class MachineBase:
 		// to satisfy DriveVIA::Delegate
 		void drive_via_did_step_head(void *driveVIA, int direction);
 		void drive_via_did_set_data_density(void *driveVIA, int density);
+		void drive_via_did_set_drive_motor(void *driveVIA, bool enabled);
+
+		/*!
+			Captures or restores the state of this drive: its processor, RAM, VIAs, serial port outputs, disk
+			controller and drive mechanism. The disk itself is not captured.
+		*/
+		void serialise(Snapshot::Archive &archive);
 
 	protected:
 		CPU::MOS6502::Processor<MachineBase, false> m6502_;
@@ -146,8 +161,8 @@ class MachineBase:
 		std::shared_ptr<SerialPort> serial_port_;
 		DriveVIA drive_VIA_port_handler_;
 
-		MOS::MOS6522::MOS6522<DriveVIA> drive_VIA_;
-		MOS::MOS6522::MOS6522<SerialPortVIA> serial_port_VIA_;
+		SequencedJustInTimeActor<MOS::MOS6522::MOS6522<DriveVIA>> drive_VIA_;
+		SequencedJustInTimeActor<MOS::MOS6522::MOS6522<SerialPortVIA>> serial_port_VIA_;
 
 		int shift_register_ = 0, bit_window_offset_;
 		virtual void process_input_bit(int value);
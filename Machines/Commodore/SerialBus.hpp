@@ -13,6 +13,8 @@
 #include <memory>
 #include <vector>
 
+#include "../../Snapshot/Snapshot.hpp"
+
 namespace Commodore {
 namespace Serial {
 
@@ -63,6 +65,13 @@ namespace Serial {
 			*/
 			void set_line_output_did_change(Line line);
 
+			/*!
+				Captures or restores the current bus levels. Attached ports are not informed; each restores its own inputs.
+			*/
+			void serialise(Snapshot::Archive &archive) {
+				archive(line_levels_);
+			}
+
 		private:
 			LineLevel line_levels_[5];
 			std::vector<std::weak_ptr<Port>> ports_;
@@ -106,6 +115,13 @@ namespace Serial {
 				serial_bus_ = serial_bus;
 			}
 
+			/*!
+				Captures or restores this port's output levels, without communicating them to the bus.
+			*/
+			void serialise(Snapshot::Archive &archive) {
+				archive(line_levels_);
+			}
+
 		private:
 			std::weak_ptr<Bus> serial_bus_;
 			LineLevel line_levels_[5];
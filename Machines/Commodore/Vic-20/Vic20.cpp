@@ -15,6 +15,8 @@
 #include "../../../Components/6522/6522.hpp"
 
 #include "../../../ClockReceiver/ForceInline.hpp"
+#include "../../../ClockReceiver/JustInTime.hpp"
+#include "../../Utility/MemoryMap.hpp"
 
 #include "../../../Storage/Tape/Parsers/Commodore.hpp"
 
@@ -40,7 +42,9 @@ enum ROMSlot {
 };
 
 std::vector<std::unique_ptr<Configurable::Option>> get_options() {
-	return Configurable::standard_options(Configurable::QuickLoadTape);
+	std::vector<std::unique_ptr<Configurable::Option>> options = Configurable::standard_options(Configurable::QuickLoadTape);
+	options.emplace_back(new Configurable::BooleanOption("Run Disk Drive In Parallel", "paralleldrive"));
+	return options;
 }
 
 enum JoystickInput {
@@ -75,10 +79,10 @@ class UserPortVIA: public MOS::MOS6522::IRQDelegatePortHandler {
 		/// Reports the current input to the 6522 port @c port.
 		uint8_t get_port_input(MOS::MOS6522::Port port) {
 			// Port A provides information about the presence or absence of a tape, and parts of
-			// the joystick and serial port state, both of which have been statefully collected
-			// into port_a_.
+			// the joystick and serial port state, both of which have been statefully collected.
+			// Serial state is kept separately because a 1540 may announce it from another thread.
 			if(!port) {
-				return port_a_ | (tape_->has_tape() ? 0x00 : 0x40);
+				return (port_a_ & ~0x03) | serial_inputs_ | (tape_->has_tape() ? 0x00 : 0x40);
 			}
 			return 0xff;
 		}
@@ -95,8 +99,8 @@ class UserPortVIA: public MOS::MOS6522::IRQDelegatePortHandler {
 		void set_serial_line_state(::Commodore::Serial::Line line, bool value) {
 			switch(line) {
 				default: break;
-				case ::Commodore::Serial::Line::Data: port_a_ = (port_a_ & ~0x02) | (value ? 0x02 : 0x00);	break;
-				case ::Commodore::Serial::Line::Clock: port_a_ = (port_a_ & ~0x01) | (value ? 0x01 : 0x00);	break;
+				case ::Commodore::Serial::Line::Data: serial_inputs_ = (serial_inputs_ & ~0x02) | (value ? 0x02 : 0x00);	break;
+				case ::Commodore::Serial::Line::Clock: serial_inputs_ = (serial_inputs_ & ~0x01) | (value ? 0x01 : 0x00);	break;
 			}
 		}
 
@@ -126,8 +130,19 @@ class UserPortVIA: public MOS::MOS6522::IRQDelegatePortHandler {
 			tape_ = tape;
 		}
 
+		/// Captures or restores the serial and joystick inputs collected into Port A.
+		void serialise(Snapshot::Archive &archive) {
+			uint8_t port_a = static_cast<uint8_t>((port_a_ & ~0x03) | serial_inputs_);
+			archive(port_a);
+			if(archive.is_reading()) {
+				port_a_ = port_a | 0x03;
+				serial_inputs_ = port_a & 0x03;
+			}
+		}
+
 	private:
 		uint8_t port_a_;
+		uint8_t serial_inputs_ = 0x03;
 		std::weak_ptr<::Commodore::Serial::Port> serial_port_;
 		std::shared_ptr<Storage::Tape::BinaryTapePlayer> tape_;
 };
@@ -200,6 +215,11 @@ class KeyboardVIA: public MOS::MOS6522::IRQDelegatePortHandler {
 			serial_port_ = serialPort;
 		}
 
+		/// Captures or restores the keyboard, the joystick input on Port B and the selected keyboard columns.
+		void serialise(Snapshot::Archive &archive) {
+			archive(port_b_, columns_, activation_mask_);
+		}
+
 	private:
 		uint8_t port_b_;
 		uint8_t columns_[8];
@@ -277,6 +297,7 @@ class ConcreteMachine:
 	public MOS::MOS6522::IRQDelegatePortHandler::Delegate,
 	public Utility::TypeRecipient,
 	public Storage::Tape::BinaryTapePlayer::Delegate,
+	public Sleeper::SleepObserver,
 	public Machine {
 	public:
 		ConcreteMachine() :
@@ -287,7 +308,8 @@ class ConcreteMachine:
 				serial_bus_(new ::Commodore::Serial::Bus),
 				user_port_via_(*user_port_via_port_handler_),
 				keyboard_via_(*keyboard_via_port_handler_),
-				tape_(new Storage::Tape::BinaryTapePlayer(1022727)) {
+				tape_(new Storage::Tape::BinaryTapePlayer(1022727)),
+				c1540_(Cycles(2048)) {
 			// communicate the tape to the user-port VIA
 			user_port_via_port_handler_->set_tape(tape_);
 
@@ -303,6 +325,7 @@ class ConcreteMachine:
 			user_port_via_port_handler_->set_interrupt_delegate(this);
 			keyboard_via_port_handler_->set_interrupt_delegate(this);
 			tape_->set_delegate(this);
+			tape_->set_sleep_observer(this);
 
 			// install a joystick
 			joysticks_.emplace_back(new Joystick(*user_port_via_port_handler_, *keyboard_via_port_handler_));
@@ -317,6 +340,9 @@ class ConcreteMachine:
 
 		// Obtains the system ROMs.
 		bool set_rom_fetcher(const std::function<std::vector<std::unique_ptr<std::vector<uint8_t>>>(const std::string &machine, const std::vector<std::string> &names)> &roms_with_names) override {
+			// Retain the fetcher so that a 1540 can use it if one is attached later.
+			rom_fetcher_ = roms_with_names;
+
 			auto roms = roms_with_names(
 				"Vic20",
 				{
@@ -365,13 +391,13 @@ class ConcreteMachine:
 
 			if(target.media.disks.size()) {
 				// construct the 1540
-				c1540_.reset(new ::Commodore::C1540::Machine(Commodore::C1540::Machine::C1540));
+				c1540_.object().reset(new ::Commodore::C1540::Machine(Commodore::C1540::Machine::C1540));
 
 				// attach it to the serial bus
-				c1540_->set_serial_bus(serial_bus_);
+				c1540_.last_valid()->set_serial_bus(serial_bus_);
 
 				// give it a means to obtain its ROM
-				c1540_->set_rom_fetcher(rom_fetcher_);
+				c1540_.last_valid()->set_rom_fetcher(rom_fetcher_);
 			}
 
 			insert_media(target.media);
@@ -382,8 +408,8 @@ class ConcreteMachine:
 				tape_->set_tape(media.tapes.front());
 			}
 
-			if(!media.disks.empty() && c1540_) {
-				c1540_->set_disk(media.disks.front());
+			if(!media.disks.empty() && c1540_.last_valid()) {
+				c1540_.last_valid()->set_disk(media.disks.front());
 			}
 
 			if(!media.cartridges.empty()) {
@@ -393,17 +419,18 @@ class ConcreteMachine:
 
 				rom_ = new uint8_t[0x2000];
 				std::memcpy(rom_, rom_image.data(), rom_image.size());
-				write_to_map(processor_read_memory_map_, rom_, rom_address_, 0x2000);
+				memory_map_.map_read(rom_, rom_address_, 0x2000);
 			}
 
-			return !media.tapes.empty() || (!media.disks.empty() && c1540_ != nullptr) || !media.cartridges.empty();
+			return !media.tapes.empty() || (!media.disks.empty() && c1540_.last_valid() != nullptr) || !media.cartridges.empty();
 		}
 
 		void set_key_state(uint16_t key, bool is_pressed) override final {
 			if(key != KeyRestore)
 				keyboard_via_port_handler_->set_key_state(key, is_pressed);
-			else
-				user_port_via_.set_control_line_input(MOS::MOS6522::Port::A, MOS::MOS6522::Line::One, !is_pressed);
+			else {
+				user_port_via_.last_valid()->set_control_line_input(MOS::MOS6522::Port::A, MOS::MOS6522::Line::One, !is_pressed);
+			}
 		}
 
 		void clear_all_keys() override final {
@@ -450,36 +477,36 @@ class ConcreteMachine:
 				set_pal_6560();
 			}
 
-			memset(processor_read_memory_map_, 0, sizeof(processor_read_memory_map_));
-			memset(processor_write_memory_map_, 0, sizeof(processor_write_memory_map_));
+			memory_map_.clear();
+			memory_map_.set_io(0x9000, 0x400);
 			memset(mos6560_->video_memory_map, 0, sizeof(mos6560_->video_memory_map));
 
 			switch(memory_size_) {
 				default: break;
 				case ThreeKB:
-					write_to_map(processor_read_memory_map_, expansion_ram_, 0x0000, 0x1000);
-					write_to_map(processor_write_memory_map_, expansion_ram_, 0x0000, 0x1000);
+					memory_map_.map_read(expansion_ram_, 0x0000, 0x1000);
+					memory_map_.map_write(expansion_ram_, 0x0000, 0x1000);
 				break;
 				case ThirtyTwoKB:
-					write_to_map(processor_read_memory_map_, expansion_ram_, 0x0000, 0x8000);
-					write_to_map(processor_write_memory_map_, expansion_ram_, 0x0000, 0x8000);
+					memory_map_.map_read(expansion_ram_, 0x0000, 0x8000);
+					memory_map_.map_write(expansion_ram_, 0x0000, 0x8000);
 				break;
 			}
 
 			// install the system ROMs and VIC-visible memory
-			write_to_map(processor_read_memory_map_, user_basic_memory_, 0x0000, sizeof(user_basic_memory_));
-			write_to_map(processor_read_memory_map_, screen_memory_, 0x1000, sizeof(screen_memory_));
-			write_to_map(processor_read_memory_map_, colour_memory_, 0x9400, sizeof(colour_memory_));
+			memory_map_.map_read(user_basic_memory_, 0x0000, sizeof(user_basic_memory_));
+			memory_map_.map_read(screen_memory_, 0x1000, sizeof(screen_memory_));
+			memory_map_.map_read(colour_memory_, 0x9400, sizeof(colour_memory_));
 
-			write_to_map(processor_write_memory_map_, user_basic_memory_, 0x0000, sizeof(user_basic_memory_));
-			write_to_map(processor_write_memory_map_, screen_memory_, 0x1000, sizeof(screen_memory_));
-			write_to_map(processor_write_memory_map_, colour_memory_, 0x9400, sizeof(colour_memory_));
+			memory_map_.map_write(user_basic_memory_, 0x0000, sizeof(user_basic_memory_));
+			memory_map_.map_write(screen_memory_, 0x1000, sizeof(screen_memory_));
+			memory_map_.map_write(colour_memory_, 0x9400, sizeof(colour_memory_));
 
 			write_to_map(mos6560_->video_memory_map, user_basic_memory_, 0x2000, sizeof(user_basic_memory_));
 			write_to_map(mos6560_->video_memory_map, screen_memory_, 0x3000, sizeof(screen_memory_));
 			mos6560_->colour_memory = colour_memory_;
 
-			write_to_map(processor_read_memory_map_, basic_rom_.data(), 0xc000, static_cast<uint16_t>(basic_rom_.size()));
+			memory_map_.map_read(basic_rom_.data(), 0xc000, basic_rom_.size());
 
 			ROM character_rom;
 			ROM kernel_rom;
@@ -506,13 +533,13 @@ class ConcreteMachine:
 				break;
 			}
 
-			write_to_map(processor_read_memory_map_, roms_[character_rom].data(), 0x8000, static_cast<uint16_t>(roms_[character_rom].size()));
+			memory_map_.map_read(roms_[character_rom].data(), 0x8000, roms_[character_rom].size());
 			write_to_map(mos6560_->video_memory_map, roms_[character_rom].data(), 0x0000, static_cast<uint16_t>(roms_[character_rom].size()));
-			write_to_map(processor_read_memory_map_, roms_[kernel_rom].data(), 0xe000, static_cast<uint16_t>(roms_[kernel_rom].size()));
+			memory_map_.map_read(roms_[kernel_rom].data(), 0xe000, roms_[kernel_rom].size());
 
 			// install the inserted ROM if there is one
 			if(rom_) {
-				write_to_map(processor_read_memory_map_, rom_, rom_address_, rom_length_);
+				memory_map_.map_read(rom_, rom_address_, rom_length_);
 			}
 		}
 
@@ -527,11 +554,14 @@ class ConcreteMachine:
 
 			// run the phase-2 part of the cycle, which is whatever the 6502 said it should be
 			if(isReadOperation(operation)) {
-				uint8_t result = processor_read_memory_map_[address >> 10] ? processor_read_memory_map_[address >> 10][address & 0x3ff] : 0xff;
-				if((address&0xfc00) == 0x9000) {
+				uint8_t result = memory_map_.read(address);
+				if(memory_map_.is_io(address)) {
 					if((address&0xff00) == 0x9000)	result &= mos6560_->get_register(address);
-					if((address&0xfc10) == 0x9010)	result &= user_port_via_.get_register(address);
-					if((address&0xfc20) == 0x9020)	result &= keyboard_via_.get_register(address);
+					if(address & 0x30) {
+						c1540_.flush();
+						if((address&0xfc10) == 0x9010)	result &= user_port_via_->get_register(address);
+						if((address&0xfc20) == 0x9020)	result &= keyboard_via_->get_register(address);
+					}
 				}
 				*value = result;
 
@@ -569,12 +599,11 @@ class ConcreteMachine:
 							start_address = static_cast<uint16_t>(user_basic_memory_[0xc1] | (user_basic_memory_[0xc2] << 8));
 							end_address = static_cast<uint16_t>(user_basic_memory_[0xae] | (user_basic_memory_[0xaf] << 8));
 
-							// perform a via-processor_write_memory_map_ memcpy
+							// perform a via-memory_map_ memcpy
 							uint8_t *data_ptr = data->data.data();
 							std::size_t data_left = data->data.size();
 							while(data_left && start_address != end_address) {
-								uint8_t *page = processor_write_memory_map_[start_address >> 10];
-								if(page) page[start_address & 0x3ff] = *data_ptr;
+								memory_map_.write(start_address, *data_ptr);
 								data_ptr++;
 								start_address++;
 								data_left--;
@@ -594,17 +623,20 @@ class ConcreteMachine:
 					}
 				}
 			} else {
-				uint8_t *ram = processor_write_memory_map_[address >> 10];
-				if(ram) ram[address & 0x3ff] = *value;
-				if((address&0xfc00) == 0x9000) {
+				memory_map_.write(address, *value);
+				if(memory_map_.is_io(address)) {
 					if((address&0xff00) == 0x9000)	mos6560_->set_register(address, *value);
-					if((address&0xfc10) == 0x9010)	user_port_via_.set_register(address, *value);
-					if((address&0xfc20) == 0x9020)	keyboard_via_.set_register(address, *value);
+					if(address & 0x30) {
+						c1540_.flush();
+						if((address&0xfc10) == 0x9010)	user_port_via_->set_register(address, *value);
+						if((address&0xfc20) == 0x9020)	keyboard_via_->set_register(address, *value);
+					}
 				}
 			}
 
-			user_port_via_.run_for(Cycles(1));
-			keyboard_via_.run_for(Cycles(1));
+			// The VIAs are run only when next they might change of their own accord, or upon an access.
+			user_port_via_ += Cycles(1);
+			keyboard_via_ += Cycles(1);
 			if(typer_ && operation == CPU::MOS6502::BusOperation::ReadOpcode && address == 0xEB1E) {
 				if(!typer_->type_next_character()) {
 					clear_all_keys();
@@ -612,13 +644,26 @@ class ConcreteMachine:
 				}
 			}
 			tape_->run_for(Cycles(1));
-			if(c1540_) c1540_->run_for(Cycles(1));
+
+			// The Vic observes and alters the serial bus only via its VIAs, so the 1540 need be
+			// brought up to date only upon a VIA access. It may be running on another thread
+			// until then.
+			if(c1540_.last_valid()) c1540_ += Cycles(1);
 
 			return Cycles(1);
 		}
 
 		forceinline void flush() {
 			mos6560_->flush();
+			user_port_via_.flush();
+			keyboard_via_.flush();
+			c1540_.flush();
+
+			// The 1540 may be running on another thread, so its state is sampled only here, once it has caught up.
+			if(c1540_.last_valid()) {
+				drive_is_sleeping_ = c1540_.last_valid()->is_sleeping();
+				update_clock_is_unlimited();
+			}
 		}
 
 		void run_for(const Cycles cycles) override final {
@@ -649,8 +694,8 @@ class ConcreteMachine:
 		}
 
 		void mos6522_did_change_interrupt_status(void *mos6522) override final {
-			m6502_.set_nmi_line(user_port_via_.get_interrupt_line());
-			m6502_.set_irq_line(keyboard_via_.get_interrupt_line());
+			m6502_.set_nmi_line(user_port_via_.last_valid()->get_interrupt_line());
+			m6502_.set_irq_line(keyboard_via_.last_valid()->get_interrupt_line());
 		}
 
 		void set_typer_for_string(const char *string) override final {
@@ -659,7 +704,12 @@ class ConcreteMachine:
 		}
 
 		void tape_did_change_input(Storage::Tape::BinaryTapePlayer *tape) override final {
-			keyboard_via_.set_control_line_input(MOS::MOS6522::Port::A, MOS::MOS6522::Line::One, !tape->get_input());
+			keyboard_via_->set_control_line_input(MOS::MOS6522::Port::A, MOS::MOS6522::Line::One, !tape->get_input());
+		}
+
+		void set_component_is_sleeping(void *component, bool is_sleeping) override final {
+			tape_is_sleeping_ = is_sleeping;
+			update_clock_is_unlimited();
 		}
 
 		KeyboardMapper &get_keyboard_mapper() override {
@@ -676,22 +726,68 @@ class ConcreteMachine:
 			if(Configurable::get_quick_load_tape(selections_by_option, quickload)) {
 				set_use_fast_tape_hack(quickload);
 			}
+
+			auto parallel_drive = Configurable::selection<Configurable::BooleanSelection>(selections_by_option, "paralleldrive");
+			if(parallel_drive) {
+				c1540_.set_is_asynchronous(parallel_drive->value);
+			}
 		}
 
 		Configurable::SelectionSet get_accurate_selections() override {
 			Configurable::SelectionSet selection_set;
 			Configurable::append_quick_load_tape_selection(selection_set, false);
+			selection_set["paralleldrive"] = std::unique_ptr<Configurable::Selection>(new Configurable::BooleanSelection(false));
 			return selection_set;
 		}
 
 		Configurable::SelectionSet get_user_friendly_selections() override {
 			Configurable::SelectionSet selection_set;
 			Configurable::append_quick_load_tape_selection(selection_set, true);
+			selection_set["paralleldrive"] = std::unique_ptr<Configurable::Selection>(new Configurable::BooleanSelection(true));
 			return selection_set;
 		}
 
+	protected:
+		// to satisfy SnapshotMachine::Machine
+		void serialise(Snapshot::Archive &archive) override {
+			archive.tag(0x56696332);
+
+			// The memory map follows from the memory size and region, so it is rebuilt rather than recorded;
+			// that must happen before the 6560 is restored, as it also selects the 6560's output mode.
+			archive(memory_size_, region_, needs_configuration_);
+			if(archive.is_reading() && !needs_configuration_) configure_memory();
+
+			bool has_cartridge = rom_ != nullptr;
+			archive(has_cartridge);
+			if(has_cartridge != (rom_ != nullptr)) {
+				archive.set_invalid();
+				return;
+			}
+
+			m6502_.serialise(archive);
+			archive(expansion_ram_, user_basic_memory_, screen_memory_, colour_memory_);
+			mos6560_->serialise(archive);
+
+			user_port_via_->serialise(archive);
+			user_port_via_port_handler_->serialise(archive);
+			keyboard_via_->serialise(archive);
+			keyboard_via_port_handler_->serialise(archive);
+			serial_port_->serialise(archive);
+			serial_bus_->serialise(archive);
+			tape_->serialise(archive);
+
+			bool has_c1540 = !!c1540_.last_valid();
+			archive(has_c1540);
+			if(has_c1540 != !!c1540_.last_valid()) {
+				archive.set_invalid();
+				return;
+			}
+			if(has_c1540) c1540_->serialise(archive);
+		}
+
 	private:
 		CPU::MOS6502::Processor<ConcreteMachine, false> m6502_;
+		Memory::MemoryMap<10> memory_map_;
 
 		std::vector<uint8_t>  roms_[9];
 
@@ -709,8 +805,6 @@ class ConcreteMachine:
 
 		std::function<std::vector<std::unique_ptr<std::vector<uint8_t>>>(const std::string &machine, const std::vector<std::string> &names)> rom_fetcher_;
 
-		uint8_t *processor_read_memory_map_[64];
-		uint8_t *processor_write_memory_map_[64];
 		void write_to_map(uint8_t **map, uint8_t *area, uint16_t address, uint16_t length) {
 			address >>= 10;
 			length >>= 10;
@@ -734,16 +828,23 @@ class ConcreteMachine:
 		std::shared_ptr<SerialPort> serial_port_;
 		std::shared_ptr<::Commodore::Serial::Bus> serial_bus_;
 
-		MOS::MOS6522::MOS6522<UserPortVIA> user_port_via_;
-		MOS::MOS6522::MOS6522<KeyboardVIA> keyboard_via_;
+		SequencedJustInTimeActor<MOS::MOS6522::MOS6522<UserPortVIA>> user_port_via_;
+		SequencedJustInTimeActor<MOS::MOS6522::MOS6522<KeyboardVIA>> keyboard_via_;
 
 		// Tape
 		std::shared_ptr<Storage::Tape::BinaryTapePlayer> tape_;
 		bool use_fast_tape_hack_;
 		bool is_running_at_zero_cost_ = false;
+		bool tape_is_sleeping_ = true;
 
 		// Disk
-		std::shared_ptr<::Commodore::C1540::Machine> c1540_;
+		AsyncJustInTimeActor<std::shared_ptr<::Commodore::C1540::Machine>> c1540_;
+		bool drive_is_sleeping_ = true;
+
+		// The machine may be run as quickly as possible while the tape is playing or the disk drive is in use.
+		void update_clock_is_unlimited() {
+			set_clock_is_unlimited(!tape_is_sleeping_ || !drive_is_sleeping_);
+		}
 };
 
 }
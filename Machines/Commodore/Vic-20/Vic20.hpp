@@ -14,6 +14,7 @@
 #include "../../CRTMachine.hpp"
 #include "../../KeyboardMachine.hpp"
 #include "../../JoystickMachine.hpp"
+#include "../../SnapshotMachine.hpp"
 
 namespace Commodore {
 namespace Vic20 {
@@ -40,7 +41,8 @@ class Machine:
 	public ConfigurationTarget::Machine,
 	public KeyboardMachine::Machine,
 	public JoystickMachine::Machine,
-	public Configurable::Device {
+	public Configurable::Device,
+	public SnapshotMachine::Machine {
 	public:
 		virtual ~Machine();
 
@@ -13,7 +13,9 @@
 #include "../../Storage/Tape/Tape.hpp"
 #include "../../ClockReceiver/ClockReceiver.hpp"
 #include "../../ClockReceiver/ForceInline.hpp"
+#include "../../ClockReceiver/JustInTime.hpp"
 
+#include "../Utility/MemoryMap.hpp"
 #include "../Utility/Typer.hpp"
 
 #include "Interrupts.hpp"
@@ -35,14 +37,17 @@ class ConcreteMachine:
 	public Machine,
 	public CPU::MOS6502::BusHandler,
 	public Tape::Delegate,
+	public Sleeper::SleepObserver,
 	public Utility::TypeRecipient {
 	public:
 		ConcreteMachine() : m6502_(*this) {
 			memset(key_states_, 0, sizeof(key_states_));
 			for(int c = 0; c < 16; c++)
 				memset(roms_[c], 0xff, 16384);
+			update_memory_map();
 
 			tape_.set_delegate(this);
+			tape_.set_sleep_observer(this);
 			set_clock_rate(2000000);
 		}
 
@@ -61,6 +66,7 @@ class ConcreteMachine:
 			}
 
 			std::memcpy(target, &data[0], std::min(static_cast<std::size_t>(16384), data.size()));
+			update_memory_map();
 		}
 
 		// Obtains the system ROMs.
@@ -105,6 +111,7 @@ class ConcreteMachine:
 
 		void set_use_fast_tape_hack(bool activate) {
 			use_fast_tape_hack_ = activate;
+			update_memory_map();
 		}
 
 		void configure_as_target(const StaticAnalyser::Target &target) override final {
@@ -118,6 +125,7 @@ class ConcreteMachine:
 
 			if(target.acorn.has_dfs || target.acorn.has_adfs) {
 				plus3_.reset(new Plus3);
+				plus3_->set_sleep_observer(this);
 
 				if(target.acorn.has_dfs) {
 					set_rom(ROMSlot0, dfs_, true);
@@ -156,13 +164,19 @@ class ConcreteMachine:
 				if(isReadOperation(operation)) {
 					*value = ram_[address];
 				} else {
-					if(address >= video_access_range_.low_address && address <= video_access_range_.high_address) update_display();
+					if(address >= video_access_range_.low_address && address <= video_access_range_.high_address) video_output_.flush();
 					ram_[address] = *value;
 				}
 
 				// for the entire frame, RAM is accessible only on odd cycles; in modes below 4
 				// it's also accessible only outside of the pixel regions
-				cycles += video_output_->get_cycles_until_next_ram_availability(cycles_since_display_update_.as_int() + 1);
+				cycles += video_output_.last_valid()->get_cycles_until_next_ram_availability(video_output_.time_since_update().as_int() + 1);
+			} else if(!memory_map_.is_io(address)) {
+				if(isReadOperation(operation)) {
+					*value = memory_map_.read(address);
+				} else {
+					memory_map_.write(address, *value);
+				}
 			} else {
 				switch(address & 0xff0f) {
 					case 0xfe00:
@@ -179,7 +193,6 @@ class ConcreteMachine:
 							// update speaker mode
 							bool new_speaker_is_enabled = (*value & 6) == 2;
 							if(new_speaker_is_enabled != speaker_is_enabled_) {
-								update_audio();
 								speaker_->set_is_enabled(new_speaker_is_enabled);
 								speaker_is_enabled_ = new_speaker_is_enabled;
 							}
@@ -196,7 +209,6 @@ class ConcreteMachine:
 					case 0xfe08: case 0xfe09: case 0xfe0a: case 0xfe0b:
 					case 0xfe0c: case 0xfe0d: case 0xfe0e: case 0xfe0f:
 						if(!isReadOperation(operation)) {
-							update_display();
 							video_output_->set_register(address, *value);
 							video_access_range_ = video_output_->get_memory_access_range();
 							queue_next_display_interrupt();
@@ -236,11 +248,11 @@ class ConcreteMachine:
 									basic_is_active_ = !keyboard_is_active_;
 								}
 							}
+							update_memory_map();
 						}
 					break;
 					case 0xfe06:
 						if(!isReadOperation(operation)) {
-							update_audio();
 							speaker_->set_divider(*value);
 							tape_.set_counter(*value);
 						}
@@ -342,15 +354,15 @@ class ConcreteMachine:
 				}
 			}
 
-			cycles_since_display_update_ += Cycles(static_cast<int>(cycles));
-			cycles_since_audio_update_ += Cycles(static_cast<int>(cycles));
-			if(cycles_since_audio_update_ > Cycles(16384)) update_audio();
+			video_output_ += Cycles(static_cast<int>(cycles));
+			speaker_ += Cycles(static_cast<int>(cycles));
+			if(speaker_.time_since_update() > Cycles(16384)) speaker_.flush();
 			tape_.run_for(Cycles(static_cast<int>(cycles)));
 
 			cycles_until_display_interrupt_ -= cycles;
 			if(cycles_until_display_interrupt_ < 0) {
 				signal_interrupt(next_display_interrupt_);
-				update_display();
+				video_output_.flush();
 				queue_next_display_interrupt();
 			}
 
@@ -370,31 +382,30 @@ class ConcreteMachine:
 		}
 
 		forceinline void flush() {
-			update_display();
-			update_audio();
+			video_output_.flush();
 			speaker_->flush();
 		}
 
 		void setup_output(float aspect_ratio) override final {
-			video_output_.reset(new VideoOutput(ram_));
+			video_output_.object().reset(new VideoOutput(ram_));
 
 			// The maximum output frequency is 62500Hz and all other permitted output frequencies are integral divisions of that;
 			// however setting the speaker on or off can happen on any 2Mhz cycle, and probably (?) takes effect immediately. So
 			// run the speaker at a 2000000Hz input rate, at least for the time being.
-			speaker_.reset(new Speaker);
+			speaker_.object().reset(new Speaker);
 			speaker_->set_input_rate(2000000 / Speaker::clock_rate_divider);
 		}
 
 		void close_output() override final {
-			video_output_.reset();
+			video_output_.object().reset();
 		}
 
 		std::shared_ptr<Outputs::CRT::CRT> get_crt() override final {
-			return video_output_->get_crt();
+			return video_output_.last_valid()->get_crt();
 		}
 
 		std::shared_ptr<Outputs::Speaker> get_speaker() override final {
-			return speaker_;
+			return speaker_.object();
 		}
 
 		void run_for(const Cycles cycles) override final {
@@ -406,6 +417,11 @@ class ConcreteMachine:
 			evaluate_interrupts();
 		}
 
+		void set_component_is_sleeping(void *component, bool is_sleeping) override final {
+			// The machine may be run as quickly as possible while the tape is being read or a disk drive is in use.
+			set_clock_is_unlimited(!tape_.is_sleeping() || (plus3_ && !plus3_->is_sleeping()));
+		}
+
 		HalfCycles get_typer_delay() override final {
 			return m6502_.get_is_resetting() ? Cycles(625*25*128) : Cycles(0);	// wait one second if resetting
 		}
@@ -454,26 +470,69 @@ class ConcreteMachine:
 			return selection_set;
 		}
 
+	protected:
+		// MARK: - SnapshotMachine::Machine.
+		void serialise(Snapshot::Archive &archive) override {
+			archive.tag(0x456c6b20);
+			m6502_.serialise(archive);
+
+			// Of the sideways slots, only those that are writeable need be captured.
+			archive(ram_, rom_write_masks_);
+			for(int c = 0; c < 16; c++) {
+				if(rom_write_masks_[c]) archive(roms_[c]);
+			}
+
+			archive(active_rom_, keyboard_is_active_, basic_is_active_);
+			if(archive.is_reading()) update_memory_map();
+			archive(interrupt_status_, interrupt_control_, key_states_);
+			video_output_.serialise_backlog(archive);
+			speaker_.serialise_backlog(archive);
+			archive(cycles_until_display_interrupt_, next_display_interrupt_, video_access_range_);
+			archive(fast_load_is_in_data_, is_holding_shift_, shift_restart_counter_, speaker_is_enabled_);
+
+			video_output_.last_valid()->serialise(archive);
+			speaker_.last_valid()->serialise(archive);
+			tape_.serialise(archive);
+
+			bool has_plus3 = !!plus3_;
+			archive(has_plus3);
+			if(has_plus3 != !!plus3_) {
+				archive.set_invalid();
+				return;
+			}
+			if(plus3_) plus3_->serialise(archive);
+		}
+
 	private:
-		// MARK: - Work deferral updates.
-		inline void update_display() {
-			if(cycles_since_display_update_ > 0) {
-				video_output_->run_for(cycles_since_display_update_.flush());
+		// MARK: - Paging.
+
+		/*!
+			Maps the paged and OS ROMs into the upper 32kb. Pages on which accesses are more than a plain read or
+			write are marked as I/O: the ULA and expansion registers, the paged ROM while the ULA's keyboard or
+			BASIC tests are active, and the OS entry points that the fast tape hack intercepts.
+		*/
+		void update_memory_map() {
+			memory_map_.clear();
+
+			memory_map_.map_read(roms_[active_rom_], 0x8000, 16384);
+			if(rom_write_masks_[active_rom_]) memory_map_.map_write(roms_[active_rom_], 0x8000, 16384);
+			if(keyboard_is_active_ || basic_is_active_) memory_map_.set_io(0x8000, 16384);
+
+			memory_map_.map_read(os_, 0xc000, 16384);
+			memory_map_.set_io(0xfc00, 256);
+			memory_map_.set_io(0xfe00, 256);
+			if(use_fast_tape_hack_) {
+				for(uint16_t address: {0xf0a8, 0xf4e5, 0xf6de, 0xf6fa, 0xfa51}) memory_map_.set_io(address, 2);
 			}
 		}
 
+		// MARK: - Work deferral updates.
 		inline void queue_next_display_interrupt() {
-			VideoOutput::Interrupt next_interrupt = video_output_->get_next_interrupt();
+			VideoOutput::Interrupt next_interrupt = video_output_.last_valid()->get_next_interrupt();
 			cycles_until_display_interrupt_ = next_interrupt.cycles;
 			next_display_interrupt_ = next_interrupt.interrupt;
 		}
 
-		inline void update_audio() {
-			if(cycles_since_audio_update_ > 0) {
-				speaker_->run_for(cycles_since_audio_update_.divide(Cycles(Speaker::clock_rate_divider)));
-			}
-		}
-
 		inline void signal_interrupt(Interrupt interrupt) {
 			interrupt_status_ |= interrupt;
 			evaluate_interrupts();
@@ -500,6 +559,7 @@ class ConcreteMachine:
 		bool rom_write_masks_[16] = {false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false};
 		uint8_t os_[16384], ram_[32768];
 		std::vector<uint8_t> dfs_, adfs1_, adfs2_;
+		Memory::MemoryMap<8> memory_map_;
 
 		// Paging
 		ROMSlot active_rom_ = ROMSlot::ROMSlot0;
@@ -513,8 +573,6 @@ class ConcreteMachine:
 		Electron::KeyboardMapper keyboard_mapper_;
 
 		// Counters related to simultaneous subsystems
-		Cycles cycles_since_display_update_ = 0;
-		Cycles cycles_since_audio_update_ = 0;
 		int cycles_until_display_interrupt_ = 0;
 		Interrupt next_display_interrupt_ = Interrupt::RealTimeClock;
 		VideoOutput::Range video_access_range_ = {0, 0xffff};
@@ -530,8 +588,8 @@ class ConcreteMachine:
 		int shift_restart_counter_ = 0;
 
 		// Outputs
-		std::unique_ptr<VideoOutput> video_output_;
-		std::shared_ptr<Speaker> speaker_;
+		JustInTimeActor<std::unique_ptr<VideoOutput>> video_output_;
+		JustInTimeActor<std::shared_ptr<Speaker>, Cycles, Speaker::clock_rate_divider> speaker_;
 		bool speaker_is_enabled_ = false;
 };
 
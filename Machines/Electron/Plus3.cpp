@@ -53,3 +53,24 @@ void Plus3::set_motor_on(bool on) {
 	// writing state, so plenty of work to do in general here.
 	get_drive().set_motor_on(on);
 }
+
+void Plus3::serialise(Snapshot::Archive &archive) {
+	WD1770::serialise(archive);
+	archive(selected_drive_, last_control_);
+
+	// Drives exist only once a disk has been inserted; it is assumed that a snapshot is applied only
+	// to a machine with the same disks as the machine it was taken from.
+	for(auto &drive: drives_) {
+		bool has_drive = !!drive;
+		archive(has_drive);
+		if(has_drive != !!drive) {
+			archive.set_invalid();
+			return;
+		}
+		if(drive) drive->serialise(archive);
+	}
+
+	if(archive.is_reading()) {
+		set_drive((selected_drive_ >= 0) ? drives_[selected_drive_] : nullptr);
+	}
+}
@@ -20,6 +20,9 @@ class Plus3 : public WD::WD1770 {
 		void set_disk(std::shared_ptr<Storage::Disk::Disk> disk, int drive);
 		void set_control_register(uint8_t control);
 
+		/// Extends WD1770::serialise with the state of the Plus 3's drives and control register.
+		void serialise(Snapshot::Archive &archive);
+
 	private:
 		void set_control_register(uint8_t control, uint8_t changes);
 		std::shared_ptr<Storage::Disk::Drive> drives_[2];
@@ -27,14 +27,28 @@ void Speaker::skip_samples(unsigned int number_of_samples) {
 }
 
 void Speaker::set_divider(uint8_t divider) {
-	enqueue([=]() {
-		divider_ = divider * 32 / clock_rate_divider;
-	});
+	enqueue_register_write(Divider, divider);
 }
 
 void Speaker::set_is_enabled(bool is_enabled) {
-	enqueue([=]() {
-		is_enabled_ = is_enabled;
-		counter_ = 0;
-	});
+	enqueue_register_write(IsEnabled, is_enabled ? 1 : 0);
+}
+
+void Speaker::apply_register_write(int address, uint8_t value) {
+	switch(address) {
+		case Divider:
+			divider_ = value * 32 / clock_rate_divider;
+		break;
+
+		case IsEnabled:
+			is_enabled_ = !!value;
+			counter_ = 0;
+		break;
+	}
+}
+
+void Speaker::serialise(Snapshot::Archive &archive) {
+	synchronise();
+	archive.tag(0x736e6420);
+	archive(counter_, divider_, is_enabled_);
 }
@@ -10,6 +10,7 @@
 #define Electron_Speaker_hpp
 
 #include "../../Outputs/Speaker.hpp"
+#include "../../Snapshot/Snapshot.hpp"
 
 namespace Electron {
 
@@ -21,10 +22,17 @@ class Speaker: public ::Outputs::Filter<Speaker> {
 
 		void get_samples(unsigned int number_of_samples, int16_t *target);
 		void skip_samples(unsigned int number_of_samples);
+		void apply_register_write(int address, uint8_t value);
+
+		void serialise(Snapshot::Archive &archive);
 
 		static const unsigned int clock_rate_divider = 8;
 
 	private:
+		enum Register {
+			Divider, IsEnabled
+		};
+
 		unsigned int counter_ = 0;
 		unsigned int divider_ = 0;
 		bool is_enabled_ = false;
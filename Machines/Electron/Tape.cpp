@@ -47,8 +47,26 @@ void Tape::clear_interrupts(uint8_t interrupts) {
 	evaluate_interrupts();
 }
 
+void Tape::set_is_running(bool is_running) {
+	if(is_running_ == is_running) return;
+	is_running_ = is_running;
+	update_sleep_observer();
+}
+
+void Tape::set_is_enabled(bool is_enabled) {
+	if(is_enabled_ == is_enabled) return;
+	is_enabled_ = is_enabled;
+	update_sleep_observer();
+}
+
 void Tape::set_is_in_input_mode(bool is_in_input_mode) {
+	if(is_in_input_mode_ == is_in_input_mode) return;
 	is_in_input_mode_ = is_in_input_mode;
+	update_sleep_observer();
+}
+
+bool Tape::is_sleeping() {
+	return !(is_enabled_ && is_in_input_mode_ && is_running_) || TapePlayer::is_sleeping();
 }
 
 void Tape::set_counter(uint8_t value) {
@@ -88,3 +106,11 @@ void Tape::run_for(const Cycles cycles) {
 		}
 	}
 }
+
+void Tape::serialise(Snapshot::Archive &archive) {
+	TapePlayer::serialise(archive);
+	archive(input_, output_, is_running_, is_enabled_, is_in_input_mode_);
+	archive(data_register_, interrupt_status_, last_posted_interrupt_status_);
+	shifter_.serialise(archive);
+	if(archive.is_reading()) update_sleep_observer();
+}
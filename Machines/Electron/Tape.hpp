@@ -40,12 +40,18 @@ class Tape:
 		};
 		inline void set_delegate(Delegate *delegate) { delegate_ = delegate; }
 
-		inline void set_is_running(bool is_running) { is_running_ = is_running; }
-		inline void set_is_enabled(bool is_enabled) { is_enabled_ = is_enabled; }
+		void set_is_running(bool is_running);
+		void set_is_enabled(bool is_enabled);
 		void set_is_in_input_mode(bool is_in_input_mode);
 
+		/// Extends TapePlayer::is_sleeping to sleep also while the tape isn't being read.
+		bool is_sleeping();
+
 		void acorn_shifter_output_bit(int value);
 
+		/// Extends TapePlayer::serialise with the state of the ULA's cassette interface.
+		void serialise(Snapshot::Archive &archive);
+
 	private:
 		void process_input_pulse(const Storage::Tape::Tape::Pulse &pulse);
 		inline void push_tape_bit(uint16_t bit);
@@ -58,6 +58,12 @@ VideoOutput::VideoOutput(uint8_t *memory) : ram_(memory) {
 			"texValue >>= 4 - (int(icoordinate.x * 8) & 4);"
 			"return vec3( uvec3(texValue) & uvec3(4u, 2u, 1u));"
 		"}");
+	crt_->set_software_rgb_sampling_function([] (const uint8_t *sample, float x, float *rgb) {
+		const int value = sample[0] >> (4 - (static_cast<int>(x * 8.0f) & 4));
+		rgb[0] = (value & 4) ? 1.0f : 0.0f;
+		rgb[1] = (value & 2) ? 1.0f : 0.0f;
+		rgb[2] = (value & 1) ? 1.0f : 0.0f;
+	});
 	std::unique_ptr<Outputs::CRT::TextureBuilder::Bookender> bookender(new FourBPPBookender);
 	crt_->set_bookender(std::move(bookender));
 	// TODO: as implied below, I've introduced a clock's latency into the graphics pipeline somehow. Investigate.
@@ -476,3 +482,21 @@ void VideoOutput::emplace_pixel_line() {
 	screen_map_.emplace_back(DrawAction::Pixels, 80);
 	screen_map_.emplace_back(DrawAction::Blank, 48 - first_graphics_cycle);
 }
+
+// MARK: - Snapshots
+
+void VideoOutput::serialise(Snapshot::Archive &archive) {
+	archive.tag(0x76696465);
+	archive(output_position_, unused_cycles_, palette_, screen_mode_, screen_mode_base_address_, start_screen_address_);
+	archive(palette_tables_);
+	archive(start_line_address_, current_screen_address_, current_pixel_line_, current_pixel_column_, current_character_row_);
+	archive(last_pixel_byte_, is_blank_line_, current_output_divider_, screen_map_pointer_, cycles_into_draw_action_);
+
+	if(archive.is_reading()) {
+		initial_output_target_ = current_output_target_ = nullptr;
+		if(screen_map_pointer_ >= screen_map_.size()) {
+			screen_map_pointer_ = 0;
+			archive.set_invalid();
+		}
+	}
+}
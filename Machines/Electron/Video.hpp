@@ -11,6 +11,7 @@
 
 #include "../../Outputs/CRT/CRT.hpp"
 #include "../../ClockReceiver/ClockReceiver.hpp"
+#include "../../Snapshot/Snapshot.hpp"
 #include "Interrupts.hpp"
 
 namespace Electron {
@@ -74,6 +75,12 @@ class VideoOutput {
 		*/
 		Range get_memory_access_range();
 
+		/*!
+			Captures or restores the video registers and the position of output. Pixels of the line in
+			progress at restoration that precede the point of restoration are not drawn.
+		*/
+		void serialise(Snapshot::Archive &archive);
+
 	private:
 		inline void start_pixel_line();
 		inline void end_pixel_line();
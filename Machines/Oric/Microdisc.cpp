@@ -76,6 +76,25 @@ void Microdisc::set_control_register(uint8_t control, uint8_t changes) {
 	}
 }
 
+void Microdisc::serialise(Snapshot::Archive &archive) {
+	WD1770::serialise(archive);
+	archive(selected_drive_, irq_enable_, paging_flags_, head_load_request_counter_, last_control_);
+
+	// Drives exist only once a disk has been inserted; it is assumed that a snapshot is applied only
+	// to a machine with the same disks as the machine it was taken from.
+	for(auto &drive: drives_) {
+		bool has_drive = !!drive;
+		archive(has_drive);
+		if(has_drive != !!drive) {
+			archive.set_invalid();
+			return;
+		}
+		if(drive) drive->serialise(archive);
+	}
+
+	if(archive.is_reading()) set_drive(drives_[selected_drive_ & 3]);
+}
+
 bool Microdisc::get_interrupt_request_line() {
 	return irq_enable_ && WD1770::get_interrupt_request_line();
 }
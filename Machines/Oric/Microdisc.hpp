@@ -39,6 +39,9 @@ class Microdisc: public WD::WD1770 {
 		inline void set_delegate(Delegate *delegate)	{	delegate_ = delegate;	WD1770::set_delegate(delegate);	}
 		inline int get_paging_flags()					{	return paging_flags_;									}
 
+		/// Extends WD1770::serialise with the state of the Microdisc's drives and control register.
+		void serialise(Snapshot::Archive &archive);
+
 	private:
 		void set_control_register(uint8_t control, uint8_t changes);
 		void set_head_load_request(bool head_load);
@@ -13,6 +13,7 @@
 #include "Video.hpp"
 
 #include "../Utility/MemoryFuzzer.hpp"
+#include "../Utility/MemoryMap.hpp"
 #include "../Utility/Typer.hpp"
 
 #include "../../Processors/6502/6502.hpp"
@@ -78,6 +79,11 @@ class Keyboard {
 			return !!(rows_[row_] & column_mask);
 		}
 
+		/// Captures or restores the active row and the state of all keys.
+		void serialise(Snapshot::Archive &archive) {
+			archive(row_, rows_);
+		}
+
 	private:
 		uint8_t row_ = 0;
 		uint8_t rows_[8];
@@ -171,6 +177,11 @@ class VIAPortHandler: public MOS::MOS6522::IRQDelegatePortHandler {
 			ay8910_ = ay;
 		}
 
+		/// Captures or restores the AY's control lines, as most recently output by the VIA, and the AY's backlog.
+		void serialise(Snapshot::Archive &archive) {
+			archive(ay_bdir_, ay_bc1_, cycles_since_ay_update_);
+		}
+
 	private:
 		void update_ay() {
 			ay8910_->run_for(cycles_since_ay_update_.flush());
@@ -190,6 +201,7 @@ class ConcreteMachine:
 	public Utility::TypeRecipient,
 	public Storage::Tape::BinaryTapePlayer::Delegate,
 	public Microdisc::Delegate,
+	public Sleeper::SleepObserver,
 	public Machine {
 
 	public:
@@ -201,7 +213,9 @@ class ConcreteMachine:
 			set_clock_rate(1000000);
 			via_port_handler_.set_interrupt_delegate(this);
 			tape_player_.set_delegate(this);
+			tape_player_.set_sleep_observer(this);
 			Memory::Fuzz(ram_, sizeof(ram_));
+			update_memory_map();
 		}
 
 		// Obtains the system ROMs.
@@ -246,6 +260,7 @@ class ConcreteMachine:
 
 		void set_use_fast_tape_hack(bool activate) {
 			use_fast_tape_hack_ = activate;
+			update_memory_map();
 		}
 
 		void set_output_device(Outputs::CRT::OutputDevice output_device) {
@@ -258,6 +273,7 @@ class ConcreteMachine:
 				microdisc_is_enabled_ = true;
 				microdisc_did_change_paging_flags(&microdisc_);
 				microdisc_.set_delegate(this);
+				microdisc_.set_sleep_observer(this);
 			}
 
 			if(target.loadingCommand.length()) {
@@ -279,6 +295,7 @@ class ConcreteMachine:
 				scan_keyboard_address_ = 0xf43c;
 				tape_speed_address_ = 0x67;
 			}
+			update_memory_map();
 
 			insert_media(target.media);
 		}
@@ -299,7 +316,10 @@ class ConcreteMachine:
 
 		// to satisfy CPU::MOS6502::BusHandler
 		forceinline Cycles perform_bus_operation(CPU::MOS6502::BusOperation operation, uint16_t address, uint8_t *value) {
-			if(address > ram_top_) {
+			if(!memory_map_.is_io(address)) {
+				if(isReadOperation(operation)) *value = memory_map_.read(address);
+				else memory_map_.write(address, *value);
+			} else if(address > ram_top_) {
 				if(isReadOperation(operation)) *value = paged_rom_[address - ram_top_ - 1];
 
 				// 024D = 0 => fast; otherwise slow
@@ -409,6 +429,11 @@ class ConcreteMachine:
 			via_.set_control_line_input(MOS::MOS6522::Port::B, MOS::MOS6522::Line::One, !tape_player->get_input());
 		}
 
+		// to satisfy Sleeper::SleepObserver; the machine may be run as quickly as possible while the tape is playing or a disk drive is in use
+		void set_component_is_sleeping(void *component, bool is_sleeping) override final {
+			set_clock_is_unlimited(!tape_player_.is_sleeping() || (microdisc_is_enabled_ && !microdisc_.is_sleeping()));
+		}
+
 		// for Utility::TypeRecipient::Delegate
 		void set_typer_for_string(const char *string) override final {
 			std::unique_ptr<CharacterMapper> mapper(new CharacterMapper);
@@ -429,6 +454,7 @@ class ConcreteMachine:
 					paged_rom_ = microdisc_rom_.data();
 				}
 			}
+			update_memory_map();
 		}
 
 		void wd1770_did_change_output(WD::WD1770 *wd1770) override final {
@@ -470,6 +496,38 @@ class ConcreteMachine:
 			return selection_set;
 		}
 
+	protected:
+		// to satisfy SnapshotMachine::Machine
+		void serialise(Snapshot::Archive &archive) override {
+			archive.tag(0x4f726963);
+			m6502_.serialise(archive);
+
+			archive(ram_, cycles_since_video_update_, keyboard_read_count_);
+			video_output_->serialise(archive);
+			ay8910_->serialise(archive);
+			via_.serialise(archive);
+			via_port_handler_.serialise(archive);
+			keyboard_.serialise(archive);
+			tape_player_.serialise(archive);
+
+			bool microdisc_is_enabled = microdisc_is_enabled_;
+			archive(microdisc_is_enabled);
+			if(microdisc_is_enabled != microdisc_is_enabled_) {
+				archive.set_invalid();
+				return;
+			}
+
+			// Paging is recorded as the top of RAM plus whether the ROM above it is the Microdisc's.
+			bool is_microdisc_rom_paged = paged_rom_ != rom_;
+			archive(ram_top_, is_microdisc_rom_paged);
+			if(archive.is_reading()) {
+				if(is_microdisc_rom_paged && microdisc_rom_.empty()) archive.set_invalid();
+				paged_rom_ = (is_microdisc_rom_paged && !microdisc_rom_.empty()) ? microdisc_rom_.data() : rom_;
+				update_memory_map();
+			}
+			if(microdisc_is_enabled_) microdisc_.serialise(archive);
+		}
+
 	private:
 		CPU::MOS6502::Processor<ConcreteMachine, false> m6502_;
 
@@ -507,6 +565,21 @@ class ConcreteMachine:
 		uint16_t ram_top_ = 0xbfff;
 		uint8_t *paged_rom_;
 
+		// Paging, as above, is applied through a memory map; I/O pages are those with side effects: the VIA and
+		// Microdisc registers, video RAM, to which writes must first bring the video up to date, and the ROM
+		// routine that the fast tape hack intercepts.
+		Memory::MemoryMap<8> memory_map_;
+		void update_memory_map() {
+			memory_map_.clear();
+			memory_map_.map_read(ram_, 0x0000, ram_top_ + 1);
+			memory_map_.map_write(ram_, 0x0000, ram_top_ + 1);
+			if(ram_top_ != 0xffff) memory_map_.map_read(paged_rom_, static_cast<uint16_t>(ram_top_ + 1), 0xffff - ram_top_);
+
+			memory_map_.set_io(0x0300, 256);
+			memory_map_.set_io(0x9800, 0x2801);
+			if(use_fast_tape_hack_) memory_map_.set_io(tape_get_byte_address_, 1);
+		}
+
 		inline void set_interrupt_line() {
 			m6502_.set_irq_line(
 				via_.get_interrupt_line() ||
@@ -39,6 +39,16 @@ VideoOutput::VideoOutput(uint8_t *memory) :
 			"return (float(texValue) - 4.0) / 20.0;"
 		"}"
 	);
+	crt_->set_software_rgb_sampling_function([] (const uint8_t *sample, float x, float *rgb) {
+		rgb[0] = (sample[0] & 4) ? 1.0f : 0.0f;
+		rgb[1] = (sample[0] & 2) ? 1.0f : 0.0f;
+		rgb[2] = (sample[0] & 1) ? 1.0f : 0.0f;
+	});
+	crt_->set_software_composite_sampling_function([] (const uint8_t *sample, float x, float phase, float amplitude) {
+		const unsigned int value = static_cast<unsigned int>(sample[0] | (sample[1] << 8));
+		const unsigned int phase_index = static_cast<unsigned int>((phase + 3.141592654f + 0.39269908175f) * 2.0f / 3.141592654f) & 3;
+		return (static_cast<float>((value >> (4*(3 - phase_index))) & 15) - 4.0f) / 20.0f;
+	});
 	crt_->set_composite_function_type(Outputs::CRT::CRT::CompositeSourceType::DiscreteFourSamplesPerCycle, 0.0f);
 
 	set_output_device(Outputs::CRT::OutputDevice::Television);
@@ -222,3 +232,11 @@ void VideoOutput::set_character_set_base_address() {
 	if(is_graphics_mode_) character_set_base_address_ = use_alternative_character_set_ ? 0x9c00 : 0x9800;
 	else character_set_base_address_ = use_alternative_character_set_ ? 0xb800 : 0xb400;
 }
+
+void VideoOutput::serialise(Snapshot::Archive &archive) {
+	archive.tag(0x76696465);
+	archive(counter_, frame_counter_, v_sync_start_position_, v_sync_end_position_, counter_period_);
+	archive(ink_, paper_, character_set_base_address_);
+	archive(is_graphics_mode_, next_frame_is_sixty_hertz_, use_alternative_character_set_, use_double_height_characters_, blink_text_);
+	if(archive.is_reading()) pixel_target_ = nullptr;
+}
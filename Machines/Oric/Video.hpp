@@ -11,6 +11,7 @@
 
 #include "../../Outputs/CRT/CRT.hpp"
 #include "../../ClockReceiver/ClockReceiver.hpp"
+#include "../../Snapshot/Snapshot.hpp"
 
 namespace Oric {
 
@@ -22,6 +23,12 @@ class VideoOutput {
 		void set_colour_rom(const std::vector<uint8_t> &rom);
 		void set_output_device(Outputs::CRT::OutputDevice output_device);
 
+		/*!
+			Captures or restores the video registers and counters. The output device is a matter of
+			configuration, so is not included; any line in progress at restoration is not drawn.
+		*/
+		void serialise(Snapshot::Archive &archive);
+
 	private:
 		uint8_t *ram_;
 		std::shared_ptr<Outputs::CRT::CRT> crt_;
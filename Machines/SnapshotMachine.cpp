@@ -0,0 +1,31 @@
+//
+//  SnapshotMachine.cpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 26/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#include "SnapshotMachine.hpp"
+
+using namespace SnapshotMachine;
+
+std::vector<uint8_t> Machine::get_snapshot() {
+	Snapshot::Archive archive;
+	serialise(archive);
+	return std::move(archive.get_data());
+}
+
+bool Machine::set_snapshot(const std::vector<uint8_t> &snapshot) {
+	// A snapshot may be found to be unacceptable only part of the way through, so keep the
+	// current state in order to be able to return to it.
+	const std::vector<uint8_t> backup = get_snapshot();
+
+	Snapshot::Archive archive(snapshot);
+	serialise(archive);
+	if(archive.is_valid() && archive.is_at_end()) return true;
+
+	Snapshot::Archive restorer(backup);
+	serialise(restorer);
+	return false;
+}
@@ -0,0 +1,52 @@
+//
+//  SnapshotMachine.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 26/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#ifndef SnapshotMachine_hpp
+#define SnapshotMachine_hpp
+
+#include "../Snapshot/Snapshot.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace SnapshotMachine {
+
+/*!
+	A SnapshotMachine::Machine is anything that can capture its complete emulated state, and later
+	return to it. So a machine can be forked: e.g. many instances can be started from a single
+	snapshot taken once booting is complete.
+
+	A snapshot covers the processor, all other chips, RAM and any media positions, but not the
+	contents of media, which it is assumed the machine accepting the snapshot will already have
+	inserted, nor the state of video or audio output. Output should have been set up before either
+	method is used.
+*/
+class Machine {
+	public:
+		/// @returns A snapshot of the machine's current state.
+		std::vector<uint8_t> get_snapshot();
+
+		/*!
+			Returns the machine to the state captured in @c snapshot, which should have been obtained from an
+			identically-configured machine.
+
+			@returns @c true if the snapshot was applied; @c false if it was unacceptable, in which case
+				the machine's state is unchanged.
+		*/
+		bool set_snapshot(const std::vector<uint8_t> &snapshot);
+
+	protected:
+		/*!
+			Should be implemented by machines; captures or restores, as per @c archive, all machine state.
+		*/
+		virtual void serialise(Snapshot::Archive &archive) = 0;
+};
+
+}
+
+#endif /* SnapshotMachine_hpp */
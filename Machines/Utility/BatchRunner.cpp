@@ -0,0 +1,137 @@
+//
+//  BatchRunner.cpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 25/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#include "BatchRunner.hpp"
+
+#include <algorithm>
+
+using namespace Machine;
+
+BatchRunner::BatchRunner(Concurrency::ThreadPool &pool) : pool_(pool) {}
+
+BatchRunner::~BatchRunner() {
+	// Machines are destroyed first, each along with its speaker, so that no audio is still being
+	// announced to the instance that owns it.
+	for(auto &instance: instances_) {
+		instance->machine.reset();
+	}
+}
+
+std::size_t BatchRunner::add_machine(DynamicMachine *machine, int audio_rate) {
+	std::unique_ptr<Instance> instance(new Instance);
+	instance->runner = this;
+	instance->machine.reset(machine);
+
+	std::shared_ptr<Outputs::Speaker> speaker = machine->crt_machine()->get_speaker();
+	if(speaker) {
+		speaker->set_output_rate(static_cast<float>(audio_rate), 1024);
+		speaker->set_delegate(instance.get());
+	}
+
+	instances_.push_back(std::move(instance));
+	return instances_.size() - 1;
+}
+
+void BatchRunner::set_slice_length(double seconds) {
+	slice_length_ = seconds;
+}
+
+void BatchRunner::set_delegate(Delegate *delegate) {
+	delegate_ = delegate;
+}
+
+void BatchRunner::run(double number_of_seconds, unsigned int number_of_frames) {
+	const double run_limit = number_of_frames ? static_cast<double>(number_of_frames) * 0.1 : number_of_seconds;
+	for(auto &instance: instances_) {
+		instance->run_limit = run_limit;
+		instance->target_frames = number_of_frames;
+		instance->progress.is_finished = instance->progress.emulated_seconds >= run_limit;
+	}
+
+	const auto start_time = std::chrono::steady_clock::now();
+	while(true) {
+		// Submit a slice of every machine that still has work to do, then wait for them all.
+		{
+			std::lock_guard<std::mutex> lock(slice_mutex_);
+			outstanding_instances_ = 0;
+			for(auto &instance: instances_) {
+				if(!instance->progress.is_finished) ++outstanding_instances_;
+			}
+		}
+		if(!outstanding_instances_) break;
+
+		for(auto &instance: instances_) {
+			if(!instance->progress.is_finished) pool_.submit(instance.get());
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(slice_mutex_);
+			slice_condition_.wait(lock, [this] { return !outstanding_instances_; });
+		}
+
+		if(delegate_) delegate_->batch_runner_did_complete_slice(this);
+	}
+
+	const auto end_time = std::chrono::steady_clock::now();
+	wall_seconds_ += std::chrono::duration_cast<std::chrono::duration<double>>(end_time - start_time).count();
+}
+
+void BatchRunner::instance_did_complete_slice() {
+	std::lock_guard<std::mutex> lock(slice_mutex_);
+	--outstanding_instances_;
+	if(!outstanding_instances_) slice_condition_.notify_all();
+}
+
+std::size_t BatchRunner::get_number_of_machines() const {
+	return instances_.size();
+}
+
+BatchRunner::Progress BatchRunner::get_progress(std::size_t index) const {
+	Progress progress = instances_[index]->progress;
+	progress.audio_samples = instances_[index]->audio_samples;
+	return progress;
+}
+
+double BatchRunner::get_total_emulated_seconds() const {
+	double total = 0.0;
+	for(auto &instance: instances_) {
+		total += instance->progress.emulated_seconds;
+	}
+	return total;
+}
+
+double BatchRunner::get_wall_seconds() const {
+	return wall_seconds_;
+}
+
+void BatchRunner::Instance::perform() {
+	const auto start_time = std::chrono::steady_clock::now();
+
+	// Run in steps of a millisecond, as the headless runner does, so that the frame count is checked often.
+	CRTMachine::Machine *crt_machine = machine->crt_machine();
+	std::shared_ptr<Outputs::CRT::CRT> crt = crt_machine->get_crt();
+	const double slice_end = std::min(progress.emulated_seconds + runner->slice_length_, run_limit);
+	while(progress.emulated_seconds < slice_end && (!target_frames || crt->get_number_of_frames() < target_frames)) {
+		const double clock_rate = crt_machine->get_clock_rate();
+		const int cycles = std::max(static_cast<int>(clock_rate / 1000.0), 1);
+		crt_machine->run_for(Cycles(cycles));
+		progress.emulated_seconds += static_cast<double>(cycles) / clock_rate;
+	}
+
+	progress.frames = crt->get_number_of_frames();
+	progress.is_finished = progress.emulated_seconds >= run_limit || (target_frames && progress.frames >= target_frames);
+
+	const auto end_time = std::chrono::steady_clock::now();
+	progress.host_seconds += std::chrono::duration_cast<std::chrono::duration<double>>(end_time - start_time).count();
+
+	runner->instance_did_complete_slice();
+}
+
+void BatchRunner::Instance::speaker_did_complete_samples(Outputs::Speaker *speaker, const std::vector<int16_t> &buffer) {
+	audio_samples += buffer.size();
+}
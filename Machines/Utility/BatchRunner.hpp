@@ -0,0 +1,128 @@
+//
+//  BatchRunner.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 25/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#ifndef BatchRunner_hpp
+#define BatchRunner_hpp
+
+#include "MachineForTarget.hpp"
+#include "../../Concurrency/ThreadPool.hpp"
+#include "../../Outputs/Speaker.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Machine {
+
+/*!
+	Owns any number of independent machines and runs them as quickly as possible, in parallel,
+	without display or audio output.
+
+	Machines are run in time slices: each slice of each machine is a job for a thread pool, and
+	all machines complete a slice before any starts the next. So the number of threads in use depends
+	on the size of the pool rather than the number of machines, and each machine's progress can be
+	inspected between slices.
+
+	Each machine's video and audio are generated, so that their costs are included, but then discarded.
+*/
+class BatchRunner {
+	public:
+		/*!
+			Creates a runner that performs its slices on @c pool.
+		*/
+		BatchRunner(Concurrency::ThreadPool &pool = Concurrency::ThreadPool::shared());
+		~BatchRunner();
+
+		/*!
+			Adds @c machine, which should already have been configured and had its output set up, to the batch.
+			The runner takes ownership, and collects audio from it sampled at @c audio_rate.
+
+			@returns The index of the new machine within the batch.
+		*/
+		std::size_t add_machine(DynamicMachine *machine, int audio_rate = 44100);
+
+		/// Sets the amount of emulated time for which each machine runs per slice; the default is 0.1 seconds.
+		void set_slice_length(double seconds);
+
+		/// A delegate is informed after each slice, on the thread that called @c run.
+		struct Delegate {
+			virtual void batch_runner_did_complete_slice(BatchRunner *runner) = 0;
+		};
+		void set_delegate(Delegate *delegate);
+
+		/*!
+			Runs every machine until it has produced @c number_of_frames frames or, if that is zero, for
+			@c number_of_seconds. Blocks until all are done.
+
+			A machine that never produces vertical sync will complete no frames; if running for a number of
+			frames, each machine therefore gives up after a tenth of an emulated second per frame.
+		*/
+		void run(double number_of_seconds, unsigned int number_of_frames = 0);
+
+		/// Describes the progress of an individual machine.
+		struct Progress {
+			double emulated_seconds = 0.0;
+			double host_seconds = 0.0;
+			unsigned int frames = 0;
+			uint64_t audio_samples = 0;
+			bool is_finished = false;
+		};
+
+		/// @returns The number of machines in the batch.
+		std::size_t get_number_of_machines() const;
+
+		/// @returns The progress of the machine at @c index. Should be called only between slices.
+		Progress get_progress(std::size_t index) const;
+
+		/// @returns The total amount of time emulated so far, across all machines.
+		double get_total_emulated_seconds() const;
+
+		/// @returns The amount of real time spent so far in @c run.
+		double get_wall_seconds() const;
+
+	private:
+		// An instance is a single machine, plus the sink for its audio; it is also the job that
+		// runs that machine for a slice.
+		struct Instance: public Concurrency::ThreadPool::Job, public Outputs::Speaker::Delegate {
+			BatchRunner *runner = nullptr;
+
+			// Declared ahead of the machine so that it is destroyed after, as the machine's speaker may
+			// announce samples until then.
+			std::atomic<uint64_t> audio_samples;
+			std::unique_ptr<DynamicMachine> machine;
+
+			Progress progress;
+			double run_limit = 0.0;
+			unsigned int target_frames = 0;
+
+			Instance() : audio_samples(0) {}
+			void perform() override;
+			void speaker_did_complete_samples(Outputs::Speaker *speaker, const std::vector<int16_t> &buffer) override;
+		};
+		std::vector<std::unique_ptr<Instance>> instances_;
+
+		Concurrency::ThreadPool &pool_;
+		Delegate *delegate_ = nullptr;
+		double slice_length_ = 0.1;
+		double wall_seconds_ = 0.0;
+
+		// Counts the instances yet to complete the current slice.
+		std::mutex slice_mutex_;
+		std::condition_variable slice_condition_;
+		std::size_t outstanding_instances_ = 0;
+
+		void instance_did_complete_slice();
+};
+
+}
+
+#endif /* BatchRunner_hpp */
@@ -16,6 +16,7 @@
 #include "../CRTMachine.hpp"
 #include "../JoystickMachine.hpp"
 #include "../KeyboardMachine.hpp"
+#include "../SnapshotMachine.hpp"
 #include "Typer.hpp"
 
 #include <map>
@@ -28,12 +29,15 @@ namespace Machine {
 	the machine's parent class or, therefore, the need to establish a common one.
 */
 struct DynamicMachine {
+	virtual ~DynamicMachine() {}
+
 	virtual ConfigurationTarget::Machine *configuration_target() = 0;
 	virtual CRTMachine::Machine *crt_machine() = 0;
 	virtual JoystickMachine::Machine *joystick_machine() = 0;
 	virtual KeyboardMachine::Machine *keyboard_machine() = 0;
 	virtual Configurable::Device *configurable_device() = 0;
 	virtual Utility::TypeRecipient *type_recipient() = 0;
+	virtual SnapshotMachine::Machine *snapshot_machine() = 0;
 };
 
 /*!
@@ -0,0 +1,112 @@
+//
+//  MemoryMap.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 26/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#ifndef MemoryMap_hpp
+#define MemoryMap_hpp
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+#include "../../ClockReceiver/ForceInline.hpp"
+
+namespace Memory {
+
+/*!
+	Divides a 16-bit address space into pages of 2^page_size_bits bytes, each of which may independently be
+	mapped to an area for reading and to an area for writing. Reads from pages with no read mapping produce 0xff;
+	writes to pages with no write mapping are discarded. Unmapped pages are directed to internal buffers to
+	achieve that, so neither reads nor writes need test for a mapping.
+
+	Pages may also be marked as I/O, allowing a bus handler to satisfy all accesses to plain RAM and ROM with
+	a single test before considering whether any further address decoding is necessary.
+*/
+template <int page_size_bits> class MemoryMap {
+	public:
+		static const int page_size = 1 << page_size_bits;
+		static const int number_of_pages = 65536 >> page_size_bits;
+
+		MemoryMap() {
+			std::fill(unmapped_read_, unmapped_read_ + page_size, 0xff);
+			clear();
+		}
+
+		/*!
+			Unmaps every page for both reading and writing, and marks no page as I/O.
+		*/
+		void clear() {
+			for(int page = 0; page < number_of_pages; ++page) {
+				read_pointers_[page] = unmapped_read_;
+				write_pointers_[page] = unmapped_write_;
+			}
+			io_pages_.reset();
+		}
+
+		/*!
+			Maps the @c length bytes from @c area for reading, from @c address onwards. Both @c address and @c length
+			are expected to be multiples of the page size.
+		*/
+		void map_read(const uint8_t *area, uint16_t address, std::size_t length) {
+			map(read_pointers_, area, address, length);
+		}
+
+		/*!
+			Maps the @c length bytes from @c area for writing, from @c address onwards. Both @c address and @c length
+			are expected to be multiples of the page size.
+		*/
+		void map_write(uint8_t *area, uint16_t address, std::size_t length) {
+			map(write_pointers_, area, address, length);
+		}
+
+		/*!
+			Marks the pages covering the @c length bytes from @c address onwards as I/O.
+		*/
+		void set_io(uint16_t address, std::size_t length) {
+			for(std::size_t page = address >> page_size_bits; page < ((address + length + page_size - 1) >> page_size_bits); ++page) {
+				io_pages_[page] = true;
+			}
+		}
+
+		/// @returns @c true if @c address lies within a page marked as I/O; @c false otherwise.
+		forceinline bool is_io(uint16_t address) const {
+			return io_pages_[address >> page_size_bits];
+		}
+
+		/// @returns The value mapped for reading at @c address, or 0xff if nothing is mapped there.
+		forceinline uint8_t read(uint16_t address) const {
+			return read_pointers_[address >> page_size_bits][address & (page_size - 1)];
+		}
+
+		/// Stores @c value to @c address if something is mapped there for writing; does nothing otherwise.
+		forceinline void write(uint16_t address, uint8_t value) {
+			write_pointers_[address >> page_size_bits][address & (page_size - 1)] = value;
+		}
+
+	private:
+		const uint8_t *read_pointers_[number_of_pages];
+		uint8_t *write_pointers_[number_of_pages];
+		std::bitset<number_of_pages> io_pages_;
+
+		uint8_t unmapped_read_[page_size];
+		uint8_t unmapped_write_[page_size];
+
+		template <typename PointerT> void map(PointerT *pointers, PointerT area, uint16_t address, std::size_t length) {
+			std::size_t page = address >> page_size_bits;
+			length >>= page_size_bits;
+			while(length-- && page < number_of_pages) {
+				pointers[page] = area;
+				area += page_size;
+				page++;
+			}
+		}
+};
+
+}
+
+#endif /* MemoryMap_hpp */
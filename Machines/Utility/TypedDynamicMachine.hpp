@@ -49,6 +49,10 @@ template<typename T> class TypedDynamicMachine: public ::Machine::DynamicMachine
 			return get<Utility::TypeRecipient>();
 		}
 
+		SnapshotMachine::Machine *snapshot_machine() override {
+			return get<SnapshotMachine::Machine>();
+		}
+
 	private:
 		template <typename Class> Class *get() {
 			return dynamic_cast<Class *>(machine_.get());
@@ -8,6 +8,7 @@
 
 #include "Typer.hpp"
 
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 
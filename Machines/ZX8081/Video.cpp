@@ -20,6 +20,9 @@ Video::Video() :
 		"{"
 			"return float(texture(texID, coordinate).r) / 255.0;"
 		"}");
+	crt_->set_software_composite_sampling_function([] (const uint8_t *sample, float x, float phase, float amplitude) {
+		return static_cast<float>(sample[0]) / 255.0f;
+	});
 
 	// Show only the centre 80% of the TV frame.
 	crt_->set_visible_area(Outputs::CRT::Rect(0.1f, 0.1f, 0.8f, 0.8f));
@@ -100,6 +103,12 @@ void Video::output_byte(uint8_t byte) {
 	}
 }
 
+void Video::serialise(Snapshot::Archive &archive) {
+	archive.tag(0x76696465);
+	archive(sync_, cycles_since_update_);
+	if(archive.is_reading()) line_data_pointer_ = line_data_ = nullptr;
+}
+
 std::shared_ptr<Outputs::CRT::CRT> Video::get_crt() {
 	return crt_;
 }
@@ -11,6 +11,7 @@
 
 #include "../../Outputs/CRT/CRT.hpp"
 #include "../../ClockReceiver/ClockReceiver.hpp"
+#include "../../Snapshot/Snapshot.hpp"
 
 namespace ZX8081 {
 
@@ -41,6 +42,9 @@ class Video {
 		/// Causes @c byte to be serialised into pixels and output over the next four cycles.
 		void output_byte(uint8_t byte);
 
+		/// Captures or restores sync and timing state; pixels not yet passed to the CRT are discarded upon restore.
+		void serialise(Snapshot::Archive &archive);
+
 	private:
 		bool sync_ = false;
 		uint8_t *line_data_ = nullptr;
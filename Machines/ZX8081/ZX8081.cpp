@@ -16,6 +16,7 @@
 #include "../../Configurable/StandardOptions.hpp"
 
 #include "../Utility/MemoryFuzzer.hpp"
+#include "../Utility/MemoryMap.hpp"
 #include "../Utility/Typer.hpp"
 
 #include "Keyboard.hpp"
@@ -45,12 +46,14 @@ std::vector<std::unique_ptr<Configurable::Option>> get_options() {
 template<bool is_zx81> class ConcreteMachine:
 	public Utility::TypeRecipient,
 	public CPU::Z80::BusHandler,
+	public Sleeper::SleepObserver,
 	public Machine {
 	public:
 		ConcreteMachine() :
 			z80_(*this),
 			tape_player_(ZX8081ClockRate) {
 			set_clock_rate(ZX8081ClockRate);
+			tape_player_.set_sleep_observer(this);
 			clear_all_keys();
 		}
 
@@ -182,27 +185,21 @@ template<bool is_zx81> class ConcreteMachine:
 					}
 					is_opcode_read = true;
 
-				case CPU::Z80::PartialMachineCycle::Read:
-					if(address < ram_base_) {
-						*cycle.value = rom_[address & rom_mask_];
-					} else {
-						uint8_t value = ram_[address & ram_mask_];
-
-						// If this is an M1 cycle reading from above the 32kb mark and HALT is not
-						// currently active, latch for video output and return a NOP. Otherwise,
-						// just return the value as read.
-						if(is_opcode_read && address&0x8000 && !(value & 0x40) && !z80_.get_halt_line()) {
-							latched_video_byte_ = value;
-							has_latched_video_byte_ = true;
-							*cycle.value = 0;
-						} else *cycle.value = value;
-					}
-				break;
+				case CPU::Z80::PartialMachineCycle::Read: {
+					const uint8_t value = memory_map_.read(address);
+
+					// If this is an M1 cycle reading from above the 32kb mark and HALT is not
+					// currently active, latch for video output and return a NOP. Otherwise,
+					// just return the value as read.
+					if(is_opcode_read && address&0x8000 && !(value & 0x40) && !z80_.get_halt_line()) {
+						latched_video_byte_ = value;
+						has_latched_video_byte_ = true;
+						*cycle.value = 0;
+					} else *cycle.value = value;
+				} break;
 
 				case CPU::Z80::PartialMachineCycle::Write:
-					if(address >= ram_base_) {
-						ram_[address & ram_mask_] = *cycle.value;
-					}
+					memory_map_.write(address, *cycle.value);
 				break;
 
 				default: break;
@@ -276,6 +273,7 @@ template<bool is_zx81> class ConcreteMachine:
 				break;
 			}
 			Memory::Fuzz(ram_);
+			update_memory_map();
 
 			if(target.loadingCommand.length()) {
 				set_typer_for_string(target.loadingCommand.c_str());
@@ -344,6 +342,11 @@ template<bool is_zx81> class ConcreteMachine:
 			tape_player_.set_motor_control(is_playing);
 		}
 
+		// The machine may be run as quickly as possible while the tape is playing.
+		void set_component_is_sleeping(void *component, bool is_sleeping) override final {
+			set_clock_is_unlimited(!is_sleeping);
+		}
+
 		// MARK: - Typer timing
 		HalfCycles get_typer_delay() override final { return Cycles(7000000); }
 		HalfCycles get_typer_frequency() override final { return Cycles(390000); }
@@ -383,6 +386,29 @@ template<bool is_zx81> class ConcreteMachine:
 			return selection_set;
 		}
 
+	protected:
+		// to satisfy SnapshotMachine::Machine
+		void serialise(Snapshot::Archive &archive) override {
+			archive.tag(0x5a583831);
+
+			// The model and quantity of RAM are set by configuration, so they are checked rather than restored.
+			bool is_zx81_model = is_zx81_;
+			uint32_t ram_size = static_cast<uint32_t>(ram_.size());
+			archive(is_zx81_model, ram_size);
+			if(is_zx81_model != is_zx81_ || ram_size != ram_.size()) {
+				archive.set_invalid();
+				return;
+			}
+
+			z80_.serialise(archive);
+			archive(ram_, key_states_);
+			if(archive.is_reading()) update_memory_map();
+			archive(vsync_, hsync_, line_counter_, nmi_is_enabled_, horizontal_counter_);
+			archive(latched_video_byte_, has_latched_video_byte_, tape_advance_delay_);
+			video_->serialise(archive);
+			tape_player_.serialise(archive);
+		}
+
 	private:
 		CPU::Z80::Processor<ConcreteMachine, false, is_zx81> z80_;
 
@@ -398,6 +424,21 @@ template<bool is_zx81> class ConcreteMachine:
 		std::vector<uint8_t> rom_;
 		uint16_t rom_mask_;
 
+		// ROM is mirrored throughout the area below ram_base_, RAM throughout the area above it.
+		Memory::MemoryMap<10> memory_map_;
+		void update_memory_map() {
+			memory_map_.clear();
+			for(int page = 0; page < 64; ++page) {
+				const uint16_t address = static_cast<uint16_t>(page << 10);
+				if(address < ram_base_) {
+					memory_map_.map_read(&rom_[address & rom_mask_], address, 1024);
+				} else {
+					memory_map_.map_read(&ram_[address & ram_mask_], address, 1024);
+					memory_map_.map_write(&ram_[address & ram_mask_], address, 1024);
+				}
+			}
+		}
+
 		bool vsync_ = false, hsync_ = false;
 		int line_counter_ = 0;
 
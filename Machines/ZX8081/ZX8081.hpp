@@ -13,6 +13,7 @@
 #include "../ConfigurationTarget.hpp"
 #include "../CRTMachine.hpp"
 #include "../KeyboardMachine.hpp"
+#include "../SnapshotMachine.hpp"
 
 namespace ZX8081 {
 
@@ -23,7 +24,8 @@ class Machine:
 	public CRTMachine::Machine,
 	public ConfigurationTarget::Machine,
 	public KeyboardMachine::Machine,
-	public Configurable::Device {
+	public Configurable::Device,
+	public SnapshotMachine::Machine {
 	public:
 		virtual ~Machine();
 
@@ -0,0 +1,581 @@
+//
+//  main.cpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 20/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../StaticAnalyser/StaticAnalyser.hpp"
+#include "../../Machines/Utility/MachineForTarget.hpp"
+
+#include "../../Machines/ConfigurationTarget.hpp"
+#include "../../Machines/CRTMachine.hpp"
+
+#include "../../Processors/6502/AllRAM/6502AllRAM.hpp"
+#include "../../Processors/Z80/AllRAM/Z80AllRAM.hpp"
+
+#include "../../Components/6560/6560.hpp"
+#include "../../Components/AY38910/AY38910.hpp"
+#include "../../Machines/Atari2600/TIA.hpp"
+#include "../../Outputs/Speaker.hpp"
+
+namespace {
+
+// MARK: - Timing and reporting
+
+/*!
+	The outcome of a single benchmark: @c cycles of something that nominally runs at @c clock_rate
+	took @c host_seconds of wall-clock time to emulate.
+*/
+struct Result {
+	std::string name;
+	double clock_rate = 0.0;
+	double cycles = 0.0;
+	double host_seconds = 0.0;
+
+	// Machines only: whether genuine system ROMs were available.
+	bool is_machine = false;
+	bool has_system_roms = false;
+};
+
+/*!
+	Performs @c function, returning the number of seconds of wall-clock time that it took.
+*/
+double host_time(const std::function<void(void)> &function) {
+	const auto start_time = std::chrono::steady_clock::now();
+	function();
+	const auto end_time = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::duration<double>>(end_time - start_time).count();
+}
+
+/*!
+	Writes @c results to @c stream as a single JSON object.
+*/
+void write_json(std::ostream &stream, double seconds, const std::vector<Result> &results) {
+	auto write_list = [&stream, &results] (bool machines) {
+		bool is_first = true;
+		for(const auto &result: results) {
+			if(result.is_machine != machines) continue;
+			if(!is_first) stream << ",";
+			is_first = false;
+
+			const double emulated_seconds = result.cycles / result.clock_rate;
+			stream << std::endl << "\t\t{";
+			stream << "\"name\": \"" << result.name << "\", ";
+			if(machines) stream << "\"roms\": \"" << (result.has_system_roms ? "system" : "synthetic") << "\", ";
+			stream << "\"clock_rate\": " << result.clock_rate << ", ";
+			stream << "\"emulated_seconds\": " << emulated_seconds << ", ";
+			stream << "\"host_seconds\": " << result.host_seconds << ", ";
+			stream << "\"emulated_mhz_per_host_second\": " << (result.cycles / 1000000.0) / result.host_seconds << ", ";
+			stream << "\"real_time_multiple\": " << emulated_seconds / result.host_seconds;
+			stream << "}";
+		}
+		stream << std::endl << "\t]";
+	};
+
+	const auto precision = stream.precision(8);
+	stream << "{" << std::endl;
+	stream << "\t\"seconds\": " << seconds << "," << std::endl;
+	stream << "\t\"machines\": [";
+	write_list(true);
+	stream << "," << std::endl << "\t\"components\": [";
+	write_list(false);
+	stream << std::endl << "}" << std::endl;
+	stream.precision(precision);
+}
+
+// MARK: - Machines
+
+/*!
+	Provides a cartridge built from an in-memory image, for the Atari 2600.
+*/
+class ImageCartridge: public Storage::Cartridge::Cartridge {
+	public:
+		ImageCartridge(const std::vector<uint8_t> &image) {
+			segments_.emplace_back(0x1000, 0x2000, image);
+		}
+};
+
+/*!
+	@returns A 4kb Atari 2600 cartridge that produces a proper vertical sync, then colours each line of
+	the display differently, indefinitely.
+*/
+std::vector<uint8_t> atari2600_cartridge() {
+	const uint8_t program[] = {
+		0x78,				// SEI
+		0xd8,				// CLD
+		0xa2, 0xff,			// LDX #$ff
+		0x9a,				// TXS
+
+		// frame:
+		0xa9, 0x02,			// LDA #2
+		0x85, 0x00,			// STA VSYNC
+		0x85, 0x02,			// STA WSYNC
+		0x85, 0x02,			// STA WSYNC
+		0x85, 0x02,			// STA WSYNC
+		0xa9, 0x00,			// LDA #0
+		0x85, 0x00,			// STA VSYNC
+
+		0xa2, 0x25,			// LDX #37
+		0x85, 0x02,			// vblank: STA WSYNC
+		0xca,				// DEX
+		0xd0, 0xfb,			// BNE vblank
+
+		0xa2, 0xc0,			// LDX #192
+		0x86, 0x09,			// pixels: STX COLUBK
+		0x85, 0x02,			// STA WSYNC
+		0xca,				// DEX
+		0xd0, 0xf9,			// BNE pixels
+
+		0xa2, 0x1e,			// LDX #30
+		0x85, 0x02,			// overscan: STA WSYNC
+		0xca,				// DEX
+		0xd0, 0xfb,			// BNE overscan
+
+		0x4c, 0x05, 0xf0,	// JMP frame
+	};
+
+	std::vector<uint8_t> image(4096, 0xea);
+	std::memcpy(image.data(), program, sizeof(program));
+
+	// Point the reset and IRQ vectors at the start of the program.
+	image[0xffc] = image[0xffe] = 0x00;
+	image[0xffd] = image[0xfff] = 0xf0;
+	return image;
+}
+
+/*!
+	@returns A target for @c machine in a simple configuration, with no media other than for the
+	Atari 2600, for which a cartridge is synthesised.
+*/
+StaticAnalyser::Target target_for_machine(StaticAnalyser::Target::Machine machine) {
+	StaticAnalyser::Target target;
+	target.machine = machine;
+	target.probability = 1.0f;
+
+	switch(machine) {
+		case StaticAnalyser::Target::AmstradCPC:
+			target.amstradcpc.model = StaticAnalyser::AmstradCPCModel::CPC6128;
+		break;
+		case StaticAnalyser::Target::Atari2600:
+			target.atari.paging_model = StaticAnalyser::Atari2600PagingModel::None;
+			target.atari.uses_superchip = false;
+			target.media.cartridges.emplace_back(new ImageCartridge(atari2600_cartridge()));
+		break;
+		case StaticAnalyser::Target::Electron:
+			target.acorn.has_adfs = false;
+			target.acorn.has_dfs = false;
+			target.acorn.should_shift_restart = false;
+		break;
+		case StaticAnalyser::Target::Oric:
+			target.oric.use_atmos_rom = true;
+			target.oric.has_microdisc = false;
+		break;
+		case StaticAnalyser::Target::Vic20:
+			target.vic20.memory_model = StaticAnalyser::Vic20MemoryModel::Unexpanded;
+			target.vic20.has_c1540 = false;
+		break;
+		case StaticAnalyser::Target::ZX8081:
+			target.zx8081.memory_model = StaticAnalyser::ZX8081MemoryModel::Unexpanded;
+			target.zx8081.isZX81 = true;
+		break;
+	}
+
+	return target;
+}
+
+/*!
+	Runs @c machine for @c seconds of emulated time. System ROMs are sought in the same places as the
+	SDL build, preceded by @c rom_path. Any that are not found are substituted by blank images, so that
+	every machine can be benchmarked; such results are comparable only with other results that were
+	obtained the same way.
+*/
+Result benchmark_machine(StaticAnalyser::Target::Machine machine_type, double seconds, const std::string &rom_path) {
+	Result result;
+	result.name = ::Machine::ShortNameForTargetMachine(machine_type);
+	result.is_machine = true;
+	result.has_system_roms = true;
+
+	const StaticAnalyser::Target target = target_for_machine(machine_type);
+	std::unique_ptr<::Machine::DynamicMachine> machine(::Machine::MachineForTarget(target));
+	CRTMachine::Machine *crt_machine = machine->crt_machine();
+
+	crt_machine->set_rom_fetcher( [&result, &rom_path]
+		(const std::string &machine, const std::vector<std::string> &names) -> std::vector<std::unique_ptr<std::vector<uint8_t>>> {
+			std::vector<std::string> paths;
+			if(!rom_path.empty()) paths.push_back(rom_path + "/" + machine + "/");
+			paths.push_back("/usr/local/share/CLK/" + machine + "/");
+			paths.push_back("/usr/share/CLK/" + machine + "/");
+
+			std::vector<std::unique_ptr<std::vector<uint8_t>>> results;
+			for(auto &name: names) {
+				std::unique_ptr<std::vector<uint8_t>> data(new std::vector<uint8_t>);
+
+				FILE *file = nullptr;
+				for(auto &path: paths) {
+					file = std::fopen((path + name).c_str(), "rb");
+					if(file) break;
+				}
+
+				if(file) {
+					std::fseek(file, 0, SEEK_END);
+					data->resize(static_cast<std::size_t>(std::ftell(file)));
+					std::fseek(file, 0, SEEK_SET);
+					if(std::fread(data->data(), 1, data->size(), file) != data->size()) data->clear();
+					std::fclose(file);
+				}
+
+				if(data->empty()) {
+					result.has_system_roms = false;
+					data->resize(16384);
+				}
+				results.emplace_back(std::move(data));
+			}
+
+			return results;
+		});
+
+	machine->configuration_target()->configure_as_target(target);
+	crt_machine->setup_output(4.0f / 3.0f);
+
+	std::shared_ptr<Outputs::Speaker> speaker = crt_machine->get_speaker();
+	if(speaker) speaker->set_output_rate(44100.0f, 1024);
+
+	// Run in slices of a hundredth of a second, as a host would.
+	result.clock_rate = crt_machine->get_clock_rate();
+	const int slice = static_cast<int>(result.clock_rate / 100.0);
+	const int slices = static_cast<int>(seconds * 100.0);
+	result.cycles = static_cast<double>(slice) * static_cast<double>(slices);
+	result.host_seconds = host_time([crt_machine, slice, slices] {
+		for(int c = 0; c < slices; ++c) {
+			crt_machine->run_for(Cycles(slice));
+		}
+	});
+
+	return result;
+}
+
+// MARK: - Components
+
+/*!
+	Exposes the speaker queue for synchronisation, allowing the cost of work performed there to be
+	measured.
+*/
+template <typename T> class Synchronised: public T {
+	public:
+		void synchronise() {
+			this->flush();
+			this->_queue->flush();
+		}
+};
+
+/*!
+	Provides a square wave, with a period of 64 samples, for the benefit of the filter benchmark.
+*/
+class SquareWave: public Outputs::Filter<SquareWave> {
+	public:
+		void get_samples(unsigned int number_of_samples, int16_t *target) {
+			while(number_of_samples--) {
+				*target = (counter_ & 32) ? 8192 : -8192;
+				++target;
+				++counter_;
+			}
+		}
+
+		void skip_samples(unsigned int number_of_samples) {
+			counter_ += number_of_samples;
+		}
+
+	private:
+		unsigned int counter_ = 0;
+};
+
+/*!
+	Provides a 6560 that fetches from a 16kb block of memory that holds a repeating pattern.
+*/
+class VIC: public MOS::MOS6560<VIC> {
+	public:
+		VIC() : memory_(16384) {
+			for(std::size_t c = 0; c < memory_.size(); ++c) memory_[c] = static_cast<uint8_t>(c * 7);
+		}
+
+		inline void perform_read(uint16_t address, uint8_t *pixel_data, uint8_t *colour_data) {
+			*pixel_data = memory_[address & 0x3fff];
+			*colour_data = memory_[(address + 1) & 0x3fff];
+		}
+
+	private:
+		std::vector<uint8_t> memory_;
+};
+
+Result benchmark_6502(double seconds) {
+	Result result;
+	result.name = "CPU::MOS6502::Processor::run_for";
+	result.clock_rate = 1000000.0;
+	result.cycles = result.clock_rate * seconds;
+
+	// A loop that increments every byte of a page, then repeats.
+	const uint8_t program[] = {
+		0xa2, 0x00,			// LDX #0
+		0xbd, 0x00, 0x10,	// loop: LDA $1000, X
+		0x69, 0x01,			// ADC #1
+		0x9d, 0x00, 0x10,	// STA $1000, X
+		0xe8,				// INX
+		0xd0, 0xf5,			// BNE loop
+		0x4c, 0x00, 0x02,	// JMP $0200
+	};
+	std::unique_ptr<CPU::MOS6502::AllRAMProcessor> processor(CPU::MOS6502::AllRAMProcessor::Processor());
+	processor->set_data_at_address(0x200, sizeof(program), program);
+	processor->set_value_of_register(CPU::MOS6502::Register::ProgramCounter, 0x200);
+
+	const int cycles = static_cast<int>(result.cycles);
+	result.host_seconds = host_time([&processor, cycles] {
+		processor->run_for(Cycles(cycles));
+	});
+	return result;
+}
+
+Result benchmark_z80(double seconds) {
+	Result result;
+	result.name = "CPU::Z80::Processor::run_for";
+	result.clock_rate = 3500000.0;
+	result.cycles = result.clock_rate * seconds;
+
+	// A loop that increments every byte of a page, then repeats.
+	const uint8_t program[] = {
+		0x21, 0x00, 0x10,	// LD HL, $1000
+		0x06, 0x00,			// LD B, 0
+		0x7e,				// loop: LD A, (HL)
+		0xc6, 0x01,			// ADD A, 1
+		0x77,				// LD (HL), A
+		0x23,				// INC HL
+		0x10, 0xf9,			// DJNZ loop
+		0xc3, 0x00, 0x00,	// JP 0
+	};
+	std::unique_ptr<CPU::Z80::AllRAMProcessor> processor(CPU::Z80::AllRAMProcessor::Processor());
+	processor->set_data_at_address(0x0000, sizeof(program), program);
+	processor->reset_power_on();
+	processor->set_value_of_register(CPU::Z80::Register::ProgramCounter, 0x0000);
+
+	const int cycles = static_cast<int>(result.cycles);
+	result.host_seconds = host_time([&processor, cycles] {
+		processor->run_for(Cycles(cycles));
+	});
+	return result;
+}
+
+Result benchmark_tia(double seconds) {
+	Result result;
+	result.name = "TIA::run_for";
+	result.clock_rate = 3579545.0;
+	result.cycles = result.clock_rate * seconds;
+
+	// Establish a playfield, a player and a missile, and sync every 262 lines.
+	Atari2600::TIA tia;
+	tia.set_playfield(0, 0xa5);
+	tia.set_playfield(1, 0x5a);
+	tia.set_playfield(2, 0xa5);
+	tia.set_playfield_ball_colour(0x46);
+	tia.set_background_colour(0x82);
+	tia.set_player_graphic(0, 0x3c);
+	tia.set_player_missile_colour(0, 0x1e);
+	tia.set_missile_enable(0, true);
+
+	const int lines = static_cast<int>(result.cycles / 228.0);
+	result.cycles = static_cast<double>(lines) * 228.0;
+	result.host_seconds = host_time([&tia, lines] {
+		for(int line = 0; line < lines; ++line) {
+			tia.set_sync((line % 262) < 3);
+			tia.run_for(Cycles(228));
+		}
+	});
+	return result;
+}
+
+Result benchmark_6560(double seconds) {
+	Result result;
+	result.name = "MOS6560::run_for";
+	result.clock_rate = 1022727.0;
+	result.cycles = result.clock_rate * seconds;
+
+	// Use the Vic-20's standard NTSC display setup, with all three voices and noise audible.
+	VIC vic;
+	vic.set_clock_rate(result.clock_rate);
+	vic.get_speaker()->set_output_rate(44100.0f, 1024);
+	const uint8_t registers[] = {
+		0x05, 0x19, 0x16, 0x2e, 0x00, 0xc0, 0x00, 0x00,
+		0x00, 0x00, 0x87, 0x93, 0xaf, 0xf0, 0x0f, 0x1b
+	};
+	for(int c = 0; c < 16; ++c) vic.set_register(c, registers[c]);
+
+	const int cycles = static_cast<int>(result.cycles);
+	result.host_seconds = host_time([&vic, cycles] {
+		vic.run_for(Cycles(cycles));
+		vic.flush();
+	});
+	return result;
+}
+
+Result benchmark_ay(double seconds) {
+	Result result;
+	result.name = "AY38910::get_samples";
+	result.clock_rate = 1000000.0;
+	result.cycles = result.clock_rate * seconds;
+
+	// Set up three tones, noise and a repeating envelope.
+	Synchronised<GI::AY38910::AY38910> ay;
+	ay.set_clock_rate(result.clock_rate);
+	const uint8_t registers[] = {
+		0x1c, 0x01, 0xfd, 0x00, 0x7f, 0x00, 0x0f, 0x30,
+		0x0f, 0x0c, 0x10, 0x00, 0x08, 0x0e
+	};
+	for(uint8_t c = 0; c < sizeof(registers); ++c) {
+		ay.set_data_input(c);
+		ay.set_control_lines(GI::AY38910::ControlLines(GI::AY38910::BDIR | GI::AY38910::BC2 | GI::AY38910::BC1));
+		ay.set_data_input(registers[c]);
+		ay.set_control_lines(GI::AY38910::ControlLines(GI::AY38910::BDIR | GI::AY38910::BC2));
+		ay.set_control_lines(GI::AY38910::ControlLines(0));
+	}
+	ay.synchronise();
+
+	std::vector<int16_t> samples(1024);
+	const int chunks = static_cast<int>(result.cycles / static_cast<double>(samples.size()));
+	result.cycles = static_cast<double>(chunks) * static_cast<double>(samples.size());
+	result.host_seconds = host_time([&ay, &samples, chunks] {
+		for(int c = 0; c < chunks; ++c) {
+			ay.get_samples(static_cast<unsigned int>(samples.size()), samples.data());
+		}
+	});
+	return result;
+}
+
+/*!
+	Resamples a square wave at @c input_rate to 44.1Khz, in slices of a hundredth of a second.
+*/
+Result benchmark_filter(const std::string &name, double input_rate, double seconds) {
+	Result result;
+	result.name = name;
+	result.clock_rate = input_rate;
+
+	Synchronised<SquareWave> speaker;
+	speaker.set_input_rate(static_cast<float>(result.clock_rate));
+	speaker.set_output_rate(44100.0f, 1024);
+
+	const int slice = static_cast<int>(result.clock_rate / 100.0);
+	const int slices = static_cast<int>(seconds * 100.0);
+	result.cycles = static_cast<double>(slice) * static_cast<double>(slices);
+	result.host_seconds = host_time([&speaker, slice, slices] {
+		for(int c = 0; c < slices; ++c) {
+			speaker.run_for(Cycles(slice));
+			speaker.flush();
+		}
+		speaker.synchronise();
+	});
+	return result;
+}
+
+Result benchmark_decimating_filter(double seconds) {
+	return benchmark_filter("Speaker::Filter::run_for", 2000000.0, seconds);
+}
+
+Result benchmark_interpolating_filter(double seconds) {
+	return benchmark_filter("Speaker::Filter::run_for, interpolating", 22050.0, seconds);
+}
+
+// MARK: - Argument handling
+
+/*!
+	Searches @c argv for an argument of the form --name=value, returning value if found
+	and @c default_value otherwise.
+*/
+std::string argument_value(int argc, char *argv[], const std::string &name, const std::string &default_value) {
+	const std::string prefix = "--" + name + "=";
+	for(int index = 1; index < argc; ++index) {
+		if(!std::strncmp(argv[index], prefix.c_str(), prefix.size())) {
+			return argv[index] + prefix.size();
+		}
+	}
+	return default_value;
+}
+
+void print_usage(std::ostream &stream, const char *name) {
+	stream << "Usage: " << name << " [options]" << std::endl;
+	stream << "Runs each machine, then each of a selection of components, for a fixed period of emulated time and reports throughput as JSON." << std::endl << std::endl;
+	stream << "Options:" << std::endl;
+	stream << "\t--seconds=S\t\temulated seconds per benchmark; defaults to 10" << std::endl;
+	stream << "\t--output=FILE\t\twrites results to FILE rather than to standard output" << std::endl;
+	stream << "\t--rompath=PATH\t\tsearches PATH for system ROMs before /usr/local/share/CLK/ and /usr/share/CLK/;" << std::endl;
+	stream << "\t\t\t\tblank images are substituted for any that are not found" << std::endl;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+	for(int index = 1; index < argc; ++index) {
+		if(!std::strcmp(argv[index], "--help") || std::strncmp(argv[index], "--", 2)) {
+			print_usage(std::cerr, argv[0]);
+			return std::strcmp(argv[index], "--help") ? -1 : 0;
+		}
+	}
+
+	const double seconds = std::atof(argument_value(argc, argv, "seconds", "10").c_str());
+	const std::string output = argument_value(argc, argv, "output", "");
+	const std::string rom_path = argument_value(argc, argv, "rompath", "");
+	if(seconds <= 0.0) {
+		print_usage(std::cerr, argv[0]);
+		return -1;
+	}
+
+	std::vector<Result> results;
+	const StaticAnalyser::Target::Machine machines[] = {
+		StaticAnalyser::Target::Atari2600,
+		StaticAnalyser::Target::Vic20,
+		StaticAnalyser::Target::Electron,
+		StaticAnalyser::Target::Oric,
+		StaticAnalyser::Target::ZX8081,
+		StaticAnalyser::Target::AmstradCPC,
+	};
+	for(auto machine: machines) {
+		results.push_back(benchmark_machine(machine, seconds, rom_path));
+		std::cerr << "Benchmarked " << results.back().name << std::endl;
+	}
+
+	const std::function<Result(double)> components[] = {
+		benchmark_6502,
+		benchmark_z80,
+		benchmark_tia,
+		benchmark_6560,
+		benchmark_ay,
+		benchmark_decimating_filter,
+		benchmark_interpolating_filter
+	};
+	for(auto &component: components) {
+		results.push_back(component(seconds));
+		std::cerr << "Benchmarked " << results.back().name << std::endl;
+	}
+
+	if(output.empty()) {
+		write_json(std::cout, seconds, results);
+	} else {
+		std::ofstream file(output);
+		if(!file) {
+			std::cerr << "Could not open " << output << " for writing" << std::endl;
+			return -1;
+		}
+		write_json(file, seconds, results);
+	}
+
+	return 0;
+}
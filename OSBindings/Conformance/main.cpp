@@ -0,0 +1,683 @@
+//
+//  main.cpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 21/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../../Processors/6502/AllRAM/6502AllRAM.hpp"
+#include "../../Processors/Z80/AllRAM/Z80AllRAM.hpp"
+
+namespace {
+
+/*!
+	The outcome of running a test suite: whether it passed, a description of every failure,
+	and how long it took in both emulated cycles and host seconds.
+*/
+struct SuiteResult {
+	std::string name;
+	std::vector<std::string> failures;
+	std::size_t number_of_tests = 0;
+	std::size_t timing_mismatches = 0;
+
+	// Cycles are counted up to the point at which the suite signalled its completion; the
+	// expected count is that established for the existing processor cores, so any difference
+	// indicates a change in timing. It is 0 if the test is one for which the total is not meaningful.
+	int64_t cycles = 0;
+	int64_t expected_cycles = 0;
+	double host_seconds = 0.0;
+};
+
+/*!
+	@returns The contents of the file at @c path, or an empty vector if it could not be read.
+*/
+std::vector<uint8_t> contents_of_file(const std::string &path) {
+	std::vector<uint8_t> contents;
+	std::FILE *file = std::fopen(path.c_str(), "rb");
+	if(!file) return contents;
+
+	std::fseek(file, 0, SEEK_END);
+	contents.resize(static_cast<std::size_t>(std::ftell(file)));
+	std::fseek(file, 0, SEEK_SET);
+	if(std::fread(contents.data(), 1, contents.size(), file) != contents.size()) contents.clear();
+	std::fclose(file);
+
+	return contents;
+}
+
+std::string hex(unsigned int value, int digits) {
+	char buffer[9];
+	std::snprintf(buffer, sizeof(buffer), "%0*x", digits, value);
+	return buffer;
+}
+
+// MARK: - Zexall
+
+/*!
+	Provides the CP/M BDOS functions used by Zexall, capturing output, and detects the end of the test.
+*/
+class CPMTrapHandler: public CPU::AllRAMProcessor::TrapHandler {
+	public:
+		std::string output;
+		bool is_done = false;
+		int64_t completion_time = 0;
+
+		/*!
+			Processor timestamps are held in an int, so would overflow across the whole run; the caller
+			therefore indicates the total number of cycles run before each period of execution begins.
+		*/
+		void begin_period(CPU::AllRAMProcessor &processor, int64_t cycles_run) {
+			period_start_ = processor.get_timestamp();
+			cycles_run_ = cycles_run;
+		}
+
+		void processor_did_trap(CPU::AllRAMProcessor &processor, uint16_t address) override {
+			CPU::Z80::AllRAMProcessor &z80 = static_cast<CPU::Z80::AllRAMProcessor &>(processor);
+			switch(address) {
+				case 0x0005:
+					switch(z80.get_value_of_register(CPU::Z80::Register::C)) {
+						case 9: {
+							uint16_t address = z80.get_value_of_register(CPU::Z80::Register::DE);
+							while(true) {
+								uint8_t character;
+								z80.get_data_at_address(address, 1, &character);
+								if(character == '$') break;
+								append(static_cast<char>(character));
+								++address;
+							}
+						} break;
+						case 5:
+							append(static_cast<char>(z80.get_value_of_register(CPU::Z80::Register::E)));
+						break;
+						case 0:
+							complete(processor);
+						break;
+						default: break;
+					}
+				break;
+
+				case 0x0000:
+					complete(processor);
+				break;
+
+				default: break;
+			}
+		}
+
+	private:
+		void append(char character) {
+			output.push_back(character);
+			std::cout << character << std::flush;
+		}
+
+		void complete(CPU::AllRAMProcessor &processor) {
+			if(is_done) return;
+			is_done = true;
+			completion_time = cycles_run_ + (processor.get_timestamp() - period_start_).as_int() / 2;
+		}
+
+		HalfCycles period_start_;
+		int64_t cycles_run_ = 0;
+};
+
+SuiteResult run_zexall(const std::string &data_path) {
+	SuiteResult result;
+	result.name = "Zexall";
+	result.number_of_tests = 1;
+	result.expected_cycles = 46734977145;
+
+	const std::vector<uint8_t> program = contents_of_file(data_path + "/Zexall/zexdoc.com");
+	if(program.empty()) {
+		result.failures.push_back("Could not load zexdoc.com");
+		return result;
+	}
+
+	// Install the test program at the usual CP/M place, with a RET at the BDOS entry point;
+	// establish that and address 0, which is one of the ways that CP/M programs can exit, as traps.
+	std::unique_ptr<CPU::Z80::AllRAMProcessor> z80(CPU::Z80::AllRAMProcessor::Processor());
+	CPMTrapHandler trap_handler;
+	z80->reset_power_on();
+	z80->set_data_at_address(0x0100, program.size(), program.data());
+
+	const uint8_t bdos[] = {0xc9, 0xff, 0xff};
+	z80->set_data_at_address(0x0005, sizeof(bdos), bdos);
+	const uint8_t reset[] = {0xc3, 0x00, 0x00};
+	z80->set_data_at_address(0x0000, sizeof(reset), reset);
+
+	z80->set_trap_handler(&trap_handler);
+	z80->add_trap_address(0x0005);
+	z80->add_trap_address(0x0000);
+	z80->set_value_of_register(CPU::Z80::Register::ProgramCounter, 0x0100);
+
+	// Zexdoc takes a little under fifty billion cycles; allow double that before giving up.
+	const auto start_time = std::chrono::steady_clock::now();
+	int64_t cycles_run = 0;
+	while(!trap_handler.is_done && cycles_run < 100000000000) {
+		trap_handler.begin_period(*z80, cycles_run);
+		z80->run_for(Cycles(10000000));
+		cycles_run += 10000000;
+	}
+	result.host_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start_time).count();
+	result.cycles = trap_handler.completion_time;
+
+	if(!trap_handler.is_done) {
+		result.failures.push_back("Did not complete");
+	}
+
+	// Any test that didn't print OK is a failure.
+	std::istringstream output(trap_handler.output);
+	std::string line;
+	bool did_complete = false;
+	while(std::getline(output, line)) {
+		line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+		if(line.find("....") != std::string::npos && line.find("OK") == std::string::npos) {
+			result.failures.push_back(line);
+		}
+		if(line == "Tests complete") did_complete = true;
+	}
+	if(trap_handler.is_done && !did_complete) {
+		result.failures.push_back("Exited without reporting completion");
+	}
+
+	return result;
+}
+
+// MARK: - FUSE
+
+/*!
+	The processor state that the FUSE tests specify as input and output, plus the
+	number of cycles to run for (or that were run) and all memory contents specified.
+*/
+struct FUSEState {
+	uint16_t af, bc, de, hl;
+	uint16_t af_dash, bc_dash, de_dash, hl_dash;
+	uint16_t ix, iy, sp, pc;
+	unsigned int i, r, iff1, iff2, im, is_halted;
+	int t_states;
+	std::vector<std::pair<uint16_t, std::vector<uint8_t>>> memory;
+
+	// The register line, the state line and memory are in common; the latter is terminated
+	// by a -1 line in the input file and by a blank line in the expectations file.
+	bool read(std::istream &stream) {
+		stream >> std::hex >> af >> bc >> de >> hl >> af_dash >> bc_dash >> de_dash >> hl_dash >> ix >> iy >> sp >> pc;
+		stream >> i >> r >> iff1 >> iff2 >> im >> is_halted >> std::dec >> t_states;
+		if(!stream) return false;
+
+		std::string line;
+		std::getline(stream, line);
+		while(std::getline(stream, line)) {
+			if(line.empty() || line == "-1") break;
+
+			std::istringstream memory_line(line);
+			std::string value;
+			memory_line >> value;
+			memory.emplace_back(static_cast<uint16_t>(std::stoul(value, nullptr, 16)), std::vector<uint8_t>());
+			while(memory_line >> value && value != "-1") {
+				memory.back().second.push_back(static_cast<uint8_t>(std::stoul(value, nullptr, 16)));
+			}
+		}
+		return true;
+	}
+
+	void apply(CPU::Z80::AllRAMProcessor &z80) {
+		z80.set_value_of_register(CPU::Z80::Register::AF, af);
+		z80.set_value_of_register(CPU::Z80::Register::BC, bc);
+		z80.set_value_of_register(CPU::Z80::Register::DE, de);
+		z80.set_value_of_register(CPU::Z80::Register::HL, hl);
+		z80.set_value_of_register(CPU::Z80::Register::AFDash, af_dash);
+		z80.set_value_of_register(CPU::Z80::Register::BCDash, bc_dash);
+		z80.set_value_of_register(CPU::Z80::Register::DEDash, de_dash);
+		z80.set_value_of_register(CPU::Z80::Register::HLDash, hl_dash);
+		z80.set_value_of_register(CPU::Z80::Register::IX, ix);
+		z80.set_value_of_register(CPU::Z80::Register::IY, iy);
+		z80.set_value_of_register(CPU::Z80::Register::StackPointer, sp);
+		z80.set_value_of_register(CPU::Z80::Register::ProgramCounter, pc);
+		z80.set_value_of_register(CPU::Z80::Register::I, static_cast<uint16_t>(i));
+		z80.set_value_of_register(CPU::Z80::Register::R, static_cast<uint16_t>(r));
+		z80.set_value_of_register(CPU::Z80::Register::IFF1, static_cast<uint16_t>(iff1));
+		z80.set_value_of_register(CPU::Z80::Register::IFF2, static_cast<uint16_t>(iff2));
+		z80.set_value_of_register(CPU::Z80::Register::IM, static_cast<uint16_t>(im));
+
+		for(auto &block: memory) {
+			z80.set_data_at_address(block.first, block.second.size(), block.second.data());
+		}
+	}
+
+	/*!
+		@returns A list of differences between this state, taken as the expectation, and the state of @c z80.
+		As per the Xcode tests, bits 3 and 5 of AF' are not tested.
+	*/
+	std::vector<std::string> differences(CPU::Z80::AllRAMProcessor &z80) {
+		std::vector<std::string> differences;
+		auto compare = [&differences, &z80] (const char *name, CPU::Z80::Register reg, unsigned int expected, unsigned int mask) {
+			const unsigned int actual = z80.get_value_of_register(reg);
+			if((actual & mask) != (expected & mask)) {
+				differences.push_back(std::string(name) + " was " + hex(actual, 4) + " but should be " + hex(expected, 4));
+			}
+		};
+
+		compare("AF", CPU::Z80::Register::AF, af, 0xffff);
+		compare("BC", CPU::Z80::Register::BC, bc, 0xffff);
+		compare("DE", CPU::Z80::Register::DE, de, 0xffff);
+		compare("HL", CPU::Z80::Register::HL, hl, 0xffff);
+		compare("AF'", CPU::Z80::Register::AFDash, af_dash, 0xffd7);
+		compare("BC'", CPU::Z80::Register::BCDash, bc_dash, 0xffff);
+		compare("DE'", CPU::Z80::Register::DEDash, de_dash, 0xffff);
+		compare("HL'", CPU::Z80::Register::HLDash, hl_dash, 0xffff);
+		compare("IX", CPU::Z80::Register::IX, ix, 0xffff);
+		compare("IY", CPU::Z80::Register::IY, iy, 0xffff);
+		compare("SP", CPU::Z80::Register::StackPointer, sp, 0xffff);
+		compare("PC", CPU::Z80::Register::ProgramCounter, pc, 0xffff);
+		compare("I", CPU::Z80::Register::I, i, 0xff);
+		compare("R", CPU::Z80::Register::R, r, 0xff);
+		compare("IFF1", CPU::Z80::Register::IFF1, iff1, 0xffff);
+		compare("IFF2", CPU::Z80::Register::IFF2, iff2, 0xffff);
+		compare("IM", CPU::Z80::Register::IM, im, 0xffff);
+		if(z80.get_halt_line() != !!is_halted) {
+			differences.push_back(is_halted ? "should be halted" : "should not be halted");
+		}
+
+		for(auto &block: memory) {
+			std::vector<uint8_t> actual(block.second.size());
+			z80.get_data_at_address(block.first, actual.size(), actual.data());
+			for(std::size_t c = 0; c < actual.size(); ++c) {
+				if(actual[c] != block.second[c]) {
+					const unsigned int address = static_cast<unsigned int>(block.first + c) & 0xffff;
+					differences.push_back("memory at " + hex(address, 4) + " was " + hex(actual[c], 2) + " but should be " + hex(block.second[c], 2));
+				}
+			}
+		}
+
+		return differences;
+	}
+};
+
+SuiteResult run_fuse(const std::string &data_path) {
+	SuiteResult result;
+	result.name = "FUSE";
+
+	const std::vector<uint8_t> input_file = contents_of_file(data_path + "/FUSE/tests.in");
+	const std::vector<uint8_t> expected_file = contents_of_file(data_path + "/FUSE/tests.expected");
+	std::istringstream input(std::string(input_file.begin(), input_file.end()));
+	std::istringstream expected(std::string(expected_file.begin(), expected_file.end()));
+
+	const auto start_time = std::chrono::steady_clock::now();
+	std::string name, expected_name, line;
+	while(input >> name) {
+		// The expectations file gives a list of bus events after the name; skip those.
+		std::getline(input, line);
+		expected >> expected_name;
+		std::getline(expected, line);
+		while(std::isspace(expected.peek())) std::getline(expected, line);
+
+		FUSEState initial_state, target_state;
+		if(name != expected_name || !initial_state.read(input) || !target_state.read(expected)) {
+			result.failures.push_back("Could not parse test " + name);
+			break;
+		}
+		++result.number_of_tests;
+
+		std::unique_ptr<CPU::Z80::AllRAMProcessor> z80(CPU::Z80::AllRAMProcessor::Processor());
+		z80->reset_power_on();
+		initial_state.apply(*z80);
+		z80->run_for(Cycles(target_state.t_states));
+		result.cycles += target_state.t_states;
+
+		// Verify that exactly the right number of cycles was run; this is a primitive cycle length test.
+		const int half_cycles_run = z80->get_timestamp().as_int();
+		if(half_cycles_run != target_state.t_states * 2) {
+			++result.timing_mismatches;
+			result.failures.push_back(name + ": instruction length off; was " + std::to_string(half_cycles_run) + " half cycles but should be " + std::to_string(target_state.t_states * 2));
+		}
+
+		for(auto &difference: target_state.differences(*z80)) {
+			result.failures.push_back(name + ": " + difference);
+		}
+	}
+	result.host_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start_time).count();
+
+	if(!result.number_of_tests) {
+		result.failures.push_back("Could not load tests.in and tests.expected");
+	}
+
+	return result;
+}
+
+// MARK: - Klaus Dormann
+
+/*!
+	Records the time at which the processor first fetches an opcode from a trapped address.
+*/
+class CompletionTrapHandler: public CPU::AllRAMProcessor::TrapHandler {
+	public:
+		bool is_done = false;
+		int64_t completion_time = 0;
+
+		void processor_did_trap(CPU::AllRAMProcessor &processor, uint16_t address) override {
+			if(is_done) return;
+			is_done = true;
+			completion_time = processor.get_timestamp().as_int() / 2;
+		}
+};
+
+SuiteResult run_dormann(const std::string &data_path) {
+	SuiteResult result;
+	result.name = "Klaus Dormann";
+	result.number_of_tests = 1;
+	result.expected_cycles = 92606007;
+
+	const std::vector<uint8_t> program = contents_of_file(data_path + "/Klaus Dormann/6502_functional_test.bin");
+	if(program.empty()) {
+		result.failures.push_back("Could not load 6502_functional_test.bin");
+		return result;
+	}
+
+	std::unique_ptr<CPU::MOS6502::AllRAMProcessor> m6502(CPU::MOS6502::AllRAMProcessor::Processor());
+	m6502->set_data_at_address(0, program.size(), program.data());
+	m6502->set_value_of_register(CPU::MOS6502::Register::ProgramCounter, 0x400);
+
+	// Time is measured up to the first arrival at the success address.
+	CompletionTrapHandler trap_handler;
+	m6502->set_trap_handler(&trap_handler);
+	m6502->add_trap_address(0x3399);
+
+	// The test signals completion, successful or otherwise, by entering a tight loop. So run
+	// until the most recent operation address ceases to change.
+	const auto start_time = std::chrono::steady_clock::now();
+	uint16_t trap_address;
+	while(true) {
+		const uint16_t old_address = m6502->get_value_of_register(CPU::MOS6502::Register::LastOperationAddress);
+		m6502->run_for(Cycles(1000));
+		trap_address = m6502->get_value_of_register(CPU::MOS6502::Register::LastOperationAddress);
+		if(trap_address == old_address || m6502->get_timestamp().as_int() / 2 > result.expected_cycles * 2) break;
+	}
+	result.cycles = trap_handler.is_done ? trap_handler.completion_time : m6502->get_timestamp().as_int() / 2;
+	result.host_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start_time).count();
+
+	switch(trap_address) {
+		case 0x3399: break;	// success!
+
+		case 0x33a7: result.failures.push_back("Decimal ADC result has wrong value");	break;
+		case 0x3502: result.failures.push_back("Binary SBC result has wrong value");	break;
+		case 0x33b9: result.failures.push_back("Decimal SBC result has wrong value");	break;
+		case 0x33c0: result.failures.push_back("Decimal SBC wrong carry flag");			break;
+		case 0x36d1: result.failures.push_back("BRK: unexpected BRK or IRQ");			break;
+		case 0x36ac:
+		case 0x36f6: result.failures.push_back("Improper JSR return address on stack");	break;
+		case 0x36e5: result.failures.push_back("BRK flag not set on stack");			break;
+		case 0x26d2: result.failures.push_back("ASL zpg,x produced incorrect flags");	break;
+		case 0x36c6: result.failures.push_back("Unexpected RESET");						break;
+
+		default: result.failures.push_back("Unknown error at " + hex(trap_address, 4));	break;
+	}
+
+	return result;
+}
+
+// MARK: - Wolfgang Lorenz
+
+/*!
+	Provides the Commodore KERNAL functions used by the Lorenz tests, capturing output, and
+	notes a test's announcement of failure.
+*/
+class KERNALTrapHandler: public CPU::AllRAMProcessor::TrapHandler {
+	public:
+		std::string output;
+		bool did_fail = false;
+		bool is_done = false;
+		int64_t completion_time = 0;
+
+		void processor_did_trap(CPU::AllRAMProcessor &processor, uint16_t address) override {
+			CPU::MOS6502::AllRAMProcessor &m6502 = static_cast<CPU::MOS6502::AllRAMProcessor &>(processor);
+			switch(address) {
+				case 0xffd2: {	// print character
+					const uint8_t zero = 0x00;
+					m6502.set_data_at_address(0x030c, 1, &zero);
+					append(static_cast<uint8_t>(m6502.get_value_of_register(CPU::MOS6502::Register::A)));
+				} break;
+
+				case 0xffe4:	// scan keyboard
+					m6502.set_value_of_register(CPU::MOS6502::Register::A, 0x03);
+				break;
+
+				case 0x8000:
+				case 0xa474:	// exit
+					did_fail = true;
+				break;
+
+				case 0xe16f:	// load, i.e. success
+					if(!is_done) {
+						is_done = true;
+						completion_time = processor.get_timestamp().as_int() / 2;
+					}
+				break;
+
+				default: break;
+			}
+		}
+
+	private:
+		// Maps PETSCII to printable ASCII, omitting control codes.
+		void append(uint8_t character) {
+			character &= 0x7f;
+			if(character == 0x0d) {
+				output.push_back(' ');
+			} else if(character >= 0x20 && character < 0x40) {
+				output.push_back(static_cast<char>(character));
+			} else if(character >= 0x40 && character < 0x60) {
+				output.push_back(static_cast<char>(character + 0x20));
+			}
+		}
+};
+
+/*!
+	@returns The names of all Lorenz tests, in the order that the Xcode tests run them.
+*/
+std::vector<std::string> lorenz_test_names() {
+	std::vector<std::string> names;
+	auto add = [&names] (const std::string &name, std::initializer_list<const char *> suffixes) {
+		for(auto suffix: suffixes) names.push_back(name + suffix);
+	};
+	const auto all_modes = {"b", "z", "zx", "a", "ax", "ay", "ix", "iy"};
+	const auto store_modes = {"z", "zx", "a", "ax", "ay", "ix", "iy"};
+	const auto shift_modes = {"n", "z", "zx", "a", "ax"};
+
+	add(" start", {""});
+	add("lda", all_modes);
+	add("sta", store_modes);
+	add("ldx", {"b", "z", "zy", "a", "ay"});
+	add("stx", {"z", "zy", "a"});
+	add("ldy", {"b", "z", "zx", "a", "ax"});
+	add("sty", {"z", "zx", "a"});
+	add("", {"taxn", "tayn", "txan", "tyan", "tsxn", "txsn"});
+	add("", {"phan", "plan", "phpn", "plpn"});
+	add("", {"inxn", "inyn", "dexn", "deyn", "incz", "inczx", "inca", "incax", "decz", "deczx", "deca", "decax"});
+	add("asl", shift_modes);
+	add("lsr", shift_modes);
+	add("rol", shift_modes);
+	add("ror", shift_modes);
+	add("and", all_modes);
+	add("ora", all_modes);
+	add("eor", all_modes);
+	add("", {"clcn", "secn", "cldn", "sedn", "clin", "sein", "clvn"});
+	add("adc", all_modes);
+	add("sbc", all_modes);
+	add("cmp", all_modes);
+	add("cpx", {"b", "z", "a"});
+	add("cpy", {"b", "z", "a"});
+	add("bit", {"z", "a"});
+	add("", {"brkn", "rtin", "jsrw", "rtsn", "jmpw", "jmpi"});
+	add("", {"beqr", "bner", "bmir", "bplr", "bcsr", "bccr", "bvsr", "bvcr"});
+	add("nop", {"n", "b", "z", "zx", "a", "ax"});
+	add("aso", store_modes);
+	add("rla", store_modes);
+	add("lse", store_modes);
+	add("rra", store_modes);
+	add("dcm", store_modes);
+	add("ins", store_modes);
+	add("lax", {"z", "zy", "a", "ay", "ix", "iy"});
+	add("axs", {"z", "zy", "a", "ix"});
+	add("", {"alrb", "arrb", "sbxb"});
+	add("sha", {"ay", "iy"});
+	add("", {"shxay", "shyax", "shsay", "lxab", "aneb", "ancb", "lasay", "sbcb(eb)"});
+
+	return names;
+}
+
+SuiteResult run_lorenz(const std::string &data_path) {
+	SuiteResult result;
+	result.name = "Wolfgang Lorenz";
+	result.expected_cycles = 3352102390;
+
+	const uint8_t irq_handler[] = {
+		0x48, 0x8a, 0x48, 0x98, 0x48, 0xba, 0xbd, 0x04, 0x01,
+		0x29, 0x10, 0xf0, 0x03, 0x6c, 0x16, 0x03, 0x6c, 0x14, 0x03
+	};
+
+	const auto start_time = std::chrono::steady_clock::now();
+	for(const auto &name: lorenz_test_names()) {
+		++result.number_of_tests;
+
+		const std::vector<uint8_t> test = contents_of_file(data_path + "/Wolfgang Lorenz 6502 test suite/" + name);
+		if(test.size() < 4) {
+			result.failures.push_back(name + ": could not load");
+			continue;
+		}
+
+		std::unique_ptr<CPU::MOS6502::AllRAMProcessor> m6502(CPU::MOS6502::AllRAMProcessor::Processor());
+		KERNALTrapHandler trap_handler;
+		m6502->set_trap_handler(&trap_handler);
+
+		// Load the test, dropping its two-byte load address and final two bytes.
+		const uint16_t load_address = static_cast<uint16_t>(test[0] | (test[1] << 8));
+		m6502->set_data_at_address(load_address, test.size() - 4, &test[2]);
+
+		// Establish enough of a Commodore environment for the tests to run, with an IRQ handler and
+		// an RTS at each KERNAL entry point used, plus a jam at the load routine, which is called
+		// upon success to load the next test.
+		auto poke = [&m6502] (uint16_t address, uint8_t value) {
+			m6502->set_data_at_address(address, 1, &value);
+		};
+		poke(0x0002, 0x00);
+		poke(0xa002, 0x00);
+		poke(0xa003, 0x80);
+		poke(0x01fe, 0xff);
+		poke(0x01ff, 0x7f);
+		poke(0xfffe, 0x48);
+		poke(0xffff, 0xff);
+		m6502->set_data_at_address(0xff48, sizeof(irq_handler), irq_handler);
+
+		for(uint16_t address: {0xffd2, 0xffe4, 0x8000, 0xa474}) {
+			m6502->add_trap_address(address);
+			poke(address, 0x60);
+		}
+		poke(0xe16f, CPU::MOS6502::JamOpcode);
+		m6502->add_trap_address(0xe16f);
+
+		m6502->set_value_of_register(CPU::MOS6502::Register::ProgramCounter, 0x0801);
+		m6502->set_value_of_register(CPU::MOS6502::Register::StackPointer, 0xfd);
+		m6502->set_value_of_register(CPU::MOS6502::Register::Flags, 0x04);
+
+		while(!m6502->is_jammed() && !trap_handler.did_fail && m6502->get_timestamp().as_int() / 2 < 100000000) {
+			m6502->run_for(Cycles(1000));
+		}
+		result.cycles += trap_handler.is_done ? trap_handler.completion_time : m6502->get_timestamp().as_int() / 2;
+
+		if(trap_handler.did_fail) {
+			result.failures.push_back(name + ": " + trap_handler.output);
+		} else if(!m6502->is_jammed()) {
+			result.failures.push_back(name + ": did not complete");
+		} else {
+			const uint16_t jammed_address = m6502->get_value_of_register(CPU::MOS6502::Register::LastOperationAddress);
+			if(jammed_address != 0xe16f) {
+				result.failures.push_back(name + ": processor jammed unexpectedly at " + hex(jammed_address, 4));
+			}
+		}
+	}
+	result.host_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start_time).count();
+
+	return result;
+}
+
+// MARK: - Argument handling
+
+void print_usage(std::ostream &stream, const char *name) {
+	stream << "Usage: " << name << " [options] [suite ...]" << std::endl;
+	stream << "Runs the named processor test suites, or all of them if none is named, reporting failures, timing and speed." << std::endl << std::endl;
+	stream << "Suites: zexall, fuse, dormann, lorenz" << std::endl << std::endl;
+	stream << "Options:" << std::endl;
+	stream << "\t--data=PATH\t\tlocation of the test data; defaults to ../Mac/Clock SignalTests, as seen from OSBindings/SDL" << std::endl;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+	const std::vector<std::pair<std::string, std::function<SuiteResult(const std::string &)>>> all_suites = {
+		{"zexall", run_zexall},
+		{"fuse", run_fuse},
+		{"dormann", run_dormann},
+		{"lorenz", run_lorenz},
+	};
+
+	std::string data_path = "../Mac/Clock SignalTests";
+	std::vector<std::pair<std::string, std::function<SuiteResult(const std::string &)>>> suites;
+	for(int index = 1; index < argc; ++index) {
+		const std::string argument = argv[index];
+		if(argument.compare(0, 7, "--data=") == 0) {
+			data_path = argument.substr(7);
+			continue;
+		}
+
+		bool found = false;
+		for(auto &suite: all_suites) {
+			if(suite.first == argument) {
+				suites.push_back(suite);
+				found = true;
+			}
+		}
+		if(!found) {
+			print_usage(std::cerr, argv[0]);
+			return argument == "--help" ? 0 : -1;
+		}
+	}
+	if(suites.empty()) suites = all_suites;
+
+	bool did_pass = true;
+	for(auto &suite: suites) {
+		const SuiteResult result = suite.second(data_path);
+		did_pass &= result.failures.empty();
+
+		for(auto &failure: result.failures) {
+			std::cout << result.name << ": " << failure << std::endl;
+		}
+
+		std::cout << result.name << ": " << (result.failures.empty() ? "passed" : "FAILED") << "; ";
+		std::cout << result.number_of_tests << " test" << (result.number_of_tests == 1 ? "" : "s") << ", ";
+		std::cout << result.failures.size() << " failure" << (result.failures.size() == 1 ? "" : "s");
+		if(result.timing_mismatches) std::cout << " (" << result.timing_mismatches << " of timing)";
+		std::cout << "; " << result.cycles << " cycles";
+		if(result.expected_cycles && result.cycles != result.expected_cycles) {
+			std::cout << ", TIMING CHANGED from " << result.expected_cycles;
+			did_pass = false;
+		}
+		std::cout << " in " << result.host_seconds << " seconds";
+		if(result.host_seconds > 0.0) std::cout << " (" << static_cast<double>(result.cycles) / (result.host_seconds * 1000000.0) << " MHz)";
+		std::cout << std::endl;
+	}
+
+	return did_pass ? 0 : -1;
+}
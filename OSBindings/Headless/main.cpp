@@ -0,0 +1,491 @@
+//
+//  main.cpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 19/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+
+#include "../../StaticAnalyser/StaticAnalyser.hpp"
+#include "../../Machines/Utility/BatchRunner.hpp"
+#include "../../Machines/Utility/MachineForTarget.hpp"
+
+#include "../../Machines/ConfigurationTarget.hpp"
+#include "../../Machines/CRTMachine.hpp"
+
+namespace {
+
+/*!
+	Receives audio from the machine's speaker, appending it to a 16-bit mono WAV file.
+*/
+struct WAVWriter: public Outputs::Speaker::Delegate {
+	WAVWriter(const std::string &file_name, int sample_rate) : sample_rate_(sample_rate) {
+		file_ = std::fopen(file_name.c_str(), "wb");
+		if(file_) write_header();
+	}
+
+	~WAVWriter() {
+		if(!file_) return;
+		std::fseek(file_, 0, SEEK_SET);
+		write_header();
+		std::fclose(file_);
+	}
+
+	bool is_open() {
+		return !!file_;
+	}
+
+	void speaker_did_complete_samples(Outputs::Speaker *speaker, const std::vector<int16_t> &buffer) {
+		std::lock_guard<std::mutex> lock_guard(file_mutex_);
+		for(auto sample: buffer) {
+			write_short(static_cast<uint16_t>(sample));
+		}
+		number_of_samples_ += static_cast<uint32_t>(buffer.size());
+	}
+
+	private:
+		void write_short(uint16_t value) {
+			std::fputc(value & 0xff, file_);
+			std::fputc(value >> 8, file_);
+		}
+
+		void write_int(uint32_t value) {
+			write_short(static_cast<uint16_t>(value));
+			write_short(static_cast<uint16_t>(value >> 16));
+		}
+
+		void write_header() {
+			const uint32_t data_size = number_of_samples_ * 2;
+			std::fputs("RIFF", file_);
+			write_int(36 + data_size);
+			std::fputs("WAVEfmt ", file_);
+			write_int(16);						// size of the format chunk
+			write_short(1);						// PCM
+			write_short(1);						// mono
+			write_int(static_cast<uint32_t>(sample_rate_));
+			write_int(static_cast<uint32_t>(sample_rate_) * 2);
+			write_short(2);						// bytes per sample frame
+			write_short(16);					// bits per sample
+			std::fputs("data", file_);
+			write_int(data_size);
+		}
+
+		std::FILE *file_ = nullptr;
+		int sample_rate_;
+		uint32_t number_of_samples_ = 0;
+		std::mutex file_mutex_;
+};
+
+/*! Writes @c pixels, packed 8-bit RGB, to @c file_name as a binary PPM. */
+bool write_ppm(const std::string &file_name, const std::vector<uint8_t> &pixels, unsigned int width, unsigned int height) {
+	std::FILE *file = std::fopen(file_name.c_str(), "wb");
+	if(!file) return false;
+	std::fprintf(file, "P6\n%u %u\n255\n", width, height);
+	std::fwrite(pixels.data(), 1, pixels.size(), file);
+	std::fclose(file);
+	return true;
+}
+
+struct ParsedArguments {
+	std::string file_name;
+	Configurable::SelectionSet selections;
+};
+
+/*! Parses an argc/argv pair to discern program arguments. */
+ParsedArguments parse_arguments(int argc, char *argv[]) {
+	ParsedArguments arguments;
+
+	for(int index = 1; index < argc; ++index) {
+		char *arg = argv[index];
+
+		// Accepted format is:
+		//
+		//	--flag			sets a Boolean option to true.
+		//	--flag=value	sets the value for a list option.
+		//	name			sets the file name to load.
+
+		// Anything starting with a dash always makes a selection; otherwise it's a file name.
+		if(arg[0] == '-') {
+			while(*arg == '-') arg++;
+
+			// Check for an equals sign, to discern a Boolean selection from a list selection.
+			std::string argument = arg;
+			std::size_t split_index = argument.find("=");
+
+			if(split_index == std::string::npos) {
+				arguments.selections[argument] =  std::unique_ptr<Configurable::Selection>(new Configurable::BooleanSelection(true));
+			} else {
+				std::string name = argument.substr(0, split_index);
+				std::string value = argument.substr(split_index+1, std::string::npos);
+				arguments.selections[name] =  std::unique_ptr<Configurable::Selection>(new Configurable::ListSelection(value));
+			}
+		} else {
+			arguments.file_name = arg;
+		}
+	}
+
+	return arguments;
+}
+
+/*!
+	Removes the selection @c name from @c arguments if present, returning its value as a string,
+	or @c default_value if it was not supplied.
+*/
+std::string take_selection(ParsedArguments &arguments, const std::string &name, const std::string &default_value) {
+	auto selection = arguments.selections.find(name);
+	if(selection == arguments.selections.end()) return default_value;
+
+	std::string value = default_value;
+	Configurable::ListSelection *list_selection = dynamic_cast<Configurable::ListSelection *>(selection->second.get());
+	if(list_selection) value = list_selection->value;
+	Configurable::BooleanSelection *boolean_selection = dynamic_cast<Configurable::BooleanSelection *>(selection->second.get());
+	if(boolean_selection) value = boolean_selection->value ? "1" : "0";
+
+	arguments.selections.erase(selection);
+	return value;
+}
+
+std::string final_path_component(const std::string &path) {
+	// An empty path has no final component.
+	if(path.empty()) {
+		return "";
+	}
+
+	// Find the last slash...
+	auto final_slash = path.find_last_of("/\\");
+
+	// If no slash was found at all, return the whole path.
+	if(final_slash == std::string::npos) {
+		return path;
+	}
+
+	// If a slash was found in the final position, remove it and recurse.
+	if(final_slash == path.size() - 1) {
+		return final_path_component(path.substr(0, path.size() - 1));
+	}
+
+	// Otherwise return everything from just after the slash to the end of the path.
+	return path.substr(final_slash+1, path.size() - final_slash - 1);
+}
+
+/*!
+	Creates a machine for @c target, looking for system ROMs in @c rom_path before the standard places, and
+	sets up its output. Reports any failure to std::cerr.
+
+	@returns The machine, or @c nullptr if it could not be created.
+*/
+std::unique_ptr<::Machine::DynamicMachine> create_machine(const StaticAnalyser::Target &target, const std::string &rom_path) {
+	std::unique_ptr<::Machine::DynamicMachine> machine(::Machine::MachineForTarget(target));
+
+	// Look for system ROMs in the same places as the SDL build, preceded by any supplied path.
+	std::vector<std::string> rom_names;
+	std::string machine_name;
+	bool roms_loaded = machine->crt_machine()->set_rom_fetcher( [&rom_names, &machine_name, &rom_path]
+		(const std::string &machine, const std::vector<std::string> &names) -> std::vector<std::unique_ptr<std::vector<uint8_t>>> {
+			rom_names.insert(rom_names.end(), names.begin(), names.end());
+			machine_name = machine;
+
+			std::vector<std::string> paths;
+			if(!rom_path.empty()) paths.push_back(rom_path + "/" + machine + "/");
+			paths.push_back("/usr/local/share/CLK/" + machine + "/");
+			paths.push_back("/usr/share/CLK/" + machine + "/");
+
+			std::vector<std::unique_ptr<std::vector<uint8_t>>> results;
+			for(auto &name: names) {
+				FILE *file = nullptr;
+				for(auto &path: paths) {
+					file = std::fopen((path + name).c_str(), "rb");
+					if(file) break;
+				}
+
+				if(!file) {
+					results.emplace_back(nullptr);
+					continue;
+				}
+
+				std::unique_ptr<std::vector<uint8_t>> data(new std::vector<uint8_t>);
+
+				std::fseek(file, 0, SEEK_END);
+				data->resize(static_cast<std::size_t>(std::ftell(file)));
+				std::fseek(file, 0, SEEK_SET);
+				std::size_t read = fread(data->data(), 1, data->size(), file);
+				std::fclose(file);
+
+				if(read == data->size())
+					results.emplace_back(std::move(data));
+				else
+					results.emplace_back(nullptr);
+			}
+
+			return results;
+		});
+
+	if(!roms_loaded) {
+		std::cerr << "Could not find system ROMs; please install to /usr/local/share/CLK/ or /usr/share/CLK/, or supply --rompath." << std::endl;
+		std::cerr << "One or more of the following were needed but not found:" << std::endl;
+		for(auto &name: rom_names) {
+			std::cerr << machine_name << '/' << name << std::endl;
+		}
+		return nullptr;
+	}
+
+	machine->configuration_target()->configure_as_target(target);
+
+	// Setup output; in this build the CRT renders in software.
+	machine->crt_machine()->setup_output(4.0 / 3.0);
+	machine->crt_machine()->get_crt()->set_output_gamma(2.2f);
+
+	return machine;
+}
+
+/*!
+	Establishes user-friendly options on @c machine by default, then applies any in @c selections.
+*/
+void apply_selections(::Machine::DynamicMachine *machine, Configurable::SelectionSet &selections) {
+	Configurable::Device *configurable_device = machine->configurable_device();
+	if(configurable_device) {
+		configurable_device->set_selections(configurable_device->get_user_friendly_selections());
+
+		// Consider transcoding any list selections that map to Boolean options.
+		for(auto &option: configurable_device->get_options()) {
+			// Check for a corresponding selection.
+			auto selection = selections.find(option->short_name);
+			if(selection != selections.end()) {
+				// Transcode selection if necessary.
+				if(dynamic_cast<Configurable::BooleanOption *>(option.get())) {
+					selections[selection->first] =  std::unique_ptr<Configurable::Selection>(selection->second->boolean_selection());
+				}
+
+				if(dynamic_cast<Configurable::ListOption *>(option.get())) {
+					selections[selection->first] =  std::unique_ptr<Configurable::Selection>(selection->second->list_selection());
+				}
+			}
+		}
+		configurable_device->set_selections(selections);
+	}
+}
+
+/*!
+	Reports overall progress to std::cerr after each slice of a batch, on a single line that is rewritten each time.
+*/
+struct BatchReporter: public ::Machine::BatchRunner::Delegate {
+	void batch_runner_did_complete_slice(::Machine::BatchRunner *runner) override {
+		std::size_t finished = 0;
+		for(std::size_t index = 0; index < runner->get_number_of_machines(); ++index) {
+			if(runner->get_progress(index).is_finished) ++finished;
+		}
+		std::cerr << "\r" << finished << " of " << runner->get_number_of_machines() << " finished; " << runner->get_total_emulated_seconds() << " seconds emulated" << std::flush;
+	}
+};
+
+void print_usage(std::ostream &stream, const char *program) {
+	stream << "Usage: " << final_path_component(program) << " [file] [OPTIONS]" << std::endl;
+	stream << "Runs the machine appropriate to the file as quickly as possible, without display or audio output." << std::endl << std::endl;
+	stream << "\t--frames=N\t\tstops after N emulated frames; the default is 500" << std::endl;
+	stream << "\t--seconds=S\t\tstops after S emulated seconds, in preference to a number of frames" << std::endl;
+	stream << "\t--frame-output=PREFIX\twrites each frame as PREFIX followed by a frame number and .ppm" << std::endl;
+	stream << "\t--audio-output=FILE\twrites all audio to FILE as a WAV" << std::endl;
+	stream << "\t--audio-rate=R\t\tsets the audio sampling rate, in Hz; the default is 44100" << std::endl;
+	stream << "\t--render\t\trenders each frame even if not writing it, to include the cost of doing so" << std::endl;
+	stream << "\t--width=W, --height=H\tsets the size of rendered frames; the default is 400x300" << std::endl;
+	stream << "\t--rompath=PATH\t\tsearches PATH for system ROMs before /usr/local/share/CLK/ and /usr/share/CLK/" << std::endl;
+	stream << "\t--instances=N\t\truns N independent copies of the machine in parallel, reporting on each; the default is 1" << std::endl;
+	stream << "\t--fork-after=S\t\truns a single machine for S emulated seconds, then starts all instances from a snapshot of it" << std::endl;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+	// Attempt to parse arguments.
+	ParsedArguments arguments = parse_arguments(argc, argv);
+
+	// Print a help message if requested.
+	if(arguments.selections.find("help") != arguments.selections.end() || arguments.selections.find("h") != arguments.selections.end()) {
+		print_usage(std::cout, argv[0]);
+		std::cout << std::endl << "Required machine type and configuration is determined from the file. Machines with further options:" << std::endl << std::endl;
+
+		auto all_options = Machine::AllOptionsByMachineName();
+		for(auto &machine_options: all_options) {
+			std::cout << machine_options.first << ":" << std::endl;
+			for(auto &option: machine_options.second) {
+				std::cout << '\t' << "--" << option->short_name;
+
+				Configurable::ListOption *list_option = dynamic_cast<Configurable::ListOption *>(option.get());
+				if(list_option) {
+					std::cout << "={";
+					bool is_first = true;
+					for(auto option: list_option->options) {
+						if(!is_first) std::cout << '|';
+						is_first = false;
+						std::cout << option;
+					}
+					std::cout << "}";
+				}
+				std::cout << std::endl;
+			}
+			std::cout << std::endl;
+		}
+		return 0;
+	}
+
+	// Perform a sanity check on arguments.
+	if(arguments.file_name.empty()) {
+		print_usage(std::cerr, argv[0]);
+		return -1;
+	}
+
+	// Pull out the options that apply to this program rather than to the machine.
+	const unsigned int number_of_frames = static_cast<unsigned int>(std::atoi(take_selection(arguments, "frames", "500").c_str()));
+	const double number_of_seconds = std::atof(take_selection(arguments, "seconds", "0").c_str());
+	const std::string frame_output = take_selection(arguments, "frame-output", "");
+	const std::string audio_output = take_selection(arguments, "audio-output", "");
+	const int audio_rate = std::atoi(take_selection(arguments, "audio-rate", "44100").c_str());
+	const bool should_render = take_selection(arguments, "render", "0") == "1" || !frame_output.empty();
+	const unsigned int width = static_cast<unsigned int>(std::atoi(take_selection(arguments, "width", "400").c_str()));
+	const unsigned int height = static_cast<unsigned int>(std::atoi(take_selection(arguments, "height", "300").c_str()));
+	const std::string rom_path = take_selection(arguments, "rompath", "");
+	const std::size_t number_of_instances = static_cast<std::size_t>(std::max(std::atoi(take_selection(arguments, "instances", "1").c_str()), 1));
+	const double fork_seconds = std::atof(take_selection(arguments, "fork-after", "0").c_str());
+
+	// Determine the machine for the supplied file.
+	std::list<StaticAnalyser::Target> targets = StaticAnalyser::GetTargets(arguments.file_name.c_str());
+	if(targets.empty()) {
+		std::cerr << "Cannot open " << arguments.file_name << std::endl;
+		return -1;
+	}
+
+	// If multiple instances were requested, hand them all to a batch runner and report on each.
+	if(number_of_instances > 1) {
+		if(!frame_output.empty() || !audio_output.empty() || should_render) {
+			std::cerr << "Frames and audio are neither rendered nor written when running multiple instances" << std::endl;
+		}
+
+		// If a fork point was requested, run one machine up to it and capture its state.
+		std::vector<uint8_t> snapshot;
+		if(fork_seconds > 0.0) {
+			std::unique_ptr<::Machine::DynamicMachine> machine = create_machine(targets.front(), rom_path);
+			if(!machine) return -1;
+			apply_selections(machine.get(), arguments.selections);
+
+			SnapshotMachine::Machine *snapshot_machine = machine->snapshot_machine();
+			if(!snapshot_machine) {
+				std::cerr << "Machine does not support snapshots; each instance will start from the beginning" << std::endl;
+			} else {
+				CRTMachine::Machine *crt_machine = machine->crt_machine();
+				std::shared_ptr<Outputs::Speaker> speaker = crt_machine->get_speaker();
+				if(speaker) speaker->set_output_rate(static_cast<float>(audio_rate), 1024);
+				crt_machine->run_for(Cycles(static_cast<int>(fork_seconds * crt_machine->get_clock_rate())));
+				snapshot = snapshot_machine->get_snapshot();
+			}
+		}
+
+		::Machine::BatchRunner runner;
+		for(std::size_t index = 0; index < number_of_instances; ++index) {
+			std::unique_ptr<::Machine::DynamicMachine> machine = create_machine(targets.front(), rom_path);
+			if(!machine) return -1;
+			apply_selections(machine.get(), arguments.selections);
+			if(!snapshot.empty() && !machine->snapshot_machine()->set_snapshot(snapshot)) {
+				std::cerr << "Could not apply snapshot to instance " << index << std::endl;
+				return -1;
+			}
+			runner.add_machine(machine.release(), audio_rate);
+		}
+
+		BatchReporter reporter;
+		runner.set_delegate(&reporter);
+		runner.run(number_of_seconds, (number_of_seconds > 0.0) ? 0 : number_of_frames);
+		std::cerr << std::endl;
+
+		for(std::size_t index = 0; index < runner.get_number_of_machines(); ++index) {
+			const ::Machine::BatchRunner::Progress progress = runner.get_progress(index);
+			std::cout << index << ": " << progress.frames << " frames, " << progress.audio_samples << " audio samples and " << progress.emulated_seconds << " seconds emulated in " << progress.host_seconds << " seconds of host time" << std::endl;
+		}
+
+		const double emulated_time = runner.get_total_emulated_seconds();
+		const double wall_time = runner.get_wall_seconds();
+		std::cout << ::Machine::LongNameForTargetMachine(targets.front().machine) << " x" << number_of_instances << ": ";
+		std::cout << emulated_time << " seconds emulated in " << wall_time << " seconds on " << Concurrency::ThreadPool::shared().get_number_of_threads() << " threads";
+		if(wall_time > 0.0) std::cout << "; " << emulated_time / wall_time << "x real time in aggregate";
+		std::cout << std::endl;
+		return 0;
+	}
+
+	// Create and configure a machine.
+	std::unique_ptr<::Machine::DynamicMachine> machine = create_machine(targets.front(), rom_path);
+	if(!machine) return -1;
+
+	// Audio is always generated, so that its cost is included, but is written only if requested.
+	std::unique_ptr<WAVWriter> wav_writer;
+	std::shared_ptr<Outputs::Speaker> speaker = machine->crt_machine()->get_speaker();
+	if(speaker) {
+		speaker->set_output_rate(static_cast<float>(audio_rate), 1024);
+		if(!audio_output.empty()) {
+			wav_writer.reset(new WAVWriter(audio_output, audio_rate));
+			if(!wav_writer->is_open()) {
+				std::cerr << "Could not open " << audio_output << " for writing" << std::endl;
+				return -1;
+			}
+			speaker->set_delegate(wav_writer.get());
+		}
+	} else if(!audio_output.empty()) {
+		std::cerr << "Machine has no audio output; " << audio_output << " will not be written" << std::endl;
+	}
+
+	apply_selections(machine.get(), arguments.selections);
+
+	// Run in slices of a millisecond, checking after each whether a frame has ended. If running for
+	// a number of frames, give up after a tenth of a second per frame in case the machine never
+	// produces vertical sync.
+	CRTMachine::Machine *crt_machine = machine->crt_machine();
+	std::shared_ptr<Outputs::CRT::CRT> crt = crt_machine->get_crt();
+	const double run_limit = (number_of_seconds > 0.0) ? number_of_seconds : static_cast<double>(number_of_frames) * 0.1;
+	double emulated_time = 0.0;
+	unsigned int frames_drawn = 0;
+	std::vector<uint8_t> frame;
+
+	const auto start_time = std::chrono::steady_clock::now();
+	while(emulated_time < run_limit && (number_of_seconds > 0.0 || crt->get_number_of_frames() < number_of_frames)) {
+		const double clock_rate = crt_machine->get_clock_rate();
+		const int cycles = std::max(static_cast<int>(clock_rate / 1000.0), 1);
+		crt_machine->run_for(Cycles(cycles));
+		emulated_time += static_cast<double>(cycles) / clock_rate;
+
+		if(should_render && crt->get_number_of_frames() != frames_drawn) {
+			frames_drawn = crt->get_number_of_frames();
+			crt->draw_frame(width, height, false);
+
+			if(!frame_output.empty()) {
+				crt->read_frame(frame);
+				char frame_number[16];
+				std::snprintf(frame_number, sizeof(frame_number), "%05u", frames_drawn);
+				if(!write_ppm(frame_output + frame_number + ".ppm", frame, width, height)) {
+					std::cerr << "Could not write frame " << frames_drawn << std::endl;
+					return -1;
+				}
+			}
+		}
+	}
+	const auto end_time = std::chrono::steady_clock::now();
+	const double wall_time = std::chrono::duration_cast<std::chrono::duration<double>>(end_time - start_time).count();
+
+	// Report.
+	std::cout << ::Machine::LongNameForTargetMachine(targets.front().machine) << ": ";
+	std::cout << crt->get_number_of_frames() << " frames and " << emulated_time << " seconds emulated in " << wall_time << " seconds";
+	if(wall_time > 0.0) std::cout << "; " << emulated_time / wall_time << "x real time";
+	std::cout << std::endl;
+
+	// Destroy the machine ahead of the WAV writer, so that any audio still queued is written.
+	crt.reset();
+	speaker.reset();
+	machine.reset();
+
+	return 0;
+}
@@ -54,6 +54,11 @@ struct UpdaterDelegate: public Concurrency::BestEffortUpdater::Delegate {
 	_updater.set_clock_rate(clockRate);
 }
 
+- (void)setRunAsUnlimited:(BOOL)runAsUnlimited {
+	_runAsUnlimited = runAsUnlimited;
+	_updater.set_run_as_unlimited(runAsUnlimited ? true : false);
+}
+
 - (void)setDelegate:(id<CSBestEffortUpdaterDelegate>)delegate {
 	[_delegateLock lock];
 	_updaterDelegate.delegate = delegate;
@@ -6,6 +6,8 @@
 //  Copyright © 2017 Thomas Harte. All rights reserved.
 //
 
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <iostream>
 #include <memory>
@@ -19,18 +21,22 @@
 #include "../../Machines/CRTMachine.hpp"
 
 #include "../../Concurrency/BestEffortUpdater.hpp"
+#include "../../Concurrency/RingBuffer.hpp"
+#include "../../Outputs/CRT/Internals/OpenGL.hpp"
 
 namespace {
 
+struct SpeakerDelegate;
+
 struct CRTMachineDelegate: public CRTMachine::Machine::Delegate {
 	void machine_did_change_clock_rate(CRTMachine::Machine *machine) {
 		best_effort_updater->set_clock_rate(machine->get_clock_rate());
 	}
 
-	void machine_did_change_clock_is_unlimited(CRTMachine::Machine *machine) {
-	}
+	void machine_did_change_clock_is_unlimited(CRTMachine::Machine *machine);
 
 	Concurrency::BestEffortUpdater *best_effort_updater;
+	SpeakerDelegate *speaker_delegate;
 };
 
 struct BestEffortUpdaterDelegate: public Concurrency::BestEffortUpdater::Delegate {
@@ -41,44 +47,89 @@ struct BestEffortUpdaterDelegate: public Concurrency::BestEffortUpdater::Delegat
 	Machine::DynamicMachine *machine;
 };
 
-// This is set to a relatively large number for now.
+/*!
+	Passes audio from the speaker to SDL via a lock-free ring buffer, so that the audio callback never
+	waits on the emulation thread, and keeps count of underruns and of the latency that buffered audio adds.
+*/
 struct SpeakerDelegate: public Outputs::Speaker::Delegate {
+	// This is set to a relatively large number for now.
 	static const int buffer_size = 1024;
 
+	SpeakerDelegate() : audio_buffer_(buffer_size * 4) {}
+
 	void speaker_did_complete_samples(Outputs::Speaker *speaker, const std::vector<int16_t> &buffer) {
-		std::lock_guard<std::mutex> lock_guard(audio_buffer_mutex_);
-		if(audio_buffer_.size() > buffer_size) {
-			audio_buffer_.erase(audio_buffer_.begin(), audio_buffer_.end() - buffer_size);
-		}
-		audio_buffer_.insert(audio_buffer_.end(), buffer.begin(), buffer.end());
+		if(is_muted) return;
+
+		// Don't allow more than two buffers' worth to queue up, to bound latency; anything beyond that is discarded.
+		const std::size_t space = std::max(static_cast<std::size_t>(buffer_size * 2), audio_buffer_.size()) - audio_buffer_.size();
+		const std::size_t written = audio_buffer_.write(buffer.data(), std::min(buffer.size(), space));
+		dropped_samples_ += buffer.size() - written;
 	}
 
 	void audio_callback(Uint8 *stream, int len) {
 		updater->update();
-		std::lock_guard<std::mutex> lock_guard(audio_buffer_mutex_);
 
-		std::size_t sample_length = static_cast<std::size_t>(len) / sizeof(int16_t);
-		std::size_t copy_length = std::min(sample_length, audio_buffer_.size());
+		const std::size_t sample_length = static_cast<std::size_t>(len) / sizeof(int16_t);
 		int16_t *target = static_cast<int16_t *>(static_cast<void *>(stream));
 
-		std::memcpy(stream, audio_buffer_.data(), copy_length * sizeof(int16_t));
+		// While muted, discard anything left over from before and output silence, without counting it as an underrun.
+		if(is_muted) {
+			audio_buffer_.read(target, sample_length);
+			std::memset(target, 0, sample_length * sizeof(int16_t));
+			return;
+		}
+
+		// Whatever is buffered at this point will be heard after the current contents of the device buffer,
+		// which are about to be replaced by this callback's worth.
+		const std::size_t buffered_samples = audio_buffer_.size();
+		total_latency_samples_ += buffered_samples + sample_length;
+		max_latency_samples_ = std::max(max_latency_samples_.load(), buffered_samples + sample_length);
+		++callbacks_;
+
+		const std::size_t copy_length = audio_buffer_.read(target, sample_length);
 		if(copy_length < sample_length) {
 			std::memset(&target[copy_length], 0, (sample_length - copy_length) * sizeof(int16_t));
+			++underruns_;
+			silent_samples_ += sample_length - copy_length;
 		}
-		audio_buffer_.erase(audio_buffer_.begin(), audio_buffer_.begin() + copy_length);
 	}
 
 	static void SDL_audio_callback(void *userdata, Uint8 *stream, int len) {
 		reinterpret_cast<SpeakerDelegate *>(userdata)->audio_callback(stream, len);
 	}
 
+	/*!
+		Writes a summary of audio underruns, overruns and latency to @c stream.
+	*/
+	void print_statistics(std::ostream &stream) {
+		if(!callbacks_) return;
+		const double milliseconds_per_sample = 1000.0 / static_cast<double>(sample_rate);
+		stream << "Audio: " << callbacks_ << " callbacks, " << underruns_ << " underruns (" << silent_samples_ << " samples of silence inserted), ";
+		stream << dropped_samples_ << " samples dropped; latency ";
+		stream << static_cast<double>(total_latency_samples_) * milliseconds_per_sample / static_cast<double>(callbacks_) << "ms average, ";
+		stream << static_cast<double>(max_latency_samples_) * milliseconds_per_sample << "ms maximum" << std::endl;
+	}
+
 	SDL_AudioDeviceID audio_device;
+	int sample_rate = 0;
 	Concurrency::BestEffortUpdater *updater;
 
-	std::mutex audio_buffer_mutex_;
-	std::vector<int16_t> audio_buffer_;
+	// Set while the machine is running unlimited, during which its audio would be unintelligible.
+	std::atomic<bool> is_muted{false};
+
+	Concurrency::RingBuffer<int16_t> audio_buffer_;
+
+	// Written only by the audio callback, other than dropped_samples_ which is written only by the speaker.
+	std::atomic<std::size_t> callbacks_{0}, underruns_{0}, silent_samples_{0}, dropped_samples_{0};
+	std::atomic<std::size_t> total_latency_samples_{0}, max_latency_samples_{0};
 };
 
+void CRTMachineDelegate::machine_did_change_clock_is_unlimited(CRTMachine::Machine *machine) {
+	const bool is_unlimited = machine->get_clock_is_unlimited();
+	best_effort_updater->set_run_as_unlimited(is_unlimited);
+	speaker_delegate->is_muted = is_unlimited;
+}
+
 bool KeyboardKeyForSDLScancode(SDL_Keycode scancode, Inputs::Keyboard::Key &key) {
 #define BIND(x, y) case SDL_SCANCODE_##x: key = Inputs::Keyboard::Key::y; break;
 	switch(scancode) {
@@ -265,6 +316,7 @@ int main(int argc, char *argv[]) {
 
 	updater.set_clock_rate(machine->crt_machine()->get_clock_rate());
 	crt_delegate.best_effort_updater = &updater;
+	crt_delegate.speaker_delegate = &speaker_delegate;
 	best_effort_updater_delegate.machine = machine.get();
 	speaker_delegate.updater = &updater;
 
@@ -376,6 +428,7 @@ int main(int argc, char *argv[]) {
 
 		speaker_delegate.audio_device = SDL_OpenAudioDevice(nullptr, 0, &desired_audio_spec, &obtained_audio_spec, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
 
+		speaker_delegate.sample_rate = obtained_audio_spec.freq;
 		speaker->set_output_rate(obtained_audio_spec.freq, desired_audio_spec.samples);
 		speaker->set_delegate(&speaker_delegate);
 		SDL_PauseAudioDevice(speaker_delegate.audio_device, 0);
@@ -474,6 +527,7 @@ int main(int argc, char *argv[]) {
 	}
 
 	// Clean up.
+	speaker_delegate.print_statistics(std::cout);
 	SDL_DestroyWindow( window );
 	SDL_Quit();
 
@@ -7,7 +7,11 @@
 //
 
 #include "CRT.hpp"
+#ifdef NO_OPENGL
+#include "Internals/CRTSoftware.hpp"
+#else
 #include "Internals/CRTOpenGL.hpp"
+#endif
 #include <cstdarg>
 #include <cmath>
 #include <algorithm>
@@ -16,7 +20,7 @@
 using namespace Outputs::CRT;
 
 void CRT::set_new_timing(unsigned int cycles_per_line, unsigned int height_of_display, ColourSpace colour_space, unsigned int colour_cycle_numerator, unsigned int colour_cycle_denominator, unsigned int vertical_sync_half_lines, bool should_alternate) {
-	openGL_output_builder_.set_colour_format(colour_space, colour_cycle_numerator, colour_cycle_denominator);
+	output_builder_->set_colour_format(colour_space, colour_cycle_numerator, colour_cycle_denominator);
 
 	const unsigned int millisecondsHorizontalRetraceTime = 7;	// source: Dictionary of Video and Television Technology, p. 234
 	const unsigned int scanlinesVerticalRetraceTime = 10;		// source: ibid
@@ -49,7 +53,7 @@ void CRT::set_new_timing(unsigned int cycles_per_line, unsigned int height_of_di
 	unsigned int real_clock_scan_period = (multiplied_cycles_per_line * height_of_display) / (time_multiplier_ * common_output_divisor_);
 	vertical_flywheel_output_divider_ = static_cast<uint16_t>(ceilf(real_clock_scan_period / 65536.0f) * (time_multiplier_ * common_output_divisor_));
 
-	openGL_output_builder_.set_timing(cycles_per_line, multiplied_cycles_per_line, height_of_display, horizontal_flywheel_->get_scan_period(), vertical_flywheel_->get_scan_period(), vertical_flywheel_output_divider_);
+	output_builder_->set_timing(cycles_per_line, multiplied_cycles_per_line, height_of_display, horizontal_flywheel_->get_scan_period(), vertical_flywheel_->get_scan_period(), vertical_flywheel_output_divider_);
 }
 
 void CRT::set_new_display_type(unsigned int cycles_per_line, DisplayType displayType) {
@@ -86,12 +90,16 @@ void CRT::set_output_gamma(float gamma) {
 
 void CRT::update_gamma() {
 	float gamma_ratio = input_gamma_ / output_gamma_;
-	openGL_output_builder_.set_gamma(gamma_ratio);
+	output_builder_->set_gamma(gamma_ratio);
 }
 
 CRT::CRT(unsigned int common_output_divisor, unsigned int buffer_depth) :
 	common_output_divisor_(common_output_divisor),
-	openGL_output_builder_(buffer_depth) {}
+#ifdef NO_OPENGL
+	output_builder_(new SoftwareOutputBuilder(buffer_depth)) {}
+#else
+	output_builder_(new OpenGLOutputBuilder(buffer_depth)) {}
+#endif
 
 CRT::CRT(	unsigned int cycles_per_line,
 			unsigned int common_output_divisor,
@@ -135,7 +143,7 @@ Flywheel::SyncEvent CRT::get_next_horizontal_sync_event(bool hsync_is_requested,
 #define source_amplitude()			next_run[SourceVertexOffsetOfPhaseTimeAndAmplitude + 1]
 
 void CRT::advance_cycles(unsigned int number_of_cycles, bool hsync_requested, bool vsync_requested, const Scan::Type type) {
-	std::unique_lock<std::mutex> output_lock = openGL_output_builder_.get_output_lock();
+	std::unique_lock<std::mutex> output_lock = output_builder_->get_output_lock();
 	number_of_cycles *= time_multiplier_;
 
 	bool is_output_run = ((type == Scan::Type::Level) || (type == Scan::Type::Data));
@@ -157,12 +165,12 @@ void CRT::advance_cycles(unsigned int number_of_cycles, bool hsync_requested, bo
 
 		bool is_output_segment = ((is_output_run && next_run_length) && !horizontal_flywheel_->is_in_retrace() && !vertical_flywheel_->is_in_retrace());
 		uint8_t *next_run = nullptr;
-		if(is_output_segment && !openGL_output_builder_.composite_output_buffer_is_full()) {
-			bool did_retain_source_data = openGL_output_builder_.texture_builder.retain_latest();
+		if(is_output_segment && !output_builder_->composite_output_buffer_is_full()) {
+			bool did_retain_source_data = output_builder_->texture_builder.retain_latest();
 			if(did_retain_source_data) {
-				next_run = openGL_output_builder_.array_builder.get_input_storage(SourceVertexSize);
+				next_run = output_builder_->array_builder.get_input_storage(SourceVertexSize);
 				if(!next_run) {
-					openGL_output_builder_.texture_builder.discard_latest();
+					output_builder_->texture_builder.discard_latest();
 				}
 			}
 		}
@@ -199,27 +207,27 @@ void CRT::advance_cycles(unsigned int number_of_cycles, bool hsync_requested, bo
 
 		if(needs_endpoint) {
 			if(
-				!openGL_output_builder_.array_builder.is_full() &&
-				!openGL_output_builder_.composite_output_buffer_is_full()) {
+				!output_builder_->array_builder.is_full() &&
+				!output_builder_->composite_output_buffer_is_full()) {
 
 				if(!is_writing_composite_run_) {
 					output_run_.x1 = static_cast<uint16_t>(horizontal_flywheel_->get_current_output_position());
 					output_run_.y = static_cast<uint16_t>(vertical_flywheel_->get_current_output_position() / vertical_flywheel_output_divider_);
 				} else {
 					// Get and write all those previously unwritten output ys
-					const uint16_t output_y = openGL_output_builder_.get_composite_output_y();
+					const uint16_t output_y = output_builder_->get_composite_output_y();
 
 					// Construct the output run
-					uint8_t *next_output_run = openGL_output_builder_.array_builder.get_output_storage(OutputVertexSize);
+					uint8_t *next_output_run = output_builder_->array_builder.get_output_storage(OutputVertexSize);
 					if(next_output_run) {
 						output_x1() = output_run_.x1;
 						output_position_y() = output_run_.y;
 						output_tex_y() = output_y;
 						output_x2() = static_cast<uint16_t>(horizontal_flywheel_->get_current_output_position());
 					}
-					openGL_output_builder_.array_builder.flush(
+					output_builder_->array_builder.flush(
 						[=] (uint8_t *input_buffer, std::size_t input_size, uint8_t *output_buffer, std::size_t output_size) {
-							openGL_output_builder_.texture_builder.flush(
+							output_builder_->texture_builder.flush(
 								[=] (const std::vector<TextureBuilder::WriteArea> &write_areas, std::size_t number_of_write_areas) {
 									assert(number_of_write_areas * SourceVertexSize == input_size);
 									for(std::size_t run = 0; run < number_of_write_areas; run++) {
@@ -239,11 +247,12 @@ void CRT::advance_cycles(unsigned int number_of_cycles, bool hsync_requested, bo
 		}
 
 		if(next_run_length == time_until_horizontal_sync_event && next_horizontal_sync_event == Flywheel::SyncEvent::StartRetrace) {
-			openGL_output_builder_.increment_composite_output_y();
+			output_builder_->increment_composite_output_y();
 		}
 
 		// if this is vertical retrace then adcance a field
 		if(next_run_length == time_until_vertical_sync_event && next_vertical_sync_event == Flywheel::SyncEvent::EndRetrace) {
+			number_of_frames_++;
 			if(delegate_) {
 				frames_since_last_delegate_call_++;
 				if(frames_since_last_delegate_call_ == 20) {
@@ -357,7 +366,7 @@ void CRT::output_blank(unsigned int number_of_cycles) {
 }
 
 void CRT::output_level(unsigned int number_of_cycles) {
-	openGL_output_builder_.texture_builder.reduce_previous_allocation_to(1);
+	output_builder_->texture_builder.reduce_previous_allocation_to(1);
 	Scan scan;
 	scan.type = Scan::Type::Level;
 	scan.number_of_cycles = number_of_cycles;
@@ -378,7 +387,7 @@ void CRT::output_default_colour_burst(unsigned int number_of_cycles) {
 }
 
 void CRT::output_data(unsigned int number_of_cycles, unsigned int source_divider) {
-	openGL_output_builder_.texture_builder.reduce_previous_allocation_to(number_of_cycles / source_divider);
+	output_builder_->texture_builder.reduce_previous_allocation_to(number_of_cycles / source_divider);
 	Scan scan;
 	scan.type = Scan::Type::Data;
 	scan.number_of_cycles = number_of_cycles;
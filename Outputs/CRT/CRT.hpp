@@ -10,10 +10,12 @@
 #define CRT_hpp
 
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 #include "CRTTypes.hpp"
 #include "Internals/Flywheel.hpp"
-#include "Internals/CRTOpenGL.hpp"
+#include "Internals/OutputBuilder.hpp"
 #include "Internals/ArrayBuilder.hpp"
 #include "Internals/TextureBuilder.hpp"
 
@@ -67,8 +69,8 @@ class CRT {
 		Flywheel::SyncEvent get_next_vertical_sync_event(bool vsync_is_requested, unsigned int cycles_to_run_for, unsigned int *cycles_advanced);
 		Flywheel::SyncEvent get_next_horizontal_sync_event(bool hsync_is_requested, unsigned int cycles_to_run_for, unsigned int *cycles_advanced);
 
-		// OpenGL state
-		OpenGLOutputBuilder openGL_output_builder_;
+		// the output builder; OpenGL unless built with NO_OPENGL, in which case software
+		std::unique_ptr<OutputBuilder> output_builder_;
 
 		// temporary storage used during the construction of output runs
 		struct {
@@ -78,13 +80,14 @@ class CRT {
 		// the delegate
 		Delegate *delegate_ = nullptr;
 		unsigned int frames_since_last_delegate_call_ = 0;
+		unsigned int number_of_frames_ = 0;
 
-		// queued tasks for the OpenGL queue; performed before the next draw
+		// queued tasks for the output builder; performed before the next draw
 		std::mutex function_mutex_;
-		std::vector<std::function<void(void)>> enqueued_openGL_functions_;
-		inline void enqueue_openGL_function(const std::function<void(void)> &function) {
+		std::vector<std::function<void(void)>> enqueued_output_functions_;
+		inline void enqueue_output_function(const std::function<void(void)> &function) {
 			std::lock_guard<std::mutex> function_guard(function_mutex_);
-			enqueued_openGL_functions_.push_back(function);
+			enqueued_output_functions_.push_back(function);
 		}
 
 		// sync counter, for determining vertical sync
@@ -222,29 +225,39 @@ class CRT {
 			@returns A pointer to the allocated area if room is available; @c nullptr otherwise.
 		*/
 		inline uint8_t *allocate_write_area(std::size_t required_length, std::size_t required_alignment = 1) {
-			std::unique_lock<std::mutex> output_lock = openGL_output_builder_.get_output_lock();
-			return openGL_output_builder_.texture_builder.allocate_write_area(required_length, required_alignment);
+			std::unique_lock<std::mutex> output_lock = output_builder_->get_output_lock();
+			return output_builder_->texture_builder.allocate_write_area(required_length, required_alignment);
 		}
 
 		/*!	Causes appropriate OpenGL or OpenGL ES calls to be issued in order to draw the current CRT state.
 			The caller is responsible for ensuring that a valid OpenGL context exists for the duration of this call.
+
+			If built with NO_OPENGL then the current CRT state is instead drawn in software, for collection via
+			@c read_frame.
 		*/
 		inline void draw_frame(unsigned int output_width, unsigned int output_height, bool only_if_dirty) {
 			{
 				std::lock_guard<std::mutex> function_guard(function_mutex_);
-				for(std::function<void(void)> function : enqueued_openGL_functions_)
+				for(std::function<void(void)> function : enqueued_output_functions_)
 				{
 					function();
 				}
-				enqueued_openGL_functions_.clear();
+				enqueued_output_functions_.clear();
 			}
-			openGL_output_builder_.draw_frame(output_width, output_height, only_if_dirty);
+			output_builder_->draw_frame(output_width, output_height, only_if_dirty);
+		}
+
+		/*!	Copies the most recently drawn frame to @c target as packed 8-bit RGB triplets, top row first,
+			at the size passed to the most recent call to @c draw_frame.
+		*/
+		inline void read_frame(std::vector<uint8_t> &target) {
+			output_builder_->read_frame(target);
 		}
 
 		/*! Sets the OpenGL framebuffer to which output is drawn. */
-		inline void set_target_framebuffer(GLint framebuffer) {
-			enqueue_openGL_function( [framebuffer, this] {
-				openGL_output_builder_.set_target_framebuffer(framebuffer);
+		inline void set_target_framebuffer(int framebuffer) {
+			enqueue_output_function( [framebuffer, this] {
+				output_builder_->set_target_framebuffer(framebuffer);
 			});
 		}
 
@@ -262,8 +275,8 @@ class CRT {
 			@c false then the references are simply marked as invalid.
 		*/
 		inline void set_openGL_context_will_change(bool should_delete_resources) {
-			enqueue_openGL_function([should_delete_resources, this] {
-				openGL_output_builder_.set_openGL_context_will_change(should_delete_resources);
+			enqueue_output_function([should_delete_resources, this] {
+				output_builder_->set_openGL_context_will_change(should_delete_resources);
 			});
 		}
 
@@ -275,8 +288,17 @@ class CRT {
 			carrier phase and amplitude.
 		*/
 		inline void set_composite_sampling_function(const std::string &shader) {
-			enqueue_openGL_function([shader, this] {
-				openGL_output_builder_.set_composite_sampling_function(shader);
+			enqueue_output_function([shader, this] {
+				output_builder_->set_composite_sampling_function(shader);
+			});
+		}
+
+		/*!	Sets the software equivalent of the function supplied to @c set_composite_sampling_function, for use
+			when drawing without OpenGL.
+		*/
+		inline void set_software_composite_sampling_function(const CompositeSamplingFunction &function) {
+			enqueue_output_function([function, this] {
+				output_builder_->set_software_composite_sampling_function(function);
 			});
 		}
 
@@ -314,24 +336,33 @@ class CRT {
 			* `vec2 icoordinate` representing the source buffer location to sample from as a pixel count, for easier multiple-pixels-per-byte unpacking.
 		*/
 		inline void set_rgb_sampling_function(const std::string &shader) {
-			enqueue_openGL_function([shader, this] {
-				openGL_output_builder_.set_rgb_sampling_function(shader);
+			enqueue_output_function([shader, this] {
+				output_builder_->set_rgb_sampling_function(shader);
+			});
+		}
+
+		/*!	Sets the software equivalent of the function supplied to @c set_rgb_sampling_function, for use
+			when drawing without OpenGL.
+		*/
+		inline void set_software_rgb_sampling_function(const RGBSamplingFunction &function) {
+			enqueue_output_function([function, this] {
+				output_builder_->set_software_rgb_sampling_function(function);
 			});
 		}
 
 		inline void set_bookender(std::unique_ptr<TextureBuilder::Bookender> bookender) {
-			openGL_output_builder_.texture_builder.set_bookender(std::move(bookender));
+			output_builder_->texture_builder.set_bookender(std::move(bookender));
 		}
 
 		inline void set_output_device(OutputDevice output_device) {
-			enqueue_openGL_function([output_device, this] {
-				openGL_output_builder_.set_output_device(output_device);
+			enqueue_output_function([output_device, this] {
+				output_builder_->set_output_device(output_device);
 			});
 		}
 
 		inline void set_visible_area(Rect visible_area) {
-			enqueue_openGL_function([visible_area, this] {
-				openGL_output_builder_.set_visible_area(visible_area);
+			enqueue_output_function([visible_area, this] {
+				output_builder_->set_visible_area(visible_area);
 			});
 		}
 
@@ -340,6 +371,13 @@ class CRT {
 		inline void set_delegate(Delegate *delegate) {
 			delegate_ = delegate;
 		}
+
+		/*!	@returns The number of fields that have been completed since this CRT was created,
+			as judged by the end of vertical retrace.
+		*/
+		inline unsigned int get_number_of_frames() {
+			return number_of_frames_;
+		}
 };
 
 }
@@ -9,6 +9,9 @@
 #ifndef CRTTypes_h
 #define CRTTypes_h
 
+#include <cstdint>
+#include <functional>
+
 namespace Outputs {
 namespace CRT {
 
@@ -41,6 +44,19 @@ enum class OutputDevice {
 	Television
 };
 
+/*!
+	The software equivalent of a GLSL `composite_sample`: evaluates to the composite signal level for the
+	source pixel at @c sample, which sits at horizontal position @c x within the source buffer as a pixel count,
+	given the colour subcarrier @c phase in radians and @c amplitude in the range [0, 1].
+*/
+typedef std::function<float(const uint8_t *sample, float x, float phase, float amplitude)> CompositeSamplingFunction;
+
+/*!
+	The software equivalent of a GLSL `rgb_sample`: writes to @c rgb the colour, in the range [0, 1] per channel,
+	of the source pixel at @c sample, which sits at horizontal position @c x within the source buffer as a pixel count.
+*/
+typedef std::function<void(const uint8_t *sample, float x, float *rgb)> RGBSamplingFunction;
+
 }
 }
 
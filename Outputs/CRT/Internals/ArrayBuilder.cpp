@@ -12,10 +12,6 @@
 
 using namespace Outputs::CRT;
 
-ArrayBuilder::ArrayBuilder(std::size_t input_size, std::size_t output_size) :
-		output_(output_size, nullptr),
-		input_(input_size, nullptr) {}
-
 ArrayBuilder::ArrayBuilder(std::size_t input_size, std::size_t output_size, std::function<void(bool is_input, uint8_t *, std::size_t)> submission_function) :
 		output_(output_size, submission_function),
 		input_(input_size, submission_function) {}
@@ -46,14 +42,6 @@ void ArrayBuilder::flush(const std::function<void(uint8_t *input, std::size_t in
 	}
 }
 
-void ArrayBuilder::bind_input() {
-	input_.bind();
-}
-
-void ArrayBuilder::bind_output() {
-	output_.bind();
-}
-
 ArrayBuilder::Submission ArrayBuilder::submit() {
 	ArrayBuilder::Submission submission;
 
@@ -70,18 +58,10 @@ ArrayBuilder::Submission ArrayBuilder::submit() {
 
 ArrayBuilder::Buffer::Buffer(std::size_t size, std::function<void(bool is_input, uint8_t *, std::size_t)> submission_function) :
 		submission_function_(submission_function) {
-	if(!submission_function_) {
-		glGenBuffers(1, &buffer);
-		glBindBuffer(GL_ARRAY_BUFFER, buffer);
-		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)size, NULL, GL_STREAM_DRAW);
-	}
 	data.resize(size);
 }
 
-ArrayBuilder::Buffer::~Buffer() {
-	if(!submission_function_)
-		glDeleteBuffers(1, &buffer);
-}
+ArrayBuilder::Buffer::~Buffer() {}
 
 uint8_t *ArrayBuilder::get_storage(std::size_t size, Buffer &buffer) {
 	uint8_t *pointer = buffer.get_storage(size);
@@ -120,27 +100,11 @@ void ArrayBuilder::Buffer::flush() {
 
 std::size_t ArrayBuilder::Buffer::submit(bool is_input) {
 	std::size_t length = flushed_data;
-	if(submission_function_) {
-		submission_function_(is_input, data.data(), length);
-	} else {
-		glBindBuffer(GL_ARRAY_BUFFER, buffer);
-		uint8_t *destination = static_cast<uint8_t *>(glMapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)length, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT));
-		if(!glGetError() && destination) {
-			std::memcpy(destination, data.data(), length);
-			glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)length);
-			glUnmapBuffer(GL_ARRAY_BUFFER);
-		} else {
-			glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)length, data.data(), GL_STREAM_DRAW);
-		}
-	}
+	submission_function_(is_input, data.data(), length);
 	submitted_data = flushed_data;
 	return length;
 }
 
-void ArrayBuilder::Buffer::bind() {
-	glBindBuffer(GL_ARRAY_BUFFER, buffer);
-}
-
 void ArrayBuilder::Buffer::reset() {
 	is_full = false;
 	allocated_data = 0;
@@ -9,19 +9,18 @@
 #ifndef ArrayBuilder_hpp
 #define ArrayBuilder_hpp
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <vector>
 
-#include "OpenGL.hpp"
-
 namespace Outputs {
 namespace CRT {
 
 /*!
 	Owns two array buffers, an 'input' and an 'output' and vends pointers to allow an owner to write provisional data into those
 	plus a flush function to lock provisional data into place. Also supplies a submit method to transfer all currently locked
-	data to the GPU and bind_input/output methods to bind the internal buffers.
+	data to whichever output builder is consuming it, via the submission function.
 
 	It is safe for one thread to communicate via the get_*_storage and flush inputs asynchronously from another that is making
 	use of the bind and submit outputs.
@@ -29,12 +28,7 @@ namespace CRT {
 class ArrayBuilder {
 	public:
 		/// Creates an instance of ArrayBuilder with @c output_size bytes of storage for the output buffer and
-		/// @c input_size bytes of storage for the input buffer.
-		ArrayBuilder(std::size_t input_size, std::size_t output_size);
-
-		/// Creates an instance of ArrayBuilder with @c output_size bytes of storage for the output buffer and
-		/// @c input_size bytes of storage for the input buffer that, rather than using OpenGL, will submit data
-		/// to the @c submission_function. [Teleological: this is provided as a testing hook.]
+		/// @c input_size bytes of storage for the input buffer that will submit data to the @c submission_function.
 		ArrayBuilder(std::size_t input_size, std::size_t output_size, std::function<void(bool is_input, uint8_t *, std::size_t)> submission_function);
 
 		/// Attempts to add @c size bytes to the input set.
@@ -53,12 +47,6 @@ class ArrayBuilder {
 		/// chance to perform last-minute processing. Otherwise acts as a no-op.
 		void flush(const std::function<void(uint8_t *input, std::size_t input_size, uint8_t *output, std::size_t output_size)> &);
 
-		/// Binds the input array to GL_ARRAY_BUFFER.
-		void bind_input();
-
-		/// Binds the output array to GL_ARRAY_BUFFER.
-		void bind_output();
-
 		struct Submission {
 			std::size_t input_size, output_size;
 		};
@@ -78,12 +66,10 @@ class ArrayBuilder {
 
 				void flush();
 				std::size_t submit(bool is_input);
-				void bind();
 				void reset();
 
 			private:
 				bool is_full = false;
-				GLuint buffer = 0;
 				std::function<void(bool is_input, uint8_t *, std::size_t)> submission_function_;
 				std::vector<uint8_t> data;
 				std::size_t allocated_data = 0;
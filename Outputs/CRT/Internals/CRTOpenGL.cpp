@@ -10,6 +10,7 @@
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 
 #include "CRTOpenGL.hpp"
 #include "../../../SignalProcessing/FIRFilter.hpp"
@@ -26,16 +27,54 @@ namespace {
 	static const GLenum filtered_texture_unit			= GL_TEXTURE4;
 
 	static const GLenum work_texture_unit				= GL_TEXTURE2;
+
+	GLint internalFormatForDepth(std::size_t depth) {
+		switch(depth) {
+			default: return GL_FALSE;
+			case 1: return GL_R8UI;
+			case 2: return GL_RG8UI;
+			case 3: return GL_RGB8UI;
+			case 4: return GL_RGBA8UI;
+		}
+	}
+
+	GLenum formatForDepth(std::size_t depth) {
+		switch(depth) {
+			default: return GL_FALSE;
+			case 1: return GL_RED_INTEGER;
+			case 2: return GL_RG_INTEGER;
+			case 3: return GL_RGB_INTEGER;
+			case 4: return GL_RGBA_INTEGER;
+		}
+	}
 }
 
 OpenGLOutputBuilder::OpenGLOutputBuilder(std::size_t bytes_per_pixel) :
-		visible_area_(Rect(0, 0, 1, 1)),
-		composite_src_output_y_(0),
+		OutputBuilder(bytes_per_pixel, [this] (bool is_input, uint8_t *data, std::size_t size) {
+			submit_array(is_input, data, size);
+		}),
 		last_output_width_(0),
 		last_output_height_(0),
-		fence_(nullptr),
-		texture_builder(bytes_per_pixel, source_data_texture_unit),
-		array_builder(SourceVertexBufferDataSize, OutputVertexBufferDataSize) {
+		fence_(nullptr) {
+	// create the source texture
+	glGenTextures(1, &source_texture_);
+	glActiveTexture(source_data_texture_unit);
+	glBindTexture(GL_TEXTURE_2D, source_texture_);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormatForDepth(bytes_per_pixel), InputBufferBuilderWidth, InputBufferBuilderHeight, 0, formatForDepth(bytes_per_pixel), GL_UNSIGNED_BYTE, nullptr);
+
+	// create the array buffers that the source and output runs are uploaded to
+	glGenBuffers(1, &input_array_buffer_);
+	glBindBuffer(GL_ARRAY_BUFFER, input_array_buffer_);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)SourceVertexBufferDataSize, NULL, GL_STREAM_DRAW);
+
+	glGenBuffers(1, &output_array_buffer_);
+	glBindBuffer(GL_ARRAY_BUFFER, output_array_buffer_);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)OutputVertexBufferDataSize, NULL, GL_STREAM_DRAW);
+
 	glBlendFunc(GL_SRC_ALPHA, GL_CONSTANT_COLOR);
 	glBlendColor(0.6f, 0.6f, 0.6f, 1.0f);
 
@@ -69,13 +108,28 @@ OpenGLOutputBuilder::OpenGLOutputBuilder(std::size_t bytes_per_pixel) :
 
 OpenGLOutputBuilder::~OpenGLOutputBuilder() {
 	glDeleteVertexArrays(1, &output_vertex_array_);
+	glDeleteBuffers(1, &input_array_buffer_);
+	glDeleteBuffers(1, &output_array_buffer_);
+	glDeleteTextures(1, &source_texture_);
+}
+
+void OpenGLOutputBuilder::submit_array(bool is_input, uint8_t *data, std::size_t size) {
+	glBindBuffer(GL_ARRAY_BUFFER, is_input ? input_array_buffer_ : output_array_buffer_);
+	uint8_t *destination = static_cast<uint8_t *>(glMapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)size, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT));
+	if(!glGetError() && destination) {
+		std::memcpy(destination, data, size);
+		glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)size);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+	} else {
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)size, data, GL_STREAM_DRAW);
+	}
 }
 
 bool OpenGLOutputBuilder::get_is_television_output() {
 	return output_device_ == OutputDevice::Television || !rgb_input_shader_program_;
 }
 
-void OpenGLOutputBuilder::set_target_framebuffer(GLint target_framebuffer) {
+void OpenGLOutputBuilder::set_target_framebuffer(int target_framebuffer) {
 	target_framebuffer_ = target_framebuffer;
 }
 
@@ -131,7 +185,15 @@ void OpenGLOutputBuilder::draw_frame(unsigned int output_width, unsigned int out
 
 	// upload new source pixels, if any
 	glActiveTexture(source_data_texture_unit);
-	texture_builder.submit();
+	glBindTexture(GL_TEXTURE_2D, source_texture_);
+	const GLenum source_format = formatForDepth(texture_builder.get_bytes_per_pixel());
+	texture_builder.submit([source_format] (const uint8_t *pixels, uint16_t first_line, uint16_t number_of_lines) {
+		glTexSubImage2D(	GL_TEXTURE_2D, 0,
+							0, first_line,
+							InputBufferBuilderWidth, number_of_lines,
+							source_format, GL_UNSIGNED_BYTE,
+							pixels);
+	});
 
 	// buffer usage restart from 0 for the next time around
 	composite_src_output_y_ = 0;
@@ -234,6 +296,28 @@ void OpenGLOutputBuilder::draw_frame(unsigned int output_width, unsigned int out
 	draw_mutex_.unlock();
 }
 
+void OpenGLOutputBuilder::read_frame(std::vector<uint8_t> &target) {
+	std::lock_guard<std::mutex> lock_guard(draw_mutex_);
+	if(!framebuffer_) {
+		target.clear();
+		return;
+	}
+
+	const std::size_t width = static_cast<std::size_t>(framebuffer_->get_width());
+	const std::size_t height = static_cast<std::size_t>(framebuffer_->get_height());
+	std::vector<uint8_t> rows(width * height * 3);
+
+	framebuffer_->bind_framebuffer();
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, (GLsizei)width, (GLsizei)height, GL_RGB, GL_UNSIGNED_BYTE, rows.data());
+
+	// OpenGL supplies the bottom row first; flip to top row first.
+	target.resize(rows.size());
+	for(std::size_t y = 0; y < height; y++) {
+		std::memcpy(&target[y * width * 3], &rows[(height - 1 - y) * width * 3], width * 3);
+	}
+}
+
 void OpenGLOutputBuilder::reset_all_OpenGL_state() {
 	composite_input_shader_program_ = nullptr;
 	composite_separation_filter_program_ = nullptr;
@@ -304,7 +388,7 @@ void OpenGLOutputBuilder::prepare_rgb_input_shaders() {
 void OpenGLOutputBuilder::prepare_source_vertex_array() {
 	if(composite_input_shader_program_) {
 		glBindVertexArray(source_vertex_array_);
-		array_builder.bind_input();
+		glBindBuffer(GL_ARRAY_BUFFER, input_array_buffer_);
 
 		using Shader = OpenGL::IntermediateShader;
 		composite_input_shader_program_->enable_vertex_attribute_with_pointer(
@@ -339,7 +423,7 @@ void OpenGLOutputBuilder::prepare_output_shader() {
 void OpenGLOutputBuilder::prepare_output_vertex_array() {
 	if(output_shader_program_) {
 		glBindVertexArray(output_vertex_array_);
-		array_builder.bind_output();
+		glBindBuffer(GL_ARRAY_BUFFER, output_array_buffer_);
 		
 		using Shader = OpenGL::OutputShader;
 		output_shader_program_->enable_vertex_attribute_with_pointer(
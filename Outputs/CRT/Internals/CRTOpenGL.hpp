@@ -12,12 +12,10 @@
 #include "../CRTTypes.hpp"
 #include "CRTConstants.hpp"
 #include "OpenGL.hpp"
+#include "OutputBuilder.hpp"
 #include "TextureTarget.hpp"
 #include "Shaders/Shader.hpp"
 
-#include "ArrayBuilder.hpp"
-#include "TextureBuilder.hpp"
-
 #include "Shaders/OutputShader.hpp"
 #include "Shaders/IntermediateShader.hpp"
 
@@ -27,26 +25,8 @@
 namespace Outputs {
 namespace CRT {
 
-class OpenGLOutputBuilder {
+class OpenGLOutputBuilder: public OutputBuilder {
 	private:
-		// colour information
-		ColourSpace colour_space_;
-		unsigned int colour_cycle_numerator_;
-		unsigned int colour_cycle_denominator_;
-		OutputDevice output_device_;
-		float gamma_;
-
-		// timing information to allow reasoning about input information
-		unsigned int input_frequency_;
-		unsigned int cycles_per_line_;
-		unsigned int height_of_display_;
-		unsigned int horizontal_scan_period_;
-		unsigned int vertical_scan_period_;
-		unsigned int vertical_period_divider_;
-
-		// The user-supplied visible area
-		Rect visible_area_;
-
 		// Other things the caller may have provided.
 		std::string composite_shader_;
 		std::string rgb_shader_;
@@ -61,11 +41,12 @@ class OpenGLOutputBuilder {
 		void prepare_source_vertex_array();
 
 		// the run and input data buffers
-		std::mutex output_mutex_;
 		std::mutex draw_mutex_;
 
-		// transient buffers indicating composite data not yet decoded
-		GLsizei composite_src_output_y_;
+		// the GPU-side copies of the source texture and run arrays
+		GLuint source_texture_;
+		GLuint input_array_buffer_, output_array_buffer_;
+		void submit_array(bool is_input, uint8_t *data, std::size_t size);
 
 		std::unique_ptr<OpenGL::OutputShader> output_shader_program_;
 
@@ -102,10 +83,6 @@ class OpenGLOutputBuilder {
 		bool get_is_television_output();
 
 	public:
-		// These two are protected by output_mutex_.
-		TextureBuilder texture_builder;
-		ArrayBuilder array_builder;
-
 		OpenGLOutputBuilder(std::size_t bytes_per_pixel);
 		~OpenGLOutputBuilder();
 
@@ -117,38 +94,18 @@ class OpenGLOutputBuilder {
 			set_colour_space_uniforms();
 		}
 
-		inline void set_visible_area(Rect visible_area) {
-			visible_area_ = visible_area;
-		}
-
 		inline void set_gamma(float gamma) {
 			gamma_ = gamma;
 			set_gamma();
 		}
 
-		inline std::unique_lock<std::mutex> get_output_lock() {
-			return std::unique_lock<std::mutex>(output_mutex_);
-		}
+		// The OpenGL pipeline has no use for the software sampling functions.
+		void set_software_composite_sampling_function(const CompositeSamplingFunction &function) {}
+		void set_software_rgb_sampling_function(const RGBSamplingFunction &function) {}
 
-		inline OutputDevice get_output_device() {
-			return output_device_;
-		}
-
-		inline uint16_t get_composite_output_y() {
-			return static_cast<uint16_t>(composite_src_output_y_);
-		}
-
-		inline bool composite_output_buffer_is_full() {
-			return composite_src_output_y_ == IntermediateBufferHeight;
-		}
-
-		inline void increment_composite_output_y() {
-			if(!composite_output_buffer_is_full())
-				composite_src_output_y_++;
-		}
-	
-		void set_target_framebuffer(GLint target_framebuffer);
+		void set_target_framebuffer(int target_framebuffer);
 		void draw_frame(unsigned int output_width, unsigned int output_height, bool only_if_dirty);
+		void read_frame(std::vector<uint8_t> &target);
 		void set_openGL_context_will_change(bool should_delete_resources);
 		void set_composite_sampling_function(const std::string &shader);
 		void set_rgb_sampling_function(const std::string &shader);
@@ -0,0 +1,582 @@
+//
+//  CRTSoftware.cpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 18/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#include "CRTSoftware.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#include "../../../SignalProcessing/FIRFilter.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace Outputs::CRT;
+
+namespace {
+	// The number of samples of padding kept at either end of each line of working storage;
+	// this must be at least half the width of the widest filter.
+	const int LinePadding = 8;
+	const int PaddedLineWidth = IntermediateBufferWidth + LinePadding*2;
+
+	const float Pi = 3.141592654f;
+
+	inline uint16_t read_short(const uint8_t *pointer) {
+		return *reinterpret_cast<const uint16_t *>(pointer);
+	}
+
+	inline float clamp(float value, float minimum, float maximum) {
+		return std::min(std::max(value, minimum), maximum);
+	}
+
+	// A minimal four-lane vector type, sufficient for the filters and blending below; each
+	// operation maps to a single SSE or NEON instruction where available.
+#if defined(__SSE2__)
+	typedef __m128 float4;
+	inline float4 load(const float *source)				{	return _mm_loadu_ps(source);		}
+	inline void store(float *target, float4 value)		{	_mm_storeu_ps(target, value);		}
+	inline float4 splat(float value)					{	return _mm_set1_ps(value);			}
+	inline float4 add(float4 lhs, float4 rhs)			{	return _mm_add_ps(lhs, rhs);		}
+	inline float4 sub(float4 lhs, float4 rhs)			{	return _mm_sub_ps(lhs, rhs);		}
+	inline float4 mul(float4 lhs, float4 rhs)			{	return _mm_mul_ps(lhs, rhs);		}
+	inline float4 min(float4 lhs, float4 rhs)			{	return _mm_min_ps(lhs, rhs);		}
+	inline float4 max(float4 lhs, float4 rhs)			{	return _mm_max_ps(lhs, rhs);		}
+#elif defined(__ARM_NEON)
+	typedef float32x4_t float4;
+	inline float4 load(const float *source)				{	return vld1q_f32(source);			}
+	inline void store(float *target, float4 value)		{	vst1q_f32(target, value);			}
+	inline float4 splat(float value)					{	return vdupq_n_f32(value);			}
+	inline float4 add(float4 lhs, float4 rhs)			{	return vaddq_f32(lhs, rhs);			}
+	inline float4 sub(float4 lhs, float4 rhs)			{	return vsubq_f32(lhs, rhs);			}
+	inline float4 mul(float4 lhs, float4 rhs)			{	return vmulq_f32(lhs, rhs);			}
+	inline float4 min(float4 lhs, float4 rhs)			{	return vminq_f32(lhs, rhs);			}
+	inline float4 max(float4 lhs, float4 rhs)			{	return vmaxq_f32(lhs, rhs);			}
+#else
+	struct float4 {
+		float v[4];
+	};
+	inline float4 load(const float *source)				{	float4 r;	for(int c = 0; c < 4; c++) r.v[c] = source[c];	return r;	}
+	inline void store(float *target, float4 value)		{	for(int c = 0; c < 4; c++) target[c] = value.v[c];				}
+	inline float4 splat(float value)					{	float4 r;	for(int c = 0; c < 4; c++) r.v[c] = value;	return r;		}
+	inline float4 add(float4 lhs, float4 rhs)			{	for(int c = 0; c < 4; c++) lhs.v[c] += rhs.v[c];	return lhs;		}
+	inline float4 sub(float4 lhs, float4 rhs)			{	for(int c = 0; c < 4; c++) lhs.v[c] -= rhs.v[c];	return lhs;		}
+	inline float4 mul(float4 lhs, float4 rhs)			{	for(int c = 0; c < 4; c++) lhs.v[c] *= rhs.v[c];	return lhs;		}
+	inline float4 min(float4 lhs, float4 rhs)			{	for(int c = 0; c < 4; c++) lhs.v[c] = std::min(lhs.v[c], rhs.v[c]);	return lhs;	}
+	inline float4 max(float4 lhs, float4 rhs)			{	for(int c = 0; c < 4; c++) lhs.v[c] = std::max(lhs.v[c], rhs.v[c]);	return lhs;	}
+#endif
+
+	// Rounds to four-sample boundaries so that the vector loops below needn't deal with remainders;
+	// the padding guarantees that doing so stays within bounds.
+	inline int round_down(int value)	{	return value & ~3;			}
+	inline int round_up(int value)		{	return (value + 3) & ~3;	}
+}
+
+SoftwareOutputBuilder::SoftwareOutputBuilder(std::size_t bytes_per_pixel) :
+		OutputBuilder(bytes_per_pixel, [this] (bool is_input, uint8_t *data, std::size_t size) {
+			submit_array(is_input, data, size);
+		}),
+		source_texture_(bytes_per_pixel * InputBufferBuilderWidth * InputBufferBuilderHeight),
+		is_colour_(PaddedLineWidth),
+		luminance_scale_(PaddedLineWidth),
+		chrominance_scale_(PaddedLineWidth),
+		filtered_(4 * IntermediateBufferWidth * IntermediateBufferHeight),
+		gamma_line_(4 * IntermediateBufferWidth) {
+	for(int c = 0; c < 3; c++) {
+		signal_[c].resize(PaddedLineWidth);
+		separated_[c].resize(PaddedLineWidth);
+	}
+	quadrature_[0].resize(PaddedLineWidth);
+	quadrature_[1].resize(PaddedLineWidth);
+}
+
+void SoftwareOutputBuilder::submit_array(bool is_input, uint8_t *data, std::size_t size) {
+	std::vector<uint8_t> &target = is_input ? source_runs_ : output_runs_;
+	target.assign(data, data + size);
+}
+
+// MARK: - Public Configuration
+
+void SoftwareOutputBuilder::set_colour_format(ColourSpace colour_space, unsigned int colour_cycle_numerator, unsigned int colour_cycle_denominator) {
+	std::lock_guard<std::mutex> output_guard(output_mutex_);
+	colour_space_ = colour_space;
+	colour_cycle_numerator_ = colour_cycle_numerator;
+	colour_cycle_denominator_ = colour_cycle_denominator;
+	derived_state_is_dirty_ = true;
+}
+
+void SoftwareOutputBuilder::set_gamma(float gamma) {
+	gamma_ = gamma;
+	derived_state_is_dirty_ = true;
+}
+
+void SoftwareOutputBuilder::set_timing(unsigned int input_frequency, unsigned int cycles_per_line, unsigned int height_of_display, unsigned int horizontal_scan_period, unsigned int vertical_scan_period, unsigned int vertical_period_divider) {
+	std::lock_guard<std::mutex> lock_guard(output_mutex_);
+	input_frequency_ = input_frequency;
+	cycles_per_line_ = cycles_per_line;
+	height_of_display_ = height_of_display;
+	horizontal_scan_period_ = horizontal_scan_period;
+	vertical_scan_period_ = vertical_scan_period;
+	vertical_period_divider_ = vertical_period_divider;
+	derived_state_is_dirty_ = true;
+}
+
+void SoftwareOutputBuilder::set_output_device(OutputDevice output_device) {
+	if(output_device_ != output_device) {
+		output_device_ = output_device;
+		composite_src_output_y_ = 0;
+	}
+}
+
+void SoftwareOutputBuilder::set_software_composite_sampling_function(const CompositeSamplingFunction &function) {
+	std::lock_guard<std::mutex> lock_guard(output_mutex_);
+	composite_sampling_function_ = function;
+}
+
+void SoftwareOutputBuilder::set_software_rgb_sampling_function(const RGBSamplingFunction &function) {
+	std::lock_guard<std::mutex> lock_guard(output_mutex_);
+	rgb_sampling_function_ = function;
+}
+
+// MARK: - Internal Configuration
+
+bool SoftwareOutputBuilder::get_is_television_output() {
+	return output_device_ == OutputDevice::Television || !rgb_sampling_function_;
+}
+
+float SoftwareOutputBuilder::get_composite_output_width() const {
+	return (static_cast<float>(colour_cycle_numerator_) * 4.0f) / static_cast<float>(colour_cycle_denominator_ * IntermediateBufferWidth);
+}
+
+void SoftwareOutputBuilder::update_derived_state() {
+	if(!derived_state_is_dirty_) return;
+	derived_state_is_dirty_ = false;
+
+	// These are the same matrices as used by the OpenGL pipeline, similarly column-major.
+	const float rgbToYUV[] = {0.299f, -0.14713f, 0.615f, 0.587f, -0.28886f, -0.51499f, 0.114f, 0.436f, -0.10001f};
+	const float yuvToRGB[] = {1.0f, 1.0f, 1.0f, 0.0f, -0.39465f, 2.03211f, 1.13983f, -0.58060f, 0.0f};
+
+	const float rgbToYIQ[] = {0.299f, 0.596f, 0.211f, 0.587f, -0.274f, -0.523f, 0.114f, -0.322f, 0.312f};
+	const float yiqToRGB[] = {1.0f, 1.0f, 1.0f, 0.956f, -0.272f, -1.106f, 0.621f, -0.647f, 1.703f};
+
+	switch(colour_space_) {
+		case ColourSpace::YIQ:
+			std::memcpy(from_rgb_, rgbToYIQ, sizeof(from_rgb_));
+			std::memcpy(to_rgb_, yiqToRGB, sizeof(to_rgb_));
+		break;
+
+		case ColourSpace::YUV:
+			std::memcpy(from_rgb_, rgbToYUV, sizeof(from_rgb_));
+			std::memcpy(to_rgb_, yuvToRGB, sizeof(to_rgb_));
+		break;
+
+		default:	assert(false);	break;
+	}
+
+	// The RGB filter is the same eleven-tap low-pass filter as the OpenGL pipeline uses.
+	const float sample_cycles_per_line = cycles_per_line_ / get_composite_output_width();
+	SignalProcessing::FIRFilter filter(11, sample_cycles_per_line, 0.0f, static_cast<float>(input_frequency_) * 0.5f, SignalProcessing::FIRFilter::DefaultAttenuation);
+	std::vector<float> coefficients = filter.get_coefficients();
+	for(std::size_t c = 0; c < 11; c++) {
+		rgb_filter_coefficients_[c] = coefficients[c];
+	}
+
+	// Gamma is applied via lookup, to the eight-bit filtered values.
+	for(int c = 0; c < 256; c++) {
+		gamma_table_[c] = powf(static_cast<float>(c) / 255.0f, gamma_);
+	}
+}
+
+// MARK: - Drawing
+
+void SoftwareOutputBuilder::draw_frame(unsigned int output_width, unsigned int output_height, bool only_if_dirty) {
+	std::lock_guard<std::mutex> draw_guard(draw_mutex_);
+
+	// make sure there's a target to draw to
+	if(framebuffer_width_ != output_width || framebuffer_height_ != output_height) {
+		framebuffer_width_ = output_width;
+		framebuffer_height_ = output_height;
+		framebuffer_.assign(4 * output_width * output_height, 0.0f);
+	}
+
+	// lock out the machine emulation until data is copied
+	output_mutex_.lock();
+
+	ArrayBuilder::Submission array_submission = array_builder.submit();
+	const std::size_t bytes_per_pixel = texture_builder.get_bytes_per_pixel();
+	texture_builder.submit([this, bytes_per_pixel] (const uint8_t *pixels, uint16_t first_line, uint16_t number_of_lines) {
+		std::memcpy(
+			&source_texture_[first_line * InputBufferBuilderWidth * bytes_per_pixel],
+			pixels,
+			number_of_lines * InputBufferBuilderWidth * bytes_per_pixel);
+	});
+
+	// buffer usage restart from 0 for the next time around
+	composite_src_output_y_ = 0;
+
+	// data having been grabbed, allow the machine to continue
+	output_mutex_.unlock();
+
+	if(!array_submission.input_size && !array_submission.output_size) return;
+	if(array_submission.input_size != source_runs_.size()) source_runs_.clear();
+	if(array_submission.output_size != output_runs_.size()) output_runs_.clear();
+
+	update_derived_state();
+
+	// Bucket the source runs by the intermediate line they target.
+	const int number_of_runs = static_cast<int>(source_runs_.size() / SourceVertexSize);
+	int number_of_lines = 0;
+	for(int run = 0; run < number_of_runs; run++) {
+		const int line = read_short(&source_runs_[run * SourceVertexSize + SourceVertexOffsetOfOutputStart + 2]);
+		number_of_lines = std::max(number_of_lines, line + 1);
+	}
+	for(std::size_t run = 0; run < output_runs_.size(); run += OutputVertexSize) {
+		const int line = read_short(&output_runs_[run + OutputVertexOffsetOfVertical + 2]);
+		number_of_lines = std::max(number_of_lines, line + 1);
+	}
+	number_of_lines = std::min(number_of_lines, IntermediateBufferHeight);
+
+	line_starts_.assign(static_cast<std::size_t>(number_of_lines + 1), 0);
+	line_run_indices_.resize(static_cast<std::size_t>(number_of_runs));
+	for(int run = 0; run < number_of_runs; run++) {
+		const int line = read_short(&source_runs_[run * SourceVertexSize + SourceVertexOffsetOfOutputStart + 2]);
+		if(line < number_of_lines) line_starts_[line + 1]++;
+	}
+	for(int line = 0; line < number_of_lines; line++) {
+		line_starts_[line + 1] += line_starts_[line];
+	}
+	std::vector<int> fill_positions(line_starts_.begin(), line_starts_.end() - 1);
+	for(int run = 0; run < number_of_runs; run++) {
+		const int line = read_short(&source_runs_[run * SourceVertexSize + SourceVertexOffsetOfOutputStart + 2]);
+		if(line < number_of_lines) line_run_indices_[static_cast<std::size_t>(fill_positions[line]++)] = run;
+	}
+
+	// Convert each line to filtered RGB.
+	const float output_scale = get_is_television_output() ? get_composite_output_width() : 1.0f;
+	for(int line = 0; line < number_of_lines; line++) {
+		sample_line(line, output_scale);
+	}
+
+	paint_scans(output_width, output_height);
+}
+
+void SoftwareOutputBuilder::sample_line(int line, float output_width) {
+	uint8_t *const filtered_line = &filtered_[static_cast<std::size_t>(line * IntermediateBufferWidth * 4)];
+	std::memset(filtered_line, 0, IntermediateBufferWidth * 4);
+
+	const int first_run = line_starts_[line];
+	const int end_run = line_starts_[line + 1];
+	if(first_run == end_run) return;
+
+	const bool is_television = get_is_television_output();
+	if(is_television && !composite_sampling_function_ && !rgb_sampling_function_) return;
+
+	// Establish the extent of this line that is touched by runs, and clear it.
+	int start = IntermediateBufferWidth, end = 0;
+	for(int index = first_run; index < end_run; index++) {
+		const uint8_t *run = &source_runs_[static_cast<std::size_t>(line_run_indices_[index] * SourceVertexSize)];
+		const float x1 = read_short(&run[SourceVertexOffsetOfOutputStart]) * output_width;
+		const float x2 = read_short(&run[SourceVertexOffsetOfEnds + 2]) * output_width;
+		start = std::min(start, static_cast<int>(ceilf(x1 - 0.5f)));
+		end = std::max(end, static_cast<int>(ceilf(x2 - 0.5f)));
+	}
+	start = std::max(start, 0);
+	end = std::min(end, IntermediateBufferWidth);
+	if(start >= end) return;
+
+	const int clear_start = round_down(start) - 4 + LinePadding;
+	const int clear_end = round_up(end) + 4 + LinePadding;
+	for(int c = 0; c < 3; c++) {
+		std::fill(&signal_[c][static_cast<std::size_t>(clear_start)], &signal_[c][static_cast<std::size_t>(clear_end)], 0.0f);
+	}
+	std::fill(&is_colour_[static_cast<std::size_t>(clear_start)], &is_colour_[static_cast<std::size_t>(clear_end)], 0.0f);
+	std::fill(&luminance_scale_[static_cast<std::size_t>(clear_start)], &luminance_scale_[static_cast<std::size_t>(clear_end)], 0.0f);
+	std::fill(&chrominance_scale_[static_cast<std::size_t>(clear_start)], &chrominance_scale_[static_cast<std::size_t>(clear_end)], 0.0f);
+	std::fill(&quadrature_[0][static_cast<std::size_t>(clear_start)], &quadrature_[0][static_cast<std::size_t>(clear_end)], 0.0f);
+	std::fill(&quadrature_[1][static_cast<std::size_t>(clear_start)], &quadrature_[1][static_cast<std::size_t>(clear_end)], 0.0f);
+
+	// Sample each run, mapping linearly from its input range to its output range.
+	const std::size_t bytes_per_pixel = texture_builder.get_bytes_per_pixel();
+	for(int index = first_run; index < end_run; index++) {
+		const uint8_t *run = &source_runs_[static_cast<std::size_t>(line_run_indices_[index] * SourceVertexSize)];
+		const int input_x1 = read_short(&run[SourceVertexOffsetOfInputStart]);
+		const int input_y = read_short(&run[SourceVertexOffsetOfInputStart + 2]);
+		const int input_x2 = read_short(&run[SourceVertexOffsetOfEnds]);
+		const float output_x1 = read_short(&run[SourceVertexOffsetOfOutputStart]) * output_width;
+		const float output_x2 = read_short(&run[SourceVertexOffsetOfEnds + 2]) * output_width;
+		if(output_x2 <= output_x1 || input_y >= InputBufferBuilderHeight) continue;
+
+		const uint8_t *input_line = &source_texture_[static_cast<std::size_t>(input_y * InputBufferBuilderWidth) * bytes_per_pixel];
+		const float input_step = static_cast<float>(input_x2 - input_x1) / (output_x2 - output_x1);
+		const int first_sample = std::max(static_cast<int>(ceilf(output_x1 - 0.5f)), 0);
+		const int end_sample = std::min(static_cast<int>(ceilf(output_x2 - 0.5f)), IntermediateBufferWidth);
+
+		const auto source_pixel = [=] (int sample, float &input_x) -> const uint8_t * {
+			input_x = input_x1 + (static_cast<float>(sample) + 0.5f - output_x1) * input_step;
+			const int texel = std::min(std::max(static_cast<int>(input_x), std::max(input_x1 - 1, 0)), InputBufferBuilderWidth - 1);
+			return &input_line[static_cast<std::size_t>(texel) * bytes_per_pixel];
+		};
+
+		if(!is_television) {
+			float rgb[3];
+			for(int sample = first_sample; sample < end_sample; sample++) {
+				float input_x;
+				const uint8_t *pixel = source_pixel(sample, input_x);
+				rgb_sampling_function_(pixel, input_x, rgb);
+				signal_[0][static_cast<std::size_t>(sample + LinePadding)] = rgb[0];
+				signal_[1][static_cast<std::size_t>(sample + LinePadding)] = rgb[1];
+				signal_[2][static_cast<std::size_t>(sample + LinePadding)] = rgb[2];
+			}
+			continue;
+		}
+
+		// The colour subcarrier advances by a quarter of a cycle per sample, so cos and sin of its phase
+		// need be calculated only once per run, thereafter being rotated.
+		const float amplitude = static_cast<float>(run[SourceVertexOffsetOfPhaseTimeAndAmplitude + 1]) / 255.0f;
+		const float phase_offset = static_cast<float>(run[SourceVertexOffsetOfPhaseTimeAndAmplitude + 0]) / 64.0f;
+		const float base_phase = (static_cast<float>(first_sample) + 0.5f + phase_offset) * 0.5f * Pi;
+		float cos_phase = cosf(base_phase), sin_phase = sinf(base_phase);
+
+		// Separation will use luminance averaged over a colour cycle if there is a colour subcarrier,
+		// and a lightly-filtered version otherwise.
+		const float is_colour = (amplitude > 0.0f) ? 1.0f : 0.0f;
+		const float luminance_scale = (amplitude > 0.0f) ? 1.0f / (1.0f - amplitude) : 0.0f;
+		const float chrominance_scale = (amplitude > 0.0f) ? 0.5f / amplitude : 0.0f;
+		if(first_sample < end_sample) {
+			const std::size_t first_target = static_cast<std::size_t>(first_sample + LinePadding);
+			const std::size_t end_target = static_cast<std::size_t>(end_sample + LinePadding);
+			std::fill(&is_colour_[first_target], &is_colour_[end_target], is_colour);
+			std::fill(&luminance_scale_[first_target], &luminance_scale_[end_target], luminance_scale);
+			std::fill(&chrominance_scale_[first_target], &chrominance_scale_[end_target], chrominance_scale);
+		}
+
+		for(int sample = first_sample; sample < end_sample; sample++) {
+			const std::size_t target = static_cast<std::size_t>(sample + LinePadding);
+			float input_x;
+			const uint8_t *pixel = source_pixel(sample, input_x);
+
+			if(composite_sampling_function_) {
+				const float phase = (static_cast<float>(sample) + 0.5f + phase_offset) * 0.5f * Pi;
+				signal_[0][target] = composite_sampling_function_(pixel, input_x, phase, amplitude);
+			} else {
+				float rgb[3];
+				rgb_sampling_function_(pixel, input_x, rgb);
+				for(int c = 0; c < 3; c++) rgb[c] = clamp(rgb[c], 0.0f, 1.0f);
+				const float luma_chroma[3] = {
+					from_rgb_[0]*rgb[0] + from_rgb_[3]*rgb[1] + from_rgb_[6]*rgb[2],
+					from_rgb_[1]*rgb[0] + from_rgb_[4]*rgb[1] + from_rgb_[7]*rgb[2],
+					from_rgb_[2]*rgb[0] + from_rgb_[5]*rgb[1] + from_rgb_[8]*rgb[2],
+				};
+				signal_[0][target] =
+					luma_chroma[0] * (1.0f - amplitude) +
+					luma_chroma[1] * cos_phase * amplitude -
+					luma_chroma[2] * sin_phase * amplitude;
+			}
+			signal_[0][target] = clamp(signal_[0][target], 0.0f, 1.0f);
+			quadrature_[0][target] = cos_phase;
+			quadrature_[1][target] = sin_phase;
+
+			// Advance by a quarter turn.
+			const float next_cos = -sin_phase;
+			sin_phase = cos_phase;
+			cos_phase = next_cos;
+		}
+	}
+
+	if(is_television) {
+		decode_composite_line(line, start, end);
+	} else {
+		filter_rgb_line(line, start, end);
+	}
+}
+
+void SoftwareOutputBuilder::decode_composite_line(int line, int start, int end) {
+	float *const composite = &signal_[0][LinePadding];
+	float *const is_colour = &is_colour_[LinePadding];
+	float *const luminance_scale = &luminance_scale_[LinePadding];
+	float *const chrominance_scale = &chrominance_scale_[LinePadding];
+	float *const cosine = &quadrature_[0][LinePadding];
+	float *const sine = &quadrature_[1][LinePadding];
+	float *const luminance = &separated_[0][LinePadding];
+	float *const chroma_u = &separated_[1][LinePadding];
+	float *const chroma_v = &separated_[2][LinePadding];
+
+	// Separate luminance and chrominance: where there's a colour subcarrier, luminance is the average
+	// over a complete colour cycle and chrominance is whatever remains; otherwise luminance is lightly
+	// filtered and there is no chrominance.
+	const int vector_start = round_down(start) - 4;
+	const int vector_end = round_up(end) + 4;
+	const float4 zero = splat(0.0f), one = splat(1.0f), half = splat(0.5f), quarter = splat(0.25f);
+	const float4 side_weight = splat(0.16f), centre_weight = splat(0.66f);
+	for(int x = vector_start; x < vector_end; x += 4) {
+		const float4 previous2 = load(&composite[x - 2]);
+		const float4 previous = load(&composite[x - 1]);
+		const float4 current = load(&composite[x]);
+		const float4 next = load(&composite[x + 1]);
+
+		const float4 average = mul(add(add(previous2, previous), add(current, next)), quarter);
+		const float4 smoothed = add(mul(add(previous, next), side_weight), mul(current, centre_weight));
+
+		const float4 luma = add(sub(smoothed, mul(smoothed, load(&is_colour[x]))), mul(average, load(&luminance_scale[x])));
+
+		// chrominance is 0.5 * (composite - average) / amplitude, demodulated by the subcarrier
+		const float4 chroma = mul(sub(current, average), load(&chrominance_scale[x]));
+		store(&luminance[x], min(max(luma, zero), one));
+		store(&chroma_u[x], min(max(mul(chroma, load(&cosine[x])), sub(zero, half)), half));
+		store(&chroma_v[x], min(max(sub(zero, mul(chroma, load(&sine[x]))), sub(zero, half)), half));
+	}
+
+	// Filter chrominance over a complete colour cycle, then convert to RGB.
+	uint8_t *const filtered_line = &filtered_[static_cast<std::size_t>(line * IntermediateBufferWidth * 4)];
+	const float4 two = splat(2.0f);
+	const float4 scale = splat(255.0f);
+	const float4 matrix[9] = {
+		splat(to_rgb_[0]), splat(to_rgb_[1]), splat(to_rgb_[2]),
+		splat(to_rgb_[3]), splat(to_rgb_[4]), splat(to_rgb_[5]),
+		splat(to_rgb_[6]), splat(to_rgb_[7]), splat(to_rgb_[8]),
+	};
+	const int output_start = round_down(start);
+	const int output_end = std::min(round_up(end), IntermediateBufferWidth);
+	for(int x = output_start; x < output_end; x += 4) {
+		const float4 y = load(&luminance[x]);
+		const float4 u = mul(mul(add(add(load(&chroma_u[x - 2]), load(&chroma_u[x - 1])), add(load(&chroma_u[x]), load(&chroma_u[x + 1]))), quarter), two);
+		const float4 v = mul(mul(add(add(load(&chroma_v[x - 2]), load(&chroma_v[x - 1])), add(load(&chroma_v[x]), load(&chroma_v[x + 1]))), quarter), two);
+
+		float rgb[3][4];
+		for(int c = 0; c < 3; c++) {
+			const float4 channel = add(add(mul(matrix[c], y), mul(matrix[3 + c], u)), mul(matrix[6 + c], v));
+			store(rgb[c], mul(min(max(channel, zero), one), scale));
+		}
+		for(int c = 0; c < 4; c++) {
+			uint8_t *const pixel = &filtered_line[(x + c) * 4];
+			pixel[0] = static_cast<uint8_t>(rgb[0][c] + 0.5f);
+			pixel[1] = static_cast<uint8_t>(rgb[1][c] + 0.5f);
+			pixel[2] = static_cast<uint8_t>(rgb[2][c] + 0.5f);
+		}
+	}
+}
+
+void SoftwareOutputBuilder::filter_rgb_line(int line, int start, int end) {
+	uint8_t *const filtered_line = &filtered_[static_cast<std::size_t>(line * IntermediateBufferWidth * 4)];
+	const float4 zero = splat(0.0f), one = splat(1.0f), scale = splat(255.0f);
+
+	float4 coefficients[11];
+	for(int c = 0; c < 11; c++) coefficients[c] = splat(rgb_filter_coefficients_[c]);
+
+	const int output_start = round_down(start);
+	const int output_end = std::min(round_up(end), IntermediateBufferWidth);
+	for(int x = output_start; x < output_end; x += 4) {
+		float rgb[3][4];
+		for(int c = 0; c < 3; c++) {
+			const float *const channel = &signal_[c][static_cast<std::size_t>(x + LinePadding - 5)];
+			float4 total = zero;
+			for(int tap = 0; tap < 11; tap++) {
+				total = add(total, mul(load(&channel[tap]), coefficients[tap]));
+			}
+			store(rgb[c], mul(min(max(total, zero), one), scale));
+		}
+		for(int c = 0; c < 4; c++) {
+			uint8_t *const pixel = &filtered_line[(x + c) * 4];
+			pixel[0] = static_cast<uint8_t>(rgb[0][c] + 0.5f);
+			pixel[1] = static_cast<uint8_t>(rgb[1][c] + 0.5f);
+			pixel[2] = static_cast<uint8_t>(rgb[2][c] + 0.5f);
+		}
+	}
+}
+
+void SoftwareOutputBuilder::paint_scans(unsigned int output_width, unsigned int output_height) {
+	// Determine the visible area, adjusted for aspect ratio exactly as the OpenGL output shader does.
+	Rect visible_area = visible_area_;
+	const float aspect_ratio_multiplier = (static_cast<float>(output_width) / static_cast<float>(output_height)) / (4.0f / 3.0f);
+	const float bonus_width = (aspect_ratio_multiplier - 1.0f) * visible_area.size.width;
+	visible_area.origin.x -= bonus_width * 0.5f * visible_area.size.width;
+	visible_area.size.width *= aspect_ratio_multiplier;
+
+	const float scan_angle = atan2f(1.0f / static_cast<float>(height_of_display_), 1.0f);
+	const float scan_thickness = cosf(scan_angle) * static_cast<float>(cycles_per_line_) / (static_cast<float>(height_of_display_) * static_cast<float>(horizontal_scan_period_));
+	const float horizontal_conversion = static_cast<float>(horizontal_scan_period_);
+	const float vertical_conversion = static_cast<float>(vertical_scan_period_) / static_cast<float>(vertical_period_divider_);
+	const float input_scaler = get_is_television_output() ? get_composite_output_width() : 1.0f;
+
+	const float width = static_cast<float>(output_width);
+	const float height = static_cast<float>(output_height);
+	const float4 source_weight = splat(0.5f), destination_weight = splat(0.6f), one = splat(1.0f);
+
+	for(std::size_t index = 0; index < output_runs_.size(); index += OutputVertexSize) {
+		const uint8_t *run = &output_runs_[index];
+		const uint16_t x1 = read_short(&run[OutputVertexOffsetOfHorizontal]);
+		const uint16_t x2 = read_short(&run[OutputVertexOffsetOfHorizontal + 2]);
+		const uint16_t position_y = read_short(&run[OutputVertexOffsetOfVertical]);
+		const uint16_t tex_y = read_short(&run[OutputVertexOffsetOfVertical + 2]);
+		if(x2 <= x1 || tex_y >= IntermediateBufferHeight) continue;
+
+		// Map to output pixels.
+		const float left = ((static_cast<float>(x1) / horizontal_conversion) - visible_area.origin.x) / visible_area.size.width * width;
+		const float right = ((static_cast<float>(x2) / horizontal_conversion) - visible_area.origin.x) / visible_area.size.width * width;
+		const float top_position = static_cast<float>(position_y) / vertical_conversion;
+		const float top = (top_position - visible_area.origin.y) / visible_area.size.height * height;
+		const float bottom = (top_position + scan_thickness - visible_area.origin.y) / visible_area.size.height * height;
+
+		const int first_column = std::max(static_cast<int>(ceilf(left - 0.5f)), 0);
+		const int end_column = std::min(static_cast<int>(ceilf(right - 0.5f)), static_cast<int>(output_width));
+		const int first_row = std::max(static_cast<int>(ceilf(top - 0.5f)), 0);
+		const int end_row = std::min(static_cast<int>(ceilf(bottom - 0.5f)), static_cast<int>(output_height));
+		if(first_column >= end_column || first_row >= end_row) continue;
+
+		// Source positions are quantised to whole texels at the ends of each run, then sampled with
+		// linear filtering in between.
+		const float source_left = floorf(static_cast<float>(x1) * input_scaler);
+		const float source_right = floorf(static_cast<float>(x2) * input_scaler);
+		const float source_step = (source_right - source_left) / (right - left);
+		const uint8_t *const source_line = &filtered_[static_cast<std::size_t>(tex_y * IntermediateBufferWidth * 4)];
+
+		// Apply gamma to the portion of the source line in use.
+		const int first_texel = std::max(static_cast<int>(source_left) - 1, 0);
+		const int end_texel = std::min(static_cast<int>(source_right) + 2, IntermediateBufferWidth);
+		for(int texel = first_texel; texel < end_texel; texel++) {
+			float *const colour = &gamma_line_[static_cast<std::size_t>(texel * 4)];
+			colour[0] = gamma_table_[source_line[texel*4 + 0]];
+			colour[1] = gamma_table_[source_line[texel*4 + 1]];
+			colour[2] = gamma_table_[source_line[texel*4 + 2]];
+		}
+
+		float source_x = source_left + (static_cast<float>(first_column) + 0.5f - left) * source_step - 0.5f;
+		for(int column = first_column; column < end_column; column++) {
+			// source_x is never less than -1, so truncation is flooring here.
+			const int texel = static_cast<int>(source_x + 1.0f) - 1;
+			const float4 fraction = splat(source_x - static_cast<float>(texel));
+			source_x += source_step;
+
+			const int left_texel = std::min(std::max(texel, first_texel), end_texel - 1);
+			const int right_texel = std::min(std::max(texel + 1, first_texel), end_texel - 1);
+			const float4 left_colour = load(&gamma_line_[static_cast<std::size_t>(left_texel * 4)]);
+			const float4 right_colour = load(&gamma_line_[static_cast<std::size_t>(right_texel * 4)]);
+			const float4 source = mul(add(left_colour, mul(sub(right_colour, left_colour), fraction)), source_weight);
+
+			for(int row = first_row; row < end_row; row++) {
+				float *const destination = &framebuffer_[(static_cast<std::size_t>(row) * output_width + static_cast<std::size_t>(column)) * 4];
+				store(destination, min(add(source, mul(load(destination), destination_weight)), one));
+			}
+		}
+	}
+}
+
+void SoftwareOutputBuilder::read_frame(std::vector<uint8_t> &target) {
+	std::lock_guard<std::mutex> lock_guard(draw_mutex_);
+	const std::size_t pixels = static_cast<std::size_t>(framebuffer_width_) * static_cast<std::size_t>(framebuffer_height_);
+	target.resize(pixels * 3);
+	for(std::size_t pixel = 0; pixel < pixels; pixel++) {
+		for(std::size_t c = 0; c < 3; c++) {
+			target[pixel * 3 + c] = static_cast<uint8_t>(framebuffer_[pixel * 4 + c] * 255.0f + 0.5f);
+		}
+	}
+}
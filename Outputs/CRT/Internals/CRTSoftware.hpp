@@ -0,0 +1,106 @@
+//
+//  CRTSoftware.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 18/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#ifndef CRTSoftware_hpp
+#define CRTSoftware_hpp
+
+#include "../CRTTypes.hpp"
+#include "CRTConstants.hpp"
+#include "OutputBuilder.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace Outputs {
+namespace CRT {
+
+/*!
+	Reconstructs frames entirely on the CPU, following the same stages as the OpenGL pipeline: source pixels are
+	sampled into a per-line signal, composite signals are separated into luminance and chrominance and then
+	filtered, RGB signals are low-pass filtered, and the results are painted as scans into an accumulation
+	buffer with the same persistence as the OpenGL output.
+
+	Only the software sampling functions are used; the GLSL versions are ignored. The frame most recently
+	drawn can be obtained via @c read_frame.
+*/
+class SoftwareOutputBuilder: public OutputBuilder {
+	public:
+		SoftwareOutputBuilder(std::size_t bytes_per_pixel);
+
+		void set_colour_format(ColourSpace colour_space, unsigned int colour_cycle_numerator, unsigned int colour_cycle_denominator) override;
+		void set_gamma(float gamma) override;
+		void set_timing(unsigned int input_frequency, unsigned int cycles_per_line, unsigned int height_of_display, unsigned int horizontal_scan_period, unsigned int vertical_scan_period, unsigned int vertical_period_divider) override;
+		void set_output_device(OutputDevice output_device) override;
+
+		// The software pipeline has no use for the GLSL sampling functions.
+		void set_composite_sampling_function(const std::string &shader) override {}
+		void set_rgb_sampling_function(const std::string &shader) override {}
+		void set_software_composite_sampling_function(const CompositeSamplingFunction &function) override;
+		void set_software_rgb_sampling_function(const RGBSamplingFunction &function) override;
+
+		// There is no OpenGL state to speak of.
+		void set_target_framebuffer(int target_framebuffer) override {}
+		void set_openGL_context_will_change(bool should_delete_resources) override {}
+
+		void draw_frame(unsigned int output_width, unsigned int output_height, bool only_if_dirty) override;
+		void read_frame(std::vector<uint8_t> &target) override;
+
+	private:
+		CompositeSamplingFunction composite_sampling_function_;
+		RGBSamplingFunction rgb_sampling_function_;
+
+		// Copies of the source texture and of the most recent run submissions.
+		std::vector<uint8_t> source_texture_;
+		std::vector<uint8_t> source_runs_;
+		std::vector<uint8_t> output_runs_;
+		void submit_array(bool is_input, uint8_t *data, std::size_t size);
+
+		// Source runs bucketed by the intermediate line they target.
+		std::vector<int> line_starts_;
+		std::vector<int> line_run_indices_;
+
+		// Per-line working storage, each padded at both ends so that filters can read beyond the
+		// extremes of a line; 'signal' holds composite levels or RGB, depending on the pipeline.
+		std::vector<float> signal_[3];
+		std::vector<float> is_colour_, luminance_scale_, chrominance_scale_;
+		std::vector<float> quadrature_[2];
+		std::vector<float> separated_[3];
+
+		// The filtered result, as the OpenGL pipeline would store it: eight bits per channel,
+		// with a fourth unused channel for alignment.
+		std::vector<uint8_t> filtered_;
+
+		// A single line of the filtered result, with gamma applied, as floats in RGBx order.
+		std::vector<float> gamma_line_;
+
+		// The accumulated output, in RGBx order, as floats.
+		std::vector<float> framebuffer_;
+		unsigned int framebuffer_width_ = 0, framebuffer_height_ = 0;
+		std::mutex draw_mutex_;
+
+		// Derived state.
+		float from_rgb_[9], to_rgb_[9];
+		float rgb_filter_coefficients_[11];
+		float gamma_table_[256];
+		bool derived_state_is_dirty_ = true;
+		void update_derived_state();
+
+		bool get_is_television_output();
+		float get_composite_output_width() const;
+
+		void sample_line(int line, float output_width);
+		void decode_composite_line(int line, int start, int end);
+		void filter_rgb_line(int line, int start, int end);
+		void paint_scans(unsigned int output_width, unsigned int output_height);
+};
+
+}
+}
+
+#endif /* CRTSoftware_hpp */
@@ -0,0 +1,115 @@
+//
+//  OutputBuilder.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 18/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#ifndef OutputBuilder_hpp
+#define OutputBuilder_hpp
+
+#include "../CRTTypes.hpp"
+#include "CRTConstants.hpp"
+
+#include "ArrayBuilder.hpp"
+#include "TextureBuilder.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Outputs {
+namespace CRT {
+
+/*!
+	An output builder owns the source texture and run arrays that the CRT fills, and turns their contents
+	into a displayable frame. Concrete builders differ in how they do so: @c OpenGLOutputBuilder uses
+	shaders on the GPU, @c SoftwareOutputBuilder reconstructs the frame on the CPU.
+
+	Each builder is handed both the GLSL and the software versions of the sampling functions, and uses
+	whichever it is able to.
+*/
+class OutputBuilder {
+	public:
+		// These two are protected by output_mutex_.
+		TextureBuilder texture_builder;
+		ArrayBuilder array_builder;
+
+		OutputBuilder(std::size_t bytes_per_pixel, const std::function<void(bool is_input, uint8_t *, std::size_t)> &array_submission_function) :
+			texture_builder(bytes_per_pixel),
+			array_builder(SourceVertexBufferDataSize, OutputVertexBufferDataSize, array_submission_function) {}
+		virtual ~OutputBuilder() {}
+
+		inline std::unique_lock<std::mutex> get_output_lock() {
+			return std::unique_lock<std::mutex>(output_mutex_);
+		}
+
+		inline OutputDevice get_output_device() {
+			return output_device_;
+		}
+
+		inline void set_visible_area(Rect visible_area) {
+			visible_area_ = visible_area;
+		}
+
+		inline uint16_t get_composite_output_y() {
+			return static_cast<uint16_t>(composite_src_output_y_);
+		}
+
+		inline bool composite_output_buffer_is_full() {
+			return composite_src_output_y_ == IntermediateBufferHeight;
+		}
+
+		inline void increment_composite_output_y() {
+			if(!composite_output_buffer_is_full())
+				composite_src_output_y_++;
+		}
+
+		virtual void set_colour_format(ColourSpace colour_space, unsigned int colour_cycle_numerator, unsigned int colour_cycle_denominator) = 0;
+		virtual void set_gamma(float gamma) = 0;
+		virtual void set_timing(unsigned int input_frequency, unsigned int cycles_per_line, unsigned int height_of_display, unsigned int horizontal_scan_period, unsigned int vertical_scan_period, unsigned int vertical_period_divider) = 0;
+		virtual void set_output_device(OutputDevice output_device) = 0;
+
+		virtual void set_composite_sampling_function(const std::string &shader) = 0;
+		virtual void set_rgb_sampling_function(const std::string &shader) = 0;
+		virtual void set_software_composite_sampling_function(const CompositeSamplingFunction &function) = 0;
+		virtual void set_software_rgb_sampling_function(const RGBSamplingFunction &function) = 0;
+
+		virtual void set_target_framebuffer(int target_framebuffer) = 0;
+		virtual void set_openGL_context_will_change(bool should_delete_resources) = 0;
+
+		virtual void draw_frame(unsigned int output_width, unsigned int output_height, bool only_if_dirty) = 0;
+		virtual void read_frame(std::vector<uint8_t> &target) = 0;
+
+	protected:
+		// colour information
+		ColourSpace colour_space_;
+		unsigned int colour_cycle_numerator_;
+		unsigned int colour_cycle_denominator_;
+		OutputDevice output_device_;
+		float gamma_;
+
+		// timing information to allow reasoning about input information
+		unsigned int input_frequency_;
+		unsigned int cycles_per_line_;
+		unsigned int height_of_display_;
+		unsigned int horizontal_scan_period_;
+		unsigned int vertical_scan_period_;
+		unsigned int vertical_period_divider_;
+
+		// The user-supplied visible area
+		Rect visible_area_ = Rect(0, 0, 1, 1);
+
+		// the run and input data buffers
+		std::mutex output_mutex_;
+
+		// transient buffers indicating composite data not yet decoded
+		int composite_src_output_y_ = 0;
+};
+
+}
+}
+
+#endif /* OutputBuilder_hpp */
@@ -7,8 +7,6 @@
 //
 
 #include "TextureBuilder.hpp"
-#include "CRTOpenGL.hpp"
-#include "OpenGL.hpp"
 
 #include <cstring>
 
@@ -16,26 +14,6 @@ using namespace Outputs::CRT;
 
 namespace {
 
-const GLint internalFormatForDepth(std::size_t depth) {
-	switch(depth) {
-		default: return GL_FALSE;
-		case 1: return GL_R8UI;
-		case 2: return GL_RG8UI;
-		case 3: return GL_RGB8UI;
-		case 4: return GL_RGBA8UI;
-	}
-}
-
-const GLenum formatForDepth(std::size_t depth) {
-	switch(depth) {
-		default: return GL_FALSE;
-		case 1: return GL_RED_INTEGER;
-		case 2: return GL_RG_INTEGER;
-		case 3: return GL_RGB_INTEGER;
-		case 4: return GL_RGBA_INTEGER;
-	}
-}
-
 struct DefaultBookender: public TextureBuilder::Bookender {
 	public:
 		DefaultBookender(std::size_t bytes_per_pixel) : bytes_per_pixel_(bytes_per_pixel) {}
@@ -51,24 +29,16 @@ struct DefaultBookender: public TextureBuilder::Bookender {
 
 }
 
-TextureBuilder::TextureBuilder(std::size_t bytes_per_pixel, GLenum texture_unit) :
+TextureBuilder::TextureBuilder(std::size_t bytes_per_pixel) :
 		bytes_per_pixel_(bytes_per_pixel) {
 	image_.resize(bytes_per_pixel * InputBufferBuilderWidth * InputBufferBuilderHeight);
-	glGenTextures(1, &texture_name_);
-
-	glActiveTexture(texture_unit);
-	glBindTexture(GL_TEXTURE_2D, texture_name_);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexImage2D(GL_TEXTURE_2D, 0, internalFormatForDepth(bytes_per_pixel), InputBufferBuilderWidth, InputBufferBuilderHeight, 0, formatForDepth(bytes_per_pixel), GL_UNSIGNED_BYTE, nullptr);
-
 	set_bookender(nullptr);
 }
 
-TextureBuilder::~TextureBuilder() {
-	glDeleteTextures(1, &texture_name_);
+TextureBuilder::~TextureBuilder() {}
+
+std::size_t TextureBuilder::get_bytes_per_pixel() const {
+	return bytes_per_pixel_;
 }
 
 inline uint8_t *TextureBuilder::pointer_to_location(uint16_t x, uint16_t y) {
@@ -156,31 +126,24 @@ bool TextureBuilder::is_full() {
 	return is_full_;
 }
 
-void TextureBuilder::submit() {
+void TextureBuilder::submit(const std::function<void(const uint8_t *pixels, uint16_t first_line, uint16_t number_of_lines)> &function) {
 	if(write_areas_start_y_ < first_unsubmitted_y_) {
 		// A write area start y less than the first line on which submissions began implies it must have wrapped
 		// around. So the submission set is everything back to zero before the current write area plus everything
 		// from the first unsubmitted y downward.
 		uint16_t height = write_areas_start_y_ + (write_areas_start_x_ ? 1 : 0);
-		glTexSubImage2D(	GL_TEXTURE_2D, 0,
-							0, 0,
-							InputBufferBuilderWidth, height,
-							formatForDepth(bytes_per_pixel_), GL_UNSIGNED_BYTE,
-							image_.data());
-
-		glTexSubImage2D(	GL_TEXTURE_2D, 0,
-							0, first_unsubmitted_y_,
-							InputBufferBuilderWidth, InputBufferBuilderHeight - first_unsubmitted_y_,
-							formatForDepth(bytes_per_pixel_), GL_UNSIGNED_BYTE,
-							image_.data() + first_unsubmitted_y_ * bytes_per_pixel_ * InputBufferBuilderWidth);
+		function(image_.data(), 0, height);
+		function(
+			image_.data() + first_unsubmitted_y_ * bytes_per_pixel_ * InputBufferBuilderWidth,
+			first_unsubmitted_y_,
+			static_cast<uint16_t>(InputBufferBuilderHeight - first_unsubmitted_y_));
 	} else {
 		// If the current write area start y is after the first unsubmitted line, just submit the region in between.
 		uint16_t height = write_areas_start_y_ + (write_areas_start_x_ ? 1 : 0) - first_unsubmitted_y_;
-		glTexSubImage2D(	GL_TEXTURE_2D, 0,
-							0, first_unsubmitted_y_,
-							InputBufferBuilderWidth, height,
-							formatForDepth(bytes_per_pixel_), GL_UNSIGNED_BYTE,
-							image_.data() + first_unsubmitted_y_ * bytes_per_pixel_ * InputBufferBuilderWidth);
+		function(
+			image_.data() + first_unsubmitted_y_ * bytes_per_pixel_ * InputBufferBuilderWidth,
+			first_unsubmitted_y_,
+			height);
 	}
 
 	// Update the starting location for the next submission, and mark definitively that the buffer is once again not full.
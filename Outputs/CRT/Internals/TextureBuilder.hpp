@@ -14,19 +14,18 @@
 #include <memory>
 #include <vector>
 
-#include "OpenGL.hpp"
 #include "CRTConstants.hpp"
 
 namespace Outputs {
 namespace CRT {
 
 /*!
-	Owns an OpenGL texture resource and provides mechanisms to fill it from bottom left to top right
+	Owns a texture-sized pixel buffer and provides mechanisms to fill it from bottom left to top right
 	with runs of data, ensuring each run is neighboured immediately to the left and right by copies of its
 	first and last pixels.
 
 	Although this class is not itself inherently thread safe, it is built to permit one serialised stream
-	of calls to provide source data, with an interceding (but also serialised) submission to the GPU at any time.
+	of calls to provide source data, with an interceding (but also serialised) submission to the output builder at any time.
 
 
 	Intended usage by the data generator:
@@ -51,21 +50,23 @@ namespace CRT {
 	the CPU's memory space but has now passed beyond any further modification or reporting.
 
 
-	Intended usage by the GPU owner:
+	Intended usage by the output builder:
 
-		(i)		call submit to move data to the GPU and free up its CPU-side resources.
+		(i)		call submit to receive the new data, e.g. to move it to the GPU, and free up its resources here.
 
-	The latest data is now on the GPU, regardless of where the data provider may be in its process — only data
-	that has entered the submission queue is uploaded.
+	The latest data has now been handed over, regardless of where the data provider may be in its process — only data
+	that has entered the submission queue is passed on.
 
 */
 class TextureBuilder {
 	public:
-		/// Constructs an instance of InputTextureBuilder that contains a texture of colour depth @c bytes_per_pixel;
-		/// this creates a new texture and binds it to the current active texture unit.
-		TextureBuilder(std::size_t bytes_per_pixel, GLenum texture_unit);
+		/// Constructs an instance of InputTextureBuilder that contains a texture of colour depth @c bytes_per_pixel.
+		TextureBuilder(std::size_t bytes_per_pixel);
 		virtual ~TextureBuilder();
 
+		/// @returns The colour depth of this texture.
+		std::size_t get_bytes_per_pixel() const;
+
 		/// Finds the first available space of at least @c required_length pixels in size which is suitably aligned
 		/// for writing of @c required_alignment number of pixels at a time.
 		/// Calls must be paired off with calls to @c reduce_previous_allocation_to.
@@ -87,8 +88,10 @@ class TextureBuilder {
 		/// being full; @c false if calls may succeed.
 		bool is_full();
 
-		/// Updates the currently-bound texture with all new data provided since the last @c submit.
-		void submit();
+		/// Passes all new data provided since the last @c submit to @c function, as one or two spans of
+		/// complete lines. Each call nominates the first line supplied and the number of lines; @c pixels
+		/// points to the first pixel of the first line, with lines being InputBufferBuilderWidth pixels long.
+		void submit(const std::function<void(const uint8_t *pixels, uint16_t first_line, uint16_t number_of_lines)> &function);
 
 		struct WriteArea {
 			uint16_t x, y, length;
@@ -120,7 +123,6 @@ class TextureBuilder {
 
 		// the buffer
 		std::vector<uint8_t> image_;
-		GLuint texture_name_;
 
 		// the current write area
 		WriteArea write_area_;
@@ -15,12 +15,12 @@
 #include <cstring>
 #include <ctime>
 
+#include <atomic>
 #include <memory>
-#include <list>
 #include <vector>
 
-#include "../SignalProcessing/Stepper.hpp"
 #include "../SignalProcessing/FIRFilter.hpp"
+#include "../SignalProcessing/PolyphaseFilter.hpp"
 #include "../Concurrency/AsyncTaskQueue.hpp"
 #include "../ClockReceiver/ClockReceiver.hpp"
 
@@ -83,28 +83,104 @@ class Speaker {
 			set_needs_updated_filter_coefficients();
 		}
 
-		Speaker() : _queue(new Concurrency::AsyncTaskQueue) {}
+		Speaker() :
+			published_time_(0),
+			is_processing_scheduled_(false),
+			_queue(new Concurrency::AsyncTaskQueue),
+			register_write_index_(0),
+			register_read_index_(0) {}
+		virtual ~Speaker() {}
 
 		/*!
 			Ensures any deferred processing occurs now.
 		*/
 		void flush() {
-			if(!queued_functions_) return;
-			std::shared_ptr<std::list<std::function<void(void)>>> queued_functions = queued_functions_;
-			queued_functions_.reset();
-			_queue->enqueue([queued_functions] {
-				for(auto &function : *queued_functions) {
-					function();
-				}
-			});
+			if(published_time_.load(std::memory_order_relaxed) == scheduled_time_) return;
+			published_time_.store(scheduled_time_, std::memory_order_release);
+
+			// Schedule processing only if it isn't already pending; the processing task clears
+			// the flag before it reads the published time, so no publication is ever missed.
+			if(!is_processing_scheduled_.exchange(true)) {
+				_queue->enqueue([this] {
+					is_processing_scheduled_ = false;
+					process_published_input();
+				});
+			}
 		}
 
 	protected:
-		void enqueue(std::function<void(void)> function) {
-			if(!queued_functions_) queued_functions_.reset(new std::list<std::function<void(void)>>);
-			queued_functions_->push_back(function);
+		/*!
+			Brings audio generation up to date and waits for it to finish, after which the emulation
+			thread may safely inspect or modify state otherwise owned by the audio thread.
+		*/
+		void synchronise() {
+			flush();
+			_queue->flush();
+		}
+
+		/*!
+			A register write, timestamped in input samples since the speaker was created.
+		*/
+		struct RegisterWrite {
+			uint64_t time;
+			int address;
+			uint8_t value;
+		};
+
+		/*!
+			Records that @c value should be written to the register at @c address at the current
+			input time. Descendants that use this must implement
+			`apply_register_write(int address, uint8_t value)`, which will be called on the audio
+			thread exactly between the generation of the samples that precede the write and those
+			that follow it.
+
+			This does not allocate; if the fixed-size buffer of pending writes is full then the caller
+			will block while audio is brought up to date.
+		*/
+		void enqueue_register_write(int address, uint8_t value) {
+			const std::size_t write_index = register_write_index_.load(std::memory_order_relaxed);
+			if(write_index - register_read_index_.load(std::memory_order_acquire) == RegisterWriteBufferSize) {
+				flush();
+				_queue->flush();
+			}
+
+			RegisterWrite &write = register_writes_[write_index & (RegisterWriteBufferSize - 1)];
+			write.time = scheduled_time_;
+			write.address = address;
+			write.value = value;
+			register_write_index_.store(write_index + 1, std::memory_order_release);
+		}
+
+		/*!
+			Obtains the oldest register write not yet applied, if any. For use on the audio thread only.
+
+			@returns @c true if there is such a write; @c false otherwise.
+		*/
+		bool peek_register_write(RegisterWrite &write) {
+			const std::size_t read_index = register_read_index_.load(std::memory_order_relaxed);
+			if(read_index == register_write_index_.load(std::memory_order_acquire)) return false;
+			write = register_writes_[read_index & (RegisterWriteBufferSize - 1)];
+			return true;
+		}
+
+		/*!
+			Discards the oldest register write. For use on the audio thread only.
+		*/
+		void pop_register_write() {
+			register_read_index_.store(register_read_index_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
 		}
-		std::shared_ptr<std::list<std::function<void(void)>>> queued_functions_;
+
+		/*!
+			Generates output for all input published by @c flush that has not yet been processed,
+			applying register writes as they occur. Called on the audio thread.
+		*/
+		virtual void process_published_input() = 0;
+
+		// Time is measured in input samples. scheduled_time_ is owned by the emulation thread and
+		// published_time_ is the most recent value of it to have been passed to the audio thread.
+		uint64_t scheduled_time_ = 0;
+		std::atomic<uint64_t> published_time_;
+		std::atomic<bool> is_processing_scheduled_;
 
 		std::vector<int16_t> buffer_in_progress_;
 		float high_frequency_cut_off_ = -1.0;
@@ -122,23 +198,33 @@ class Speaker {
 		}
 
 		void get_samples(unsigned int quantity, int16_t *target)	{}
+		void apply_register_write(int address, uint8_t value)	{}
 		void skip_samples(unsigned int quantity) {
 			int16_t throwaway_samples[quantity];
 			get_samples(quantity, throwaway_samples);
 		}
 
 		std::unique_ptr<Concurrency::AsyncTaskQueue> _queue;
+
+	private:
+		// Register writes form a single-producer, single-consumer ring buffer.
+		static const std::size_t RegisterWriteBufferSize = 4096;
+		RegisterWrite register_writes_[RegisterWriteBufferSize];
+		std::atomic<std::size_t> register_write_index_;
+		std::atomic<std::size_t> register_read_index_;
 };
 
 /*!
-	A concrete descendant of Speaker that uses a FIR filter to map from input data to output data when scaling
-	and a copy-through buffer when input and output rates are the same.
+	A concrete descendant of Speaker that uses a polyphase FIR filter to map from input data to output data when
+	resampling, in either direction, and a copy-through buffer when input and output rates are the same.
 
 	Audio sources should use @c Filter as both a template and a parent, implementing at least
 	`get_samples(unsigned int quantity, int16_t *target)` and ideally also `skip_samples(unsigned int quantity)`
 	to provide source data.
 
-	Call `run_for` to request that the next period of input data is collected.
+	Call `run_for` to request that the next period of input data is collected. Sources with registers that affect
+	output should record writes via `enqueue_register_write` and implement
+	`apply_register_write(int address, uint8_t value)`; collection occurs in batches upon `flush`.
 */
 template <class T> class Filter: public Speaker {
 	public:
@@ -147,109 +233,158 @@ template <class T> class Filter: public Speaker {
 		}
 
 		void run_for(const Cycles cycles) {
-			enqueue([=]() {
-				unsigned int cycles_remaining = static_cast<unsigned int>(cycles.as_int());
-				if(coefficients_are_dirty_) update_filter_coefficients();
-
-				// if input and output rates exactly match, just accumulate results and pass on
-				if(input_cycles_per_second_ == output_cycles_per_second_ && high_frequency_cut_off_ < 0.0) {
-					while(cycles_remaining) {
-						unsigned int cycles_to_read = static_cast<unsigned int>(buffer_in_progress_.size() - static_cast<std::size_t>(buffer_in_progress_pointer_));
-						if(cycles_to_read > cycles_remaining) cycles_to_read = cycles_remaining;
-
-						static_cast<T *>(this)->get_samples(cycles_to_read, &buffer_in_progress_[static_cast<std::size_t>(buffer_in_progress_pointer_)]);
-						buffer_in_progress_pointer_ += cycles_to_read;
-
-						// announce to delegate if full
-						if(buffer_in_progress_pointer_ == buffer_in_progress_.size()) {
-							buffer_in_progress_pointer_ = 0;
-							if(delegate_) {
-								delegate_->speaker_did_complete_samples(this, buffer_in_progress_);
-							}
-						}
+			scheduled_time_ += static_cast<uint64_t>(cycles.as_int());
+		}
+
+	protected:
+		void process_published_input() override {
+			const uint64_t target_time = published_time_.load(std::memory_order_acquire);
+			if(coefficients_are_dirty_) update_filter_coefficients();
+
+			// Alternate between applying every register write that is now due and generating
+			// samples up until the next one, or until the target time if there are no more.
+			RegisterWrite write;
+			while(true) {
+				while(peek_register_write(write) && write.time <= processed_time_) {
+					static_cast<T *>(this)->apply_register_write(write.address, write.value);
+					pop_register_write();
+				}
+				if(processed_time_ == target_time) break;
 
-						cycles_remaining -= cycles_to_read;
+				uint64_t next_time = target_time;
+				if(peek_register_write(write) && write.time < next_time) next_time = write.time;
+				next_time = std::min(next_time, processed_time_ + 0x7fffffff);
+
+				generate_samples(static_cast<unsigned int>(next_time - processed_time_));
+				processed_time_ = next_time;
+			}
+		}
+
+	private:
+		uint64_t processed_time_ = 0;
+
+		void generate_samples(unsigned int cycles_remaining) {
+			// if input and output rates exactly match, just accumulate results and pass on
+			if(input_cycles_per_second_ == output_cycles_per_second_ && high_frequency_cut_off_ < 0.0) {
+				while(cycles_remaining) {
+					unsigned int cycles_to_read = static_cast<unsigned int>(buffer_in_progress_.size() - static_cast<std::size_t>(buffer_in_progress_pointer_));
+					if(cycles_to_read > cycles_remaining) cycles_to_read = cycles_remaining;
+
+					static_cast<T *>(this)->get_samples(cycles_to_read, &buffer_in_progress_[static_cast<std::size_t>(buffer_in_progress_pointer_)]);
+					buffer_in_progress_pointer_ += cycles_to_read;
+
+					// announce to delegate if full
+					if(buffer_in_progress_pointer_ == buffer_in_progress_.size()) {
+						buffer_in_progress_pointer_ = 0;
+						if(delegate_) {
+							delegate_->speaker_did_complete_samples(this, buffer_in_progress_);
+						}
 					}
 
-					return;
+					cycles_remaining -= cycles_to_read;
 				}
 
-				// if the output rate is less than the input rate, use the filter
-				if(input_cycles_per_second_ > output_cycles_per_second_ || (input_cycles_per_second_ == output_cycles_per_second_ && high_frequency_cut_off_ >= 0.0)) {
-					while(cycles_remaining) {
-						unsigned int cycles_to_read = static_cast<unsigned int>(std::min(static_cast<std::size_t>(cycles_remaining), number_of_taps_ - input_buffer_depth_));
-						static_cast<T *>(this)->get_samples(cycles_to_read, &input_buffer_[static_cast<std::size_t>(input_buffer_depth_)]);
-						cycles_remaining -= cycles_to_read;
-						input_buffer_depth_ += cycles_to_read;
-
-						if(input_buffer_depth_ == number_of_taps_) {
-							buffer_in_progress_[static_cast<std::size_t>(buffer_in_progress_pointer_)] = filter_->apply(input_buffer_.data());
-							buffer_in_progress_pointer_++;
-
-							// announce to delegate if full
-							if(buffer_in_progress_pointer_ == buffer_in_progress_.size()) {
-								buffer_in_progress_pointer_ = 0;
-								if(delegate_) {
-									delegate_->speaker_did_complete_samples(this, buffer_in_progress_);
-								}
-							}
-
-							// If the next loop around is going to reuse some of the samples just collected, use a memmove to
-							// preserve them in the correct locations (TODO: use a longer buffer to fix that) and don't skip
-							// anything. Otherwise skip as required to get to the next sample batch and don't expect to reuse.
-							uint64_t steps = stepper_->step();
-							if(steps < number_of_taps_) {
-								int16_t *input_buffer = input_buffer_.data();
-								memmove(input_buffer, &input_buffer[steps], sizeof(int16_t) * (static_cast<std::size_t>(number_of_taps_) - static_cast<std::size_t>(steps)));
-								input_buffer_depth_ -= steps;
-							} else {
-								if(steps > number_of_taps_)
-									static_cast<T *>(this)->skip_samples(static_cast<unsigned int>(steps) - static_cast<unsigned int>(number_of_taps_));
-								input_buffer_depth_ = 0;
-							}
+				return;
+			}
+
+			// otherwise, resample
+			while(cycles_remaining) {
+				// If the next output sample is sufficiently far ahead then none of the buffered input is
+				// needed, and the input that contributes to nothing can be skipped.
+				if(input_buffer_depth_ < window_start_) {
+					window_start_ -= input_buffer_depth_;
+					input_buffer_depth_ = 0;
+
+					const unsigned int cycles_to_skip = static_cast<unsigned int>(std::min(static_cast<std::size_t>(cycles_remaining), window_start_));
+					static_cast<T *>(this)->skip_samples(cycles_to_skip);
+					cycles_remaining -= cycles_to_skip;
+					window_start_ -= cycles_to_skip;
+					continue;
+				}
+
+				// If the input buffer is full, move the portion that is still needed back to its start. This is why the
+				// buffer is substantially longer than a single window: the move happens comparatively rarely.
+				if(input_buffer_depth_ == input_buffer_size_) {
+					const std::size_t retained_samples = input_buffer_depth_ - window_start_;
+					memmove(input_buffer_.data(), &input_buffer_[window_start_], sizeof(int16_t) * retained_samples);
+					input_buffer_depth_ = retained_samples;
+					window_start_ = 0;
+				}
+
+				const unsigned int cycles_to_read = static_cast<unsigned int>(std::min(static_cast<std::size_t>(cycles_remaining), input_buffer_size_ - input_buffer_depth_));
+				static_cast<T *>(this)->get_samples(cycles_to_read, &input_buffer_[input_buffer_depth_]);
+				cycles_remaining -= cycles_to_read;
+				input_buffer_depth_ += cycles_to_read;
+
+				// Produce as many output samples as the input now covers.
+				const std::size_t number_of_taps = filter_->get_number_of_taps();
+				while(window_start_ + number_of_taps <= input_buffer_depth_) {
+					buffer_in_progress_[buffer_in_progress_pointer_] = filter_->apply(&input_buffer_[window_start_], window_offset_ >> phase_shift_);
+					buffer_in_progress_pointer_++;
+
+					// announce to delegate if full
+					if(buffer_in_progress_pointer_ == buffer_in_progress_.size()) {
+						buffer_in_progress_pointer_ = 0;
+						if(delegate_) {
+							delegate_->speaker_did_complete_samples(this, buffer_in_progress_);
 						}
 					}
 
-					return;
+					const uint64_t next_offset = static_cast<uint64_t>(window_offset_) + window_step_;
+					window_start_ += static_cast<std::size_t>(next_offset >> 32);
+					window_offset_ = static_cast<uint32_t>(next_offset);
 				}
-
-			// TODO: input rate is less than output rate
-			});
+			}
 		}
 
-	private:
-		std::unique_ptr<SignalProcessing::Stepper> stepper_;
-		std::unique_ptr<SignalProcessing::FIRFilter> filter_;
-
+		// The input buffer holds input samples from index 0 up to input_buffer_depth_; the next output sample will
+		// be derived from those starting at window_start_, and lies window_offset_ / 2^32 of the way towards the next.
+		// window_step_ is the distance between output samples, in input samples, fixed point with 32 bits of fraction.
+		std::unique_ptr<SignalProcessing::PolyphaseFilter> filter_;
 		std::vector<int16_t> input_buffer_;
+		std::size_t input_buffer_size_;
 		std::size_t input_buffer_depth_;
+		std::size_t window_start_;
+		uint32_t window_offset_;
+		uint64_t window_step_;
+		int phase_shift_;
 
 		void update_filter_coefficients() {
-			// make a guess at a good number of taps if this hasn't been provided explicitly
+			// make a guess at a good number of taps if this hasn't been provided explicitly;
+			// the filter will round this up to a multiple of 16
 			if(requested_number_of_taps_) {
 				number_of_taps_ = requested_number_of_taps_;
 			} else {
 				number_of_taps_ = static_cast<std::size_t>(ceilf((input_cycles_per_second_ + output_cycles_per_second_) / output_cycles_per_second_));
 				number_of_taps_ *= 2;
-				number_of_taps_ |= 1;
 			}
 
 			coefficients_are_dirty_ = false;
 			buffer_in_progress_pointer_ = 0;
 
-			stepper_.reset(new SignalProcessing::Stepper((uint64_t)input_cycles_per_second_, (uint64_t)output_cycles_per_second_));
-
-			float high_pass_frequency;
+			// The filter should cut off at whichever is lower of the input and output Nyquist frequencies, and below
+			// the requested cut off if there is one.
+			float high_pass_frequency = std::min(input_cycles_per_second_, output_cycles_per_second_) / 2.0f;
 			if(high_frequency_cut_off_ > 0.0) {
-				high_pass_frequency = std::min(output_cycles_per_second_ / 2.0f, high_frequency_cut_off_);
-			} else {
-				high_pass_frequency = output_cycles_per_second_ / 2.0f;
+				high_pass_frequency = std::min(high_pass_frequency, high_frequency_cut_off_);
 			}
-			filter_.reset(new SignalProcessing::FIRFilter(static_cast<unsigned int>(number_of_taps_), static_cast<float>(input_cycles_per_second_), 0.0, high_pass_frequency, SignalProcessing::FIRFilter::DefaultAttenuation));
-
-			input_buffer_.resize(static_cast<std::size_t>(number_of_taps_));
+			filter_.reset(new SignalProcessing::PolyphaseFilter(number_of_taps_, NumberOfPhases, input_cycles_per_second_, high_pass_frequency, SignalProcessing::FIRFilter::DefaultAttenuation));
+			number_of_taps_ = filter_->get_number_of_taps();
+
+			window_step_ = static_cast<uint64_t>((static_cast<double>(input_cycles_per_second_) / static_cast<double>(output_cycles_per_second_)) * 4294967296.0);
+			window_start_ = 0;
+			window_offset_ = 0;
+			phase_shift_ = 32;
+			for(std::size_t phases = NumberOfPhases; phases > 1; phases >>= 1) --phase_shift_;
+
+			// Allow room for a good number of windows, plus enough for the filter to read a full window
+			// from beyond the final input sample should it wish to.
+			input_buffer_size_ = number_of_taps_ + 4096;
+			input_buffer_.resize(input_buffer_size_ + number_of_taps_);
 			input_buffer_depth_ = 0;
 		}
+
+		static const std::size_t NumberOfPhases = 64;
 };
 
 }
@@ -15,6 +15,7 @@
 
 #include "../RegisterSizes.hpp"
 #include "../../ClockReceiver/ClockReceiver.hpp"
+#include "../../Snapshot/Snapshot.hpp"
 
 namespace CPU {
 namespace MOS6502 {
@@ -178,6 +179,11 @@ class ProcessorBase: public ProcessorStorage {
 			@returns @c true if the 6502 is jammed; @c false otherwise.
 		*/
 		bool is_jammed();
+
+		/*!
+			Captures or restores the complete state of the processor, which may be mid-instruction, via @c archive.
+		*/
+		void serialise(Snapshot::Archive &archive);
 };
 
 /*!
@@ -42,3 +42,67 @@ void ProcessorBase::set_value_of_register(Register r, uint16_t value) {
 bool ProcessorBase::is_jammed() {
 	return is_jammed_;
 }
+
+void ProcessorBase::serialise(Snapshot::Archive &archive) {
+	archive.tag(0x36353032);
+
+	// The position within the current micro-program is recorded as the index of the program
+	// plus an offset into it; the opcode table counts as a single program.
+	const MicroOp *const programs[] = {
+		&operations[0][0],		do_branch,		fetch_decode_execute,
+		reset_program,			irq_program,	nmi_program
+	};
+	const std::size_t program_lengths[] = {
+		sizeof(operations) / sizeof(MicroOp),	sizeof(do_branch) / sizeof(MicroOp),	sizeof(fetch_decode_execute) / sizeof(MicroOp),
+		sizeof(reset_program) / sizeof(MicroOp),	sizeof(irq_program) / sizeof(MicroOp),	sizeof(nmi_program) / sizeof(MicroOp)
+	};
+	const std::size_t number_of_programs = sizeof(programs) / sizeof(*programs);
+
+	int program = -1;
+	uint32_t program_offset = 0;
+	if(!archive.is_reading() && scheduled_program_counter_) {
+		for(std::size_t index = 0; index < number_of_programs; ++index) {
+			if(scheduled_program_counter_ >= programs[index] && scheduled_program_counter_ <= programs[index] + program_lengths[index]) {
+				program = static_cast<int>(index);
+				program_offset = static_cast<uint32_t>(scheduled_program_counter_ - programs[index]);
+				break;
+			}
+		}
+	}
+	archive(program, program_offset);
+
+	// The target of any pending bus access is similarly recorded as an index into the possible targets.
+	uint8_t *const bus_values[] = {
+		&operation_,	&operand_,	&pc_.bytes.low,	&pc_.bytes.high,	&a_,	&throwaway_target_
+	};
+	const std::size_t number_of_bus_values = sizeof(bus_values) / sizeof(*bus_values);
+
+	int bus_value = -1;
+	if(!archive.is_reading()) {
+		for(std::size_t index = 0; index < number_of_bus_values; ++index) {
+			if(bus_value_ == bus_values[index]) bus_value = static_cast<int>(index);
+		}
+	}
+	archive(bus_value);
+
+	archive(
+		pc_, last_operation_pc_, a_, x_, y_, s_,
+		carry_flag_, negative_result_, zero_result_, decimal_flag_, overflow_flag_, inverse_interrupt_flag_,
+		operation_, operand_, address_, next_address_,
+		next_bus_operation_, bus_address_, throwaway_target_,
+		is_jammed_, cycles_left_to_run_, interrupt_requests_,
+		ready_is_active_, ready_line_is_enabled_,
+		irq_line_, irq_request_history_, nmi_line_is_enabled_, set_overflow_line_is_enabled_);
+
+	if(archive.is_reading()) {
+		if(
+			program >= static_cast<int>(number_of_programs) ||
+			(program >= 0 && program_offset > program_lengths[program]) ||
+			bus_value >= static_cast<int>(number_of_bus_values)) {
+			archive.set_invalid();
+			return;
+		}
+		scheduled_program_counter_ = (program >= 0) ? programs[program] + program_offset : nullptr;
+		bus_value_ = (bus_value >= 0) ? bus_values[bus_value] : nullptr;
+	}
+}
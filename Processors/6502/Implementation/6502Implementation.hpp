@@ -12,19 +12,16 @@
 	6502.hpp, but it's implementation stuff.
 */
 
-template <typename T, bool uses_ready_line> void Processor<T, uses_ready_line>::run_for(const Cycles cycles) {
-	static const MicroOp doBranch[] = {
-		CycleReadFromPC,
-		CycleAddSignedOperandToPC,
-		OperationMoveToNextProgram
-	};
-	static uint8_t throwaway_target;
-	static const MicroOp fetch_decode_execute[] = {
-		CycleFetchOperation,
-		CycleFetchOperand,
-		OperationDecodeOperation
-	};
+/*
+	Micro-ops are dispatched via a computed goto where the compiler supports labels as values, as GCC and Clang do,
+	which allows each to jump directly to its successor rather than returning to a single switch. Define
+	MOS6502_NO_COMPUTED_GOTO to use the portable switch-based dispatch instead, e.g. for comparison.
+*/
+#if defined(__GNUC__) && !defined(MOS6502_NO_COMPUTED_GOTO)
+#define MOS6502_COMPUTED_GOTO
+#endif
 
+template <typename T, bool uses_ready_line> void Processor<T, uses_ready_line>::run_for(const Cycles cycles) {
 	// These plus program below act to give the compiler permission to update these values
 	// without touching the class storage (i.e. it explicitly says they need be completely up
 	// to date in this stack frame only); which saves some complicated addressing
@@ -33,6 +30,53 @@ template <typename T, bool uses_ready_line> void Processor<T, uses_ready_line>::
 	uint16_t busAddress = bus_address_;
 	uint8_t *busValue = bus_value_;
 
+#ifdef MOS6502_COMPUTED_GOTO
+	// Indexed by MicroOp, so this list must be kept in step with the enum in 6502Storage.hpp.
+	static const void *const micro_op_targets[] = {
+		&&CycleFetchOperation_label,							&&CycleFetchOperand_label,						&&OperationDecodeOperation_label,					&&CycleIncPCPushPCH_label,
+		&&CyclePushPCH_label,									&&CyclePushPCL_label,							&&CyclePushA_label,									&&CyclePushOperand_label,
+		&&OperationSetI_label,
+
+		&&OperationBRKPickVector_label,							&&OperationNMIPickVector_label,					&&OperationRSTPickVector_label,
+		&&CycleReadVectorLow_label,								&&CycleReadVectorHigh_label,
+
+		&&CycleReadFromS_label,									&&CycleReadFromPC_label,
+		&&CyclePullOperand_label,								&&CyclePullPCL_label,							&&CyclePullPCH_label,								&&CyclePullA_label,
+		&&CycleNoWritePush_label,
+		&&CycleReadAndIncrementPC_label,						&&CycleIncrementPCAndReadStack_label,			&&CycleIncrementPCReadPCHLoadPCL_label,				&&CycleReadPCHLoadPCL_label,
+		&&CycleReadAddressHLoadAddressL_label,					&&CycleReadPCLFromAddress_label,				&&CycleReadPCHFromAddress_label,					&&CycleLoadAddressAbsolute_label,
+		&&OperationLoadAddressZeroPage_label,					&&CycleLoadAddessZeroX_label,					&&CycleLoadAddessZeroY_label,						&&CycleAddXToAddressLow_label,
+		&&CycleAddYToAddressLow_label,							&&CycleAddXToAddressLowRead_label,				&&OperationCorrectAddressHigh_label,				&&CycleAddYToAddressLowRead_label,
+		&&OperationMoveToNextProgram_label,						&&OperationIncrementPC_label,
+		&&CycleFetchOperandFromAddress_label,					&&CycleWriteOperandToAddress_label,				&&OperationCopyOperandFromA_label,					&&OperationCopyOperandToA_label,
+		&&CycleIncrementPCFetchAddressLowFromOperand_label,		&&CycleAddXToOperandFetchAddressLow_label,		&&CycleIncrementOperandFetchAddressHigh_label,		&&OperationDecrementOperand_label,
+		&&OperationIncrementOperand_label,						&&OperationORA_label,							&&OperationAND_label,								&&OperationEOR_label,
+		&&OperationINS_label,									&&OperationADC_label,							&&OperationSBC_label,								&&OperationLDA_label,
+		&&OperationLDX_label,									&&OperationLDY_label,							&&OperationLAX_label,								&&OperationSTA_label,
+		&&OperationSTX_label,									&&OperationSTY_label,							&&OperationSAX_label,								&&OperationSHA_label,
+		&&OperationSHX_label,									&&OperationSHY_label,							&&OperationSHS_label,								&&OperationCMP_label,
+		&&OperationCPX_label,									&&OperationCPY_label,							&&OperationBIT_label,								&&OperationASL_label,
+		&&OperationASO_label,									&&OperationROL_label,							&&OperationRLA_label,								&&OperationLSR_label,
+		&&OperationLSE_label,									&&OperationASR_label,							&&OperationROR_label,								&&OperationRRA_label,
+		&&OperationCLC_label,									&&OperationCLI_label,							&&OperationCLV_label,								&&OperationCLD_label,
+		&&OperationSEC_label,									&&OperationSEI_label,							&&OperationSED_label,								&&OperationINC_label,
+		&&OperationDEC_label,									&&OperationINX_label,							&&OperationDEX_label,								&&OperationINY_label,
+		&&OperationDEY_label,									&&OperationBPL_label,							&&OperationBMI_label,								&&OperationBVC_label,
+		&&OperationBVS_label,									&&OperationBCC_label,							&&OperationBCS_label,								&&OperationBNE_label,
+		&&OperationBEQ_label,									&&OperationTXA_label,							&&OperationTYA_label,								&&OperationTXS_label,
+		&&OperationTAY_label,									&&OperationTAX_label,							&&OperationTSX_label,								&&OperationARR_label,
+		&&OperationSBX_label,									&&OperationLXA_label,							&&OperationANE_label,								&&OperationANC_label,
+		&&OperationLAS_label,									&&CycleAddSignedOperandToPC_label,				&&OperationSetFlagsFromOperand_label,				&&OperationSetOperandFromFlagsWithBRKSet_label,
+		&&OperationSetOperandFromFlags_label,
+		&&OperationSetFlagsFromA_label,
+		&&CycleScheduleJam_label,
+		&&CycleFetchOperandDecodeOperation_label
+	};
+#define micro_op(x)	case x: x##_label
+#else
+#define micro_op(x)	case x
+#endif
+
 #define checkSchedule(op) \
 if(!scheduled_program_counter_) {\
 if(interrupt_requests_) {\
@@ -79,28 +123,43 @@ if(number_of_cycles <= Cycles(0)) break;
 
 #define read_op(val, addr)		nextBusOperation = BusOperation::ReadOpcode;	busAddress = addr;		busValue = &val;				val = 0xff
 #define read_mem(val, addr)		nextBusOperation = BusOperation::Read;			busAddress = addr;		busValue = &val;				val	= 0xff
-#define throwaway_read(addr)	nextBusOperation = BusOperation::Read;			busAddress = addr;		busValue = &throwaway_target;	throwaway_target = 0xff
+#define throwaway_read(addr)	nextBusOperation = BusOperation::Read;			busAddress = addr;		busValue = &throwaway_target_;	throwaway_target_ = 0xff
 #define write_mem(val, addr)	nextBusOperation = BusOperation::Write;			busAddress = addr;		busValue = &val
 
+#ifdef MOS6502_COMPUTED_GOTO
+				goto *micro_op_targets[cycle];
+#endif
 				switch(cycle) {
 
 // MARK: - Fetch/Decode
 
-					case CycleFetchOperation: {
+					micro_op(CycleFetchOperation):
+					fetch_operation: {
 						last_operation_pc_ = pc_;
 						pc_.full++;
 						read_op(operation_, last_operation_pc_.full);
 					} break;
 
-					case CycleFetchOperand:
+					micro_op(CycleFetchOperand):
 						read_mem(operand_, pc_.full);
 					break;
 
-					case OperationDecodeOperation:
+					micro_op(OperationDecodeOperation):
 						scheduled_program_counter_ = operations[operation_];
 					continue;
 
-					case OperationMoveToNextProgram:
+					micro_op(CycleFetchOperandDecodeOperation):
+						// The opcode is already known, so decoding can happen before rather than after the operand is fetched.
+						scheduled_program_counter_ = operations[operation_];
+						read_mem(operand_, pc_.full);
+					break;
+
+					micro_op(OperationMoveToNextProgram):
+						// Absent any interrupt request, proceed directly to the fetch that begins the next instruction.
+						if(!interrupt_requests_) {
+							scheduled_program_counter_ = &fetch_decode_execute[1];
+							goto fetch_operation;
+						}
 						scheduled_program_counter_ = nullptr;
 						checkSchedule();
 					continue;
@@ -110,12 +169,12 @@ if(number_of_cycles <= Cycles(0)) break;
 	write_mem(v, targetAddress);\
 }
 
-					case CycleIncPCPushPCH:				pc_.full++;														// deliberate fallthrough
-					case CyclePushPCH:					push(pc_.bytes.high);											break;
-					case CyclePushPCL:					push(pc_.bytes.low);											break;
-					case CyclePushOperand:				push(operand_);													break;
-					case CyclePushA:					push(a_);														break;
-					case CycleNoWritePush: {
+					micro_op(CycleIncPCPushPCH):		pc_.full++;														// deliberate fallthrough
+					micro_op(CyclePushPCH):				push(pc_.bytes.high);											break;
+					micro_op(CyclePushPCL):				push(pc_.bytes.low);											break;
+					micro_op(CyclePushOperand):			push(operand_);													break;
+					micro_op(CyclePushA):				push(a_);														break;
+					micro_op(CycleNoWritePush): {
 						uint16_t targetAddress = s_ | 0x100; s_--;
 						read_mem(operand_, targetAddress);
 					}
@@ -123,34 +182,34 @@ if(number_of_cycles <= Cycles(0)) break;
 
 #undef push
 
-					case CycleReadFromS:				throwaway_read(s_ | 0x100);										break;
-					case CycleReadFromPC:				throwaway_read(pc_.full);										break;
+					micro_op(CycleReadFromS):			throwaway_read(s_ | 0x100);										break;
+					micro_op(CycleReadFromPC):			throwaway_read(pc_.full);										break;
 
-					case OperationBRKPickVector:
+					micro_op(OperationBRKPickVector):
 						// NMI can usurp BRK-vector operations
 						nextAddress.full = (interrupt_requests_ & InterruptRequestFlags::NMI) ? 0xfffa : 0xfffe;
 						interrupt_requests_ &= ~InterruptRequestFlags::NMI;	// TODO: this probably doesn't happen now?
 					continue;
-					case OperationNMIPickVector:		nextAddress.full = 0xfffa;											continue;
-					case OperationRSTPickVector:		nextAddress.full = 0xfffc;											continue;
-					case CycleReadVectorLow:			read_mem(pc_.bytes.low, nextAddress.full);							break;
-					case CycleReadVectorHigh:			read_mem(pc_.bytes.high, nextAddress.full+1);						break;
-					case OperationSetI:					inverse_interrupt_flag_ = 0;										continue;
-
-					case CyclePullPCL:					s_++; read_mem(pc_.bytes.low, s_ | 0x100);							break;
-					case CyclePullPCH:					s_++; read_mem(pc_.bytes.high, s_ | 0x100);							break;
-					case CyclePullA:					s_++; read_mem(a_, s_ | 0x100);										break;
-					case CyclePullOperand:				s_++; read_mem(operand_, s_ | 0x100);								break;
-					case OperationSetFlagsFromOperand:	set_flags(operand_);												continue;
-					case OperationSetOperandFromFlagsWithBRKSet: operand_ = get_flags() | Flag::Break;						continue;
-					case OperationSetOperandFromFlags:  operand_ = get_flags();												continue;
-					case OperationSetFlagsFromA:		zero_result_ = negative_result_ = a_;								continue;
-
-					case CycleIncrementPCAndReadStack:	pc_.full++; throwaway_read(s_ | 0x100);								break;
-					case CycleReadPCLFromAddress:		read_mem(pc_.bytes.low, address_.full);								break;
-					case CycleReadPCHFromAddress:		address_.bytes.low++; read_mem(pc_.bytes.high, address_.full);		break;
-
-					case CycleReadAndIncrementPC: {
+					micro_op(OperationNMIPickVector):	nextAddress.full = 0xfffa;											continue;
+					micro_op(OperationRSTPickVector):	nextAddress.full = 0xfffc;											continue;
+					micro_op(CycleReadVectorLow):		read_mem(pc_.bytes.low, nextAddress.full);							break;
+					micro_op(CycleReadVectorHigh):		read_mem(pc_.bytes.high, nextAddress.full+1);						break;
+					micro_op(OperationSetI):			inverse_interrupt_flag_ = 0;										continue;
+
+					micro_op(CyclePullPCL):				s_++; read_mem(pc_.bytes.low, s_ | 0x100);							break;
+					micro_op(CyclePullPCH):				s_++; read_mem(pc_.bytes.high, s_ | 0x100);							break;
+					micro_op(CyclePullA):				s_++; read_mem(a_, s_ | 0x100);										break;
+					micro_op(CyclePullOperand):			s_++; read_mem(operand_, s_ | 0x100);								break;
+					micro_op(OperationSetFlagsFromOperand):	set_flags(operand_);												continue;
+					micro_op(OperationSetOperandFromFlagsWithBRKSet): operand_ = get_flags() | Flag::Break;						continue;
+					micro_op(OperationSetOperandFromFlags):  operand_ = get_flags();												continue;
+					micro_op(OperationSetFlagsFromA):	zero_result_ = negative_result_ = a_;								continue;
+
+					micro_op(CycleIncrementPCAndReadStack):	pc_.full++; throwaway_read(s_ | 0x100);								break;
+					micro_op(CycleReadPCLFromAddress):	read_mem(pc_.bytes.low, address_.full);								break;
+					micro_op(CycleReadPCHFromAddress):	address_.bytes.low++; read_mem(pc_.bytes.high, address_.full);		break;
+
+					micro_op(CycleReadAndIncrementPC): {
 						uint16_t oldPC = pc_.full;
 						pc_.full++;
 						throwaway_read(oldPC);
@@ -158,51 +217,51 @@ if(number_of_cycles <= Cycles(0)) break;
 
 // MARK: - JAM
 
-					case CycleScheduleJam: {
+					micro_op(CycleScheduleJam): {
 						is_jammed_ = true;
 						scheduled_program_counter_ = operations[CPU::MOS6502::JamOpcode];
 					} continue;
 
 // MARK: - Bitwise
 
-					case OperationORA:	a_ |= operand_;	negative_result_ = zero_result_ = a_;		continue;
-					case OperationAND:	a_ &= operand_;	negative_result_ = zero_result_ = a_;		continue;
-					case OperationEOR:	a_ ^= operand_;	negative_result_ = zero_result_ = a_;		continue;
+					micro_op(OperationORA):	a_ |= operand_;	negative_result_ = zero_result_ = a_;		continue;
+					micro_op(OperationAND):	a_ &= operand_;	negative_result_ = zero_result_ = a_;		continue;
+					micro_op(OperationEOR):	a_ ^= operand_;	negative_result_ = zero_result_ = a_;		continue;
 
 // MARK: - Load and Store
 
-					case OperationLDA:	a_ = negative_result_ = zero_result_ = operand_;			continue;
-					case OperationLDX:	x_ = negative_result_ = zero_result_ = operand_;			continue;
-					case OperationLDY:	y_ = negative_result_ = zero_result_ = operand_;			continue;
-					case OperationLAX:	a_ = x_ = negative_result_ = zero_result_ = operand_;		continue;
-
-					case OperationSTA:	operand_ = a_;											continue;
-					case OperationSTX:	operand_ = x_;											continue;
-					case OperationSTY:	operand_ = y_;											continue;
-					case OperationSAX:	operand_ = a_ & x_;										continue;
-					case OperationSHA:	operand_ = a_ & x_ & (address_.bytes.high+1);			continue;
-					case OperationSHX:	operand_ = x_ & (address_.bytes.high+1);				continue;
-					case OperationSHY:	operand_ = y_ & (address_.bytes.high+1);				continue;
-					case OperationSHS:	s_ = a_ & x_; operand_ = s_ & (address_.bytes.high+1);	continue;
-
-					case OperationLXA:
+					micro_op(OperationLDA):	a_ = negative_result_ = zero_result_ = operand_;			continue;
+					micro_op(OperationLDX):	x_ = negative_result_ = zero_result_ = operand_;			continue;
+					micro_op(OperationLDY):	y_ = negative_result_ = zero_result_ = operand_;			continue;
+					micro_op(OperationLAX):	a_ = x_ = negative_result_ = zero_result_ = operand_;		continue;
+
+					micro_op(OperationSTA):	operand_ = a_;											continue;
+					micro_op(OperationSTX):	operand_ = x_;											continue;
+					micro_op(OperationSTY):	operand_ = y_;											continue;
+					micro_op(OperationSAX):	operand_ = a_ & x_;										continue;
+					micro_op(OperationSHA):	operand_ = a_ & x_ & (address_.bytes.high+1);			continue;
+					micro_op(OperationSHX):	operand_ = x_ & (address_.bytes.high+1);				continue;
+					micro_op(OperationSHY):	operand_ = y_ & (address_.bytes.high+1);				continue;
+					micro_op(OperationSHS):	s_ = a_ & x_; operand_ = s_ & (address_.bytes.high+1);	continue;
+
+					micro_op(OperationLXA):
 						a_ = x_ = (a_ | 0xee) & operand_;
 						negative_result_ = zero_result_ = a_;
 					continue;
 
 // MARK: - Compare
 
-					case OperationCMP: {
+					micro_op(OperationCMP): {
 						const uint16_t temp16 = a_ - operand_;
 						negative_result_ = zero_result_ = static_cast<uint8_t>(temp16);
 						carry_flag_ = ((~temp16) >> 8)&1;
 					} continue;
-					case OperationCPX: {
+					micro_op(OperationCPX): {
 						const uint16_t temp16 = x_ - operand_;
 						negative_result_ = zero_result_ = static_cast<uint8_t>(temp16);
 						carry_flag_ = ((~temp16) >> 8)&1;
 					} continue;
-					case OperationCPY: {
+					micro_op(OperationCPY): {
 						const uint16_t temp16 = y_ - operand_;
 						negative_result_ = zero_result_ = static_cast<uint8_t>(temp16);
 						carry_flag_ = ((~temp16) >> 8)&1;
@@ -210,7 +269,7 @@ if(number_of_cycles <= Cycles(0)) break;
 
 // MARK: - BIT
 
-					case OperationBIT:
+					micro_op(OperationBIT):
 						zero_result_ = operand_ & a_;
 						negative_result_ = operand_;
 						overflow_flag_ = operand_&Flag::Overflow;
@@ -218,9 +277,9 @@ if(number_of_cycles <= Cycles(0)) break;
 
 // MARK: - ADC/SBC (and INS)
 
-					case OperationINS:
+					micro_op(OperationINS):
 						operand_++;			// deliberate fallthrough
-					case OperationSBC:
+					micro_op(OperationSBC):
 						if(decimal_flag_) {
 							const uint16_t notCarry = carry_flag_ ^ 0x1;
 							const uint16_t decimalResult = static_cast<uint16_t>(a_) - static_cast<uint16_t>(operand_) - notCarry;
@@ -245,7 +304,7 @@ if(number_of_cycles <= Cycles(0)) break;
 						}
 
 					// deliberate fallthrough
-					case OperationADC:
+					micro_op(OperationADC):
 						if(decimal_flag_) {
 							const uint16_t decimalResult = static_cast<uint16_t>(a_) + static_cast<uint16_t>(operand_) + static_cast<uint16_t>(carry_flag_);
 
@@ -272,26 +331,26 @@ if(number_of_cycles <= Cycles(0)) break;
 
 // MARK: - Shifts and Rolls
 
-					case OperationASL:
+					micro_op(OperationASL):
 						carry_flag_ = operand_ >> 7;
 						operand_ <<= 1;
 						negative_result_ = zero_result_ = operand_;
 					continue;
 
-					case OperationASO:
+					micro_op(OperationASO):
 						carry_flag_ = operand_ >> 7;
 						operand_ <<= 1;
 						a_ |= operand_;
 						negative_result_ = zero_result_ = a_;
 					continue;
 
-					case OperationROL: {
+					micro_op(OperationROL): {
 						const uint8_t temp8 = static_cast<uint8_t>((operand_ << 1) | carry_flag_);
 						carry_flag_ = operand_ >> 7;
 						operand_ = negative_result_ = zero_result_ = temp8;
 					} continue;
 
-					case OperationRLA: {
+					micro_op(OperationRLA): {
 						const uint8_t temp8 = static_cast<uint8_t>((operand_ << 1) | carry_flag_);
 						carry_flag_ = operand_ >> 7;
 						operand_ = temp8;
@@ -299,76 +358,76 @@ if(number_of_cycles <= Cycles(0)) break;
 						negative_result_ = zero_result_ = a_;
 					} continue;
 
-					case OperationLSR:
+					micro_op(OperationLSR):
 						carry_flag_ = operand_ & 1;
 						operand_ >>= 1;
 						negative_result_ = zero_result_ = operand_;
 					continue;
 
-					case OperationLSE:
+					micro_op(OperationLSE):
 						carry_flag_ = operand_ & 1;
 						operand_ >>= 1;
 						a_ ^= operand_;
 						negative_result_ = zero_result_ = a_;
 					continue;
 
-					case OperationASR:
+					micro_op(OperationASR):
 						a_ &= operand_;
 						carry_flag_ = a_ & 1;
 						a_ >>= 1;
 						negative_result_ = zero_result_ = a_;
 					continue;
 
-					case OperationROR: {
+					micro_op(OperationROR): {
 						const uint8_t temp8 = static_cast<uint8_t>((operand_ >> 1) | (carry_flag_ << 7));
 						carry_flag_ = operand_ & 1;
 						operand_ = negative_result_ = zero_result_ = temp8;
 					} continue;
 
-					case OperationRRA: {
+					micro_op(OperationRRA): {
 						const uint8_t temp8 = static_cast<uint8_t>((operand_ >> 1) | (carry_flag_ << 7));
 						carry_flag_ = operand_ & 1;
 						operand_ = temp8;
 					} continue;
 
-					case OperationDecrementOperand: operand_--; continue;
-					case OperationIncrementOperand: operand_++; continue;
+					micro_op(OperationDecrementOperand): operand_--; continue;
+					micro_op(OperationIncrementOperand): operand_++; continue;
 
-					case OperationCLC: carry_flag_ = 0;								continue;
-					case OperationCLI: inverse_interrupt_flag_ = Flag::Interrupt;	continue;
-					case OperationCLV: overflow_flag_ = 0;							continue;
-					case OperationCLD: decimal_flag_ = 0;							continue;
+					micro_op(OperationCLC): carry_flag_ = 0;								continue;
+					micro_op(OperationCLI): inverse_interrupt_flag_ = Flag::Interrupt;	continue;
+					micro_op(OperationCLV): overflow_flag_ = 0;							continue;
+					micro_op(OperationCLD): decimal_flag_ = 0;							continue;
 
-					case OperationSEC: carry_flag_ = Flag::Carry;		continue;
-					case OperationSEI: inverse_interrupt_flag_ = 0;		continue;
-					case OperationSED: decimal_flag_ = Flag::Decimal;	continue;
+					micro_op(OperationSEC): carry_flag_ = Flag::Carry;		continue;
+					micro_op(OperationSEI): inverse_interrupt_flag_ = 0;		continue;
+					micro_op(OperationSED): decimal_flag_ = Flag::Decimal;	continue;
 
-					case OperationINC: operand_++; negative_result_ = zero_result_ = operand_; continue;
-					case OperationDEC: operand_--; negative_result_ = zero_result_ = operand_; continue;
-					case OperationINX: x_++; negative_result_ = zero_result_ = x_; continue;
-					case OperationDEX: x_--; negative_result_ = zero_result_ = x_; continue;
-					case OperationINY: y_++; negative_result_ = zero_result_ = y_; continue;
-					case OperationDEY: y_--; negative_result_ = zero_result_ = y_; continue;
+					micro_op(OperationINC): operand_++; negative_result_ = zero_result_ = operand_; continue;
+					micro_op(OperationDEC): operand_--; negative_result_ = zero_result_ = operand_; continue;
+					micro_op(OperationINX): x_++; negative_result_ = zero_result_ = x_; continue;
+					micro_op(OperationDEX): x_--; negative_result_ = zero_result_ = x_; continue;
+					micro_op(OperationINY): y_++; negative_result_ = zero_result_ = y_; continue;
+					micro_op(OperationDEY): y_--; negative_result_ = zero_result_ = y_; continue;
 
-					case OperationANE:
+					micro_op(OperationANE):
 						a_ = (a_ | 0xee) & operand_ & x_;
 						negative_result_ = zero_result_ = a_;
 					continue;
 
-					case OperationANC:
+					micro_op(OperationANC):
 						a_ &= operand_;
 						negative_result_ = zero_result_ = a_;
 						carry_flag_ = a_ >> 7;
 					continue;
 
-					case OperationLAS:
+					micro_op(OperationLAS):
 						a_ = x_ = s_ = s_ & operand_;
 						negative_result_ = zero_result_ = a_;
 					continue;
 
 // MARK: - Addressing Mode Work
 
-					case CycleAddXToAddressLow:
+					micro_op(CycleAddXToAddressLow):
 						nextAddress.full = address_.full + x_;
 						address_.bytes.low = nextAddress.bytes.low;
 						if(address_.bytes.high != nextAddress.bytes.high) {
@@ -376,12 +435,12 @@ if(number_of_cycles <= Cycles(0)) break;
 							break;
 						}
 					continue;
-					case CycleAddXToAddressLowRead:
+					micro_op(CycleAddXToAddressLowRead):
 						nextAddress.full = address_.full + x_;
 						address_.bytes.low = nextAddress.bytes.low;
 						throwaway_read(address_.full);
 					break;
-					case CycleAddYToAddressLow:
+					micro_op(CycleAddYToAddressLow):
 						nextAddress.full = address_.full + y_;
 						address_.bytes.low = nextAddress.bytes.low;
 						if(address_.bytes.high != nextAddress.bytes.high) {
@@ -389,83 +448,83 @@ if(number_of_cycles <= Cycles(0)) break;
 							break;
 						}
 					continue;
-					case CycleAddYToAddressLowRead:
+					micro_op(CycleAddYToAddressLowRead):
 						nextAddress.full = address_.full + y_;
 						address_.bytes.low = nextAddress.bytes.low;
 						throwaway_read(address_.full);
 					break;
-					case OperationCorrectAddressHigh:
+					micro_op(OperationCorrectAddressHigh):
 						address_.full = nextAddress.full;
 					continue;
-					case CycleIncrementPCFetchAddressLowFromOperand:
+					micro_op(CycleIncrementPCFetchAddressLowFromOperand):
 						pc_.full++;
 						read_mem(address_.bytes.low, operand_);
 					break;
-					case CycleAddXToOperandFetchAddressLow:
+					micro_op(CycleAddXToOperandFetchAddressLow):
 						operand_ += x_;
 						read_mem(address_.bytes.low, operand_);
 					break;
-					case CycleIncrementOperandFetchAddressHigh:
+					micro_op(CycleIncrementOperandFetchAddressHigh):
 						operand_++;
 						read_mem(address_.bytes.high, operand_);
 					break;
-					case CycleIncrementPCReadPCHLoadPCL:	// deliberate fallthrough
+					micro_op(CycleIncrementPCReadPCHLoadPCL):	// deliberate fallthrough
 						pc_.full++;
-					case CycleReadPCHLoadPCL: {
+					micro_op(CycleReadPCHLoadPCL): {
 						uint16_t oldPC = pc_.full;
 						pc_.bytes.low = operand_;
 						read_mem(pc_.bytes.high, oldPC);
 					} break;
 
-					case CycleReadAddressHLoadAddressL:
+					micro_op(CycleReadAddressHLoadAddressL):
 						address_.bytes.low = operand_; pc_.full++;
 						read_mem(address_.bytes.high, pc_.full);
 					break;
 
-					case CycleLoadAddressAbsolute: {
+					micro_op(CycleLoadAddressAbsolute): {
 						uint16_t nextPC = pc_.full+1;
 						pc_.full += 2;
 						address_.bytes.low = operand_;
 						read_mem(address_.bytes.high, nextPC);
 					} break;
 
-					case OperationLoadAddressZeroPage:
+					micro_op(OperationLoadAddressZeroPage):
 						pc_.full++;
 						address_.full = operand_;
 					continue;
 
-					case CycleLoadAddessZeroX:
+					micro_op(CycleLoadAddessZeroX):
 						pc_.full++;
 						address_.full = (operand_ + x_)&0xff;
 						throwaway_read(operand_);
 					break;
 
-					case CycleLoadAddessZeroY:
+					micro_op(CycleLoadAddessZeroY):
 						pc_.full++;
 						address_.full = (operand_ + y_)&0xff;
 						throwaway_read(operand_);
 					break;
 
-					case OperationIncrementPC:			pc_.full++;						continue;
-					case CycleFetchOperandFromAddress:	read_mem(operand_, address_.full);	break;
-					case CycleWriteOperandToAddress:	write_mem(operand_, address_.full);	break;
-					case OperationCopyOperandFromA:		operand_ = a_;					continue;
-					case OperationCopyOperandToA:		a_ = operand_;					continue;
+					micro_op(OperationIncrementPC):		pc_.full++;						continue;
+					micro_op(CycleFetchOperandFromAddress):	read_mem(operand_, address_.full);	break;
+					micro_op(CycleWriteOperandToAddress):	write_mem(operand_, address_.full);	break;
+					micro_op(OperationCopyOperandFromA):	operand_ = a_;					continue;
+					micro_op(OperationCopyOperandToA):	a_ = operand_;					continue;
 
 // MARK: - Branching
 
-#define BRA(condition)	pc_.full++; if(condition) scheduled_program_counter_ = doBranch
+#define BRA(condition)	pc_.full++; if(condition) scheduled_program_counter_ = do_branch
 
-					case OperationBPL: BRA(!(negative_result_&0x80));				continue;
-					case OperationBMI: BRA(negative_result_&0x80);					continue;
-					case OperationBVC: BRA(!overflow_flag_);						continue;
-					case OperationBVS: BRA(overflow_flag_);							continue;
-					case OperationBCC: BRA(!carry_flag_);							continue;
-					case OperationBCS: BRA(carry_flag_);							continue;
-					case OperationBNE: BRA(zero_result_);							continue;
-					case OperationBEQ: BRA(!zero_result_);							continue;
+					micro_op(OperationBPL): BRA(!(negative_result_&0x80));				continue;
+					micro_op(OperationBMI): BRA(negative_result_&0x80);					continue;
+					micro_op(OperationBVC): BRA(!overflow_flag_);						continue;
+					micro_op(OperationBVS): BRA(overflow_flag_);							continue;
+					micro_op(OperationBCC): BRA(!carry_flag_);							continue;
+					micro_op(OperationBCS): BRA(carry_flag_);							continue;
+					micro_op(OperationBNE): BRA(zero_result_);							continue;
+					micro_op(OperationBEQ): BRA(!zero_result_);							continue;
 
-					case CycleAddSignedOperandToPC:
+					micro_op(CycleAddSignedOperandToPC):
 						nextAddress.full = static_cast<uint16_t>(pc_.full + (int8_t)operand_);
 						pc_.bytes.low = nextAddress.bytes.low;
 						if(nextAddress.bytes.high != pc_.bytes.high) {
@@ -480,14 +539,14 @@ if(number_of_cycles <= Cycles(0)) break;
 
 // MARK: - Transfers
 
-					case OperationTXA: zero_result_ = negative_result_ = a_ = x_;	continue;
-					case OperationTYA: zero_result_ = negative_result_ = a_ = y_;	continue;
-					case OperationTXS: s_ = x_;										continue;
-					case OperationTAY: zero_result_ = negative_result_ = y_ = a_;	continue;
-					case OperationTAX: zero_result_ = negative_result_ = x_ = a_;	continue;
-					case OperationTSX: zero_result_ = negative_result_ = x_ = s_;	continue;
+					micro_op(OperationTXA): zero_result_ = negative_result_ = a_ = x_;	continue;
+					micro_op(OperationTYA): zero_result_ = negative_result_ = a_ = y_;	continue;
+					micro_op(OperationTXS): s_ = x_;										continue;
+					micro_op(OperationTAY): zero_result_ = negative_result_ = y_ = a_;	continue;
+					micro_op(OperationTAX): zero_result_ = negative_result_ = x_ = a_;	continue;
+					micro_op(OperationTSX): zero_result_ = negative_result_ = x_ = s_;	continue;
 
-					case OperationARR:
+					micro_op(OperationARR):
 						if(decimal_flag_) {
 							a_ &= operand_;
 							uint8_t unshiftedA = a_;
@@ -508,7 +567,7 @@ if(number_of_cycles <= Cycles(0)) break;
 						}
 					continue;
 
-					case OperationSBX:
+					micro_op(OperationSBX):
 						x_ &= a_;
 						uint16_t difference = x_ - operand_;
 						x_ = static_cast<uint8_t>(difference);
@@ -533,6 +592,8 @@ if(number_of_cycles <= Cycles(0)) break;
 	bus_value_ = busValue;
 
 	bus_handler_.flush();
+
+#undef micro_op
 }
 
 template <typename T, bool uses_ready_line> void Processor<T, uses_ready_line>::set_ready_line(bool active) {
@@ -576,51 +637,15 @@ void ProcessorBase::set_nmi_line(bool active) {
 }
 
 inline const ProcessorStorage::MicroOp *ProcessorStorage::get_reset_program() {
-	static const MicroOp reset[] = {
-		CycleFetchOperand,
-		CycleFetchOperand,
-		CycleNoWritePush,
-		CycleNoWritePush,
-		OperationRSTPickVector,
-		CycleNoWritePush,
-		CycleReadVectorLow,
-		CycleReadVectorHigh,
-		OperationMoveToNextProgram
-	};
-	return reset;
+	return reset_program;
 }
 
 inline const ProcessorStorage::MicroOp *ProcessorStorage::get_irq_program() {
-	static const MicroOp reset[] = {
-		CycleFetchOperand,
-		CycleFetchOperand,
-		CyclePushPCH,
-		CyclePushPCL,
-		OperationBRKPickVector,
-		OperationSetOperandFromFlags,
-		CyclePushOperand,
-		OperationSetI,
-		CycleReadVectorLow,
-		CycleReadVectorHigh,
-		OperationMoveToNextProgram
-	};
-	return reset;
+	return irq_program;
 }
 
 inline const ProcessorStorage::MicroOp *ProcessorStorage::get_nmi_program() {
-	static const MicroOp reset[] = {
-		CycleFetchOperand,
-		CycleFetchOperand,
-		CyclePushPCH,
-		CyclePushPCL,
-		OperationNMIPickVector,
-		OperationSetOperandFromFlags,
-		CyclePushOperand,
-		CycleReadVectorLow,
-		CycleReadVectorHigh,
-		OperationMoveToNextProgram
-	};
-	return reset;
+	return nmi_program;
 }
 
 uint8_t ProcessorStorage::get_flags() {
@@ -244,6 +244,56 @@ const ProcessorStorage::MicroOp ProcessorStorage::operations[256][10] = {
 #undef Immediate
 #undef Implied
 
+const ProcessorStorage::MicroOp ProcessorStorage::do_branch[3] = {
+	CycleReadFromPC,
+	CycleAddSignedOperandToPC,
+	OperationMoveToNextProgram
+};
+
+const ProcessorStorage::MicroOp ProcessorStorage::fetch_decode_execute[2] = {
+	CycleFetchOperation,
+	CycleFetchOperandDecodeOperation
+};
+
+const ProcessorStorage::MicroOp ProcessorStorage::reset_program[9] = {
+	CycleFetchOperand,
+	CycleFetchOperand,
+	CycleNoWritePush,
+	CycleNoWritePush,
+	OperationRSTPickVector,
+	CycleNoWritePush,
+	CycleReadVectorLow,
+	CycleReadVectorHigh,
+	OperationMoveToNextProgram
+};
+
+const ProcessorStorage::MicroOp ProcessorStorage::irq_program[11] = {
+	CycleFetchOperand,
+	CycleFetchOperand,
+	CyclePushPCH,
+	CyclePushPCL,
+	OperationBRKPickVector,
+	OperationSetOperandFromFlags,
+	CyclePushOperand,
+	OperationSetI,
+	CycleReadVectorLow,
+	CycleReadVectorHigh,
+	OperationMoveToNextProgram
+};
+
+const ProcessorStorage::MicroOp ProcessorStorage::nmi_program[10] = {
+	CycleFetchOperand,
+	CycleFetchOperand,
+	CyclePushPCH,
+	CyclePushPCL,
+	OperationNMIPickVector,
+	OperationSetOperandFromFlags,
+	CyclePushOperand,
+	CycleReadVectorLow,
+	CycleReadVectorHigh,
+	OperationMoveToNextProgram
+};
+
 ProcessorStorage::ProcessorStorage() {
 	// only the interrupt flag is defined upon reset but get_flags isn't going to
 	// mask the other flags so we need to do that, at least
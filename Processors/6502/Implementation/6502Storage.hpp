@@ -21,6 +21,7 @@ class ProcessorStorage {
 			This emulation functions by decomposing instructions into micro programs, consisting of the micro operations
 			as per the enum below. Each micro op takes at most one cycle. By convention, those called CycleX take a cycle
 			to perform whereas those called OperationX occur for free (so, in effect, their cost is loaded onto the next cycle).
+			A few, such as CycleFetchOperandDecodeOperation, fuse a common pair into a single step.
 		*/
 		enum MicroOp {
 			CycleFetchOperation,						CycleFetchOperand,					OperationDecodeOperation,				CycleIncPCPushPCH,
@@ -59,11 +60,19 @@ class ProcessorStorage {
 			OperationLAS,								CycleAddSignedOperandToPC,			OperationSetFlagsFromOperand,			OperationSetOperandFromFlagsWithBRKSet,
 			OperationSetOperandFromFlags,
 			OperationSetFlagsFromA,
-			CycleScheduleJam
+			CycleScheduleJam,
+			CycleFetchOperandDecodeOperation
 		};
 
 		static const MicroOp operations[256][10];
 
+		// The fixed programs that run other than in response to an opcode.
+		static const MicroOp do_branch[3];
+		static const MicroOp fetch_decode_execute[2];
+		static const MicroOp reset_program[9];
+		static const MicroOp irq_program[11];
+		static const MicroOp nmi_program[10];
+
 		const MicroOp *scheduled_program_counter_ = nullptr;
 
 		/*
@@ -86,6 +95,7 @@ class ProcessorStorage {
 		BusOperation next_bus_operation_ = BusOperation::None;
 		uint16_t bus_address_;
 		uint8_t *bus_value_;
+		uint8_t throwaway_target_;
 
 		/*!
 			Gets the flags register.
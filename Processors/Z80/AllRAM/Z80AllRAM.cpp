@@ -8,6 +8,7 @@
 
 #include "Z80AllRAM.hpp"
 #include <algorithm>
+#include <cstdio>
 
 using namespace CPU::Z80;
 namespace {
@@ -119,3 +119,64 @@ void ProcessorBase::set_value_of_register(Register r, uint16_t value) {
 		default: break;
 	}
 }
+
+void ProcessorBase::serialise(Snapshot::Archive &archive) {
+	archive.tag(0x5a383020);
+
+	// Micro-programs are shared between instances, so the position within the current one is recorded
+	// as the index of the program plus an offset into it, and the current page by index.
+	const InstructionPage *const pages = instruction_set_->pages;
+	const std::size_t number_of_pages = InstructionSet::NumberOfPages;
+
+	std::vector<const std::vector<MicroOp> *> programs = {
+		&instruction_set_->conditional_call_untaken_program,	&instruction_set_->reset_program,
+		&instruction_set_->irq_program[0],	&instruction_set_->irq_program[1],	&instruction_set_->irq_program[2],
+		&instruction_set_->nmi_program
+	};
+	for(std::size_t index = 0; index < number_of_pages; ++index) {
+		programs.push_back(&pages[index].all_operations);
+		programs.push_back(&pages[index].fetch_decode_execute);
+	}
+
+	int program = -1;
+	uint32_t program_offset = 0;
+	int page = -1;
+	if(!archive.is_reading()) {
+		if(scheduled_program_counter_) {
+			for(std::size_t index = 0; index < programs.size(); ++index) {
+				const MicroOp *const start = programs[index]->data();
+				if(scheduled_program_counter_ >= start && scheduled_program_counter_ <= start + programs[index]->size()) {
+					program = static_cast<int>(index);
+					program_offset = static_cast<uint32_t>(scheduled_program_counter_ - start);
+					break;
+				}
+			}
+		}
+		for(std::size_t index = 0; index < number_of_pages; ++index) {
+			if(current_instruction_page_ == &pages[index]) page = static_cast<int>(index);
+		}
+	}
+	archive(program, program_offset, page);
+
+	archive(
+		a_, bc_, de_, hl_,
+		afDash_, bcDash_, deDash_, hlDash_,
+		ix_, iy_, pc_, sp_, ir_, refresh_addr_,
+		iff1_, iff2_, interrupt_mode_, pc_increment_,
+		sign_result_, zero_result_, half_carry_result_, bit53_result_, parity_overflow_result_, subtract_flag_, carry_result_,
+		halt_mask_, number_of_cycles_,
+		request_status_, last_request_status_, irq_line_, nmi_line_, bus_request_line_, wait_line_,
+		operation_, temp16_, memptr_, temp8_);
+
+	if(archive.is_reading()) {
+		if(
+			program >= static_cast<int>(programs.size()) ||
+			(program >= 0 && program_offset > programs[program]->size()) ||
+			page >= static_cast<int>(number_of_pages)) {
+			archive.set_invalid();
+			return;
+		}
+		scheduled_program_counter_ = (program >= 0) ? programs[program]->data() + program_offset : nullptr;
+		if(page >= 0) current_instruction_page_ = &pages[page];
+	}
+}
@@ -11,7 +11,7 @@ template <	class T,
 			bool uses_wait_line> Processor <T, uses_bus_request, uses_wait_line>
 				::Processor(T &bus_handler) :
 					bus_handler_(bus_handler) {
-	install_default_instruction_set();
+	use_shared_instruction_set(uses_wait_line);
 }
 
 template <	class T,
@@ -24,16 +24,16 @@ template <	class T,
 		halt_mask_ = 0xff;	\
 		if(last_request_status_ & (Interrupt::PowerOn | Interrupt::Reset)) {	\
 			request_status_ &= ~Interrupt::PowerOn;	\
-			scheduled_program_counter_ = reset_program_.data();	\
+			scheduled_program_counter_ = instruction_set_->reset_program.data();	\
 		} else if(last_request_status_ & Interrupt::NMI) {	\
 			request_status_ &= ~Interrupt::NMI;	\
-			scheduled_program_counter_ = nmi_program_.data();	\
+			scheduled_program_counter_ = instruction_set_->nmi_program.data();	\
 		} else if(last_request_status_ & Interrupt::IRQ) {	\
-			scheduled_program_counter_ = irq_program_[interrupt_mode_].data();	\
+			scheduled_program_counter_ = instruction_set_->irq_program[interrupt_mode_].data();	\
 		}	\
 	} else {	\
-		current_instruction_page_ = &base_page_;	\
-		scheduled_program_counter_ = base_page_.fetch_decode_execute_data;	\
+		current_instruction_page_ = &instruction_set_->pages[InstructionSet::Base];	\
+		scheduled_program_counter_ = current_instruction_page_->fetch_decode_execute_data;	\
 	}
 
 	number_of_cycles_ += cycles;
@@ -65,24 +65,35 @@ template <	class T,
 
 			switch(operation->type) {
 				case MicroOp::BusOperation:
-					if(number_of_cycles_ < operation->machine_cycle.length) {
+				bus_operation: {
+					const PartialMachineCycle &cycle = bus_cycles_[operation->bus_cycle];
+					if(number_of_cycles_ < cycle.length) {
 						scheduled_program_counter_--;
 						bus_handler_.flush();
 						return;
 					}
-					if(uses_wait_line && operation->machine_cycle.was_requested) {
+					if(uses_wait_line && operation->was_requested) {
 						if(wait_line_) {
 							scheduled_program_counter_--;
 						} else {
 							continue;
 						}
 					}
-					number_of_cycles_ -= operation->machine_cycle.length;
+					number_of_cycles_ -= cycle.length;
 					last_request_status_ = request_status_;
-					number_of_cycles_ -= bus_handler_.perform_machine_cycle(operation->machine_cycle);
+					number_of_cycles_ -= bus_handler_.perform_machine_cycle(cycle);
 					if(uses_bus_request && bus_request_line_) goto do_bus_acknowledge;
-				break;
+				} break;
 				case MicroOp::MoveToNextProgram:
+					// Absent any interrupt request, proceed directly to the bus operation that begins the next
+					// opcode fetch rather than via another pass around the loop.
+					if(!last_request_status_) {
+						pc_increment_ = 1;
+						current_instruction_page_ = &instruction_set_->pages[InstructionSet::Base];
+						operation = current_instruction_page_->fetch_decode_execute_data;
+						scheduled_program_counter_ = operation + 1;
+						goto bus_operation;
+					}
 					advance_operation();
 				break;
 				case MicroOp::DecodeOperation:
@@ -97,11 +108,11 @@ template <	class T,
 					scheduled_program_counter_ = current_instruction_page_->instructions[operation_ & halt_mask_];
 				break;
 
-				case MicroOp::Increment16:			(*static_cast<uint16_t *>(operation->source))++;		break;
+				case MicroOp::Increment16:			(*word_register(operation->source))++;		break;
 				case MicroOp::IncrementPC:			pc_.full += pc_increment_;								break;
-				case MicroOp::Decrement16:			(*static_cast<uint16_t *>(operation->source))--;		break;
-				case MicroOp::Move8:				*static_cast<uint8_t *>(operation->destination) = *static_cast<uint8_t *>(operation->source);		break;
-				case MicroOp::Move16:				*static_cast<uint16_t *>(operation->destination) = *static_cast<uint16_t *>(operation->source);		break;
+				case MicroOp::Decrement16:			(*word_register(operation->source))--;		break;
+				case MicroOp::Move8:				*byte_register(operation->destination) = *byte_register(operation->source);		break;
+				case MicroOp::Move16:				*word_register(operation->destination) = *word_register(operation->source);		break;
 
 				case MicroOp::AssembleAF:
 					temp16_.bytes.high = a_;
@@ -122,17 +133,17 @@ template <	class T,
 	carry_result_ = 0;
 
 				case MicroOp::And:
-					a_ &= *static_cast<uint8_t *>(operation->source);
+					a_ &= *byte_register(operation->source);
 					set_logical_flags(Flag::HalfCarry);
 				break;
 
 				case MicroOp::Or:
-					a_ |= *static_cast<uint8_t *>(operation->source);
+					a_ |= *byte_register(operation->source);
 					set_logical_flags(0);
 				break;
 
 				case MicroOp::Xor:
-					a_ ^= *static_cast<uint8_t *>(operation->source);
+					a_ ^= *byte_register(operation->source);
 					set_logical_flags(0);
 				break;
 
@@ -183,7 +194,7 @@ template <	class T,
 	bit53_result_ = static_cast<uint8_t>(b53);
 
 				case MicroOp::CP8: {
-					uint8_t value = *static_cast<uint8_t *>(operation->source);
+					uint8_t value = *byte_register(operation->source);
 					int result = a_ - value;
 					int half_result = (a_&0xf) - (value&0xf);
 
@@ -196,7 +207,7 @@ template <	class T,
 				} break;
 
 				case MicroOp::SUB8: {
-					uint8_t value = *static_cast<uint8_t *>(operation->source);
+					uint8_t value = *byte_register(operation->source);
 					int result = a_ - value;
 					int half_result = (a_&0xf) - (value&0xf);
 
@@ -209,7 +220,7 @@ template <	class T,
 				} break;
 
 				case MicroOp::SBC8: {
-					uint8_t value = *static_cast<uint8_t *>(operation->source);
+					uint8_t value = *byte_register(operation->source);
 					int result = a_ - value - (carry_result_ & Flag::Carry);
 					int half_result = (a_&0xf) - (value&0xf) - (carry_result_ & Flag::Carry);
 
@@ -222,7 +233,7 @@ template <	class T,
 				} break;
 
 				case MicroOp::ADD8: {
-					uint8_t value = *static_cast<uint8_t *>(operation->source);
+					uint8_t value = *byte_register(operation->source);
 					int result = a_ + value;
 					int half_result = (a_&0xf) + (value&0xf);
 
@@ -235,7 +246,7 @@ template <	class T,
 				} break;
 
 				case MicroOp::ADC8: {
-					uint8_t value = *static_cast<uint8_t *>(operation->source);
+					uint8_t value = *byte_register(operation->source);
 					int result = a_ + value + (carry_result_ & Flag::Carry);
 					int half_result = (a_&0xf) + (value&0xf) + (carry_result_ & Flag::Carry);
 
@@ -263,7 +274,7 @@ template <	class T,
 				} break;
 
 				case MicroOp::Increment8: {
-					uint8_t value = *static_cast<uint8_t *>(operation->source);
+					uint8_t value = *byte_register(operation->source);
 					int result = value + 1;
 
 					// with an increment, overflow occurs if the sign changes from
@@ -271,7 +282,7 @@ template <	class T,
 					int overflow = (value ^ result) & ~value;
 					int half_result = (value&0xf) + 1;
 
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>(result);
+					*byte_register(operation->source) = static_cast<uint8_t>(result);
 
 					// sign, zero and 5 & 3 are set directly from the result
 					bit53_result_ = sign_result_ = zero_result_ = static_cast<uint8_t>(result);
@@ -281,7 +292,7 @@ template <	class T,
 				} break;
 
 				case MicroOp::Decrement8: {
-					uint8_t value = *static_cast<uint8_t *>(operation->source);
+					uint8_t value = *byte_register(operation->source);
 					int result = value - 1;
 
 					// with a decrement, overflow occurs if the sign changes from
@@ -289,7 +300,7 @@ template <	class T,
 					int overflow = (value ^ result) & value;
 					int half_result = (value&0xf) - 1;
 
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>(result);
+					*byte_register(operation->source) = static_cast<uint8_t>(result);
 
 					// sign, zero and 5 & 3 are set directly from the result
 					bit53_result_ = sign_result_ = zero_result_ = static_cast<uint8_t>(result);
@@ -356,8 +367,8 @@ template <	class T,
 // MARK: - 16-bit arithmetic
 
 				case MicroOp::ADD16: {
-					memptr_.full = *static_cast<uint16_t *>(operation->destination);
-					uint16_t sourceValue = *static_cast<uint16_t *>(operation->source);
+					memptr_.full = *word_register(operation->destination);
+					uint16_t sourceValue = *word_register(operation->source);
 					uint16_t destinationValue = memptr_.full;
 					int result = sourceValue + destinationValue;
 					int halfResult = (sourceValue&0xfff) + (destinationValue&0xfff);
@@ -367,13 +378,13 @@ template <	class T,
 					half_carry_result_ = static_cast<uint8_t>(halfResult >> 8);
 					subtract_flag_ = 0;
 
-					*static_cast<uint16_t *>(operation->destination) = static_cast<uint16_t>(result);
+					*word_register(operation->destination) = static_cast<uint16_t>(result);
 					memptr_.full++;
 				} break;
 
 				case MicroOp::ADC16: {
-					memptr_.full = *static_cast<uint16_t *>(operation->destination);
-					uint16_t sourceValue = *static_cast<uint16_t *>(operation->source);
+					memptr_.full = *word_register(operation->destination);
+					uint16_t sourceValue = *word_register(operation->source);
 					uint16_t destinationValue = memptr_.full;
 					int result = sourceValue + destinationValue + (carry_result_ & Flag::Carry);
 					int halfResult = (sourceValue&0xfff) + (destinationValue&0xfff) + (carry_result_ & Flag::Carry);
@@ -388,13 +399,13 @@ template <	class T,
 					half_carry_result_ = static_cast<uint8_t>(halfResult >> 8);
 					parity_overflow_result_ = static_cast<uint8_t>(overflow >> 13);
 
-					*static_cast<uint16_t *>(operation->destination) = static_cast<uint16_t>(result);
+					*word_register(operation->destination) = static_cast<uint16_t>(result);
 					memptr_.full++;
 				} break;
 
 				case MicroOp::SBC16: {
-					memptr_.full = *static_cast<uint16_t *>(operation->destination);
-					uint16_t sourceValue = *static_cast<uint16_t *>(operation->source);
+					memptr_.full = *word_register(operation->destination);
+					uint16_t sourceValue = *word_register(operation->source);
 					uint16_t destinationValue = memptr_.full;
 					int result = destinationValue - sourceValue - (carry_result_ & Flag::Carry);
 					int halfResult = (destinationValue&0xfff) - (sourceValue&0xfff) - (carry_result_ & Flag::Carry);
@@ -412,7 +423,7 @@ template <	class T,
 					half_carry_result_ = static_cast<uint8_t>(halfResult >> 8);
 					parity_overflow_result_ = static_cast<uint8_t>(overflow >> 13);
 
-					*static_cast<uint16_t *>(operation->destination) = static_cast<uint16_t>(result);
+					*word_register(operation->destination) = static_cast<uint16_t>(result);
 					memptr_.full++;
 				} break;
 
@@ -420,7 +431,7 @@ template <	class T,
 
 #define decline_conditional()	\
 	if(operation->source) {		\
-		scheduled_program_counter_ = (MicroOp *)operation->source;	\
+		scheduled_program_counter_ = instruction_set_->conditional_call_untaken_program.data();	\
 	} else {	\
 		advance_operation();	\
 	}
@@ -619,12 +630,12 @@ template <	class T,
 // MARK: - Bit Manipulation
 
 				case MicroOp::BIT: {
-					uint8_t result = *static_cast<uint8_t *>(operation->source) & (1 << ((operation_ >> 3)&7));
+					uint8_t result = *byte_register(operation->source) & (1 << ((operation_ >> 3)&7));
 
 					if(current_instruction_page_->is_indexed || ((operation_&0x08) == 7)) {
 						bit53_result_ = memptr_.bytes.high;
 					} else {
-						bit53_result_ = *static_cast<uint8_t *>(operation->source);
+						bit53_result_ = *byte_register(operation->source);
 					}
 
 					sign_result_ = zero_result_ = result;
@@ -634,11 +645,11 @@ template <	class T,
 				} break;
 
 				case MicroOp::RES:
-					*static_cast<uint8_t *>(operation->source) &= ~(1 << ((operation_ >> 3)&7));
+					*byte_register(operation->source) &= ~(1 << ((operation_ >> 3)&7));
 				break;
 
 				case MicroOp::SET:
-					*static_cast<uint8_t *>(operation->source) |= (1 << ((operation_ >> 3)&7));
+					*byte_register(operation->source) |= (1 << ((operation_ >> 3)&7));
 				break;
 
 // MARK: - Rotation and shifting
@@ -675,58 +686,58 @@ template <	class T,
 #undef set_rotate_flags
 
 #define set_shift_flags()	\
-	sign_result_ = zero_result_ = bit53_result_ = *static_cast<uint8_t *>(operation->source);	\
+	sign_result_ = zero_result_ = bit53_result_ = *byte_register(operation->source);	\
 	set_parity(sign_result_);	\
 	half_carry_result_ = 0;	\
 	subtract_flag_ = 0;
 
 				case MicroOp::RLC:
-					carry_result_ = *static_cast<uint8_t *>(operation->source) >> 7;
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>((*static_cast<uint8_t *>(operation->source) << 1) | carry_result_);
+					carry_result_ = *byte_register(operation->source) >> 7;
+					*byte_register(operation->source) = static_cast<uint8_t>((*byte_register(operation->source) << 1) | carry_result_);
 					set_shift_flags();
 				break;
 
 				case MicroOp::RRC:
-					carry_result_ = *static_cast<uint8_t *>(operation->source);
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>((*static_cast<uint8_t *>(operation->source) >> 1) | (carry_result_ << 7));
+					carry_result_ = *byte_register(operation->source);
+					*byte_register(operation->source) = static_cast<uint8_t>((*byte_register(operation->source) >> 1) | (carry_result_ << 7));
 					set_shift_flags();
 				break;
 
 				case MicroOp::RL: {
-					uint8_t next_carry = *static_cast<uint8_t *>(operation->source) >> 7;
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>((*static_cast<uint8_t *>(operation->source) << 1) | (carry_result_ & Flag::Carry));
+					uint8_t next_carry = *byte_register(operation->source) >> 7;
+					*byte_register(operation->source) = static_cast<uint8_t>((*byte_register(operation->source) << 1) | (carry_result_ & Flag::Carry));
 					carry_result_ = next_carry;
 					set_shift_flags();
 				} break;
 
 				case MicroOp::RR: {
-					uint8_t next_carry = *static_cast<uint8_t *>(operation->source);
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>((*static_cast<uint8_t *>(operation->source) >> 1) | (carry_result_ << 7));
+					uint8_t next_carry = *byte_register(operation->source);
+					*byte_register(operation->source) = static_cast<uint8_t>((*byte_register(operation->source) >> 1) | (carry_result_ << 7));
 					carry_result_ = next_carry;
 					set_shift_flags();
 				} break;
 
 				case MicroOp::SLA:
-					carry_result_ = *static_cast<uint8_t *>(operation->source) >> 7;
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>(*static_cast<uint8_t *>(operation->source) << 1);
+					carry_result_ = *byte_register(operation->source) >> 7;
+					*byte_register(operation->source) = static_cast<uint8_t>(*byte_register(operation->source) << 1);
 					set_shift_flags();
 				break;
 
 				case MicroOp::SRA:
-					carry_result_ = *static_cast<uint8_t *>(operation->source);
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>((*static_cast<uint8_t *>(operation->source) >> 1) | (*static_cast<uint8_t *>(operation->source) & 0x80));
+					carry_result_ = *byte_register(operation->source);
+					*byte_register(operation->source) = static_cast<uint8_t>((*byte_register(operation->source) >> 1) | (*byte_register(operation->source) & 0x80));
 					set_shift_flags();
 				break;
 
 				case MicroOp::SLL:
-					carry_result_ = *static_cast<uint8_t *>(operation->source) >> 7;
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>(*static_cast<uint8_t *>(operation->source) << 1) | 1;
+					carry_result_ = *byte_register(operation->source) >> 7;
+					*byte_register(operation->source) = static_cast<uint8_t>(*byte_register(operation->source) << 1) | 1;
 					set_shift_flags();
 				break;
 
 				case MicroOp::SRL:
-					carry_result_ = *static_cast<uint8_t *>(operation->source);
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>((*static_cast<uint8_t *>(operation->source) >> 1));
+					carry_result_ = *byte_register(operation->source);
+					*byte_register(operation->source) = static_cast<uint8_t>((*byte_register(operation->source) >> 1));
 					set_shift_flags();
 				break;
 
@@ -782,7 +793,7 @@ template <	class T,
 
 				case MicroOp::SetInFlags:
 					subtract_flag_ = half_carry_result_ = 0;
-					sign_result_ = zero_result_ = bit53_result_ = *static_cast<uint8_t *>(operation->source);
+					sign_result_ = zero_result_ = bit53_result_ = *byte_register(operation->source);
 					set_parity(sign_result_);
 				break;
 
@@ -840,12 +851,14 @@ template <	class T,
 // MARK: - Internal bookkeeping
 
 				case MicroOp::SetInstructionPage:
-					current_instruction_page_ = (InstructionPage *)operation->source;
-					scheduled_program_counter_ = current_instruction_page_->fetch_decode_execute_data;
-				break;
+					// Every page's fetch-decode-execute program begins with a bus operation, so proceed directly to it.
+					current_instruction_page_ = &instruction_set_->pages[operation->source];
+					operation = current_instruction_page_->fetch_decode_execute_data;
+					scheduled_program_counter_ = operation + 1;
+				goto bus_operation;
 
 				case MicroOp::CalculateIndexAddress:
-					memptr_.full = static_cast<uint16_t>(*static_cast<uint16_t *>(operation->source) + (int8_t)temp8_);
+					memptr_.full = static_cast<uint16_t>(*word_register(operation->source) + (int8_t)temp8_);
 				break;
 
 				case MicroOp::IndexedPlaceHolder:
@@ -887,93 +900,6 @@ template <	class T,
 	return wait_line_;
 }
 
-#define isTerminal(n)	(n == MicroOp::MoveToNextProgram || n == MicroOp::DecodeOperation || n == MicroOp::DecodeOperationNoRChange)
-
-template <	class T,
-			bool uses_bus_request,
-			bool uses_wait_line> void Processor <T, uses_bus_request, uses_wait_line>
-				::assemble_page(InstructionPage &target, InstructionTable &table, bool add_offsets) {
-	std::size_t number_of_micro_ops = 0;
-	std::size_t lengths[256];
-
-	// Count number of micro-ops required.
-	for(int c = 0; c < 256; c++) {
-		std::size_t length = 0;
-		while(!isTerminal(table[c][length].type)) length++;
-		length++;
-		lengths[c] = length;
-		number_of_micro_ops += length;
-	}
-
-	// Allocate a landing area.
-	std::vector<std::size_t> operation_indices;
-	target.all_operations.reserve(number_of_micro_ops);
-	target.instructions.resize(256, nullptr);
-
-	// Copy in all programs, recording where they go.
-	std::size_t destination = 0;
-	for(std::size_t c = 0; c < 256; c++) {
-		operation_indices.push_back(target.all_operations.size());
-		for(std::size_t t = 0; t < lengths[c];) {
-			// Skip zero-length bus cycles.
-			if(table[c][t].type == MicroOp::BusOperation && table[c][t].machine_cycle.length.as_int() == 0) {
-				t++;
-				continue;
-			}
-
-			// Skip optional waits if this instance doesn't use the wait line.
-			if(table[c][t].machine_cycle.was_requested && !uses_wait_line) {
-				t++;
-				continue;
-			}
-
-			// If an index placeholder is hit then drop it, and if offsets aren't being added,
-			// then also drop the indexing that follows, which is assumed to be everything
-			// up to and including the next ::CalculateIndexAddress. Coupled to the INDEX() macro.
-			if(table[c][t].type == MicroOp::IndexedPlaceHolder) {
-				t++;
-				if(!add_offsets) {
-					while(table[c][t].type != MicroOp::CalculateIndexAddress) t++;
-					t++;
-				}
-			}
-			target.all_operations.emplace_back(table[c][t]);
-			destination++;
-			t++;
-		}
-	}
-
-	// Since the vector won't change again, it's now safe to set pointers.
-	std::size_t c = 0;
-	for(std::size_t index : operation_indices) {
-		target.instructions[c] = &target.all_operations[index];
-		c++;
-	}
-}
-
-template <	class T,
-			bool uses_bus_request,
-			bool uses_wait_line> void Processor <T, uses_bus_request, uses_wait_line>
-		::copy_program(const MicroOp *source, std::vector<MicroOp> &destination) {
-	std::size_t length = 0;
-	while(!isTerminal(source[length].type)) length++;
-	std::size_t pointer = 0;
-	while(true) {
-		// TODO: This test is duplicated from assemble_page; can a better factoring be found?
-		// Skip optional waits if this instance doesn't use the wait line.
-		if(source[pointer].machine_cycle.was_requested && !uses_wait_line) {
-			pointer++;
-			continue;
-		}
-
-		destination.emplace_back(source[pointer]);
-		if(isTerminal(source[pointer].type)) break;
-		pointer++;
-	}
-}
-
-#undef isTerminal
-
 bool ProcessorBase::get_halt_line() {
 	return halt_mask_ == 0x00;
 }
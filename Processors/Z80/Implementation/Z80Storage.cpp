@@ -7,6 +7,7 @@
 //
 
 #include "../Z80.hpp"
+#include <algorithm>
 #include <cstring>
 
 using namespace CPU::Z80;
@@ -15,6 +16,36 @@ ProcessorStorage::ProcessorStorage() {
 	set_flags(0xff);
 }
 
+const ProcessorStorage::InstructionSet &ProcessorStorage::shared_instruction_set(ProcessorStorage &prototype, bool uses_wait_line) {
+	// Register indices are the same in every instance, so whichever instance asks first acts as the
+	// prototype. Function-scope statics are constructed exactly once, even if several threads race here.
+	if(uses_wait_line) {
+		static const InstructionSet wait_line_set(prototype, true);
+		return wait_line_set;
+	}
+	static const InstructionSet set(prototype, false);
+	return set;
+}
+
+void ProcessorStorage::use_shared_instruction_set(bool uses_wait_line) {
+	instruction_set_ = &shared_instruction_set(*this, uses_wait_line);
+
+	bus_cycles_.reserve(instruction_set_->bus_cycles.size());
+	for(const auto &cycle: instruction_set_->bus_cycles) {
+		bus_cycles_.emplace_back(
+			static_cast<PartialMachineCycle::Operation>(cycle.operation),
+			HalfCycles(cycle.length),
+			(cycle.address != MicroOp::NoRegister) ? word_register(cycle.address) : nullptr,
+			(cycle.value != MicroOp::NoRegister) ? byte_register(cycle.value) : nullptr,
+			cycle.was_requested);
+	}
+}
+
+ProcessorStorage::InstructionSet::InstructionSet(ProcessorStorage &prototype, bool uses_wait_line) :
+	uses_wait_line(uses_wait_line) {
+	prototype.assemble_instruction_set(*this);
+}
+
 // Elemental bus operations
 #define ReadOpcodeStart()			PartialMachineCycle(PartialMachineCycle::ReadOpcodeStart, HalfCycles(3), &pc_.full, &operation_, false)
 #define ReadOpcodeWait(f)			PartialMachineCycle(PartialMachineCycle::ReadOpcodeWait, HalfCycles(2), &pc_.full, &operation_, f)
@@ -99,7 +130,7 @@ ProcessorStorage::ProcessorStorage() {
 #define NOP						Sequence(BusOp(Refresh(4)))
 
 #define JP(cc)					StdInstr(Read16Inc(pc_, temp16_), {MicroOp::cc, nullptr}, {MicroOp::Move16, &temp16_.full, &pc_.full})
-#define CALL(cc)				StdInstr(ReadInc(pc_, temp16_.bytes.low), {MicroOp::cc, conditional_call_untaken_program_.data()}, Read4Inc(pc_, temp16_.bytes.high), Push(pc_), {MicroOp::Move16, &temp16_.full, &pc_.full})
+#define CALL(cc)				StdInstr(ReadInc(pc_, temp16_.bytes.low), {MicroOp::cc, &set.conditional_call_untaken_program}, Read4Inc(pc_, temp16_.bytes.high), Push(pc_), {MicroOp::Move16, &temp16_.full, &pc_.full})
 #define RET(cc)					Instr(6, {MicroOp::cc, nullptr}, Pop(memptr_), {MicroOp::Move16, &memptr_.full, &pc_.full})
 #define JR(cc)					StdInstr(ReadInc(pc_, temp8_), {MicroOp::cc, nullptr}, InternalOperation(10), {MicroOp::CalculateIndexAddress, &pc_.full}, {MicroOp::Move16, &memptr_.full, &pc_.full})
 #define RST()					Instr(6, {MicroOp::CalculateRSTDestination}, Push(pc_), {MicroOp::Move16, &memptr_.full, &pc_.full})
@@ -159,38 +190,40 @@ ProcessorStorage::ProcessorStorage() {
 #define ADC16(d, s) StdInstr(InternalOperation(8), InternalOperation(6), {MicroOp::ADC16, &s.full, &d.full})
 #define SBC16(d, s) StdInstr(InternalOperation(8), InternalOperation(6), {MicroOp::SBC16, &s.full, &d.full})
 
-void ProcessorStorage::install_default_instruction_set() {
-	MicroOp conditional_call_untaken_program[] = Sequence(ReadInc(pc_, temp16_.bytes.high));
-	copy_program(conditional_call_untaken_program, conditional_call_untaken_program_);
+void ProcessorStorage::assemble_instruction_set(InstructionSet &set) {
+	InstructionPage *const pages = set.pages;
 
-	assemble_base_page(base_page_, hl_, false, cb_page_);
-	assemble_base_page(dd_page_, ix_, true, ddcb_page_);
-	assemble_base_page(fd_page_, iy_, true, fdcb_page_);
-	assemble_ed_page(ed_page_);
+	MicroOpDescription conditional_call_untaken_program[] = Sequence(ReadInc(pc_, temp16_.bytes.high));
+	copy_program(set, conditional_call_untaken_program, set.conditional_call_untaken_program);
 
-	fdcb_page_.r_step = 0;
-	fd_page_.is_indexed = true;
-	fdcb_page_.is_indexed = true;
+	assemble_base_page(set, pages[InstructionSet::Base], hl_, false, pages[InstructionSet::CB]);
+	assemble_base_page(set, pages[InstructionSet::DD], ix_, true, pages[InstructionSet::DDCB]);
+	assemble_base_page(set, pages[InstructionSet::FD], iy_, true, pages[InstructionSet::FDCB]);
+	assemble_ed_page(set, pages[InstructionSet::ED]);
 
-	ddcb_page_.r_step = 0;
-	dd_page_.is_indexed = true;
-	ddcb_page_.is_indexed = true;
+	pages[InstructionSet::FDCB].r_step = 0;
+	pages[InstructionSet::FD].is_indexed = true;
+	pages[InstructionSet::FDCB].is_indexed = true;
 
-	assemble_fetch_decode_execute(base_page_, 4);
-	assemble_fetch_decode_execute(dd_page_, 4);
-	assemble_fetch_decode_execute(fd_page_, 4);
-	assemble_fetch_decode_execute(ed_page_, 4);
-	assemble_fetch_decode_execute(cb_page_, 4);
+	pages[InstructionSet::DDCB].r_step = 0;
+	pages[InstructionSet::DD].is_indexed = true;
+	pages[InstructionSet::DDCB].is_indexed = true;
 
-	assemble_fetch_decode_execute(fdcb_page_, 3);
-	assemble_fetch_decode_execute(ddcb_page_, 3);
+	assemble_fetch_decode_execute(set, pages[InstructionSet::Base], 4);
+	assemble_fetch_decode_execute(set, pages[InstructionSet::DD], 4);
+	assemble_fetch_decode_execute(set, pages[InstructionSet::FD], 4);
+	assemble_fetch_decode_execute(set, pages[InstructionSet::ED], 4);
+	assemble_fetch_decode_execute(set, pages[InstructionSet::CB], 4);
 
-	MicroOp reset_program[] = Sequence(InternalOperation(6), {MicroOp::Reset});
+	assemble_fetch_decode_execute(set, pages[InstructionSet::FDCB], 3);
+	assemble_fetch_decode_execute(set, pages[InstructionSet::DDCB], 3);
+
+	MicroOpDescription reset_program[] = Sequence(InternalOperation(6), {MicroOp::Reset});
 
 	// Justification for NMI timing: per Wilf Rigter on the ZX81 (http://www.user.dccnet.com/wrigter/index_files/ZX81WAIT.htm),
 	// wait cycles occur between T2 and T3 during NMI; extending the refresh cycle is also consistent with my guess
 	// for the action of other non-four-cycle opcode fetches
-	MicroOp nmi_program[] = {
+	MicroOpDescription nmi_program[] = {
 		{ MicroOp::BeginNMI },
 		BusOp(ReadOpcodeStart()),
 		BusOp(ReadOpcodeWait(true)),
@@ -200,14 +233,14 @@ void ProcessorStorage::install_default_instruction_set() {
 		{ MicroOp::JumpTo66, nullptr, nullptr},
 		{ MicroOp::MoveToNextProgram }
 	};
-	MicroOp irq_mode0_program[] = {
+	MicroOpDescription irq_mode0_program[] = {
 		{ MicroOp::BeginIRQMode0 },
 		BusOp(IntAckStart(5, operation_)),
 		BusOp(IntWait(operation_)),
 		BusOp(IntAckEnd(operation_)),
 		{ MicroOp::DecodeOperationNoRChange }
 	};
-	MicroOp irq_mode1_program[] = {
+	MicroOpDescription irq_mode1_program[] = {
 		{ MicroOp::BeginIRQ },
 		BusOp(IntAckStart(7, operation_)),	// 7 half cycles (including  +
 		BusOp(IntWait(operation_)),			// [potentially 2 half cycles] +
@@ -217,7 +250,7 @@ void ProcessorStorage::install_default_instruction_set() {
 		{ MicroOp::Move16, &temp16_.full, &pc_.full },
 		{ MicroOp::MoveToNextProgram }
 	};
-	MicroOp irq_mode2_program[] = {
+	MicroOpDescription irq_mode2_program[] = {
 		{ MicroOp::BeginIRQ },
 		BusOp(IntAckStart(7, temp16_.bytes.low)),
 		BusOp(IntWait(temp16_.bytes.low)),
@@ -229,14 +262,14 @@ void ProcessorStorage::install_default_instruction_set() {
 		{ MicroOp::MoveToNextProgram }
 	};
 
-	copy_program(reset_program, reset_program_);
-	copy_program(nmi_program, nmi_program_);
-	copy_program(irq_mode0_program, irq_program_[0]);
-	copy_program(irq_mode1_program, irq_program_[1]);
-	copy_program(irq_mode2_program, irq_program_[2]);
+	copy_program(set, reset_program, set.reset_program);
+	copy_program(set, nmi_program, set.nmi_program);
+	copy_program(set, irq_mode0_program, set.irq_program[0]);
+	copy_program(set, irq_mode1_program, set.irq_program[1]);
+	copy_program(set, irq_mode2_program, set.irq_program[2]);
 }
 
-void ProcessorStorage::assemble_ed_page(InstructionPage &target) {
+void ProcessorStorage::assemble_ed_page(InstructionSet &set, InstructionPage &target) {
 #define IN_C(r)		StdInstr(Input(bc_, r), {MicroOp::SetInFlags, &r})
 #define OUT_C(r)	StdInstr(Output(bc_, r))
 #define IN_OUT(r)	IN_C(r), OUT_C(r)
@@ -306,11 +339,11 @@ void ProcessorStorage::assemble_ed_page(InstructionPage &target) {
 		NOP_ROW(),	/* 0xe0 */
 		NOP_ROW(),	/* 0xf0 */
 	};
-	assemble_page(target, ed_program_table, false);
+	assemble_page(set, target, ed_program_table, false);
 #undef NOP_ROW
 }
 
-void ProcessorStorage::assemble_cb_page(InstructionPage &target, RegisterPair &index, bool add_offsets) {
+void ProcessorStorage::assemble_cb_page(InstructionSet &set, InstructionPage &target, RegisterPair &index, bool add_offsets) {
 #define OCTO_OP_GROUP(m, x)	m(x),	m(x),	m(x),	m(x),	m(x),	m(x),	m(x),	m(x)
 #define CB_PAGE(m, p)	m(RLC), m(RRC),	m(RL),	m(RR),	m(SLA),	m(SRA),	m(SLL),	m(SRL),	OCTO_OP_GROUP(p, BIT),	OCTO_OP_GROUP(m, RES),	OCTO_OP_GROUP(m, SET)
 
@@ -331,13 +364,13 @@ void ProcessorStorage::assemble_cb_page(InstructionPage &target, RegisterPair &i
 	InstructionTable offsets_cb_program_table = {
 		CB_PAGE(IX_MODIFY_OP_GROUP, IX_READ_OP_GROUP)
 	};
-	assemble_page(target, add_offsets ? offsets_cb_program_table : cb_program_table, add_offsets);
+	assemble_page(set, target, add_offsets ? offsets_cb_program_table : cb_program_table, add_offsets);
 
 #undef OCTO_OP_GROUP
 #undef CB_PAGE
 }
 
-void ProcessorStorage::assemble_base_page(InstructionPage &target, RegisterPair &index, bool add_offsets, InstructionPage &cb_page) {
+void ProcessorStorage::assemble_base_page(InstructionSet &set, InstructionPage &target, RegisterPair &index, bool add_offsets, InstructionPage &cb_page) {
 #define INC_DEC_LD(r)	\
 				StdInstr({MicroOp::Increment8, &r}),	\
 				StdInstr({MicroOp::Decrement8, &r}),	\
@@ -482,7 +515,7 @@ void ProcessorStorage::assemble_base_page(InstructionPage &target, RegisterPair
 		/* 0xd7 RST 10h */	RST(),
 		/* 0xd8 RET C */	RET(TestC),								/* 0xd9 EXX */		StdInstr({MicroOp::EXX}),
 		/* 0xda JP C */		JP(TestC),								/* 0xdb IN A, (n) */StdInstr(ReadInc(pc_, temp16_.bytes.low), {MicroOp::Move8, &a_, &temp16_.bytes.high}, Input(temp16_, a_)),
-		/* 0xdc CALL C */	CALL(TestC),							/* 0xdd [DD page] */StdInstr({MicroOp::SetInstructionPage, &dd_page_}),
+		/* 0xdc CALL C */	CALL(TestC),							/* 0xdd [DD page] */StdInstr({MicroOp::SetInstructionPage, &set.pages[InstructionSet::DD]}),
 		/* 0xde SBC A, n */	StdInstr(ReadInc(pc_, temp8_), {MicroOp::SBC8, &temp8_}),
 		/* 0xdf RST 18h */	RST(),
 		/* 0xe0 RET PO */	RET(TestPO),							/* 0xe1 POP HL */	StdInstr(Pop(index)),
@@ -492,7 +525,7 @@ void ProcessorStorage::assemble_base_page(InstructionPage &target, RegisterPair
 		/* 0xe7 RST 20h */	RST(),
 		/* 0xe8 RET PE */	RET(TestPE),							/* 0xe9 JP (HL) */	StdInstr({MicroOp::Move16, &index.full, &pc_.full}),
 		/* 0xea JP PE */	JP(TestPE),								/* 0xeb EX DE, HL */StdInstr({MicroOp::ExDEHL}),
-		/* 0xec CALL PE */	CALL(TestPE),							/* 0xed [ED page] */StdInstr({MicroOp::SetInstructionPage, &ed_page_}),
+		/* 0xec CALL PE */	CALL(TestPE),							/* 0xed [ED page] */StdInstr({MicroOp::SetInstructionPage, &set.pages[InstructionSet::ED]}),
 		/* 0xee XOR n */	StdInstr(ReadInc(pc_, temp8_), {MicroOp::Xor, &temp8_}),
 		/* 0xef RST 28h */	RST(),
 		/* 0xf0 RET p */	RET(TestP),								/* 0xf1 POP AF */	StdInstr(Pop(temp16_), {MicroOp::DisassembleAF}),
@@ -502,7 +535,7 @@ void ProcessorStorage::assemble_base_page(InstructionPage &target, RegisterPair
 		/* 0xf7 RST 30h */	RST(),
 		/* 0xf8 RET M */	RET(TestM),								/* 0xf9 LD SP, HL */Instr(8, {MicroOp::Move16, &index.full, &sp_.full}),
 		/* 0xfa JP M */		JP(TestM),								/* 0xfb EI */		StdInstr({MicroOp::EI}),
-		/* 0xfc CALL M */	CALL(TestM),							/* 0xfd [FD page] */StdInstr({MicroOp::SetInstructionPage, &fd_page_}),
+		/* 0xfc CALL M */	CALL(TestM),							/* 0xfd [FD page] */StdInstr({MicroOp::SetInstructionPage, &set.pages[InstructionSet::FD]}),
 		/* 0xfe CP n */		StdInstr(ReadInc(pc_, temp8_), {MicroOp::CP8, &temp8_}),
 		/* 0xff RST 38h */	RST(),
 	};
@@ -516,24 +549,155 @@ void ProcessorStorage::assemble_base_page(InstructionPage &target, RegisterPair
 		std::memcpy(&base_program_table[0x36], &copy_table[0], sizeof(copy_table[0]));
 	}
 
-	assemble_cb_page(cb_page, index, add_offsets);
-	assemble_page(target, base_program_table, add_offsets);
+	assemble_cb_page(set, cb_page, index, add_offsets);
+	assemble_page(set, target, base_program_table, add_offsets);
 }
 
-void ProcessorStorage::assemble_fetch_decode_execute(InstructionPage &target, int length) {
-	const MicroOp normal_fetch_decode_execute[] = {
+void ProcessorStorage::assemble_fetch_decode_execute(InstructionSet &set, InstructionPage &target, int length) {
+	const MicroOpDescription normal_fetch_decode_execute[] = {
 		BusOp(ReadOpcodeStart()),
 		BusOp(ReadOpcodeWait(true)),
 		BusOp(ReadOpcodeEnd()),
 		{ MicroOp::DecodeOperation }
 	};
-	const MicroOp short_fetch_decode_execute[] = {
+	const MicroOpDescription short_fetch_decode_execute[] = {
 		BusOp(ReadOpcodeStart()),
 		BusOp(ReadOpcodeWait(false)),
 		BusOp(ReadOpcodeWait(true)),
 		BusOp(ReadOpcodeEnd()),
 		{ MicroOp::DecodeOperation }
 	};
-	copy_program((length == 4) ? normal_fetch_decode_execute : short_fetch_decode_execute, target.fetch_decode_execute);
+	copy_program(set, (length == 4) ? normal_fetch_decode_execute : short_fetch_decode_execute, target.fetch_decode_execute);
 	target.fetch_decode_execute_data = target.fetch_decode_execute.data();
 }
+
+uint8_t ProcessorStorage::register_index(const void *address) {
+	if(!address) return MicroOp::NoRegister;
+
+	const std::ptrdiff_t index = static_cast<const uint8_t *>(address) - reinterpret_cast<const uint8_t *>(this);
+	assert(index >= 0 && index < MicroOp::NoRegister);
+	return static_cast<uint8_t>(index);
+}
+
+ProcessorStorage::MicroOp ProcessorStorage::encode(InstructionSet &set, const MicroOpDescription &description) {
+	MicroOp op;
+	op.type = description.type;
+	op.source = op.destination = MicroOp::NoRegister;
+
+	switch(description.type) {
+		case MicroOp::TestNZ:	case MicroOp::TestZ:
+		case MicroOp::TestNC:	case MicroOp::TestC:
+		case MicroOp::TestPO:	case MicroOp::TestPE:
+		case MicroOp::TestP:	case MicroOp::TestM:
+			op.source = (description.source == &set.conditional_call_untaken_program) ? 1 : 0;
+		break;
+
+		case MicroOp::SetInstructionPage:
+			op.source = static_cast<uint8_t>(static_cast<InstructionPage *>(description.source) - set.pages);
+		break;
+
+		default:
+			op.source = register_index(description.source);
+			op.destination = register_index(description.destination);
+		break;
+	}
+
+	op.was_requested = description.machine_cycle.was_requested;
+	op.bus_cycle = 0;
+	if(description.type == MicroOp::BusOperation) {
+		BusCycle cycle;
+		cycle.operation = static_cast<uint8_t>(description.machine_cycle.operation);
+		cycle.length = static_cast<uint8_t>(description.machine_cycle.length.as_int());
+		cycle.address = register_index(description.machine_cycle.address);
+		cycle.value = register_index(description.machine_cycle.value);
+		cycle.was_requested = description.machine_cycle.was_requested;
+
+		const auto existing = std::find(set.bus_cycles.begin(), set.bus_cycles.end(), cycle);
+		if(existing == set.bus_cycles.end()) {
+			assert(set.bus_cycles.size() < 65536);
+			set.bus_cycles.push_back(cycle);
+			op.bus_cycle = static_cast<uint16_t>(set.bus_cycles.size() - 1);
+		} else {
+			op.bus_cycle = static_cast<uint16_t>(existing - set.bus_cycles.begin());
+		}
+	}
+
+	return op;
+}
+
+#define isTerminal(n)	(n == MicroOp::MoveToNextProgram || n == MicroOp::DecodeOperation || n == MicroOp::DecodeOperationNoRChange)
+
+void ProcessorStorage::assemble_page(InstructionSet &set, InstructionPage &target, InstructionTable &table, bool add_offsets) {
+	std::size_t number_of_micro_ops = 0;
+	std::size_t lengths[256];
+
+	// Count number of micro-ops required.
+	for(int c = 0; c < 256; c++) {
+		std::size_t length = 0;
+		while(!isTerminal(table[c][length].type)) length++;
+		length++;
+		lengths[c] = length;
+		number_of_micro_ops += length;
+	}
+
+	// Allocate a landing area.
+	std::vector<std::size_t> operation_indices;
+	target.all_operations.reserve(number_of_micro_ops);
+	target.instructions.resize(256, nullptr);
+
+	// Copy in all programs, recording where they go.
+	for(std::size_t c = 0; c < 256; c++) {
+		operation_indices.push_back(target.all_operations.size());
+		for(std::size_t t = 0; t < lengths[c];) {
+			// Skip zero-length bus cycles.
+			if(table[c][t].type == MicroOp::BusOperation && table[c][t].machine_cycle.length.as_int() == 0) {
+				t++;
+				continue;
+			}
+
+			// Skip optional waits if this instruction set is for processors that don't use the wait line.
+			if(table[c][t].machine_cycle.was_requested && !set.uses_wait_line) {
+				t++;
+				continue;
+			}
+
+			// If an index placeholder is hit then drop it, and if offsets aren't being added,
+			// then also drop the indexing that follows, which is assumed to be everything
+			// up to and including the next ::CalculateIndexAddress. Coupled to the INDEX() macro.
+			if(table[c][t].type == MicroOp::IndexedPlaceHolder) {
+				t++;
+				if(!add_offsets) {
+					while(table[c][t].type != MicroOp::CalculateIndexAddress) t++;
+					t++;
+				}
+			}
+			target.all_operations.push_back(encode(set, table[c][t]));
+			t++;
+		}
+	}
+
+	// Since the vector won't change again, it's now safe to set pointers.
+	std::size_t c = 0;
+	for(std::size_t index : operation_indices) {
+		target.instructions[c] = &target.all_operations[index];
+		c++;
+	}
+}
+
+void ProcessorStorage::copy_program(InstructionSet &set, const MicroOpDescription *source, std::vector<MicroOp> &destination) {
+	std::size_t pointer = 0;
+	while(true) {
+		// TODO: This test is duplicated from assemble_page; can a better factoring be found?
+		// Skip optional waits if this instruction set is for processors that don't use the wait line.
+		if(source[pointer].machine_cycle.was_requested && !set.uses_wait_line) {
+			pointer++;
+			continue;
+		}
+
+		destination.push_back(encode(set, source[pointer]));
+		if(isTerminal(source[pointer].type)) break;
+		pointer++;
+	}
+}
+
+#undef isTerminal
@@ -13,8 +13,13 @@
 
 class ProcessorStorage {
 	protected:
+		/*!
+			A micro-op as executed. Operands are expressed as register indices — the byte offset of the register
+			concerned within ProcessorStorage — rather than as pointers, so that a single set of tables can be
+			shared by every instance. See @c byte_register and @c word_register.
+		*/
 		struct MicroOp {
-			enum Type {
+			enum Type: uint8_t {
 				BusOperation,
 				DecodeOperation,
 				DecodeOperationNoRChange,
@@ -93,27 +98,99 @@ class ProcessorStorage {
 
 				Reset
 			};
+
+			/// Indicates the absence of a register where an index would otherwise be.
+			static const uint8_t NoRegister = 0xff;
+
 			Type type;
-			void *source;
-			void *destination;
-			PartialMachineCycle machine_cycle;
+
+			/// A register index for most operations; for conditionals it is non-zero if the conditional call
+			/// untaken program should follow a failed test, and for SetInstructionPage it is an InstructionSet::Page.
+			uint8_t source;
+			uint8_t destination;
+
+			/// For bus operations, a copy of the was_requested flag of the bus cycle, so that optional waits
+			/// can be skipped without looking further...
+			bool was_requested;
+
+			/// ... and an index into the processor's @c bus_cycles_.
+			uint16_t bus_cycle;
+		};
+
+		/*!
+			A PartialMachineCycle with register indices in place of pointers.
+		*/
+		struct BusCycle {
+			uint8_t operation;
+			uint8_t length;
+			uint8_t address;
+			uint8_t value;
+			bool was_requested;
+
+			bool operator ==(const BusCycle &rhs) const {
+				return
+					operation == rhs.operation && length == rhs.length &&
+					address == rhs.address && value == rhs.value &&
+					was_requested == rhs.was_requested;
+			}
 		};
 
 		struct InstructionPage {
-			std::vector<MicroOp *> instructions;
+			std::vector<const MicroOp *> instructions;
 			std::vector<MicroOp> all_operations;
 			std::vector<MicroOp> fetch_decode_execute;
-			MicroOp *fetch_decode_execute_data;
+			const MicroOp *fetch_decode_execute_data;
 			uint8_t r_step;
 			bool is_indexed;
 
 			InstructionPage() : r_step(1), is_indexed(false) {}
 		};
 
-		typedef MicroOp InstructionTable[256][30];
+		/*!
+			The complete set of micro-programs. Instruction sets are built once per process — one for processors
+			that use the wait line, one for those that don't, since the latter omit all optional waits — and
+			are thereafter shared, read-only, by all instances. See @c shared_instruction_set.
+		*/
+		struct InstructionSet {
+			enum Page {
+				Base, ED, FD, DD, CB, FDCB, DDCB,
+				NumberOfPages
+			};
+			InstructionPage pages[NumberOfPages];
+
+			std::vector<MicroOp> conditional_call_untaken_program;
+			std::vector<MicroOp> reset_program;
+			std::vector<MicroOp> irq_program[3];
+			std::vector<MicroOp> nmi_program;
+
+			/// Every distinct bus cycle used above; there are few enough that each processor can keep
+			/// its own list of complete PartialMachineCycles, to hand to its bus handler without assembly.
+			std::vector<BusCycle> bus_cycles;
+
+			const bool uses_wait_line;
+
+			InstructionSet(ProcessorStorage &prototype, bool uses_wait_line);
+			InstructionSet(const InstructionSet &) = delete;
+			InstructionSet &operator =(const InstructionSet &) = delete;
+		};
 
 		ProcessorStorage();
-		void install_default_instruction_set();
+
+		/*!
+			Adopts the instruction set appropriate to a processor that does or does not use the wait line,
+			building it if this is the first processor to request it.
+		*/
+		void use_shared_instruction_set(bool uses_wait_line);
+
+		/// @returns A pointer to the 8-bit register with index @c index.
+		inline uint8_t *byte_register(uint8_t index) {
+			return reinterpret_cast<uint8_t *>(this) + index;
+		}
+
+		/// @returns A pointer to the 16-bit register with index @c index.
+		inline uint16_t *word_register(uint8_t index) {
+			return reinterpret_cast<uint16_t *>(reinterpret_cast<uint8_t *>(this) + index);
+		}
 
 		uint8_t a_;
 		RegisterPair bc_, de_, hl_;
@@ -152,20 +229,9 @@ class ProcessorStorage {
 
 		const MicroOp *scheduled_program_counter_ = nullptr;
 
-		std::vector<MicroOp> conditional_call_untaken_program_;
-		std::vector<MicroOp> reset_program_;
-		std::vector<MicroOp> irq_program_[3];
-		std::vector<MicroOp> nmi_program_;
-		InstructionPage *current_instruction_page_;
-
-		InstructionPage base_page_;
-		InstructionPage ed_page_;
-		InstructionPage fd_page_;
-		InstructionPage dd_page_;
-
-		InstructionPage cb_page_;
-		InstructionPage fdcb_page_;
-		InstructionPage ddcb_page_;
+		const InstructionSet *instruction_set_ = nullptr;
+		const InstructionPage *current_instruction_page_ = nullptr;
+		std::vector<PartialMachineCycle> bus_cycles_;
 
 		/*!
 			Gets the flags register.
@@ -203,12 +269,31 @@ class ProcessorStorage {
 			carry_result_			= flags;
 		}
 
-		virtual void assemble_page(InstructionPage &target, InstructionTable &table, bool add_offsets) = 0;
-		virtual void copy_program(const MicroOp *source, std::vector<MicroOp> &destination) = 0;
+	private:
+		/*!
+			A micro-op as described by the instruction tables, with operands given as pointers into the
+			instance that is building an instruction set; these are converted to register indices by @c encode.
+		*/
+		struct MicroOpDescription {
+			MicroOp::Type type;
+			void *source;
+			void *destination;
+			PartialMachineCycle machine_cycle;
+		};
+		typedef MicroOpDescription InstructionTable[256][30];
+
+		static const InstructionSet &shared_instruction_set(ProcessorStorage &prototype, bool uses_wait_line);
+
+		uint8_t register_index(const void *address);
+		MicroOp encode(InstructionSet &target, const MicroOpDescription &description);
+
+		void assemble_page(InstructionSet &set, InstructionPage &target, InstructionTable &table, bool add_offsets);
+		void copy_program(InstructionSet &set, const MicroOpDescription *source, std::vector<MicroOp> &destination);
 
-		void assemble_fetch_decode_execute(InstructionPage &target, int length);
-		void assemble_ed_page(InstructionPage &target);
-		void assemble_cb_page(InstructionPage &target, RegisterPair &index, bool add_offsets);
-		void assemble_base_page(InstructionPage &target, RegisterPair &index, bool add_offsets, InstructionPage &cb_page);
+		void assemble_instruction_set(InstructionSet &set);
+		void assemble_fetch_decode_execute(InstructionSet &set, InstructionPage &target, int length);
+		void assemble_ed_page(InstructionSet &set, InstructionPage &target);
+		void assemble_cb_page(InstructionSet &set, InstructionPage &target, RegisterPair &index, bool add_offsets);
+		void assemble_base_page(InstructionSet &set, InstructionPage &target, RegisterPair &index, bool add_offsets, InstructionPage &cb_page);
 
 };
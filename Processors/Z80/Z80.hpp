@@ -15,6 +15,7 @@
 
 #include "../RegisterSizes.hpp"
 #include "../../ClockReceiver/ClockReceiver.hpp"
+#include "../../Snapshot/Snapshot.hpp"
 
 namespace CPU {
 namespace Z80 {
@@ -125,7 +126,8 @@ struct PartialMachineCycle {
 	}
 
 	PartialMachineCycle(const PartialMachineCycle &rhs) noexcept;
-	PartialMachineCycle(Operation operation, HalfCycles length, uint16_t *address, uint8_t *value, bool was_requested) noexcept;
+	PartialMachineCycle(Operation operation, HalfCycles length, uint16_t *address, uint8_t *value, bool was_requested) noexcept :
+		operation(operation), length(length), address(address), value(value), was_requested(was_requested) {}
 	PartialMachineCycle() noexcept;
 };
 
@@ -223,6 +225,11 @@ class ProcessorBase: public ProcessorStorage {
 			reset at the first opportunity. Use @c reset_power_on to disable that behaviour.
 		*/
 		void reset_power_on();
+
+		/*!
+			Captures or restores the complete state of the processor, which may be mid-instruction, via @c archive.
+		*/
+		void serialise(Snapshot::Archive &archive);
 };
 
 /*!
@@ -270,9 +277,6 @@ template <class T, bool uses_bus_request, bool uses_wait_line> class Processor:
 
 	private:
 		T &bus_handler_;
-
-		void assemble_page(InstructionPage &target, InstructionTable &table, bool add_offsets);
-		void copy_program(const MicroOp *source, std::vector<MicroOp> &destination);
 };
 
 #include "Implementation/Z80Implementation.hpp"
@@ -46,7 +46,7 @@ float FIRFilter::ino(float a) {
 	return s;
 }
 
-void FIRFilter::coefficients_for_idealised_filter_response(short *filter_coefficients, float *A, float attenuation, std::size_t number_of_taps) {
+void FIRFilter::coefficients_for_idealised_filter_response(float *filter_coefficients, float *A, float attenuation, std::size_t number_of_taps) {
 	/* calculate alpha, which is the Kaiser-Bessel window shape factor */
 	float a;	// to take the place of alpha in the normal derivation
 
@@ -59,14 +59,12 @@ void FIRFilter::coefficients_for_idealised_filter_response(short *filter_coeffic
 			a = 0.5842f * powf(attenuation - 21.0f, 0.4f) + 0.7886f * (attenuation - 21.0f);
 	}
 
-	std::vector<float> filter_coefficients_float(number_of_taps);
-
 	/* work out the right hand side of the filter coefficients */
 	std::size_t Np = (number_of_taps - 1) / 2;
 	float I0 = ino(a);
 	float Np_squared = static_cast<float>(Np * Np);
 	for(unsigned int i = 0; i <= Np; ++i) {
-		filter_coefficients_float[Np + i] =
+		filter_coefficients[Np + i] =
 				A[i] *
 				ino(a * sqrtf(1.0f - (static_cast<float>(i * i) / Np_squared) )) /
 				I0;
@@ -74,19 +72,18 @@ void FIRFilter::coefficients_for_idealised_filter_response(short *filter_coeffic
 
 	/* coefficients are symmetrical, so copy from right hand side to left side */
 	for(std::size_t i = 0; i < Np; ++i) {
-		filter_coefficients_float[i] = filter_coefficients_float[number_of_taps - 1 - i];
+		filter_coefficients[i] = filter_coefficients[number_of_taps - 1 - i];
 	}
 
 	/* scale back up so that we retain 100% of input volume */
 	float coefficientTotal = 0.0f;
 	for(std::size_t i = 0; i < number_of_taps; ++i) {
-		coefficientTotal += filter_coefficients_float[i];
+		coefficientTotal += filter_coefficients[i];
 	}
 
-	/* we'll also need integer versions, potentially */
 	float coefficientMultiplier = 1.0f / coefficientTotal;
 	for(std::size_t i = 0; i < number_of_taps; ++i) {
-		filter_coefficients[i] = static_cast<short>(filter_coefficients_float[i] * FixedMultiplier * coefficientMultiplier);
+		filter_coefficients[i] *= coefficientMultiplier;
 	}
 }
 
@@ -107,8 +104,16 @@ FIRFilter::FIRFilter(std::size_t number_of_taps, float input_sample_rate, float
 	// ensure we have an odd number of taps
 	number_of_taps |= 1;
 
-	// store instance variables
+	// we'll need integer versions of the coefficients
+	const std::vector<float> coefficients = coefficients_for_band_pass(number_of_taps, input_sample_rate, low_frequency, high_frequency, attenuation);
 	filter_coefficients_.resize(number_of_taps);
+	for(std::size_t i = 0; i < number_of_taps; ++i) {
+		filter_coefficients_[i] = static_cast<short>(coefficients[i] * FixedMultiplier);
+	}
+}
+
+std::vector<float> FIRFilter::coefficients_for_band_pass(std::size_t number_of_taps, float input_sample_rate, float low_frequency, float high_frequency, float attenuation) {
+	std::vector<float> coefficients(number_of_taps);
 
 	/* calculate idealised filter response */
 	std::size_t Np = (number_of_taps - 1) / 2;
@@ -125,7 +130,8 @@ FIRFilter::FIRFilter(std::size_t number_of_taps, float input_sample_rate, float
 			) / i_pi;
 	}
 
-	FIRFilter::coefficients_for_idealised_filter_response(filter_coefficients_.data(), A.data(), attenuation, number_of_taps);
+	FIRFilter::coefficients_for_idealised_filter_response(coefficients.data(), A.data(), attenuation, number_of_taps);
+	return coefficients;
 }
 
 FIRFilter::FIRFilter(const std::vector<float> &coefficients) {
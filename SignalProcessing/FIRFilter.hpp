@@ -64,6 +64,12 @@ class FIRFilter {
 			#endif
 		}
 
+		/*!
+			@returns The coefficients of a Kaiser-Bessel windowed band-pass filter with the supplied parameters,
+			scaled so as to retain 100% of input volume. @c number_of_taps should be odd.
+		*/
+		static std::vector<float> coefficients_for_band_pass(std::size_t number_of_taps, float input_sample_rate, float low_frequency, float high_frequency, float attenuation);
+
 		/*! @returns The number of taps used by this filter. */
 		inline std::size_t get_number_of_taps() const {
 			return filter_coefficients_.size();
@@ -87,7 +93,7 @@ class FIRFilter {
 	private:
 		std::vector<short> filter_coefficients_;
 
-		static void coefficients_for_idealised_filter_response(short *filterCoefficients, float *A, float attenuation, std::size_t numberOfTaps);
+		static void coefficients_for_idealised_filter_response(float *filterCoefficients, float *A, float attenuation, std::size_t numberOfTaps);
 		static float ino(float a);
 };
 
@@ -0,0 +1,45 @@
+//
+//  PolyphaseFilter.cpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 22/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#include "PolyphaseFilter.hpp"
+#include "FIRFilter.hpp"
+
+using namespace SignalProcessing;
+
+PolyphaseFilter::PolyphaseFilter(std::size_t number_of_taps, std::size_t number_of_phases, float input_sample_rate, float high_frequency, float attenuation) :
+	number_of_taps_((number_of_taps + 15) & ~static_cast<std::size_t>(15)),
+	number_of_phases_(number_of_phases) {
+	if(!number_of_taps_) number_of_taps_ = 16;
+	if(attenuation < 21.0f) attenuation = 21.0f;
+
+	// Design a single filter at the sampling rate of the input signal if it were upsampled to the number of phases;
+	// it is given one more tap than will be used so as to be symmetrical around a single centre.
+	const std::vector<float> prototype = FIRFilter::coefficients_for_band_pass(
+		number_of_taps_ * number_of_phases_ + 1,
+		input_sample_rate * static_cast<float>(number_of_phases_),
+		0.0f, high_frequency, attenuation);
+
+	// Divide that up by phase. Upsampling would insert number_of_phases_-1 zeroes between each input sample;
+	// the samples that those zeroes would have eliminated from consideration are omitted in advance. Later
+	// taps apply to earlier samples, and later phases are later in time.
+	//
+	// Each phase is then normalised individually so that all retain 100% of input volume.
+	coefficients_.resize(number_of_taps_ * number_of_phases_);
+	for(std::size_t phase = 0; phase < number_of_phases_; ++phase) {
+		float total = 0.0f;
+		for(std::size_t tap = 0; tap < number_of_taps_; ++tap) {
+			total += prototype[(number_of_taps_ - 1 - tap) * number_of_phases_ + phase];
+		}
+
+		const float multiplier = FixedMultiplier / total;
+		short *coefficients = &coefficients_[phase * number_of_taps_];
+		for(std::size_t tap = 0; tap < number_of_taps_; ++tap) {
+			coefficients[tap] = static_cast<short>(prototype[(number_of_taps_ - 1 - tap) * number_of_phases_ + phase] * multiplier);
+		}
+	}
+}
@@ -0,0 +1,123 @@
+//
+//  PolyphaseFilter.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 22/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#ifndef PolyphaseFilter_hpp
+#define PolyphaseFilter_hpp
+
+#ifdef __APPLE__
+#include <Accelerate/Accelerate.h>
+#elif defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include <cstddef>
+#include <vector>
+
+namespace SignalProcessing {
+
+/*!
+	A polyphase filter resamples a 1d PCM signal to an arbitrary output rate, applying a low-pass filter
+	along the way; it may be used both to decimate and to interpolate.
+
+	It holds a single low-pass filter, designed as though for a signal at @c number_of_phases times the
+	input sample rate, and subdivided into one set of coefficients for each phase. So each output sample
+	is produced by applying the set of coefficients for the phase closest to its position between input
+	samples to the surrounding window of input.
+*/
+class PolyphaseFilter {
+	private:
+		static constexpr float FixedMultiplier = 32767.0f;
+		static constexpr int FixedShift = 15;
+
+	public:
+		/*!
+			Creates an instance of @c PolyphaseFilter.
+
+			@param number_of_taps The size of window of input data that contributes to each output sample;
+				this will be rounded up to a multiple of 16.
+			@param number_of_phases The number of distinct positions between input samples that output may
+				be sampled at; this must be a power of two.
+			@param input_sample_rate The sampling rate of the input signal.
+			@param high_frequency The highest frequency of signal to retain in the output.
+			@param attenuation The attenuation of the discarded frequencies.
+		*/
+		PolyphaseFilter(std::size_t number_of_taps, std::size_t number_of_phases, float input_sample_rate, float high_frequency, float attenuation);
+
+		/*!
+			Applies the filter to one window of input samples, returning the net result.
+
+			@param src The source buffer to apply the filter to; at least @c get_number_of_taps() samples must
+				be readable from it.
+			@param phase The position of the output sample between input samples, in the range
+				[0, number_of_phases).
+			@returns The result of applying the filter.
+		*/
+		inline short apply(const short *src, std::size_t phase) const {
+			const short *coefficients = &coefficients_[phase * number_of_taps_];
+
+			#ifdef __APPLE__
+				short result;
+				vDSP_dotpr_s1_15(coefficients, 1, src, 1, &result, number_of_taps_);
+				return result;
+			#elif defined(__AVX2__)
+				__m256i sum = _mm256_setzero_si256();
+				for(std::size_t c = 0; c < number_of_taps_; c += 16) {
+					sum = _mm256_add_epi32(sum, _mm256_madd_epi16(
+						_mm256_loadu_si256(reinterpret_cast<const __m256i *>(&src[c])),
+						_mm256_loadu_si256(reinterpret_cast<const __m256i *>(&coefficients[c]))));
+				}
+				__m128i quarter = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+				quarter = _mm_add_epi32(quarter, _mm_shuffle_epi32(quarter, _MM_SHUFFLE(1, 0, 3, 2)));
+				quarter = _mm_add_epi32(quarter, _mm_shuffle_epi32(quarter, _MM_SHUFFLE(2, 3, 0, 1)));
+				return static_cast<short>(_mm_cvtsi128_si32(quarter) >> FixedShift);
+			#elif defined(__SSE2__)
+				__m128i sum = _mm_setzero_si128();
+				for(std::size_t c = 0; c < number_of_taps_; c += 8) {
+					sum = _mm_add_epi32(sum, _mm_madd_epi16(
+						_mm_loadu_si128(reinterpret_cast<const __m128i *>(&src[c])),
+						_mm_loadu_si128(reinterpret_cast<const __m128i *>(&coefficients[c]))));
+				}
+				sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+				sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+				return static_cast<short>(_mm_cvtsi128_si32(sum) >> FixedShift);
+			#elif defined(__ARM_NEON)
+				int32x4_t sum = vdupq_n_s32(0);
+				for(std::size_t c = 0; c < number_of_taps_; c += 4) {
+					sum = vmlal_s16(sum, vld1_s16(&src[c]), vld1_s16(&coefficients[c]));
+				}
+				const int32x2_t half = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+				return static_cast<short>(vget_lane_s32(vpadd_s32(half, half), 0) >> FixedShift);
+			#else
+				int outputValue = 0;
+				for(std::size_t c = 0; c < number_of_taps_; ++c) {
+					outputValue += coefficients[c] * src[c];
+				}
+				return static_cast<short>(outputValue >> FixedShift);
+			#endif
+		}
+
+		/*! @returns The number of taps used by this filter; this is the number of input samples read by @c apply. */
+		inline std::size_t get_number_of_taps() const {
+			return number_of_taps_;
+		}
+
+		/*! @returns The number of phases into which this filter is divided. */
+		inline std::size_t get_number_of_phases() const {
+			return number_of_phases_;
+		}
+
+	private:
+		std::size_t number_of_taps_, number_of_phases_;
+		std::vector<short> coefficients_;
+};
+
+}
+
+#endif /* PolyphaseFilter_hpp */
@@ -0,0 +1,145 @@
+//
+//  Snapshot.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 26/11/2017.
+//  Copyright © 2017 Thomas Harte. All rights reserved.
+//
+
+#ifndef Snapshot_hpp
+#define Snapshot_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "../ClockReceiver/ClockReceiver.hpp"
+
+namespace Snapshot {
+
+/*!
+	An archive is a compact binary record of state. Each component that can be captured provides a single
+	method, `serialise(Snapshot::Archive &)`, which passes each item of its state to the archive in turn;
+	the same method both captures and restores, depending on whether the archive is being written or read,
+	so the two can't fall out of step.
+
+	Values are recorded in host byte order and without any description of their types, so an archive is
+	meaningful only to the build that produced it. That suits the intended use: forking a machine from a
+	point reached earlier in the same process, or by the same executable.
+*/
+class Archive {
+	public:
+		/// Creates an empty archive, ready to be written.
+		Archive() : is_reading_(false) {}
+
+		/// Creates an archive that reads from @c data, which must outlive it.
+		Archive(const std::vector<uint8_t> &data) : is_reading_(true), source_(&data) {}
+
+		/// @returns @c true if this archive is restoring state; @c false if it is capturing it.
+		bool is_reading() const {
+			return is_reading_;
+		}
+
+		/*!
+			@returns @c true if no read has gone beyond the end of the data, or found a value it couldn't accept;
+			@c false otherwise. Once invalid, an archive stays invalid and reads leave their targets untouched.
+		*/
+		bool is_valid() const {
+			return is_valid_;
+		}
+
+		/// @returns @c true if a reading archive has consumed all of its data.
+		bool is_at_end() const {
+			return !is_reading_ || read_offset_ == source_->size();
+		}
+
+		/// @returns The data captured so far by a writing archive.
+		std::vector<uint8_t> &get_data() {
+			return data_;
+		}
+
+		/// Transfers each of @c values, in order.
+		template <typename... T> void operator()(T &... values) {
+			transfer_all(values...);
+		}
+
+		/// Transfers @c length bytes at @c bytes.
+		void bytes(void *bytes, std::size_t length) {
+			if(is_reading_) {
+				if(!is_valid_ || source_->size() - read_offset_ < length) {
+					is_valid_ = false;
+					return;
+				}
+				std::memcpy(bytes, &(*source_)[read_offset_], length);
+				read_offset_ += length;
+			} else {
+				const uint8_t *const source = static_cast<const uint8_t *>(bytes);
+				data_.insert(data_.end(), source, source + length);
+			}
+		}
+
+		/*!
+			Marks the archive with @c tag, which a reading archive checks. Components use tags to make
+			it likely that a snapshot of one machine is rejected, rather than misapplied, by another.
+		*/
+		void tag(uint32_t tag) {
+			uint32_t value = tag;
+			transfer(value);
+			if(value != tag) is_valid_ = false;
+		}
+
+		/// Marks a reading archive as invalid, for use when a component finds a value it can't accept.
+		void set_invalid() {
+			is_valid_ = false;
+		}
+
+	private:
+		bool is_reading_;
+		bool is_valid_ = true;
+
+		std::vector<uint8_t> data_;
+		const std::vector<uint8_t> *source_ = nullptr;
+		std::size_t read_offset_ = 0;
+
+		void transfer_all() {}
+		template <typename T, typename... R> void transfer_all(T &value, R &... remainder) {
+			transfer(value);
+			transfer_all(remainder...);
+		}
+
+		template <typename T> void transfer(T &value) {
+			transfer(value, std::is_base_of<WrappedInt<T>, T>());
+		}
+
+		template <typename T> void transfer(T &value, std::false_type) {
+			static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be archived directly");
+			static_assert(!std::is_pointer<T>::value, "Pointers can't be archived");
+			bytes(&value, sizeof(T));
+		}
+
+		// Cycles and HalfCycles are recorded as the ints they wrap.
+		template <typename T> void transfer(T &value, std::true_type) {
+			int length = value.as_int();
+			transfer(length);
+			value = T(length);
+		}
+
+		template <typename T> void transfer(std::vector<T> &values) {
+			uint32_t size = static_cast<uint32_t>(values.size());
+			transfer(size);
+			if(is_reading_) {
+				if(!is_valid_ || (source_->size() - read_offset_) / sizeof(T) < size) {
+					is_valid_ = false;
+					return;
+				}
+				values.resize(size);
+			}
+			if(size) bytes(values.data(), sizeof(T) * size);
+		}
+};
+
+}
+
+#endif /* Snapshot_hpp */
@@ -113,3 +113,12 @@ void Controller::end_writing() {
 bool Controller::is_reading() {
 	return is_reading_;
 }
+
+void Controller::serialise(Snapshot::Archive &archive) {
+	Time bit_length = bit_length_;
+	archive(bit_length, is_reading_);
+	if(archive.is_reading() && archive.is_valid() && bit_length.clock_rate) {
+		set_expected_bit_length(bit_length);
+	}
+	pll_->serialise(archive);
+}
@@ -30,6 +30,12 @@ namespace Disk {
 	TODO: communication of head size and permissible stepping extents, appropriate simulation of gain.
 */
 class Controller: public DigitalPhaseLockedLoop::Delegate, public Drive::EventDelegate, public Sleeper, public Sleeper::SleepObserver {
+	public:
+		/*!
+			As per Sleeper.
+		*/
+		bool is_sleeping();
+
 	protected:
 		/*!
 			Constructs a @c Controller that will be run at @c clock_rate.
@@ -97,9 +103,10 @@ class Controller: public DigitalPhaseLockedLoop::Delegate, public Drive::EventDe
 		Drive &get_drive();
 
 		/*!
-			As per Sleeper.
+			Captures or restores the state of the PLL and whether the controller is writing. Drives are
+			not included; the owner of the drives should serialise them, and reselect the current one.
 		*/
-		bool is_sleeping();
+		void serialise(Snapshot::Archive &archive);
 
 	private:
 		Time bit_length_;
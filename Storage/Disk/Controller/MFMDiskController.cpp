@@ -167,3 +167,12 @@ void MFMController::write_start_of_track() {
 		write_n_bytes(26, 0xff);
 	}
 }
+
+void MFMController::serialise(Snapshot::Archive &archive) {
+	Controller::serialise(archive);
+	shifter_.serialise(archive);
+
+	uint16_t crc = crc_generator_.get_value();
+	archive(latest_token_, is_double_density_, data_mode_, last_bit_, crc);
+	crc_generator_.set_value(crc);
+}
@@ -74,6 +74,9 @@ class MFMController: public Controller {
 		/// @returns The controller's CRC generator. This is automatically fed during reading.
 		NumberTheory::CRC16 &get_crc_generator();
 
+		/// Extends Controller::serialise with the state of the shift register and decoder.
+		void serialise(Snapshot::Archive &archive);
+
 		// Events
 		enum class Event: int {
 			Token			= (1 << 0),	// Indicates recognition of a new token in the flux stream. Use get_latest_token() for more details.
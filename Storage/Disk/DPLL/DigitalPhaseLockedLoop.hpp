@@ -13,6 +13,7 @@
 #include <vector>
 
 #include "../../../ClockReceiver/ClockReceiver.hpp"
+#include "../../../Snapshot/Snapshot.hpp"
 
 namespace Storage {
 
@@ -49,6 +50,12 @@ class DigitalPhaseLockedLoop {
 			delegate_ = delegate;
 		}
 
+		/// Captures or restores the loop's phase and history.
+		void serialise(Snapshot::Archive &archive) {
+			archive(offset_history_, offset_history_pointer_, offset_, phase_, window_length_, window_was_filled_);
+			archive(clocks_per_bit_, tolerance_);
+		}
+
 	private:
 		Delegate *delegate_ = nullptr;
 
@@ -18,7 +18,7 @@
 using namespace Storage::Disk;
 
 D64::D64(const char *file_name) :
-		file_(file_name) {
+		file_(file_name, FileHolder::FileMode::Read) {
 	// in D64, this is it for validation without imposing potential false-negative tests — check that
 	// the file size appears to be correct. Stone-age stuff.
 	if(file_.stats().st_size != 174848 && file_.stats().st_size != 196608)
@@ -152,6 +152,12 @@ void Drive::get_next_event(const Time &duration_already_passed) {
 
 	if(track_) {
 		current_event_ = track_->get_next_event();
+		if(current_event_.type == Track::Event::IndexHole) {
+			seek_time_.set_zero();
+			events_since_seek_ = 0;
+		} else {
+			++events_since_seek_;
+		}
 	} else {
 		current_event_.length.length = 1;
 		current_event_.length.clock_rate = 1;
@@ -204,6 +210,8 @@ void Drive::setup_track() {
 
 	Time time_found = track_->seek_to(track_time_now);
 	assert(time_found >= Time(0) && time_found < Time(1) && time_found <= track_time_now);
+	seek_time_ = track_time_now;
+	events_since_seek_ = 0;
 
 	offset = track_time_now - time_found;
 	get_next_event(offset);
@@ -217,6 +225,34 @@ void Drive::invalidate_track() {
 	}
 }
 
+// MARK: - Snapshots
+
+void Drive::serialise(Snapshot::Archive &archive) {
+	archive.tag(0x64726976);
+	TimedEventLoop::serialise(archive);
+
+	archive(cycles_since_index_hole_, head_position_, head_, motor_is_on_, ready_index_count_, current_event_);
+	archive(is_reading_, clamp_writing_to_index_hole_, write_start_time_, cycles_until_bits_written_, cycles_per_bit_);
+	archive(write_segment_.length_of_a_bit, write_segment_.number_of_bits, write_segment_.data);
+
+	bool has_track = !!track_;
+	archive(has_track, seek_time_, events_since_seek_);
+
+	if(archive.is_reading()) {
+		// Any writes previously made to the current track by this drive belong to the disk that is
+		// inserted, so are kept. Then reacquire the track, if there was one, and replay its events
+		// up to the current position.
+		invalidate_track();
+		if(has_track) {
+			track_ = get_track();
+			if(!track_) track_.reset(new UnformattedTrack);
+			track_->seek_to(seek_time_);
+			for(int c = 0; c < events_since_seek_; ++c) track_->get_next_event();
+		}
+		update_sleep_observer();
+	}
+}
+
 // MARK: - Writing
 
 void Drive::begin_writing(Time bit_length, bool clamp_to_index_hole) {
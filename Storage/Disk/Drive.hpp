@@ -122,6 +122,13 @@ class Drive: public Sleeper, public TimedEventLoop {
 		// As per Sleeper.
 		bool is_sleeping();
 
+		/*!
+			Captures or restores the position of the head and the disk, and any write in progress. The disk's
+			contents are not captured; upon restoration the current track is reacquired from the disk and
+			returned to the same position.
+		*/
+		void serialise(Snapshot::Archive &archive);
+
 	private:
 		// Drives contain an entire disk; from that a certain track
 		// will be currently under the head.
@@ -171,6 +178,12 @@ class Drive: public Sleeper, public TimedEventLoop {
 		void advance(const Cycles cycles);
 		Track::Event current_event_;
 
+		// The position within track_, as the time it was last sought to plus the number of events
+		// since; that's enough to return a reacquired track to the same position exactly. An index
+		// hole returns the track to its start, which is treated as a seek to time zero.
+		Time seek_time_;
+		int events_since_seek_ = 0;
+
 		// Helper for track changes.
 		Time get_time_into_track();
 
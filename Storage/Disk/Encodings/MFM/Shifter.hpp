@@ -12,6 +12,7 @@
 #include <cstdint>
 #include <memory>
 #include "../../../../NumberTheory/CRC.hpp"
+#include "../../../../Snapshot/Snapshot.hpp"
 
 namespace Storage {
 namespace Encodings {
@@ -37,6 +38,16 @@ class Shifter {
 			return *crc_generator_;
 		}
 
+		/// Captures or restores the shifter's input state, and the value of its CRC generator if it owns that.
+		void serialise(Snapshot::Archive &archive) {
+			archive(bits_since_token_, shift_register_, is_awaiting_marker_value_, should_obey_syncs_, token_, is_double_density_);
+			if(owned_crc_generator_) {
+				uint16_t crc = owned_crc_generator_->get_value();
+				archive(crc);
+				owned_crc_generator_->set_value(crc);
+			}
+		}
+
 	private:
 		// Bit stream input state
 		int bits_since_token_ = 0;
@@ -8,13 +8,18 @@
 
 #include "FileHolder.hpp"
 
+#include <sys/mman.h>
 #include <algorithm>
 #include <cstring>
 
 using namespace Storage;
 
 FileHolder::~FileHolder() {
-	if(file_) std::fclose(file_);
+	if(mapped_data_) munmap(const_cast<uint8_t *>(mapped_data_), mapped_size_);
+	if(file_) {
+		flush_write_buffer();
+		std::fclose(file_);
+	}
 }
 
 FileHolder::FileHolder(const std::string &file_name, FileMode ideal_mode)
@@ -22,6 +27,7 @@ FileHolder::FileHolder(const std::string &file_name, FileMode ideal_mode)
 	stat(file_name.c_str(), &file_stats_);
 	is_read_only_ = false;
 
+	bool is_reading_only = false;
 	switch(ideal_mode) {
 		case FileMode::ReadWrite:
 			file_ = std::fopen(file_name.c_str(), "rb+");
@@ -31,6 +37,7 @@ FileHolder::FileHolder(const std::string &file_name, FileMode ideal_mode)
 		// deliberate fallthrough...
 		case FileMode::Read:
 			file_ = std::fopen(file_name.c_str(), "rb");
+			is_reading_only = true;
 		break;
 
 		case FileMode::Rewrite:
@@ -39,114 +46,182 @@ FileHolder::FileHolder(const std::string &file_name, FileMode ideal_mode)
 	}
 
 	if(!file_) throw ErrorCantOpen;
+
+	// A file that can't change can be mapped into memory; if that fails then accesses will just go via file_.
+	if(is_reading_only && file_stats_.st_size > 0) {
+		void *const mapping = mmap(nullptr, static_cast<std::size_t>(file_stats_.st_size), PROT_READ, MAP_PRIVATE, fileno(file_), 0);
+		if(mapping != MAP_FAILED) {
+			mapped_data_ = static_cast<const uint8_t *>(mapping);
+			mapped_size_ = static_cast<std::size_t>(file_stats_.st_size);
+		}
+	}
 }
 
-uint32_t FileHolder::get32le() {
-    uint32_t result = (uint32_t)std::fgetc(file_);
-    result |= (uint32_t)(std::fgetc(file_) << 8);
-    result |= (uint32_t)(std::fgetc(file_) << 16);
-    result |= (uint32_t)(std::fgetc(file_) << 24);
+// MARK: - Reading
+
+template <bool is_little_endian> uint32_t FileHolder::get_integer(std::size_t size) {
+	// Bytes beyond the end of the file read as 0xff, as per fgetc's EOF.
+	uint8_t bytes[4];
+	std::size_t bytes_read = read(bytes, size);
+	std::fill(bytes + bytes_read, bytes + size, 0xff);
+
+	uint32_t result = 0;
+	for(std::size_t c = 0; c < size; ++c) {
+		result = (result << 8) | bytes[is_little_endian ? size - 1 - c : c];
+	}
+	return result;
+}
 
-    return result;
+uint32_t FileHolder::get32le() {
+	return get_integer<true>(4);
 }
 
 uint32_t FileHolder::get32be() {
-    uint32_t result = (uint32_t)(std::fgetc(file_) << 24);
-    result |= (uint32_t)(std::fgetc(file_) << 16);
-    result |= (uint32_t)(std::fgetc(file_) << 8);
-    result |= (uint32_t)std::fgetc(file_);
-
-    return result;
+	return get_integer<false>(4);
 }
 
 uint32_t FileHolder::get24le() {
-    uint32_t result = (uint32_t)std::fgetc(file_);
-    result |= (uint32_t)(std::fgetc(file_) << 8);
-    result |= (uint32_t)(std::fgetc(file_) << 16);
-
-    return result;
+	return get_integer<true>(3);
 }
 
 uint32_t FileHolder::get24be() {
-    uint32_t result = (uint32_t)(std::fgetc(file_) << 16);
-    result |= (uint32_t)(std::fgetc(file_) << 8);
-    result |= (uint32_t)std::fgetc(file_);
-
-    return result;
+	return get_integer<false>(3);
 }
 
 uint16_t FileHolder::get16le() {
-    uint16_t result = static_cast<uint16_t>(std::fgetc(file_));
-    result |= static_cast<uint16_t>(std::fgetc(file_) << 8);
-
-    return result;
+	return static_cast<uint16_t>(get_integer<true>(2));
 }
 
 uint16_t FileHolder::get16be() {
-    uint16_t result = static_cast<uint16_t>(std::fgetc(file_) << 8);
-    result |= static_cast<uint16_t>(std::fgetc(file_));
-
-    return result;
+	return static_cast<uint16_t>(get_integer<false>(2));
 }
 
 uint8_t FileHolder::get8() {
-    return static_cast<uint8_t>(std::fgetc(file_));
+	if(mapped_data_) {
+		if(mapped_position_ < mapped_size_) return mapped_data_[mapped_position_++];
+		mapped_eof_ = true;
+		return 0xff;
+	}
+
+	flush_write_buffer();
+	return static_cast<uint8_t>(std::fgetc(file_));
 }
 
-void FileHolder::put16be(uint16_t value) {
-	std::fputc(value >> 8, file_);
-	std::fputc(value, file_);
+std::vector<uint8_t> FileHolder::read(std::size_t size) {
+	std::vector<uint8_t> result(size);
+	result.resize(read(result.data(), size));
+	return result;
 }
 
-void FileHolder::put16le(uint16_t value) {
-	std::fputc(value, file_);
-	std::fputc(value >> 8, file_);
+std::size_t FileHolder::read(uint8_t *buffer, std::size_t size) {
+	if(mapped_data_) {
+		const std::size_t available = (mapped_position_ < mapped_size_) ? mapped_size_ - mapped_position_ : 0;
+		const std::size_t length = std::min(size, available);
+		std::memcpy(buffer, &mapped_data_[mapped_position_], length);
+		mapped_position_ += length;
+		if(length < size) mapped_eof_ = true;
+		return length;
+	}
+
+	flush_write_buffer();
+	return std::fread(buffer, 1, size, file_);
 }
 
-void FileHolder::put8(uint8_t value) {
-	std::fputc(value, file_);
+// MARK: - Writing
+
+void FileHolder::flush_write_buffer() {
+	if(write_buffer_.empty()) return;
+	std::fwrite(write_buffer_.data(), 1, write_buffer_.size(), file_);
+	write_buffer_.clear();
 }
 
-void FileHolder::putn(std::size_t repeats, uint8_t value) {
-	while(repeats--) put8(value);
+void FileHolder::put16be(uint16_t value) {
+	put8(static_cast<uint8_t>(value >> 8));
+	put8(static_cast<uint8_t>(value));
 }
 
-std::vector<uint8_t> FileHolder::read(std::size_t size) {
-	std::vector<uint8_t> result(size);
-	result.resize(std::fread(result.data(), 1, size, file_));
-	return result;
+void FileHolder::put16le(uint16_t value) {
+	put8(static_cast<uint8_t>(value));
+	put8(static_cast<uint8_t>(value >> 8));
 }
 
-std::size_t FileHolder::read(uint8_t *buffer, std::size_t size) {
-    return std::fread(buffer, 1, size, file_);
+void FileHolder::put8(uint8_t value) {
+	if(mapped_data_) return;
+	write_buffer_.push_back(value);
+	if(write_buffer_.size() >= 4096) flush_write_buffer();
+}
+
+void FileHolder::putn(std::size_t repeats, uint8_t value) {
+	if(mapped_data_) return;
+	write_buffer_.insert(write_buffer_.end(), repeats, value);
+	if(write_buffer_.size() >= 4096) flush_write_buffer();
 }
 
 std::size_t FileHolder::write(const std::vector<uint8_t> &buffer) {
-	return std::fwrite(buffer.data(), 1, buffer.size(), file_);
+	return write(buffer.data(), buffer.size());
 }
 
 std::size_t FileHolder::write(const uint8_t *buffer, std::size_t size) {
-    return std::fwrite(buffer, 1, size, file_);
+	if(mapped_data_) return 0;
+	flush_write_buffer();
+	return std::fwrite(buffer, 1, size, file_);
 }
 
+// MARK: - Positioning
+
 void FileHolder::seek(long offset, int whence) {
+	if(mapped_data_) {
+		long base = 0;
+		switch(whence) {
+			default:		base = 0;											break;
+			case SEEK_CUR:	base = static_cast<long>(mapped_position_);			break;
+			case SEEK_END:	base = static_cast<long>(mapped_size_);				break;
+		}
+		if(base + offset < 0) return;
+		mapped_position_ = static_cast<std::size_t>(base + offset);
+		mapped_eof_ = false;
+		return;
+	}
+
+	flush_write_buffer();
 	std::fseek(file_, offset, whence);
 }
 
 long FileHolder::tell() {
+	if(mapped_data_) return static_cast<long>(mapped_position_);
+
+	flush_write_buffer();
 	return std::ftell(file_);
 }
 
 void FileHolder::flush() {
+	if(mapped_data_) return;
+
+	flush_write_buffer();
 	std::fflush(file_);
 }
 
 bool FileHolder::eof() {
+	if(mapped_data_) return mapped_eof_;
+
+	flush_write_buffer();
 	return std::feof(file_);
 }
 
+void FileHolder::serialise_position(Snapshot::Archive &archive) {
+	long position = tell();
+	bool is_at_end = eof();
+	archive(position, is_at_end);
+	if(archive.is_reading() && archive.is_valid()) {
+		seek(position, SEEK_SET);
+
+		// Seeking clears the end-of-file indicator; attempting to read beyond the end is the only way to set it again.
+		if(is_at_end) get8();
+	}
+}
+
 FileHolder::BitStream FileHolder::get_bitstream(bool lsb_first) {
-	return BitStream(file_, lsb_first);
+	return BitStream(*this, lsb_first);
 }
 
 bool FileHolder::check_signature(const char *signature, std::size_t length) {
@@ -170,6 +245,8 @@ std::string FileHolder::extension() {
 }
 
 void FileHolder::ensure_is_at_least_length(long length) {
+    if(mapped_data_) return;
+    flush_write_buffer();
     std::fseek(file_, 0, SEEK_END);
     long bytes_to_write = length - ftell(file_);
     if(bytes_to_write > 0) {
@@ -16,8 +16,18 @@
 #include <string>
 #include <vector>
 
+#include "../Snapshot/Snapshot.hpp"
+
 namespace Storage {
 
+/*!
+	Provides access to a file, with helpers for reading and writing the integer encodings and bit streams
+	that disk and tape images use.
+
+	Files opened only for reading are mapped into memory, so that reads are satisfied without any library
+	calls. Other files are accessed via the C library, with the output of put8, put16le, put16be and putn
+	being collected and written in bulk.
+*/
 class FileHolder final {
 	public:
 		enum {
@@ -125,6 +135,12 @@ class FileHolder final {
 		/*! @returns @c true if the end-of-file indicator is set, @c false otherwise. */
 		bool eof();
 
+		/*!
+			Captures or restores the cursor position and the end-of-file indicator via @c archive, so that
+			reads can resume exactly as they would have from the point of capture.
+		*/
+		void serialise_position(Snapshot::Archive &archive);
+
 		class BitStream {
 			public:
 				uint8_t get_bits(int q) {
@@ -136,14 +152,14 @@ class FileHolder final {
 				}
 
 			private:
-				BitStream(FILE *file, bool lsb_first) :
+				BitStream(FileHolder &file, bool lsb_first) :
 					file_(file),
 					lsb_first_(lsb_first),
 					next_value_(0),
 					bits_remaining_(0) {}
 				friend FileHolder;
 
-				FILE *file_;
+				FileHolder &file_;
 				bool lsb_first_;
 				uint8_t next_value_;
 				int bits_remaining_;
@@ -151,7 +167,7 @@ class FileHolder final {
 				uint8_t get_bit() {
 					if(!bits_remaining_) {
 						bits_remaining_ = 8;
-						next_value_ = static_cast<uint8_t>(fgetc(file_));
+						next_value_ = file_.get8();
 					}
 
 					uint8_t bit;
@@ -218,6 +234,18 @@ class FileHolder final {
 		bool is_read_only_ = false;
 
 		std::mutex file_access_mutex_;
+
+		// The file's contents if it has been mapped into memory, and the cursor and end-of-file indicator that then apply.
+		const uint8_t *mapped_data_ = nullptr;
+		std::size_t mapped_size_ = 0;
+		std::size_t mapped_position_ = 0;
+		bool mapped_eof_ = false;
+
+		// Output that has yet to be written to file_.
+		std::vector<uint8_t> write_buffer_;
+		void flush_write_buffer();
+
+		template <bool is_little_endian> uint32_t get_integer(std::size_t size);
 };
 
 }
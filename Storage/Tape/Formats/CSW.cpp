@@ -8,13 +8,23 @@
 
 #include "CSW.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
 
 using namespace Storage::Tape;
 
+namespace {
+	// The size of deflate's window, which is also used as the size of the source buffer.
+	const std::size_t window_size = 32768;
+
+	// The approximate amount of output between ZRLE access points.
+	const uint64_t access_point_spacing = 1024 * 1024;
+}
+
 CSW::CSW(const char *file_name) :
-	file_(file_name),
-	source_data_pointer_(0) {
+	file_(file_name, FileHolder::FileMode::Read),
+	buffer_(window_size) {
 	if(file_.stats().st_size < 0x20) throw ErrorNotCSW;
 
 	// Check signature.
@@ -33,7 +43,6 @@ CSW::CSW(const char *file_name) :
 	if(major_version > 2 || !major_version || minor_version > 1) throw ErrorNotCSW;
 
 	// The header now diverges based on version.
-	uint32_t number_of_waves = 0;
 	if(major_version == 1) {
 		pulse_.length.clock_rate = file_.get16le();
 
@@ -45,7 +54,7 @@ CSW::CSW(const char *file_name) :
 		file_.seek(0x20, SEEK_SET);
 	} else {
 		pulse_.length.clock_rate = file_.get32le();
-		number_of_waves = file_.get32le();
+		file_.get32le();	// The number of waves, which isn't needed.
 		switch(file_.get8()) {
 			case 1: compression_type_ = CompressionType::RLE;	break;
 			case 2: compression_type_ = CompressionType::ZRLE;	break;
@@ -59,82 +68,160 @@ CSW::CSW(const char *file_name) :
 		file_.seek(0x34 + extension_length, SEEK_SET);
 	}
 
+	data_start_ = file_.tell();
 	if(compression_type_ == CompressionType::ZRLE) {
-		// The only clue given by CSW as to the output size in bytes is that there will be
-		// number_of_waves waves. Waves are usually one byte, but may be five. So this code
-		// is pessimistic.
-		source_data_.resize(static_cast<std::size_t>(number_of_waves) * 5);
-
-		std::vector<uint8_t> file_data;
-		std::size_t remaining_data = static_cast<std::size_t>(file_.stats().st_size) - static_cast<std::size_t>(file_.tell());
-		file_data.resize(remaining_data);
-		file_.read(file_data.data(), remaining_data);
-
-		// uncompress will tell how many compressed bytes there actually were, so use its
-		// modification of output_length to throw away all the memory that isn't actually
-		// needed.
-		uLongf output_length = static_cast<uLongf>(number_of_waves * 5);
-		uncompress(source_data_.data(), &output_length, file_data.data(), file_data.size());
-		source_data_.resize(static_cast<std::size_t>(output_length));
-	} else {
-		rle_start_ = file_.tell();
+		compressed_data_.resize(16384);
+		if(inflateInit(&inflate_stream_) != Z_OK) throw ErrorNotCSW;
 	}
 
 	invert_pulse();
+	initial_pulse_type_ = pulse_.type;
 }
 
+CSW::~CSW() {
+	if(compression_type_ == CompressionType::ZRLE) inflateEnd(&inflate_stream_);
+}
+
+// MARK: - Source data
+
 uint8_t CSW::get_next_byte() {
+	if(buffer_read_pointer_ == buffer_end_ && !fill_buffer()) return 0xff;
+	++source_offset_;
+	return buffer_[buffer_read_pointer_++];
+}
+
+uint32_t CSW::get_next_int32le() {
+	uint32_t result = get_next_byte();
+	result |= static_cast<uint32_t>(get_next_byte()) << 8;
+	result |= static_cast<uint32_t>(get_next_byte()) << 16;
+	result |= static_cast<uint32_t>(get_next_byte()) << 24;
+	return result;
+}
+
+bool CSW::fill_buffer() {
 	switch(compression_type_) {
-		case CompressionType::RLE: return file_.get8();
-		case CompressionType::ZRLE: {
-			if(source_data_pointer_ == source_data_.size()) return 0xff;
-			uint8_t result = source_data_[source_data_pointer_];
-			source_data_pointer_++;
-			return result;
-		}
+		case CompressionType::RLE:
+			buffer_read_pointer_ = 0;
+			buffer_end_ = file_.read(buffer_.data(), buffer_.size());
+		break;
+
+		case CompressionType::ZRLE:
+			if(buffer_end_ == buffer_.size()) buffer_end_ = 0;
+			buffer_read_pointer_ = buffer_end_;
+
+			inflate_stream_.next_out = &buffer_[buffer_end_];
+			inflate_stream_.avail_out = static_cast<uInt>(buffer_.size() - buffer_end_);
+			while(inflate_stream_.avail_out && !is_inflated_) {
+				if(!inflate_stream_.avail_in) {
+					inflate_stream_.next_in = compressed_data_.data();
+					inflate_stream_.avail_in = static_cast<uInt>(file_.read(compressed_data_.data(), compressed_data_.size()));
+					compressed_data_end_ = file_.tell();
+				}
+
+				// Inflate a block at a time, in order to spot the boundaries between them; access points
+				// can be recorded only at block boundaries.
+				const uInt prior_avail_out = inflate_stream_.avail_out;
+				const int result = inflate(&inflate_stream_, Z_BLOCK);
+				inflated_length_ += prior_avail_out - inflate_stream_.avail_out;
+
+				if(result != Z_OK) {
+					// Z_STREAM_END is the proper end of the data; anything else means that it was truncated or corrupt.
+					is_inflated_ = true;
+					break;
+				}
+
+				if(
+					(inflate_stream_.data_type & 128) && !(inflate_stream_.data_type & 64) &&
+					inflated_length_ >= (access_points_.empty() ? 0 : access_points_.back().output_offset) + access_point_spacing
+				) {
+					add_access_point();
+				}
+			}
+			buffer_end_ = buffer_.size() - inflate_stream_.avail_out;
+		break;
 
 		default: assert(false);	break;
 	}
+
+	return buffer_read_pointer_ != buffer_end_;
 }
 
-uint32_t CSW::get_next_int32le() {
+void CSW::add_access_point() {
+	AccessPoint point;
+	point.output_offset = inflated_length_;
+	point.input_offset = compressed_data_end_ - static_cast<long>(inflate_stream_.avail_in);
+	point.bits = inflate_stream_.data_type & 7;
+
+	// The window is the most recent window_size bytes of output; the buffer is circular so
+	// those begin at the current output position.
+	const std::size_t output_position = buffer_.size() - inflate_stream_.avail_out;
+	point.window.reserve(window_size);
+	point.window.insert(point.window.end(), buffer_.begin() + static_cast<std::ptrdiff_t>(output_position), buffer_.end());
+	point.window.insert(point.window.end(), buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(output_position));
+
+	access_points_.push_back(std::move(point));
+}
+
+void CSW::seek_source(uint64_t offset) {
 	switch(compression_type_) {
-		case CompressionType::RLE: return file_.get32le();
+		case CompressionType::RLE:
+			file_.seek(data_start_ + static_cast<long>(offset), SEEK_SET);
+			buffer_read_pointer_ = buffer_end_ = 0;
+			source_offset_ = offset;
+		break;
+
 		case CompressionType::ZRLE: {
-			if(source_data_pointer_ > source_data_.size() - 4) return 0xffff;
-			uint32_t result = (uint32_t)(
-				(source_data_[source_data_pointer_ + 0] << 0) |
-				(source_data_[source_data_pointer_ + 1] << 8) |
-				(source_data_[source_data_pointer_ + 2] << 16) |
-				(source_data_[source_data_pointer_ + 3] << 24));
-			source_data_pointer_ += 4;
-			return result;
-		}
+			// Restart inflation from the latest access point at or before the target, if there's one
+			// between here and there or the target is behind; otherwise just proceed from here.
+			const auto next_point = std::upper_bound(access_points_.begin(), access_points_.end(), offset, [] (uint64_t offset, const AccessPoint &point) {
+				return offset < point.output_offset;
+			});
+			const uint64_t restart_offset = (next_point == access_points_.begin()) ? 0 : std::prev(next_point)->output_offset;
+
+			if(offset < source_offset_ || restart_offset > source_offset_) {
+				if(next_point == access_points_.begin()) {
+					inflateReset2(&inflate_stream_, 15);
+					file_.seek(data_start_, SEEK_SET);
+				} else {
+					// Access points are within the deflate stream, so don't expect a zlib header.
+					const AccessPoint &point = *std::prev(next_point);
+					inflateReset2(&inflate_stream_, -15);
+					file_.seek(point.input_offset - (point.bits ? 1 : 0), SEEK_SET);
+					if(point.bits) inflatePrime(&inflate_stream_, point.bits, file_.get8() >> (8 - point.bits));
+					inflateSetDictionary(&inflate_stream_, point.window.data(), static_cast<uInt>(point.window.size()));
+				}
+
+				inflate_stream_.avail_in = 0;
+				is_inflated_ = false;
+				inflated_length_ = source_offset_ = restart_offset;
+				buffer_read_pointer_ = buffer_end_ = 0;
+			}
+
+			while(source_offset_ < offset) {
+				if(buffer_read_pointer_ == buffer_end_ && !fill_buffer()) break;
+				const std::size_t step = static_cast<std::size_t>(std::min(static_cast<uint64_t>(buffer_end_ - buffer_read_pointer_), offset - source_offset_));
+				buffer_read_pointer_ += step;
+				source_offset_ += step;
+			}
+		} break;
 
 		default: assert(false);	break;
 	}
 }
 
+// MARK: - Tape
+
 void CSW::invert_pulse() {
 	pulse_.type = (pulse_.type == Pulse::High) ? Pulse::Low : Pulse::High;
 }
 
 bool CSW::is_at_end() {
-	switch(compression_type_) {
-		case CompressionType::RLE: return file_.eof();
-		case CompressionType::ZRLE: return source_data_pointer_ == source_data_.size();
-
-		default: assert(false);	break;
-	}
+	return buffer_read_pointer_ == buffer_end_ && !fill_buffer();
 }
 
 void CSW::virtual_reset() {
-	switch(compression_type_) {
-		case CompressionType::RLE:	file_.seek(rle_start_, SEEK_SET);	break;
-		case CompressionType::ZRLE:	source_data_pointer_ = 0;			break;
-
-		default: assert(false);	break;
-	}
+	pulse_.type = initial_pulse_type_;
+	seek_source(0);
 }
 
 Tape::Pulse CSW::virtual_get_next_pulse() {
@@ -143,3 +230,9 @@ Tape::Pulse CSW::virtual_get_next_pulse() {
 	if(!pulse_.length.length) pulse_.length.length = get_next_int32le();
 	return pulse_;
 }
+
+void CSW::serialise_position(Snapshot::Archive &archive) {
+	uint64_t source_offset = source_offset_;
+	archive(pulse_, source_offset);
+	if(archive.is_reading() && archive.is_valid()) seek_source(source_offset);
+}
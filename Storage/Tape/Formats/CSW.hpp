@@ -20,6 +20,10 @@ namespace Tape {
 
 /*!
 	Provides a @c Tape containing a CSW tape image, which is a compressed 1-bit sampling.
+
+	The file is streamed through fixed-size buffers, so memory use doesn't depend on the length of the
+	recording. ZRLE files are inflated on demand; access points are recorded at intervals as inflation
+	proceeds, allowing it to resume from near any position without starting again from the beginning.
 */
 class CSW: public Tape {
 	public:
@@ -29,6 +33,7 @@ class CSW: public Tape {
 			@throws ErrorNotCSW if this file could not be opened and recognised as a valid CSW file.
 		*/
 		CSW(const char *file_name);
+		~CSW();
 
 		enum {
 			ErrorNotCSW
@@ -42,8 +47,10 @@ class CSW: public Tape {
 
 		void virtual_reset();
 		Pulse virtual_get_next_pulse();
+		void serialise_position(Snapshot::Archive &archive) override;
 
 		Pulse pulse_;
+		Pulse::Type initial_pulse_type_;
 		enum class CompressionType {
 			RLE,
 			ZRLE
@@ -53,10 +60,31 @@ class CSW: public Tape {
 		uint32_t get_next_int32le();
 		void invert_pulse();
 
-		std::vector<uint8_t> source_data_;
-		std::size_t source_data_pointer_;
-
-		long rle_start_;
+		// The RLE stream, after inflation if necessary, is read via buffer_. For ZRLE files the buffer
+		// is used circularly, and so always holds the most recent output of inflation.
+		std::vector<uint8_t> buffer_;
+		std::size_t buffer_read_pointer_ = 0, buffer_end_ = 0;
+		uint64_t source_offset_ = 0;
+		long data_start_;
+
+		bool fill_buffer();
+		void seek_source(uint64_t offset);
+
+		// ZRLE inflation state.
+		z_stream inflate_stream_{};
+		std::vector<uint8_t> compressed_data_;
+		long compressed_data_end_ = 0;
+		uint64_t inflated_length_ = 0;
+		bool is_inflated_ = false;
+
+		struct AccessPoint {
+			uint64_t output_offset;			// The amount of output preceding this point.
+			long input_offset;				// The file offset of the first byte not yet completely consumed.
+			int bits;						// The number of bits of the preceding byte that are yet to be consumed.
+			std::vector<uint8_t> window;	// The output immediately preceding this point.
+		};
+		std::vector<AccessPoint> access_points_;
+		void add_access_point();
 };
 
 }
@@ -13,7 +13,7 @@
 using namespace Storage::Tape;
 
 CommodoreTAP::CommodoreTAP(const char *file_name) :
-	file_(file_name)
+	file_(file_name, FileHolder::FileMode::Read)
 {
 	if(!file_.check_signature("C64-TAPE-RAW"))
 		throw ErrorNotCommodoreTAP;
@@ -89,3 +89,9 @@ Storage::Tape::Tape::Pulse CommodoreTAP::virtual_get_next_pulse()
 
 	return current_pulse_;
 }
+
+void CommodoreTAP::serialise_position(Snapshot::Archive &archive)
+{
+	file_.serialise_position(archive);
+	archive(current_pulse_, is_at_end_);
+}
@@ -39,6 +39,7 @@ class CommodoreTAP: public Tape {
 		Storage::FileHolder file_;
 		void virtual_reset();
 		Pulse virtual_get_next_pulse();
+		void serialise_position(Snapshot::Archive &archive) override;
 
 		bool updated_layout_;
 		uint32_t file_size_;
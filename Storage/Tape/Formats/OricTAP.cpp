@@ -13,7 +13,7 @@
 using namespace Storage::Tape;
 
 OricTAP::OricTAP(const char *file_name) :
-	file_(file_name)
+	file_(file_name, FileHolder::FileMode::Read)
 {
 	// check the file signature
 	if(!file_.check_signature("\x16\x16\x16\x24", 4))
@@ -151,3 +151,8 @@ Tape::Pulse OricTAP::virtual_get_next_pulse() {
 bool OricTAP::is_at_end() {
 	return phase_ == End;
 }
+
+void OricTAP::serialise_position(Snapshot::Archive &archive) {
+	file_.serialise_position(archive);
+	archive(current_value_, bit_count_, pulse_counter_, phase_, next_phase_, phase_counter_, data_end_address_, data_start_address_);
+}
@@ -39,6 +39,7 @@ class OricTAP: public Tape {
 		Storage::FileHolder file_;
 		void virtual_reset();
 		Pulse virtual_get_next_pulse();
+		void serialise_position(Snapshot::Archive &archive) override;
 
 		// byte serialisation and output
 		uint16_t current_value_;
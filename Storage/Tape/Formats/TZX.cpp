@@ -16,7 +16,7 @@ const unsigned int TZXClockMSMultiplier = 3500;
 }
 
 TZX::TZX(const char *file_name) :
-	file_(file_name),
+	file_(file_name, FileHolder::FileMode::Read),
 	current_level_(false) {
 
 	// Check for signature followed by a 0x1a
@@ -30,13 +30,59 @@ TZX::TZX(const char *file_name) :
 	// Reject if an incompatible version
 	if(major_version != 1 || minor_version > 20)  throw ErrorNotTZX;
 
+	index_blocks();
 	virtual_reset();
 }
 
+void TZX::index_blocks() {
+	file_.seek(0x0a, SEEK_SET);
+	while(true) {
+		const uint8_t block_id = file_.get8();
+		if(file_.eof()) return;
+
+		// Determine the length of the block's content from its header.
+		const long offset = file_.tell();
+		long length;
+		switch(block_id) {
+			case 0x10:	file_.seek(2, SEEK_CUR);	length = 0x04 + file_.get16le();	break;
+			case 0x11:	file_.seek(15, SEEK_CUR);	length = 0x12 + file_.get24le();	break;
+			case 0x12:	length = 0x04;											break;
+			case 0x13:	length = 0x01 + 2 * file_.get8();						break;
+			case 0x14:	file_.seek(7, SEEK_CUR);	length = 0x0a + file_.get24le();	break;
+			case 0x19:	length = 0x04 + static_cast<long>(file_.get32le());		break;
+			case 0x20:	length = 0x02;											break;
+
+			case 0x21:	length = 0x01 + file_.get8();							break;
+			case 0x22:	length = 0x00;											break;
+			case 0x23:	length = 0x02;											break;
+			case 0x24:	length = 0x02;											break;
+			case 0x25:	length = 0x00;											break;
+			case 0x26:	length = 0x02 + 2 * file_.get16le();					break;
+			case 0x27:	length = 0x00;											break;
+			case 0x28:	length = 0x02 + file_.get16le();						break;
+
+			case 0x30:	length = 0x01 + file_.get8();							break;
+			case 0x31:	file_.seek(1, SEEK_CUR);	length = 0x02 + file_.get8();		break;
+			case 0x32:	length = 0x02 + file_.get16le();						break;
+			case 0x33:	length = 0x01 + 3 * file_.get8();						break;
+			case 0x35:	file_.seek(16, SEEK_CUR);	length = 0x14 + static_cast<long>(file_.get32le());	break;
+			case 0x5a:	length = 0x09;											break;
+
+			default:
+				// In TZX each chunk has a different way of stating or implying its length,
+				// so there is no route past an unimplemented chunk.
+			return;
+		}
+
+		blocks_.push_back({block_id, offset});
+		file_.seek(offset + length, SEEK_SET);
+	}
+}
+
 void TZX::virtual_reset() {
 	clear();
 	set_is_at_end(false);
-	file_.seek(0x0a, SEEK_SET);
+	block_pointer_ = 0;
 
 	// This is a workaround for arguably dodgy ZX80/ZX81 TZXs; they launch straight
 	// into data but both machines require a gap before data begins. So impose
@@ -47,14 +93,16 @@ void TZX::virtual_reset() {
 
 void TZX::get_next_pulses() {
 	while(empty()) {
-		uint8_t chunk_id = file_.get8();
-		if(file_.eof()) {
+		if(block_pointer_ == blocks_.size()) {
 			set_is_at_end(true);
 			return;
 		}
 
-//		printf("TZX %ld\n", ftell(file_));
-		switch(chunk_id) {
+		const Block &block = blocks_[block_pointer_];
+		++block_pointer_;
+		file_.seek(block.offset, SEEK_SET);
+
+		switch(block.id) {
 			case 0x10:	get_standard_speed_data_block();	break;
 			case 0x11:	get_turbo_speed_data_block();		break;
 			case 0x12:	get_pure_tone_data_block();			break;
@@ -76,16 +124,16 @@ void TZX::get_next_pulses() {
 			case 0x31:	ignore_message_block();				break;
 			case 0x33:	get_hardware_type();				break;
 
-			default:
-				// In TZX each chunk has a different way of stating or implying its length,
-				// so there is no route past an unimplemented chunk.
-				printf("!!Unknown %02x!!", chunk_id);
-				set_is_at_end(true);
-			return;
+			// Archive information, custom information and glue blocks have no effect on output.
+			default: break;
 		}
 	}
 }
 
+void TZX::serialise_source_position(Snapshot::Archive &archive) {
+	archive(block_pointer_, current_level_);
+}
+
 void TZX::get_generalised_data_block() {
 	uint32_t block_length = file_.get32le();
 	long endpoint = file_.tell() + static_cast<long>(block_length);
@@ -203,9 +251,7 @@ void TZX::get_turbo_speed_data_block() {
 
 void TZX::get_data_block(const DataBlock &data_block) {
 	// Output pilot tone.
-	for(unsigned int c = 0; c < data_block.length_of_pilot_tone; c++) {
-		post_pulse(data_block.length_of_pilot_pulse);
-	}
+	post_pulses(data_block.length_of_pilot_tone, data_block.length_of_pilot_pulse);
 
 	// Output sync pulses.
 	post_pulse(data_block.length_of_sync_first_pulse);
@@ -237,7 +283,7 @@ void TZX::get_pure_tone_data_block() {
 	uint16_t length_of_pulse = file_.get16le();
 	uint16_t nunber_of_pulses = file_.get16le();
 
-	while(nunber_of_pulses--) post_pulse(length_of_pulse);
+	post_pulses(nunber_of_pulses, length_of_pulse);
 }
 
 void TZX::get_pure_data_block() {
@@ -273,6 +319,11 @@ void TZX::post_pulse(unsigned int length) {
 	post_pulse(Storage::Time(length, StandardTZXClock));
 }
 
+void TZX::post_pulses(unsigned int count, unsigned int length) {
+	emplace_back_alternating(current_level_ ? Tape::Pulse::High : Tape::Pulse::Low, Storage::Time(length, StandardTZXClock), count);
+	if(count & 1) current_level_ ^= true;
+}
+
 void TZX::post_gap(unsigned int milliseconds) {
 	if(!milliseconds) return;
 	if(milliseconds > 1 && !current_level_) {
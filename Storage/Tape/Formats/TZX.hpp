@@ -12,11 +12,17 @@
 #include "../PulseQueuedTape.hpp"
 #include "../../FileHolder.hpp"
 
+#include <vector>
+
 namespace Storage {
 namespace Tape {
 
 /*!
-	Provides a @c Tape containing a CSW tape image, which is a compressed 1-bit sampling.
+	Provides a @c Tape containing a TZX tape image, which is a sequence of blocks each describing
+	a run of pulses in whichever form is most compact for it.
+
+	The blocks are indexed upon opening, so moving between them never requires any parsing of
+	their contents.
 */
 class TZX: public PulseQueuedTape {
 	public:
@@ -36,9 +42,18 @@ class TZX: public PulseQueuedTape {
 
 		void virtual_reset();
 		void get_next_pulses();
+		void serialise_source_position(Snapshot::Archive &archive) override;
 
 		bool current_level_;
 
+		struct Block {
+			uint8_t id;
+			long offset;	// The file offset of the block's content, i.e. just after its ID.
+		};
+		std::vector<Block> blocks_;
+		std::size_t block_pointer_ = 0;
+		void index_blocks();
+
 		void get_standard_speed_data_block();
 		void get_turbo_speed_data_block();
 		void get_pure_tone_data_block();
@@ -81,6 +96,7 @@ class TZX: public PulseQueuedTape {
 		void get_data(const Data &);
 
 		void post_pulse(unsigned int length);
+		void post_pulses(unsigned int count, unsigned int length);
 		void post_gap(unsigned int milliseconds);
 
 		void post_pulse(const Storage::Time &time);
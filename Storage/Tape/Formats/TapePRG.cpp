@@ -49,7 +49,7 @@
 using namespace Storage::Tape;
 
 PRG::PRG(const char *file_name) :
-	file_(file_name)
+	file_(file_name, FileHolder::FileMode::Read)
 {
 	// There's really no way to validate other than that if this file is larger than 64kb,
 	// of if load address + length > 65536 then it's broken.
@@ -99,6 +99,11 @@ bool PRG::is_at_end() {
 	return file_phase_ == FilePhaseAtEnd;
 }
 
+void PRG::serialise_position(Snapshot::Archive &archive) {
+	file_.serialise_position(archive);
+	archive(file_phase_, phase_offset_, bit_phase_, output_token_, output_byte_, check_digit_, copy_mask_);
+}
+
 void PRG::get_next_output_token() {
 	static const int block_length = 192;	// not counting the checksum
 	static const int countdown_bytes = 9;
@@ -40,6 +40,7 @@ class PRG: public Tape {
 		FileHolder file_;
 		Pulse virtual_get_next_pulse();
 		void virtual_reset();
+		void serialise_position(Snapshot::Archive &archive) override;
 
 		uint16_t load_address_;
 		uint16_t length_;
@@ -7,16 +7,78 @@
 //
 
 #include "TapeUEF.hpp"
+
+#include <zlib.h>
 #include <cstring>
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
 
-// MARK: - ZLib extensions
+using namespace Storage::Tape;
+
+UEF::UEF(const char *file_name) {
+	// Inflate the whole file up front; zlib is equally happy to read an uncompressed UEF.
+	gzFile file = gzopen(file_name, "rb");
+	if(!file) throw ErrorNotUEF;
+
+	uint8_t buffer[4096];
+	int bytes_read;
+	while((bytes_read = gzread(file, buffer, sizeof(buffer))) > 0) {
+		data_.insert(data_.end(), buffer, buffer + bytes_read);
+	}
+	gzclose(file);
+
+	if(data_.size() < 12 || std::memcmp(data_.data(), "UEF File!", 10)) {
+		throw ErrorNotUEF;
+	}
+
+	if(data_[11] > 0 || data_[10] > 10) {
+		throw ErrorNotUEF;
+	}
+
+	// Index the chunks; a chunk is included if its header is complete, even if its body has been truncated.
+	std::size_t pointer = 12;
+	while(data_.size() - pointer >= 6) {
+		Chunk chunk;
+		read_pointer_ = pointer;
+		chunk.id = static_cast<uint16_t>(get16());
+		chunk.length = static_cast<uint32_t>(get32());
+		chunk.start = read_pointer_;
+		chunks_.push_back(chunk);
+
+		if(data_.size() - chunk.start < chunk.length) break;
+		pointer = chunk.start + chunk.length;
+	}
+
+	set_platform_type();
+}
+
+// MARK: - Data access
+
+uint8_t UEF::get8() {
+	// Reads beyond the end of the file produce 0s.
+	if(read_pointer_ >= data_.size()) return 0;
+	return data_[read_pointer_++];
+}
+
+int UEF::get16() {
+	const int low = get8();
+	return low | (get8() << 8);
+}
+
+int UEF::get24() {
+	const int low = get16();
+	return low | (get8() << 16);
+}
 
-static float gzgetfloat(gzFile file) {
+int UEF::get32() {
+	const int low = get24();
+	return low | (get8() << 24);
+}
+
+float UEF::get_float() {
 	uint8_t bytes[4];
-	gzread(file, bytes, 4);
+	for(auto &byte: bytes) byte = get8();
 
 	/* assume a four byte array named Float exists, where Float[0]
 	was the first byte read from the UEF, Float[1] the second, etc */
@@ -41,90 +103,27 @@ static float gzgetfloat(gzFile file) {
 	return result;
 }
 
-static uint8_t gzget8(gzFile file) {
-	// This is a workaround for gzgetc, which seems to be broken in ZLib 1.2.8.
-	uint8_t result;
-	gzread(file, &result, 1);
-	return result;
-}
-
-static int gzget16(gzFile file) {
-	uint8_t bytes[2];
-	gzread(file, bytes, 2);
-	return bytes[0] | (bytes[1] << 8);
-}
-
-static int gzget24(gzFile file) {
-	uint8_t bytes[3];
-	gzread(file, bytes, 3);
-	return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16);
-}
-
-static int gzget32(gzFile file) {
-	uint8_t bytes[4];
-	gzread(file, bytes, 4);
-	return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (bytes[3] << 24);
-}
-
-using namespace Storage::Tape;
-
-UEF::UEF(const char *file_name) {
-	file_ = gzopen(file_name, "rb");
-
-	char identifier[10];
-	int bytes_read = gzread(file_, identifier, 10);
-	if(bytes_read < 10 || std::strcmp(identifier, "UEF File!")) {
-		throw ErrorNotUEF;
-	}
-
-	uint8_t version[2];
-	gzread(file_, version, 2);
-
-	if(version[1] > 0 || version[0] > 10) {
-		throw ErrorNotUEF;
-	}
-
-	set_platform_type();
-}
-
-UEF::~UEF() {
-	gzclose(file_);
-}
-
 // MARK: - Public methods
 
 void UEF::virtual_reset() {
-	gzseek(file_, 12, SEEK_SET);
+	chunk_pointer_ = 0;
+	time_base_ = 1200;
+	is_300_baud_ = false;
 	set_is_at_end(false);
 	clear();
 }
 
 // MARK: - Chunk navigator
 
-bool UEF::get_next_chunk(UEF::Chunk &result) {
-	uint16_t chunk_id = static_cast<uint16_t>(gzget16(file_));
-	uint32_t chunk_length = (uint32_t)gzget32(file_);
-	z_off_t start_of_next_chunk = gztell(file_) + chunk_length;
-
-	if(gzeof(file_)) {
-		return false;
-	}
-
-	result.id = chunk_id;
-	result.length = chunk_length;
-	result.start_of_next_chunk = start_of_next_chunk;
-
-	return true;
-}
-
 void UEF::get_next_pulses() {
 	while(empty()) {
-		// read chunk details
-		Chunk next_chunk;
-		if(!get_next_chunk(next_chunk)) {
+		if(chunk_pointer_ == chunks_.size()) {
 			set_is_at_end(true);
 			return;
 		}
+		const Chunk &next_chunk = chunks_[chunk_pointer_];
+		++chunk_pointer_;
+		read_pointer_ = next_chunk.start;
 
 		switch(next_chunk.id) {
 			case 0x0100:	queue_implicit_bit_pattern(next_chunk.length);	break;
@@ -141,13 +140,13 @@ void UEF::get_next_pulses() {
 			// change of base rate
 			case 0x0113: {
 				// TODO: something smarter than just converting this to an int
-				float new_time_base = gzgetfloat(file_);
+				float new_time_base = get_float();
 				time_base_ = static_cast<unsigned int>(roundf(new_time_base));
 			}
 			break;
 
 			case 0x0117: {
-				int baud_rate = gzget16(file_);
+				int baud_rate = get16();
 				is_300_baud_ = (baud_rate == 300);
 			}
 			break;
@@ -156,24 +155,26 @@ void UEF::get_next_pulses() {
 				printf("!!! Skipping %04x\n", next_chunk.id);
 			break;
 		}
-
-		gzseek(file_, next_chunk.start_of_next_chunk, SEEK_SET);
 	}
 }
 
+void UEF::serialise_source_position(Snapshot::Archive &archive) {
+	archive(chunk_pointer_, time_base_, is_300_baud_);
+}
+
 // MARK: - Chunk parsers
 
 void UEF::queue_implicit_bit_pattern(uint32_t length) {
 	while(length--) {
-		queue_implicit_byte(gzget8(file_));
+		queue_implicit_byte(get8());
 	}
 }
 
 void UEF::queue_explicit_bit_pattern(uint32_t length) {
-	std::size_t length_in_bits = (length << 3) - static_cast<std::size_t>(gzget8(file_));
+	std::size_t length_in_bits = (length << 3) - static_cast<std::size_t>(get8());
 	uint8_t current_byte = 0;
 	for(std::size_t bit = 0; bit < length_in_bits; bit++) {
-		if(!(bit&7)) current_byte = gzget8(file_);
+		if(!(bit&7)) current_byte = get8();
 		queue_bit(current_byte&1);
 		current_byte >>= 1;
 	}
@@ -181,13 +182,13 @@ void UEF::queue_explicit_bit_pattern(uint32_t length) {
 
 void UEF::queue_integer_gap() {
 	Time duration;
-	duration.length = static_cast<unsigned int>(gzget16(file_));
+	duration.length = static_cast<unsigned int>(get16());
 	duration.clock_rate = time_base_;
 	emplace_back(Pulse::Zero, duration);
 }
 
 void UEF::queue_floating_point_gap() {
-	float length = gzgetfloat(file_);
+	float length = get_float();
 	Time duration;
 	duration.length = static_cast<unsigned int>(length * 4000000);
 	duration.clock_rate = 4000000;
@@ -195,26 +196,26 @@ void UEF::queue_floating_point_gap() {
 }
 
 void UEF::queue_carrier_tone() {
-	unsigned int number_of_cycles = static_cast<unsigned int>(gzget16(file_));
+	unsigned int number_of_cycles = static_cast<unsigned int>(get16());
 	while(number_of_cycles--) queue_bit(1);
 }
 
 void UEF::queue_carrier_tone_with_dummy() {
-	unsigned int pre_cycles = static_cast<unsigned int>(gzget16(file_));
-	unsigned int post_cycles = static_cast<unsigned int>(gzget16(file_));
+	unsigned int pre_cycles = static_cast<unsigned int>(get16());
+	unsigned int post_cycles = static_cast<unsigned int>(get16());
 	while(pre_cycles--) queue_bit(1);
 	queue_implicit_byte(0xaa);
 	while(post_cycles--) queue_bit(1);
 }
 
 void UEF::queue_security_cycles() {
-	int number_of_cycles = gzget24(file_);
-	bool first_is_pulse = gzget8(file_) == 'P';
-	bool last_is_pulse = gzget8(file_) == 'P';
+	int number_of_cycles = get24();
+	bool first_is_pulse = get8() == 'P';
+	bool last_is_pulse = get8() == 'P';
 
 	uint8_t current_byte = 0;
 	for(int cycle = 0; cycle < number_of_cycles; cycle++) {
-		if(!(cycle&7)) current_byte = gzget8(file_);
+		if(!(cycle&7)) current_byte = get8();
 		int bit = (current_byte >> 7);
 		current_byte <<= 1;
 
@@ -236,16 +237,16 @@ void UEF::queue_security_cycles() {
 void UEF::queue_defined_data(uint32_t length) {
 	if(length < 3) return;
 
-	int bits_per_packet = gzget8(file_);
-	char parity_type = (char)gzget8(file_);
-	int number_of_stop_bits = gzget8(file_);
+	int bits_per_packet = get8();
+	char parity_type = (char)get8();
+	int number_of_stop_bits = get8();
 
 	bool has_extra_stop_wave = (number_of_stop_bits < 0);
 	number_of_stop_bits = abs(number_of_stop_bits);
 
 	length -= 3;
 	while(length--) {
-		uint8_t byte = gzget8(file_);
+		uint8_t byte = get8();
 
 		uint8_t parity_value = byte;
 		parity_value ^= (parity_value >> 4);
@@ -321,10 +322,10 @@ TargetPlatform::Type UEF::target_platform_type() {
 void UEF::set_platform_type() {
 	// If a chunk of type 0005 exists anywhere in the UEF then the UEF specifies its target machine.
 	// So check and, if so, update the list of machines for which this file thinks it is suitable.
-	Chunk next_chunk;
-	while(get_next_chunk(next_chunk)) {
-		if(next_chunk.id == 0x0005) {
-			uint8_t target = gzget8(file_);
+	for(const auto &chunk: chunks_) {
+		if(chunk.id == 0x0005) {
+			read_pointer_ = chunk.start;
+			uint8_t target = get8();
 			switch(target >> 4) {
 				case 0:	platform_type_ = TargetPlatform::BBCModelA;		break;
 				case 1:	platform_type_ = TargetPlatform::AcornElectron;	break;
@@ -334,7 +335,6 @@ void UEF::set_platform_type() {
 				default: break;
 			}
 		}
-		gzseek(file_, next_chunk.start_of_next_chunk, SEEK_SET);
 	}
 	reset();
 }
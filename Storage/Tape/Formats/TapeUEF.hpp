@@ -13,8 +13,8 @@
 
 #include "../../TargetPlatforms.hpp"
 
-#include <zlib.h>
 #include <cstdint>
+#include <vector>
 
 namespace Storage {
 namespace Tape {
@@ -30,7 +30,6 @@ class UEF : public PulseQueuedTape, public TargetPlatform::TypeDistinguisher {
 			@throws ErrorNotUEF if this file could not be opened and recognised as a valid UEF.
 		*/
 		UEF(const char *file_name);
-		~UEF();
 
 		enum {
 			ErrorNotUEF
@@ -43,18 +42,28 @@ class UEF : public PulseQueuedTape, public TargetPlatform::TypeDistinguisher {
 		TargetPlatform::Type target_platform_type();
 		TargetPlatform::Type platform_type_ = TargetPlatform::Acorn;
 
-		gzFile file_;
-		unsigned int time_base_ = 1200;
-		bool is_300_baud_ = false;
-
+		// The entire decompressed file, and a table of the chunks within it.
+		std::vector<uint8_t> data_;
 		struct Chunk {
 			uint16_t id;
 			uint32_t length;
-			z_off_t start_of_next_chunk;
+			std::size_t start;
 		};
+		std::vector<Chunk> chunks_;
+
+		std::size_t chunk_pointer_ = 0;
+		std::size_t read_pointer_ = 0;
+		unsigned int time_base_ = 1200;
+		bool is_300_baud_ = false;
+
+		uint8_t get8();
+		int get16();
+		int get24();
+		int get32();
+		float get_float();
 
-		bool get_next_chunk(Chunk &);
 		void get_next_pulses();
+		void serialise_source_position(Snapshot::Archive &archive) override;
 
 		void queue_implicit_bit_pattern(uint32_t length);
 		void queue_explicit_bit_pattern(uint32_t length);
@@ -12,7 +12,7 @@
 using namespace Storage::Tape;
 
 ZX80O81P::ZX80O81P(const char *file_name) {
-	Storage::FileHolder file(file_name);
+	Storage::FileHolder file(file_name, Storage::FileHolder::FileMode::Read);
 
 	// Grab the actual file contents
 	data_.resize(static_cast<std::size_t>(file.stats().st_size));
@@ -42,6 +42,10 @@ void ZX80O81P::virtual_reset() {
 	bit_pointer_ = wave_pointer_ = 0;
 }
 
+void ZX80O81P::serialise_position(Snapshot::Archive &archive) {
+	archive(data_pointer_, byte_, bit_pointer_, wave_pointer_, is_past_silence_, has_ended_final_byte_, is_high_);
+}
+
 bool ZX80O81P::has_finished_data() {
 	return (data_pointer_ == data_.size()) && !wave_pointer_ && !bit_pointer_;
 }
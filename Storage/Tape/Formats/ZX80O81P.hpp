@@ -46,6 +46,7 @@ class ZX80O81P: public Tape, public TargetPlatform::TypeDistinguisher {
 
 		void virtual_reset();
 		Pulse virtual_get_next_pulse();
+		void serialise_position(Snapshot::Archive &archive) override;
 		bool has_finished_data();
 
 		uint8_t byte_;
@@ -33,6 +33,12 @@ class Shifter: public Storage::DigitalPhaseLockedLoop::Delegate {
 
 		void digital_phase_locked_loop_output_bit(int value);
 
+		/// Captures or restores the state of the shifter and its PLL.
+		void serialise(Snapshot::Archive &archive) {
+			pll_.serialise(archive);
+			archive(was_high_, input_pattern_, input_bit_counter_);
+		}
+
 	private:
 		Storage::DigitalPhaseLockedLoop pll_;
 		bool was_high_;
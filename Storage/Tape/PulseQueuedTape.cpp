@@ -22,6 +22,7 @@ void PulseQueuedTape::set_is_at_end(bool is_at_end) {
 
 void PulseQueuedTape::clear() {
 	queued_pulses_.clear();
+	batch_position_.clear();
 	pulse_pointer_ = 0;
 }
 
@@ -33,6 +34,19 @@ void PulseQueuedTape::emplace_back(Tape::Pulse::Type type, Time length) {
 	queued_pulses_.emplace_back(type, length);
 }
 
+void PulseQueuedTape::emplace_back_alternating(Tape::Pulse::Type type, Time length, std::size_t count) {
+	if(!count) return;
+
+	const std::size_t start = queued_pulses_.size();
+	queued_pulses_.reserve(start + count);
+	queued_pulses_.insert(queued_pulses_.end(), count, Pulse(type, length));
+
+	const Pulse::Type other_type = (type == Pulse::High) ? Pulse::Low : Pulse::High;
+	for(std::size_t c = start + 1; c < queued_pulses_.size(); c += 2) {
+		queued_pulses_[c].type = other_type;
+	}
+}
+
 Tape::Pulse PulseQueuedTape::silence() {
 	Pulse silence;
 	silence.type = Pulse::Zero;
@@ -48,6 +62,15 @@ Tape::Pulse PulseQueuedTape::virtual_get_next_pulse() {
 
 	if(pulse_pointer_ == queued_pulses_.size()) {
 		clear();
+		if(can_capture_source_position_) {
+			Snapshot::Archive archive;
+			serialise_source_position(archive);
+			if(archive.is_valid()) {
+				batch_position_ = std::move(archive.get_data());
+			} else {
+				can_capture_source_position_ = false;
+			}
+		}
 		get_next_pulses();
 
 		if(is_at_end_ || pulse_pointer_ == queued_pulses_.size()) {
@@ -59,3 +82,36 @@ Tape::Pulse PulseQueuedTape::virtual_get_next_pulse() {
 	pulse_pointer_++;
 	return queued_pulses_[read_pointer];
 }
+
+// MARK: - Checkpoints
+
+void PulseQueuedTape::serialise_source_position(Snapshot::Archive &archive) {
+	archive.set_invalid();
+}
+
+void PulseQueuedTape::serialise_position(Snapshot::Archive &archive) {
+	if(!can_capture_source_position_) {
+		archive.set_invalid();
+		return;
+	}
+
+	std::size_t pulse_pointer = pulse_pointer_;
+	bool is_at_end = is_at_end_;
+	std::vector<uint8_t> batch_position = batch_position_;
+	archive(pulse_pointer, is_at_end, batch_position);
+
+	if(archive.is_reading() && archive.is_valid()) {
+		// Regenerate the batch that was current at the point of capture, then resume within it.
+		if(batch_position.empty()) {
+			reset();
+		} else {
+			clear();
+			Snapshot::Archive source(batch_position);
+			serialise_source_position(source);
+			batch_position_ = std::move(batch_position);
+			get_next_pulses();
+		}
+		pulse_pointer_ = pulse_pointer;
+		is_at_end_ = is_at_end;
+	}
+}
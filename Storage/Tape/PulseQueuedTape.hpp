@@ -24,6 +24,10 @@ namespace Tape {
 	Otherwise get_next_pulse() returns something from the pulse queue if there is
 	anything there, and otherwise calls get_next_pulses(). get_next_pulses() is
 	virtual, giving subclasses a chance to provide the next batch of pulses.
+
+	Subclasses that implement @c serialise_source_position can be checkpointed; the
+	queue records the source position before each batch and regenerates the batch
+	from there upon restoration.
 */
 class PulseQueuedTape: public Tape {
 	public:
@@ -32,19 +36,39 @@ class PulseQueuedTape: public Tape {
 
 	protected:
 		void emplace_back(Tape::Pulse::Type type, Time length);
+
+		/*!
+			Appends @c count pulses of @c length, alternating in level and starting with @c type;
+			storage is reserved once and the pulses are inserted with a single call.
+		*/
+		void emplace_back_alternating(Tape::Pulse::Type type, Time length, std::size_t count);
 		void clear();
 		bool empty();
 
 		void set_is_at_end(bool);
 		virtual void get_next_pulses() = 0;
 
+		/*!
+			Captures or restores via @c archive whatever is necessary in order that a subsequent
+			call to get_next_pulses produces the same batch as it would have at the point of capture.
+
+			The default implementation marks the archive as invalid, indicating that the format
+			can't be checkpointed.
+		*/
+		virtual void serialise_source_position(Snapshot::Archive &archive);
+
 	private:
 		Pulse virtual_get_next_pulse();
 		Pulse silence();
+		void serialise_position(Snapshot::Archive &archive) override;
 
 		std::vector<Pulse> queued_pulses_;
 		std::size_t pulse_pointer_;
 		bool is_at_end_;
+
+		// The source position from which the current batch was generated; empty if the batch was queued upon reset.
+		std::vector<uint8_t> batch_position_;
+		bool can_capture_source_position_ = true;
 };
 
 }
@@ -9,6 +9,8 @@
 #include "Tape.hpp"
 #include "../../NumberTheory/Factors.hpp"
 
+#include <algorithm>
+
 using namespace Storage::Tape;
 
 // MARK: - Lifecycle
@@ -20,21 +22,17 @@ TapePlayer::TapePlayer(unsigned int input_clock_rate) :
 // MARK: - Seeking
 
 void Storage::Tape::Tape::seek(Time &seek_time) {
-	Time next_time(0);
-	reset();
+	Time next_time = resume_from(checkpoint_before(seek_time));
 	while(next_time <= seek_time) {
-		get_next_pulse();
-		next_time += pulse_.length;
+		advance(next_time);
 	}
 }
 
 Storage::Time Tape::get_current_time() {
-	Time time(0);
-	uint64_t steps = get_offset();
-	reset();
-	while(steps--) {
-		get_next_pulse();
-		time += pulse_.length;
+	const uint64_t offset = offset_;
+	Time time = resume_from(checkpoint_before(offset));
+	while(offset_ < offset) {
+		advance(time);
 	}
 	return time;
 }
@@ -56,11 +54,72 @@ uint64_t Tape::get_offset() {
 
 void Tape::set_offset(uint64_t offset) {
 	if(offset == offset_) return;
-	if(offset < offset_) {
+
+	// Resume from a checkpoint if moving backwards, or if there's one between here and there;
+	// otherwise just proceed from the current position.
+	const std::size_t checkpoint = checkpoint_before(offset);
+	if(offset < offset_ || (checkpoint && checkpoints_[checkpoint - 1].offset > offset_)) {
+		Time time = resume_from(checkpoint);
+		while(offset_ < offset) advance(time);
+	} else {
+		while(offset_ < offset) get_next_pulse();
+	}
+}
+
+// MARK: - Checkpoints
+
+void Tape::serialise_position(Snapshot::Archive &archive) {
+	archive.set_invalid();
+}
+
+/*
+	Checkpoint 0 is the start of the tape; checkpoint n is checkpoints_[n-1]. The two checkpoint_befores
+	return the latest checkpoint at or before the nominated offset or time.
+*/
+std::size_t Tape::checkpoint_before(uint64_t offset) {
+	return static_cast<std::size_t>(std::min(offset / checkpoint_interval, static_cast<uint64_t>(checkpoints_.size())));
+}
+
+std::size_t Tape::checkpoint_before(const Time &time) {
+	const auto next = std::upper_bound(checkpoints_.begin(), checkpoints_.end(), time, [] (const Time &time, const Checkpoint &checkpoint) {
+		return time < checkpoint.time;
+	});
+	return static_cast<std::size_t>(next - checkpoints_.begin());
+}
+
+Storage::Time Tape::resume_from(std::size_t checkpoint) {
+	if(!checkpoint) {
 		reset();
+		return Time(0);
+	}
+
+	const Checkpoint &target = checkpoints_[checkpoint - 1];
+	Snapshot::Archive archive(target.position);
+	serialise_position(archive);
+	offset_ = target.offset;
+	pulse_ = target.pulse;
+	return target.time;
+}
+
+void Tape::advance(Time &time) {
+	get_next_pulse();
+	time += pulse_.length;
+
+	// Record a checkpoint if this is the first time this offset has been reached.
+	if(can_checkpoint_ && offset_ == (checkpoints_.size() + 1) * checkpoint_interval) {
+		Snapshot::Archive archive;
+		serialise_position(archive);
+		if(archive.is_valid()) {
+			Checkpoint checkpoint;
+			checkpoint.offset = offset_;
+			checkpoint.time = time;
+			checkpoint.pulse = pulse_;
+			checkpoint.position = std::move(archive.get_data());
+			checkpoints_.push_back(std::move(checkpoint));
+		} else {
+			can_checkpoint_ = false;
+		}
 	}
-	offset -= offset_;
-	while(offset--) get_next_pulse();
 }
 
 // MARK: - Player
@@ -114,6 +173,18 @@ void TapePlayer::process_next_event() {
 	get_next_pulse();
 }
 
+void TapePlayer::serialise(Snapshot::Archive &archive) {
+	archive.tag(0x74617065);
+	TimedEventLoop::serialise(archive);
+
+	uint64_t offset = tape_ ? tape_->get_offset() : 0;
+	archive(offset, current_pulse_);
+	if(archive.is_reading()) {
+		if(tape_ && archive.is_valid()) tape_->set_offset(offset);
+		update_sleep_observer();
+	}
+}
+
 // MARK: - Binary Player
 
 BinaryTapePlayer::BinaryTapePlayer(unsigned int input_clock_rate) :
@@ -143,6 +214,12 @@ void BinaryTapePlayer::run_for(const Cycles cycles) {
 	if(motor_is_running_) TapePlayer::run_for(cycles);
 }
 
+void BinaryTapePlayer::serialise(Snapshot::Archive &archive) {
+	TapePlayer::serialise(archive);
+	archive(input_level_, motor_is_running_);
+	if(archive.is_reading()) update_sleep_observer();
+}
+
 void BinaryTapePlayer::set_delegate(Delegate *delegate) {
 	delegate_ = delegate;
 }
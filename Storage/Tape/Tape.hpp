@@ -10,6 +10,7 @@
 #define Tape_hpp
 
 #include <memory>
+#include <vector>
 
 #include "../../ClockReceiver/ClockReceiver.hpp"
 #include "../../ClockReceiver/Sleeper.hpp"
@@ -29,6 +30,10 @@ namespace Tape {
 	Subclasses should implement at least @c get_next_pulse and @c reset to provide a serial feeding
 	of pulses and the ability to return to the start of the feed. They may also implement @c seek if
 	a better implementation than a linear search from the @c reset time can be implemented.
+
+	Subclasses that also implement @c serialise_position allow the tape to record checkpoints as it
+	replays pulses in order to seek or to calculate the current time; thereafter such searches resume
+	from the nearest checkpoint rather than from the start.
 */
 class Tape {
 	public:
@@ -69,21 +74,48 @@ class Tape {
 		virtual void set_offset(uint64_t);
 
 		/*!
-			Calculates and returns the amount of time that has elapsed since the time began. Potentially expensive.
+			Calculates and returns the amount of time that has elapsed since the time began. Potentially expensive,
+			though less so once checkpoints have been recorded.
 		*/
 		virtual Time get_current_time();
 
 		/*!
-			Seeks to @c time. Potentially expensive.
+			Seeks to @c time. Potentially expensive, though less so once checkpoints have been recorded.
 		*/
 		virtual void seek(Time &time);
 
 		virtual ~Tape() {};
 
+	protected:
+		/*!
+			Captures or restores via @c archive whatever this format needs in order to resume producing pulses
+			from the current position, exactly as it would have had it arrived there by replaying from the start.
+
+			The default implementation marks the archive as invalid, indicating that the format can't be
+			checkpointed; such tapes always replay from the start.
+		*/
+		virtual void serialise_position(Snapshot::Archive &archive);
+
 	private:
 		uint64_t offset_;
 		Tape::Pulse pulse_;
 
+		/// Checkpoints are recorded every this many pulses, i.e. checkpoints_[n] is at offset (n+1) * checkpoint_interval.
+		static const uint64_t checkpoint_interval = 4096;
+		struct Checkpoint {
+			uint64_t offset;
+			Time time;
+			Tape::Pulse pulse;
+			std::vector<uint8_t> position;
+		};
+		std::vector<Checkpoint> checkpoints_;
+		bool can_checkpoint_ = true;
+
+		std::size_t checkpoint_before(uint64_t offset);
+		std::size_t checkpoint_before(const Time &time);
+		Time resume_from(std::size_t checkpoint);
+		void advance(Time &time);
+
 		virtual Pulse virtual_get_next_pulse() = 0;
 		virtual void virtual_reset() = 0;
 };
@@ -109,6 +141,12 @@ class TapePlayer: public TimedEventLoop, public Sleeper {
 
 		bool is_sleeping();
 
+		/*!
+			Captures or restores the position of the tape, if there is one, and the time until the current
+			pulse ends. The tape's contents are not captured.
+		*/
+		void serialise(Snapshot::Archive &archive);
+
 	protected:
 		virtual void process_next_event();
 		virtual void process_input_pulse(const Tape::Pulse &pulse) = 0;
@@ -145,6 +183,9 @@ class BinaryTapePlayer: public TapePlayer {
 
 		bool is_sleeping();
 
+		/// Extends TapePlayer::serialise with the input level and motor state.
+		void serialise(Snapshot::Archive &archive);
+
 	protected:
 		Delegate *delegate_ = nullptr;
 		virtual void process_input_pulse(const Storage::Tape::Tape::Pulse &pulse);
@@ -87,6 +87,10 @@ void TimedEventLoop::set_next_event_time_interval(Time interval) {
 	subcycles_until_event_.simplify();
 }
 
+void TimedEventLoop::serialise(Snapshot::Archive &archive) {
+	archive(cycles_until_event_, subcycles_until_event_);
+}
+
 Time TimedEventLoop::get_time_into_next_event() {
 	// TODO: calculate, presumably as [length of interval] - ([cycles left] + [subcycles left])
 	Time zero;
@@ -12,6 +12,7 @@
 #include "Storage.hpp"
 #include "../ClockReceiver/ClockReceiver.hpp"
 #include "../SignalProcessing/Stepper.hpp"
+#include "../Snapshot/Snapshot.hpp"
 
 #include <memory>
 
@@ -59,6 +60,12 @@ namespace Storage {
 			*/
 			unsigned int get_input_clock_rate();
 
+			/*!
+				Captures or restores the time remaining until the next event. Subclasses remain responsible
+				for the event itself.
+			*/
+			void serialise(Snapshot::Archive &archive);
+
 		protected:
 			/*!
 				Sets the time interval, as a proportion of a second, until the next event should be triggered.